@@ -54,6 +54,9 @@ public:
 
   virtual bool getTransactions(const std::vector<Crypto::Hash>& transactionHashes, std::vector<TransactionDetails>& transactions) = 0;
   virtual bool getTransactionsByPaymentId(const Crypto::Hash& paymentId, std::vector<TransactionDetails>& transactions) = 0;
+  // Require explorer indexes on the node, NULL_HASH stands for a key which isn't found
+  virtual bool getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes) = 0;
+  virtual bool getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes) = 0;
   virtual bool getPoolState(const std::vector<Crypto::Hash>& knownPoolTransactionHashes, Crypto::Hash knownBlockchainTop, bool& isBlockchainActual, std::vector<TransactionDetails>& newTransactions, std::vector<Crypto::Hash>& removedTransactions) = 0;
 
   virtual uint64_t getRewardBlocksWindow() = 0;
@@ -102,6 +102,9 @@ public:
 
   virtual void getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount, std::vector<Crypto::Hash>& blockHashes, const Callback& callback) = 0;
   virtual void getTransactionHashesByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) = 0;
+  // Require explorer indexes on the node, NULL_HASH stands for a key which isn't found
+  virtual void getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) = 0;
+  virtual void getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) = 0;
 
   virtual BlockHeaderInfo getLastLocalBlockHeaderInfo() const = 0;
 
@@ -111,6 +114,10 @@ public:
   virtual void getTransactionOutsGlobalIndices(const Crypto::Hash& transactionHash, std::vector<uint32_t>& outsGlobalIndices, const Callback& callback) = 0;
   virtual void queryBlocks(std::vector<Crypto::Hash>&& knownBlockIds, uint64_t timestamp, std::vector<BlockShortEntry>& newBlocks, uint32_t& startHeight, const Callback& callback) = 0;
   virtual void getPoolSymmetricDifference(std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual, std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) = 0;
+  // Returns pool changes since poolVersion and updates it. knownPoolTxIds are used only if the node doesn't remember poolVersion,
+  // isDelta tells which of the two the result is relative to. Pass poolVersion = 0 if there is no version yet.
+  virtual void getPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual, bool& isDelta,
+    std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) = 0;
   virtual void getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, MultisignatureOutput& out, const Callback& callback) = 0;
 
   virtual void getBlocks(const std::vector<uint32_t>& blockHeights, std::vector<std::vector<BlockDetails>>& blocks, const Callback& callback) = 0;
@@ -97,6 +97,10 @@ public:
   virtual size_t transactionsCount() const = 0;
   virtual uint64_t balance(uint32_t flags = IncludeDefault) const = 0;
   virtual void getOutputs(std::vector<TransactionOutputInformation>& transfers, uint32_t flags = IncludeDefault) const = 0;
+  // Visible key outputs are indexed by amount, so a random one can be picked without copying all outputs.
+  // Indices are in [0, spendableOutputsCount(...)), getSpendableOutput returns false if the output is still locked
+  virtual size_t spendableOutputsCount(uint64_t minAmount, uint64_t maxAmount) const = 0;
+  virtual bool getSpendableOutput(uint64_t minAmount, uint64_t maxAmount, size_t index, TransactionOutputInformation& output) const = 0;
   virtual bool getTransactionInformation(const Crypto::Hash& transactionHash, TransactionInformation& info,
     uint64_t* amountIn = nullptr, uint64_t* amountOut = nullptr) const = 0;
   virtual std::vector<TransactionOutputInformation> getTransactionOutputs(const Crypto::Hash& transactionHash, uint32_t flags = IncludeDefault) const = 0;
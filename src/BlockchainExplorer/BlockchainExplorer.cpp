@@ -389,6 +389,40 @@ bool BlockchainExplorer::getTransactionsByPaymentId(const Hash& paymentId, std::
   return getTransactions(transactionHashes, transactions);
 }
 
+bool BlockchainExplorer::getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Hash>& transactionHashes) {
+  if (state.load() != INITIALIZED) {
+    throw std::system_error(make_error_code(CryptoNote::error::BlockchainExplorerErrorCodes::NOT_INITIALIZED));
+  }
+
+  logger(DEBUGGING) << "Get transaction hashes by " << keyImages.size() << " key images request came.";
+
+  NodeRequest request([&](const INode::Callback& cb) { return node.getTransactionHashesByKeyImages(keyImages, transactionHashes, cb); });
+  auto ec = request.performBlocking();
+  if (ec) {
+    logger(ERROR) << "Can't get transaction hashes by key images: " << ec.message();
+    throw std::system_error(ec);
+  }
+
+  return true;
+}
+
+bool BlockchainExplorer::getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Hash>& transactionHashes) {
+  if (state.load() != INITIALIZED) {
+    throw std::system_error(make_error_code(CryptoNote::error::BlockchainExplorerErrorCodes::NOT_INITIALIZED));
+  }
+
+  logger(DEBUGGING) << "Get transaction hashes by " << outputKeys.size() << " output keys request came.";
+
+  NodeRequest request([&](const INode::Callback& cb) { return node.getTransactionHashesByOutputKeys(outputKeys, transactionHashes, cb); });
+  auto ec = request.performBlocking();
+  if (ec) {
+    logger(ERROR) << "Can't get transaction hashes by output keys: " << ec.message();
+    throw std::system_error(ec);
+  }
+
+  return true;
+}
+
 bool BlockchainExplorer::getPoolState(const std::vector<Hash>& knownPoolTransactionHashes, Hash knownBlockchainTopHash, bool& isBlockchainActual, std::vector<TransactionDetails>& newTransactions, std::vector<Hash>& removedTransactions) {
   if (state.load() != INITIALIZED) {
     throw std::system_error(make_error_code(CryptoNote::error::BlockchainExplorerErrorCodes::NOT_INITIALIZED));
@@ -63,6 +63,8 @@ public:
 
   virtual bool getTransactions(const std::vector<Crypto::Hash>& transactionHashes, std::vector<TransactionDetails>& transactions) override;
   virtual bool getTransactionsByPaymentId(const Crypto::Hash& paymentId, std::vector<TransactionDetails>& transactions) override;
+  virtual bool getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes) override;
+  virtual bool getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes) override;
   virtual bool getPoolState(const std::vector<Crypto::Hash>& knownPoolTransactionHashes, Crypto::Hash knownBlockchainTop, bool& isBlockchainActual, std::vector<TransactionDetails>& newTransactions, std::vector<Crypto::Hash>& removedTransactions) override;
 
   virtual uint64_t getRewardBlocksWindow() override;
@@ -0,0 +1,327 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace Common {
+
+namespace {
+
+const unsigned SUB_BUCKET_BITS = 3;
+const size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+
+static_assert(MetricHistogram::BUCKET_COUNT == (40 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + 1, "BUCKET_COUNT doesn't match MAX_VALUE");
+
+size_t getShardIndex() {
+  // thread ids are often aligned addresses, mix their bits before taking the remainder
+  uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return static_cast<size_t>((id * UINT64_C(0x9e3779b97f4a7c15)) >> 32) % METRIC_SHARD_COUNT;
+}
+
+unsigned floorLog2(uint64_t value) {
+  unsigned result = 0;
+  for (unsigned shift = 32; shift > 0; shift /= 2) {
+    if (value >= (UINT64_C(1) << shift)) {
+      value >>= shift;
+      result += shift;
+    }
+  }
+
+  return result;
+}
+
+bool isPowerOfTwo(uint64_t value) {
+  return value != 0 && (value & (value - 1)) == 0;
+}
+
+std::string withLabels(const std::string& name, const std::string& labels, const std::string& extraLabel = "") {
+  if (labels.empty() && extraLabel.empty()) {
+    return name;
+  }
+
+  return name + "{" + labels + (labels.empty() || extraLabel.empty() ? "" : ",") + extraLabel + "}";
+}
+
+}
+
+MetricCounter::MetricCounter(const std::atomic<bool>& enabled) : m_enabled(enabled) {
+  for (auto& shard : m_shards) {
+    shard.value.store(0, std::memory_order_relaxed);
+  }
+}
+
+void MetricCounter::increment(uint64_t value) {
+  if (m_enabled.load(std::memory_order_relaxed)) {
+    m_shards[getShardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+  }
+}
+
+uint64_t MetricCounter::getValue() const {
+  uint64_t result = 0;
+  for (auto& shard : m_shards) {
+    result += shard.value.load(std::memory_order_relaxed);
+  }
+
+  return result;
+}
+
+MetricGauge::MetricGauge(const std::atomic<bool>& enabled) : m_enabled(enabled), m_value(0) {
+}
+
+void MetricGauge::set(int64_t value) {
+  if (m_enabled.load(std::memory_order_relaxed)) {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+}
+
+void MetricGauge::add(int64_t value) {
+  if (m_enabled.load(std::memory_order_relaxed)) {
+    m_value.fetch_add(value, std::memory_order_relaxed);
+  }
+}
+
+int64_t MetricGauge::getValue() const {
+  return m_value.load(std::memory_order_relaxed);
+}
+
+const uint64_t MetricHistogram::MAX_VALUE;
+const size_t MetricHistogram::BUCKET_COUNT;
+
+uint64_t MetricHistogram::Snapshot::getPercentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100 * count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t cumulativeCount = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    cumulativeCount += buckets[i];
+    if (cumulativeCount >= rank) {
+      return getBucketUpperBound(i);
+    }
+  }
+
+  return MAX_VALUE;
+}
+
+MetricHistogram::MetricHistogram(const std::atomic<bool>& enabled) : m_enabled(enabled), m_shards(new Shard[METRIC_SHARD_COUNT]) {
+  for (size_t i = 0; i < METRIC_SHARD_COUNT; ++i) {
+    m_shards[i].sum.store(0, std::memory_order_relaxed);
+    for (auto& bucket : m_shards[i].buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool MetricHistogram::isEnabled() const {
+  return m_enabled.load(std::memory_order_relaxed);
+}
+
+void MetricHistogram::record(uint64_t value) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  Shard& shard = m_shards[getShardIndex()];
+  shard.buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(value < MAX_VALUE ? value : MAX_VALUE, std::memory_order_relaxed);
+}
+
+MetricHistogram::Snapshot MetricHistogram::getSnapshot() const {
+  Snapshot snapshot;
+  snapshot.count = 0;
+  snapshot.sum = 0;
+  snapshot.buckets.assign(BUCKET_COUNT, 0);
+  for (size_t i = 0; i < METRIC_SHARD_COUNT; ++i) {
+    snapshot.sum += m_shards[i].sum.load(std::memory_order_relaxed);
+    for (size_t j = 0; j < BUCKET_COUNT; ++j) {
+      snapshot.buckets[j] += m_shards[i].buckets[j].load(std::memory_order_relaxed);
+    }
+  }
+
+  // counting buckets instead of a separate counter keeps the snapshot consistent with concurrent records
+  for (uint64_t bucket : snapshot.buckets) {
+    snapshot.count += bucket;
+  }
+
+  return snapshot;
+}
+
+size_t MetricHistogram::getBucketIndex(uint64_t value) {
+  if (value == 0) {
+    return 0;
+  }
+
+  // bucket i > 0 contains value if bucket i - 1 of the plain log-linear layout contains value - 1,
+  // so powers of two are upper bounds of buckets as Prometheus expects
+  uint64_t shifted = (value < MAX_VALUE ? value : MAX_VALUE) - 1;
+  if (shifted < SUB_BUCKET_COUNT) {
+    return static_cast<size_t>(shifted) + 1;
+  }
+
+  unsigned exponent = floorLog2(shifted);
+  return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + static_cast<size_t>(shifted >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT + 1;
+}
+
+uint64_t MetricHistogram::getBucketUpperBound(size_t index) {
+  if (index < SUB_BUCKET_COUNT) {
+    return index;
+  }
+
+  return static_cast<uint64_t>(index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << (index / SUB_BUCKET_COUNT - 1);
+}
+
+MetricsRegistry::MetricsRegistry() : m_enabled(false) {
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+void MetricsRegistry::enable() {
+  m_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool MetricsRegistry::isEnabled() const {
+  return m_enabled.load(std::memory_order_relaxed);
+}
+
+MetricCounter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto& metric = getFamily(name, help, MetricType::COUNTER).counters[labels];
+  if (!metric) {
+    metric.reset(new MetricCounter(m_enabled));
+  }
+
+  return *metric;
+}
+
+MetricGauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto& metric = getFamily(name, help, MetricType::GAUGE).gauges[labels];
+  if (!metric) {
+    metric.reset(new MetricGauge(m_enabled));
+  }
+
+  return *metric;
+}
+
+MetricHistogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto& metric = getFamily(name, help, MetricType::HISTOGRAM).histograms[labels];
+  if (!metric) {
+    metric.reset(new MetricHistogram(m_enabled));
+  }
+
+  return *metric;
+}
+
+std::string MetricsRegistry::toPrometheusText() const {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  std::ostringstream stream;
+  for (auto& familyPair : m_families) {
+    const std::string& name = familyPair.first;
+    const MetricFamily& family = familyPair.second;
+    stream << "# HELP " << name << " " << family.help << "\n";
+    switch (family.type) {
+    case MetricType::COUNTER:
+      stream << "# TYPE " << name << " counter\n";
+      for (auto& metric : family.counters) {
+        stream << withLabels(name, metric.first) << " " << metric.second->getValue() << "\n";
+      }
+      break;
+
+    case MetricType::GAUGE:
+      stream << "# TYPE " << name << " gauge\n";
+      for (auto& metric : family.gauges) {
+        stream << withLabels(name, metric.first) << " " << metric.second->getValue() << "\n";
+      }
+      break;
+
+    case MetricType::HISTOGRAM:
+      stream << "# TYPE " << name << " histogram\n";
+      for (auto& metric : family.histograms) {
+        MetricHistogram::Snapshot snapshot = metric.second->getSnapshot();
+        // buckets above the largest value only repeat the total count
+        auto lastBucket = std::find_if(snapshot.buckets.rbegin(), snapshot.buckets.rend(), [](uint64_t bucket) { return bucket != 0; });
+        uint64_t maxBound = lastBucket == snapshot.buckets.rend() ? 0 : MetricHistogram::getBucketUpperBound(snapshot.buckets.rend() - lastBucket - 1);
+        uint64_t cumulativeCount = 0;
+        for (size_t i = 0; i < snapshot.buckets.size(); ++i) {
+          cumulativeCount += snapshot.buckets[i];
+          uint64_t bound = MetricHistogram::getBucketUpperBound(i);
+          if (isPowerOfTwo(bound)) {
+            stream << withLabels(name + "_bucket", metric.first, "le=\"" + std::to_string(bound) + "\"") << " " << cumulativeCount << "\n";
+            if (bound >= maxBound) {
+              break;
+            }
+          }
+        }
+
+        stream << withLabels(name + "_bucket", metric.first, "le=\"+Inf\"") << " " << snapshot.count << "\n";
+        stream << withLabels(name + "_sum", metric.first) << " " << snapshot.sum << "\n";
+        stream << withLabels(name + "_count", metric.first) << " " << snapshot.count << "\n";
+      }
+      break;
+    }
+  }
+
+  return stream.str();
+}
+
+MetricsRegistry::MetricFamily& MetricsRegistry::getFamily(const std::string& name, const std::string& help, MetricType type) {
+  auto it = m_families.find(name);
+  if (it == m_families.end()) {
+    it = m_families.emplace(name, MetricFamily()).first;
+    it->second.type = type;
+    it->second.help = help;
+  } else if (it->second.type != type) {
+    throw std::runtime_error("Metric " + name + " is already registered with another type");
+  }
+
+  return it->second;
+}
+
+MetricTimer::MetricTimer(MetricHistogram& histogram) : MetricTimer(&histogram) {
+}
+
+MetricTimer::MetricTimer(MetricHistogram* histogram) : m_histogram(histogram != nullptr && histogram->isEnabled() ? histogram : nullptr) {
+  if (m_histogram != nullptr) {
+    m_start = std::chrono::steady_clock::now();
+  }
+}
+
+MetricTimer::~MetricTimer() {
+  stop();
+}
+
+void MetricTimer::stop() {
+  if (m_histogram != nullptr) {
+    auto duration = std::chrono::steady_clock::now() - m_start;
+    m_histogram->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    m_histogram = nullptr;
+  }
+}
+
+}
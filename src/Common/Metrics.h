@@ -0,0 +1,165 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Common {
+
+// Updates from different threads go to different shards, so they don't contend for a cache line
+const size_t METRIC_SHARD_COUNT = 8;
+
+// All metric updates are no-ops while the registry of the metric is disabled
+
+class MetricCounter {
+public:
+  explicit MetricCounter(const std::atomic<bool>& enabled);
+  MetricCounter(const MetricCounter&) = delete;
+  MetricCounter& operator=(const MetricCounter&) = delete;
+
+  void increment(uint64_t value = 1);
+  uint64_t getValue() const;
+
+private:
+  struct Shard {
+    std::atomic<uint64_t> value;
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  const std::atomic<bool>& m_enabled;
+  Shard m_shards[METRIC_SHARD_COUNT];
+};
+
+class MetricGauge {
+public:
+  explicit MetricGauge(const std::atomic<bool>& enabled);
+  MetricGauge(const MetricGauge&) = delete;
+  MetricGauge& operator=(const MetricGauge&) = delete;
+
+  void set(int64_t value);
+  void add(int64_t value);
+  int64_t getValue() const;
+
+private:
+  const std::atomic<bool>& m_enabled;
+  std::atomic<int64_t> m_value;
+};
+
+// HDR-style histogram of non-negative integers. Values up to 8 have their own buckets, every next power of two
+// range is split into 8 buckets, so a value is reported with at most 12.5% error. Values above MAX_VALUE are
+// counted as MAX_VALUE.
+class MetricHistogram {
+public:
+  static const uint64_t MAX_VALUE = UINT64_C(1) << 40;
+  static const size_t BUCKET_COUNT = 305;
+
+  struct Snapshot {
+    uint64_t count;
+    uint64_t sum;
+    std::vector<uint64_t> buckets;
+
+    // Upper bound of the bucket containing the value at the given percentile (0..100), 0 if there are no values
+    uint64_t getPercentile(double percentile) const;
+  };
+
+  explicit MetricHistogram(const std::atomic<bool>& enabled);
+  MetricHistogram(const MetricHistogram&) = delete;
+  MetricHistogram& operator=(const MetricHistogram&) = delete;
+
+  bool isEnabled() const;
+  void record(uint64_t value);
+  Snapshot getSnapshot() const;
+
+  // Bucket 0 contains 0, bucket i > 0 contains values from getBucketUpperBound(i - 1) + 1 to getBucketUpperBound(i)
+  static size_t getBucketIndex(uint64_t value);
+  static uint64_t getBucketUpperBound(size_t index);
+
+private:
+  struct Shard {
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+  };
+
+  const std::atomic<bool>& m_enabled;
+  std::unique_ptr<Shard[]> m_shards;
+};
+
+// Metrics of a process, they are created on first use and live as long as the registry.
+// Labels are given in Prometheus text format without braces, e.g. url="/getinfo"
+class MetricsRegistry {
+public:
+  MetricsRegistry();
+  MetricsRegistry(const MetricsRegistry&) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  // The registry which daemon and walletd subsystems report to
+  static MetricsRegistry& instance();
+
+  void enable();
+  bool isEnabled() const;
+
+  // Throws std::runtime_error if the name is already used by a metric of another type
+  MetricCounter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+  MetricGauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+  MetricHistogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+  // Prometheus text exposition format 0.0.4, histogram buckets are reported at powers of two
+  std::string toPrometheusText() const;
+
+private:
+  enum class MetricType { COUNTER, GAUGE, HISTOGRAM };
+
+  struct MetricFamily {
+    MetricType type;
+    std::string help;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+  };
+
+  MetricFamily& getFamily(const std::string& name, const std::string& help, MetricType type);
+
+  std::atomic<bool> m_enabled;
+  mutable std::mutex m_mutex;
+  std::map<std::string, MetricFamily> m_families;
+};
+
+// Records microseconds from construction to stop() or destruction, does nothing if the histogram is disabled or null
+class MetricTimer {
+public:
+  explicit MetricTimer(MetricHistogram& histogram);
+  explicit MetricTimer(MetricHistogram* histogram);
+  MetricTimer(const MetricTimer&) = delete;
+  MetricTimer& operator=(const MetricTimer&) = delete;
+  ~MetricTimer();
+
+  void stop();
+
+private:
+  MetricHistogram* m_histogram;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}
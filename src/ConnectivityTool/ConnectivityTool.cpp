@@ -205,6 +205,8 @@ bool handle_get_daemon_info(po::variables_map& vm) {
       << "difficulty: " << res.difficulty << ENDL
       << "tx_count: " << res.tx_count << ENDL
       << "tx_pool_size: " << res.tx_pool_size << ENDL
+      << "tx_pool_bytes: " << res.tx_pool_bytes << ENDL
+      << "tx_pool_evictions: " << res.tx_pool_evictions << ENDL
       << "alt_blocks_count: " << res.alt_blocks_count << ENDL
       << "outgoing_connections_count: " << res.outgoing_connections_count << ENDL
       << "incoming_connections_count: " << res.incoming_connections_count << ENDL
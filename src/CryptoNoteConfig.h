@@ -65,6 +65,9 @@ const uint64_t CRYPTONOTE_LOCKED_TX_ALLOWED_DELTA_SECONDS    = DIFFICULTY_TARGET
 const uint64_t CRYPTONOTE_MEMPOOL_TX_LIVETIME                = 60 * 60 * 24;     //seconds, one day
 const uint64_t CRYPTONOTE_MEMPOOL_TX_FROM_ALT_BLOCK_LIVETIME = 60 * 60 * 24 * 7; //seconds, one week
 const uint64_t CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL = 7;  // CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL * CRYPTONOTE_MEMPOOL_TX_LIVETIME = time to forget tx
+const size_t   CRYPTONOTE_MEMPOOL_MAX_TRANSACTION_COUNT      = 20000;
+const size_t   CRYPTONOTE_MEMPOOL_MAX_SIZE                   = 64 * 1024 * 1024; //bytes, transactions with the lowest fee per byte are evicted above it
+const size_t   CRYPTONOTE_MEMPOOL_CHANGE_LOG_SIZE            = 2 * CRYPTONOTE_MEMPOOL_MAX_TRANSACTION_COUNT; //pool changes kept for clients polling with a pool version
 
 const size_t   FUSION_TX_MAX_SIZE                            = CRYPTONOTE_BLOCK_GRANTED_FULL_REWARD_ZONE_CURRENT * 30 / 100;
 const size_t   FUSION_TX_MIN_INPUT_COUNT                     = 12;
@@ -82,6 +85,7 @@ const char     CRYPTONOTE_BLOCKS_FILENAME[]                  = "blocks.bin";
 const char     CRYPTONOTE_BLOCKINDEXES_FILENAME[]            = "blockindexes.bin";
 const char     CRYPTONOTE_POOLDATA_FILENAME[]                = "poolstate.bin";
 const char     P2P_NET_DATA_FILENAME[]                       = "p2pstate.bin";
+const char     CRYPTONOTE_DB_CACHE_SNAPSHOT_FILENAME[]       = "dbcache.bin";
 const char     MINER_CONFIG_FILE_NAME[]                      = "miner_conf.json";
 } // parameters
 
@@ -99,6 +103,7 @@ const uint8_t  BLOCK_MINOR_VERSION_1                         =  1;
 const size_t   BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT        =  10000;  //by default, blocks ids count in synchronizing
 const size_t   BLOCKS_SYNCHRONIZING_DEFAULT_COUNT            =  200;    //by default, blocks count in blocks downloading
 const size_t   COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT         =  1000;
+const size_t   QUERY_BLOCKS_CACHE_SIZE                       =  2 * BLOCKS_SYNCHRONIZING_DEFAULT_COUNT; //blocks kept for queryblocks and queryblockslite each
 
 const int      P2P_DEFAULT_PORT                              =  8080;
 const int      RPC_DEFAULT_PORT                              =  8081;
@@ -0,0 +1,97 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include <CryptoTypes.h>
+#include "crypto/hash.h"
+
+namespace CryptoNote {
+
+//Bounded least recently used map from block hash to information made from that block.
+//Information of a block never changes, so entries don't have to be invalidated, only evicted
+template<class Info>
+class BlockInfoCache {
+public:
+  explicit BlockInfoCache(size_t capacity) : capacity(capacity), hits(0), misses(0) {
+  }
+
+  bool get(const Crypto::Hash& blockHash, Info& info) {
+    auto it = index.find(blockHash);
+    if (it == index.end()) {
+      ++misses;
+      return false;
+    }
+
+    ++hits;
+    items.splice(items.begin(), items, it->second);
+    info = it->second->second;
+    return true;
+  }
+
+  void put(const Crypto::Hash& blockHash, const Info& info) {
+    if (capacity == 0) {
+      return;
+    }
+
+    auto it = index.find(blockHash);
+    if (it != index.end()) {
+      items.splice(items.begin(), items, it->second);
+      return;
+    }
+
+    if (items.size() == capacity) {
+      index.erase(items.back().first);
+      items.pop_back();
+    }
+
+    items.emplace_front(blockHash, info);
+    index.emplace(blockHash, items.begin());
+  }
+
+  void clear() {
+    index.clear();
+    items.clear();
+  }
+
+  size_t size() const {
+    return items.size();
+  }
+
+  uint64_t getHits() const {
+    return hits;
+  }
+
+  uint64_t getMisses() const {
+    return misses;
+  }
+
+private:
+  typedef std::list<std::pair<Crypto::Hash, Info>> Items;
+
+  const size_t capacity;
+  uint64_t hits;
+  uint64_t misses;
+  Items items;
+  std::unordered_map<Crypto::Hash, typename Items::iterator> index;
+};
+
+}
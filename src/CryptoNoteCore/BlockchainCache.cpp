@@ -658,6 +658,16 @@ bool BlockchainCache::getTransactionGlobalIndexes(const Crypto::Hash& transactio
   return true;
 }
 
+std::vector<std::vector<uint32_t>>
+BlockchainCache::getTransactionsGlobalIndexes(const std::vector<Crypto::Hash>& transactionHashes) const {
+  std::vector<std::vector<uint32_t>> globalIndexes(transactionHashes.size());
+  for (size_t i = 0; i < transactionHashes.size(); ++i) {
+    getTransactionGlobalIndexes(transactionHashes[i], globalIndexes[i]);
+  }
+
+  return globalIndexes;
+}
+
 size_t BlockchainCache::getTransactionCount() const {
   size_t count = 0;
 
@@ -673,6 +683,16 @@ RawBlock BlockchainCache::getBlockByIndex(uint32_t index) const {
   return index < startIndex ? parent->getBlockByIndex(index) : storage->getBlockByIndex(index - startIndex);
 }
 
+std::vector<RawBlock> BlockchainCache::getBlocksByIndexes(const std::vector<uint32_t>& blockIndexes) const {
+  std::vector<RawBlock> blocks;
+  blocks.reserve(blockIndexes.size());
+  for (uint32_t index : blockIndexes) {
+    blocks.push_back(getBlockByIndex(index));
+  }
+
+  return blocks;
+}
+
 BinaryArray BlockchainCache::getRawTransaction(uint32_t index, uint32_t transactionIndex) const {
   if (index < startIndex) {
     return parent->getRawTransaction(index, transactionIndex);
@@ -996,6 +1016,50 @@ std::vector<Crypto::Hash> BlockchainCache::getBlockHashesByTimestamps(uint64_t t
   return blockHashes;
 }
 
+bool BlockchainCache::findTransactionSpendingKeyImage(const Crypto::KeyImage& keyImage, Crypto::Hash& transactionHash) const {
+  auto& keyImagesIndex = spentKeyImages.get<KeyImageTag>();
+  auto keyImageIt = keyImagesIndex.find(keyImage);
+  if (keyImageIt == keyImagesIndex.end()) {
+    return parent != nullptr && parent->findTransactionSpendingKeyImage(keyImage, transactionHash);
+  }
+
+  // segments are small, so the spending transaction is looked up among the transactions of the block
+  auto range = transactions.get<BlockIndexTag>().equal_range(keyImageIt->blockIndex);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto transaction = fromBinaryArray<Transaction>(getRawTransaction(it->blockIndex, it->transactionIndex));
+    for (const auto& input : transaction.inputs) {
+      if (input.type() == typeid(KeyInput) && boost::get<KeyInput>(input).keyImage == keyImage) {
+        transactionHash = it->transactionHash;
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool BlockchainCache::findTransactionByOutputKey(const Crypto::PublicKey& outputKey, Crypto::Hash& transactionHash, uint16_t& outputIndex) const {
+  for (const auto& transaction : transactions) {
+    for (size_t i = 0; i < transaction.outputs.size(); ++i) {
+      if (transaction.outputs[i].type() == typeid(KeyOutput) && boost::get<KeyOutput>(transaction.outputs[i]).key == outputKey) {
+        transactionHash = transaction.transactionHash;
+        outputIndex = static_cast<uint16_t>(i);
+        return true;
+      }
+    }
+  }
+
+  return parent != nullptr && parent->findTransactionByOutputKey(outputKey, transactionHash, outputIndex);
+}
+
+ExplorerIndexesStatus BlockchainCache::getExplorerIndexesStatus() const {
+  return parent != nullptr ? parent->getExplorerIndexesStatus() : ExplorerIndexesStatus::DISABLED;
+}
+
+bool BlockchainCache::buildExplorerIndexes(uint32_t blockCount) {
+  return false;
+}
+
 ExtractOutputKeysResult BlockchainCache::extractKeyOtputIndexes(uint64_t amount,
                                                                 Common::ArrayView<uint32_t> globalIndexes,
                                                                 std::vector<PackedOutIndex>& outIndexes) const {
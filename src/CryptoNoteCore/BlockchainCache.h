@@ -180,6 +180,7 @@ public:
 
   virtual uint32_t getTimestampLowerBoundBlockIndex(uint64_t timestamp) const override;
   virtual bool getTransactionGlobalIndexes(const Crypto::Hash& transactionHash, std::vector<uint32_t>& globalIndexes) const override;
+  virtual std::vector<std::vector<uint32_t>> getTransactionsGlobalIndexes(const std::vector<Crypto::Hash>& transactionHashes) const override;
   virtual size_t getTransactionCount() const override;
   virtual void addSpentMultisignature(uint64_t amount, uint32_t globalIndex, uint32_t blockIndex) override;
   virtual uint32_t getBlockIndexContainingTx(const Crypto::Hash& transactionHash) const override;
@@ -198,6 +199,7 @@ public:
     std::vector<BinaryArray> &foundTransactions,
     std::vector<Crypto::Hash> &missedTransactions) const override;
   virtual RawBlock getBlockByIndex(uint32_t index) const override;
+  virtual std::vector<RawBlock> getBlocksByIndexes(const std::vector<uint32_t>& blockIndexes) const override;
   virtual BinaryArray getRawTransaction(uint32_t blockIndex, uint32_t transactionIndex) const override;
   virtual std::vector<Crypto::Hash> getTransactionHashes() const override;
   virtual std::vector<uint32_t> getRandomOutsByAmount(uint64_t amount, size_t count, uint32_t blockIndex) const override;
@@ -208,6 +210,11 @@ public:
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const override;
 
+  virtual bool findTransactionSpendingKeyImage(const Crypto::KeyImage& keyImage, Crypto::Hash& transactionHash) const override;
+  virtual bool findTransactionByOutputKey(const Crypto::PublicKey& outputKey, Crypto::Hash& transactionHash, uint16_t& outputIndex) const override;
+  virtual ExplorerIndexesStatus getExplorerIndexesStatus() const override;
+  virtual bool buildExplorerIndexes(uint32_t blockCount) override;
+
 private:
 
   struct BlockIndexTag {};
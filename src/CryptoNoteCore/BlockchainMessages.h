@@ -50,7 +50,8 @@ struct DeleteTransaction {
   enum class Reason {
     InBlock,
     Outdated,
-    NotActual
+    NotActual,
+    Evicted
   } reason;
 };
 }
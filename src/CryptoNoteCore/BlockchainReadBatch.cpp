@@ -152,12 +152,28 @@ BlockchainReadBatch& BlockchainReadBatch::requestKeyOutputInfo(IBlockchainCache:
   return *this;
 }
 
+BlockchainReadBatch& BlockchainReadBatch::requestSpendingTransaction(const Crypto::KeyImage& keyImage) {
+  state.spendingTransactionsByKeyImages.emplace(keyImage, NULL_HASH);
+  return *this;
+}
+
+BlockchainReadBatch& BlockchainReadBatch::requestOutputKeyReference(const Crypto::PublicKey& outputKey) {
+  state.outputKeyReferences.emplace(outputKey, OutputKeyReference{});
+  return *this;
+}
+
+BlockchainReadBatch& BlockchainReadBatch::requestExplorerIndexesState() {
+  state.explorerIndexesState.second = true;
+  return *this;
+}
+
 BlockchainReadResult BlockchainReadBatch::extractResult() {
   assert(resultSubmitted);
   auto st = std::move(state);
   state.lastBlockIndex = {0, false};
   state.keyOutputAmountsCount = {{}, false};
   state.multisignatureOutputAmountsCount = {{}, false};
+  state.explorerIndexesState = {{}, false};
 
   resultSubmitted = false;
   return BlockchainReadResult(st);
@@ -187,6 +203,8 @@ std::vector<std::string> BlockchainReadBatch::getRawKeys() const {
   DB::serializeKeys(rawKeys, DB::PAYMENT_ID_TO_TX_HASH_PREFIX, state.transactionHashesByPaymentIds);
   DB::serializeKeys(rawKeys, DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX, state.blockHashesByTimestamp);
   DB::serializeKeys(rawKeys, DB::KEY_OUTPUT_KEY_PREFIX, state.keyOutputKeys);
+  DB::serializeKeys(rawKeys, DB::KEY_IMAGE_TO_SPENDING_TX_HASH_PREFIX, state.spendingTransactionsByKeyImages);
+  DB::serializeKeys(rawKeys, DB::OUTPUT_KEY_TO_TX_HASH_PREFIX, state.outputKeyReferences);
 
   if (state.lastBlockIndex.second) {
     rawKeys.emplace_back(DB::serializeKey(DB::BLOCK_INDEX_TO_BLOCK_HASH_PREFIX, DB::LAST_BLOCK_INDEX_KEY));
@@ -204,6 +222,10 @@ std::vector<std::string> BlockchainReadBatch::getRawKeys() const {
     rawKeys.emplace_back(DB::serializeKey(DB::TRANSACTION_HASH_TO_TRANSACTION_INFO_PREFIX, DB::TRANSACTIONS_COUNT_KEY));
   }
 
+  if (state.explorerIndexesState.second) {
+    rawKeys.emplace_back(DB::serializeKey(DB::EXPLORER_INDEXES_STATE_PREFIX, DB::EXPLORER_INDEXES_STATE_KEY));
+  }
+
   assert(!rawKeys.empty());
   return rawKeys;
 }
@@ -312,6 +334,18 @@ const KeyOutputKeyResult& BlockchainReadResult::getKeyOutputInfo() const {
   return state.keyOutputKeys;
 }
 
+const std::unordered_map<Crypto::KeyImage, Crypto::Hash>& BlockchainReadResult::getSpendingTransactionsByKeyImages() const {
+  return state.spendingTransactionsByKeyImages;
+}
+
+const std::unordered_map<Crypto::PublicKey, OutputKeyReference>& BlockchainReadResult::getOutputKeyReferences() const {
+  return state.outputKeyReferences;
+}
+
+const std::pair<ExplorerIndexesState, bool>& BlockchainReadResult::getExplorerIndexesState() const {
+  return state.explorerIndexesState;
+}
+
 void BlockchainReadBatch::submitRawResult(const std::vector<std::string>& values, const std::vector<bool>& resultStates) {
   assert(state.size() == values.size());
   assert(values.size() == resultStates.size());
@@ -338,11 +372,14 @@ void BlockchainReadBatch::submitRawResult(const std::vector<std::string>& values
   DB::deserializeValues(state.transactionHashesByPaymentIds, iter, DB::PAYMENT_ID_TO_TX_HASH_PREFIX);
   DB::deserializeValues(state.blockHashesByTimestamp, iter, DB::TIMESTAMP_TO_BLOCKHASHES_PREFIX);
   DB::deserializeValues(state.keyOutputKeys, iter, DB::KEY_OUTPUT_KEY_PREFIX);
+  DB::deserializeValues(state.spendingTransactionsByKeyImages, iter, DB::KEY_IMAGE_TO_SPENDING_TX_HASH_PREFIX);
+  DB::deserializeValues(state.outputKeyReferences, iter, DB::OUTPUT_KEY_TO_TX_HASH_PREFIX);
 
   DB::deserializeValue(state.lastBlockIndex, iter, DB::BLOCK_INDEX_TO_BLOCK_HASH_PREFIX);
   DB::deserializeValue(state.keyOutputAmountsCount, iter, DB::KEY_OUTPUT_AMOUNTS_COUNT_PREFIX);
   DB::deserializeValue(state.multisignatureOutputAmountsCount, iter, DB::MULTISIGNATURE_OUTPUT_AMOUNTS_COUNT_PREFIX);
   DB::deserializeValue(state.transactionsCount, iter, DB::TRANSACTION_HASH_TO_TRANSACTION_INFO_PREFIX);
+  DB::deserializeValue(state.explorerIndexesState, iter, DB::EXPLORER_INDEXES_STATE_PREFIX);
 
   assert(iter == range.end());
   
@@ -365,6 +402,8 @@ multisignatureOutputsSpendingStatuses(std::move(state.multisignatureOutputsSpend
 rawBlocks(std::move(state.rawBlocks)),
 blockHashesByTimestamp(std::move(state.blockHashesByTimestamp)),
 keyOutputKeys(std::move(state.keyOutputKeys)),
+spendingTransactionsByKeyImages(std::move(state.spendingTransactionsByKeyImages)),
+outputKeyReferences(std::move(state.outputKeyReferences)),
 closestTimestampBlockIndex(std::move(state.closestTimestampBlockIndex)),
 lastBlockIndex(std::move(state.lastBlockIndex)),
 keyOutputAmountsCount(std::move(state.keyOutputAmountsCount)),
@@ -373,7 +412,8 @@ keyOutputAmounts(std::move(state.keyOutputAmounts)),
 multisignatureOutputAmounts(std::move(state.multisignatureOutputAmounts)),
 transactionCountsByPaymentIds(std::move(state.transactionCountsByPaymentIds)),
 transactionHashesByPaymentIds(std::move(state.transactionHashesByPaymentIds)),
-transactionsCount(std::move(state.transactionsCount)) {
+transactionsCount(std::move(state.transactionsCount)),
+explorerIndexesState(std::move(state.explorerIndexesState)) {
 }
 
 size_t BlockchainReadState::size() const {
@@ -397,10 +437,13 @@ size_t BlockchainReadState::size() const {
     transactionHashesByPaymentIds.size() +
     blockHashesByTimestamp.size() +
     keyOutputKeys.size() +
+    spendingTransactionsByKeyImages.size() +
+    outputKeyReferences.size() +
     (lastBlockIndex.second ? 1 : 0) +
     (keyOutputAmountsCount.second ? 1 : 0) +
     (multisignatureOutputAmountsCount.second ? 1 : 0) +
-    (transactionsCount.second ? 1 : 0);
+    (transactionsCount.second ? 1 : 0) +
+    (explorerIndexesState.second ? 1 : 0);
 }
 
 BlockchainReadResult::BlockchainReadResult(BlockchainReadResult&& result) : state(std::move(result.state)) {
@@ -73,11 +73,14 @@ struct BlockchainReadState {
   std::unordered_map<std::pair<Crypto::Hash, uint32_t>, Crypto::Hash> transactionHashesByPaymentIds;
   std::unordered_map<uint64_t, std::vector<Crypto::Hash>> blockHashesByTimestamp;
   KeyOutputKeyResult keyOutputKeys;
+  std::unordered_map<Crypto::KeyImage, Crypto::Hash> spendingTransactionsByKeyImages;
+  std::unordered_map<Crypto::PublicKey, OutputKeyReference> outputKeyReferences;
 
   std::pair<uint32_t, bool> lastBlockIndex = { 0, false };
   std::pair<uint32_t, bool> keyOutputAmountsCount = { {}, false };
   std::pair<uint32_t, bool> multisignatureOutputAmountsCount = { {}, false };
   std::pair<uint64_t, bool> transactionsCount = { 0, false };
+  std::pair<ExplorerIndexesState, bool> explorerIndexesState = { {}, false };
 
   BlockchainReadState() = default;
   BlockchainReadState(const BlockchainReadState&) = default;
@@ -117,6 +120,9 @@ public:
   const std::unordered_map<uint64_t, std::vector<Crypto::Hash> >& getBlockHashesByTimestamp() const;
   const std::pair<uint64_t, bool>& getTransactionsCount() const;
   const KeyOutputKeyResult& getKeyOutputInfo() const;
+  const std::unordered_map<Crypto::KeyImage, Crypto::Hash>& getSpendingTransactionsByKeyImages() const;
+  const std::unordered_map<Crypto::PublicKey, OutputKeyReference>& getOutputKeyReferences() const;
+  const std::pair<ExplorerIndexesState, bool>& getExplorerIndexesState() const;
 
 private:
   BlockchainReadState state;
@@ -151,6 +157,9 @@ public:
   BlockchainReadBatch& requestBlockHashesByTimestamp(uint64_t timestamp);
   BlockchainReadBatch& requestTransactionsCount();
   BlockchainReadBatch& requestKeyOutputInfo(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex);
+  BlockchainReadBatch& requestSpendingTransaction(const Crypto::KeyImage& keyImage);
+  BlockchainReadBatch& requestOutputKeyReference(const Crypto::PublicKey& outputKey);
+  BlockchainReadBatch& requestExplorerIndexesState();
 
   std::vector<std::string> getRawKeys() const override;
   void submitRawResult(const std::vector<std::string>& values, const std::vector<bool>& resultStates) override;
@@ -143,6 +143,21 @@ BlockchainWriteBatch& BlockchainWriteBatch::insertKeyOutputInfo(IBlockchainCache
   return *this;
 }
 
+BlockchainWriteBatch& BlockchainWriteBatch::insertSpendingTransaction(const Crypto::KeyImage& keyImage, const Crypto::Hash& transactionHash) {
+  rawDataToInsert.emplace_back(DB::serialize(DB::KEY_IMAGE_TO_SPENDING_TX_HASH_PREFIX, keyImage, transactionHash));
+  return *this;
+}
+
+BlockchainWriteBatch& BlockchainWriteBatch::insertOutputKeyReference(const Crypto::PublicKey& outputKey, const OutputKeyReference& reference) {
+  rawDataToInsert.emplace_back(DB::serialize(DB::OUTPUT_KEY_TO_TX_HASH_PREFIX, outputKey, reference));
+  return *this;
+}
+
+BlockchainWriteBatch& BlockchainWriteBatch::insertExplorerIndexesState(const ExplorerIndexesState& state) {
+  rawDataToInsert.emplace_back(DB::serialize(DB::EXPLORER_INDEXES_STATE_PREFIX, DB::EXPLORER_INDEXES_STATE_KEY, state));
+  return *this;
+}
+
 BlockchainWriteBatch& BlockchainWriteBatch::removeSpentKeyImages(uint32_t blockIndex, const std::vector<Crypto::KeyImage>& spentKeyImages) {
   rawKeysToRemove.reserve(rawKeysToRemove.size() + spentKeyImages.size() + 1);
   rawKeysToRemove.emplace_back(DB::serializeKey(DB::BLOCK_INDEX_TO_KEY_IMAGE_PREFIX, blockIndex));
@@ -241,6 +256,21 @@ BlockchainWriteBatch&BlockchainWriteBatch::removeKeyOutputInfo(IBlockchainCache:
   return *this;
 }
 
+BlockchainWriteBatch& BlockchainWriteBatch::removeSpendingTransaction(const Crypto::KeyImage& keyImage) {
+  rawKeysToRemove.emplace_back(DB::serializeKey(DB::KEY_IMAGE_TO_SPENDING_TX_HASH_PREFIX, keyImage));
+  return *this;
+}
+
+BlockchainWriteBatch& BlockchainWriteBatch::removeOutputKeyReference(const Crypto::PublicKey& outputKey) {
+  rawKeysToRemove.emplace_back(DB::serializeKey(DB::OUTPUT_KEY_TO_TX_HASH_PREFIX, outputKey));
+  return *this;
+}
+
+BlockchainWriteBatch& BlockchainWriteBatch::removeExplorerIndexesState() {
+  rawKeysToRemove.emplace_back(DB::serializeKey(DB::EXPLORER_INDEXES_STATE_PREFIX, DB::EXPLORER_INDEXES_STATE_KEY));
+  return *this;
+}
+
 std::vector<std::pair<std::string, std::string>> BlockchainWriteBatch::extractRawDataToInsert() {
   return std::move(rawDataToInsert);
 }
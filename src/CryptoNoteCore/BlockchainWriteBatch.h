@@ -43,6 +43,9 @@ public:
   BlockchainWriteBatch& insertMultisignatureOutputAmounts(const std::set<IBlockchainCache::Amount>& amounts, uint32_t totalMultisignatureOutputAmountsCount);
   BlockchainWriteBatch& insertTimestamp(uint64_t timestamp, const std::vector<Crypto::Hash>& blockHashes);
   BlockchainWriteBatch& insertKeyOutputInfo(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex, const KeyOutputInfo& outputInfo);
+  BlockchainWriteBatch& insertSpendingTransaction(const Crypto::KeyImage& keyImage, const Crypto::Hash& transactionHash);
+  BlockchainWriteBatch& insertOutputKeyReference(const Crypto::PublicKey& outputKey, const OutputKeyReference& reference);
+  BlockchainWriteBatch& insertExplorerIndexesState(const ExplorerIndexesState& state);
 
   BlockchainWriteBatch& removeSpentKeyImages(uint32_t blockIndex, const std::vector<Crypto::KeyImage>& spentKeyImages);
   BlockchainWriteBatch& removeCachedTransaction(const Crypto::Hash& transactionHash, uint64_t totalTxsCount);
@@ -57,6 +60,9 @@ public:
   BlockchainWriteBatch& removeKeyOutputAmounts(uint32_t keyOutputAmountsToRemoveCount, uint32_t totalKeyOutputAmountsCount);
   BlockchainWriteBatch& removeMultisignatureOutputAmounts(uint32_t multisignatureOutputAmountsToRemoveCount, uint32_t totalMultisignatureOutputAmountsCount);
   BlockchainWriteBatch& removeKeyOutputInfo(IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex globalIndex);
+  BlockchainWriteBatch& removeSpendingTransaction(const Crypto::KeyImage& keyImage);
+  BlockchainWriteBatch& removeOutputKeyReference(const Crypto::PublicKey& outputKey);
+  BlockchainWriteBatch& removeExplorerIndexesState();
 
   std::vector<std::pair<std::string, std::string>> extractRawDataToInsert() override;
   std::vector<std::string> extractRawKeysToRemove() override;
@@ -0,0 +1,114 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "Serialization/ISerializer.h"
+
+namespace CryptoNote {
+
+//Set of 32-byte values (hashes, key images) answering "definitely not present" without false negatives.
+//Values are uniformly distributed already, so probe positions are taken from their own bytes.
+//Nothing is ever removed: a removed value stays a false positive until the filter is rebuilt
+class BloomFilter {
+public:
+  static const size_t BITS_PER_VALUE = 16;
+  static const size_t PROBE_COUNT = 8;
+
+  explicit BloomFilter(size_t capacity) :
+    valuesCapacity(std::max<size_t>(capacity, 1)),
+    valuesCount(0),
+    bits((valuesCapacity * BITS_PER_VALUE + 63) / 64, 0) {
+  }
+
+  template<class Value> void insert(const Value& value) {
+    static_assert(sizeof(value.data) == 32, "BloomFilter supports 32-byte values only");
+    uint64_t first, second;
+    getProbes(value.data, first, second);
+    for (size_t i = 0; i < PROBE_COUNT; ++i) {
+      uint64_t bit = (first + i * second) % (bits.size() * 64);
+      bits[bit / 64] |= UINT64_C(1) << (bit % 64);
+    }
+
+    ++valuesCount;
+  }
+
+  template<class Value> bool mayContain(const Value& value) const {
+    static_assert(sizeof(value.data) == 32, "BloomFilter supports 32-byte values only");
+    uint64_t first, second;
+    getProbes(value.data, first, second);
+    for (size_t i = 0; i < PROBE_COUNT; ++i) {
+      uint64_t bit = (first + i * second) % (bits.size() * 64);
+      if ((bits[bit / 64] & (UINT64_C(1) << (bit % 64))) == 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  //False positive rate grows quickly past capacity, owner should rebuild a bigger filter then
+  bool isFull() const {
+    return valuesCount >= valuesCapacity;
+  }
+
+  size_t capacity() const {
+    return valuesCapacity;
+  }
+
+  //Bits are stored as is, so the result is readable on machines with the same byte order only
+  void serialize(ISerializer& s) {
+    uint64_t capacity = valuesCapacity;
+    uint64_t count = valuesCount;
+    s(capacity, "capacity");
+    s(count, "count");
+
+    if (s.type() == ISerializer::INPUT) {
+      if (capacity == 0 || capacity > MAX_CAPACITY) {
+        throw std::runtime_error("Invalid bloom filter capacity");
+      }
+
+      valuesCapacity = static_cast<size_t>(capacity);
+      valuesCount = static_cast<size_t>(count);
+      bits.assign((valuesCapacity * BITS_PER_VALUE + 63) / 64, 0);
+    }
+
+    s.binary(bits.data(), bits.size() * sizeof(uint64_t), "bits");
+  }
+
+private:
+  static const uint64_t MAX_CAPACITY = UINT64_C(1) << 32;
+
+  static void getProbes(const uint8_t* data, uint64_t& first, uint64_t& second) {
+    memcpy(&first, data, sizeof(first));
+    memcpy(&second, data + sizeof(first), sizeof(second));
+    //odd step visits distinct positions for power of two sizes and is never zero
+    second |= 1;
+  }
+
+  size_t valuesCapacity;
+  size_t valuesCount;
+  std::vector<uint64_t> bits;
+};
+
+}
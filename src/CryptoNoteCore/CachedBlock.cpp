@@ -59,17 +59,9 @@ const Crypto::Hash& CachedBlock::getBlockHash() const {
 
 const Crypto::Hash& CachedBlock::getBlockLongHash(cn_context& cryptoContext) const {
   if (!blockLongHash.is_initialized()) {
-    if (block.majorVersion == BLOCK_MAJOR_VERSION_1) {
-      const auto& rawHashingBlock = getBlockHashingBinaryArray();
-      blockLongHash = Hash();
-      cn_slow_hash(cryptoContext, rawHashingBlock.data(), rawHashingBlock.size(), blockLongHash.get());
-    } else if (block.majorVersion >= BLOCK_MAJOR_VERSION_2) {
-      const auto& rawHashingBlock = getParentBlockHashingBinaryArray(true);
-      blockLongHash = Hash();
-      cn_slow_hash(cryptoContext, rawHashingBlock.data(), rawHashingBlock.size(), blockLongHash.get());
-    } else {
-      throw std::runtime_error("Unknown block major version.");
-    }
+    const auto& rawHashingBlock = getBlockLongHashingBinaryArray();
+    blockLongHash = Hash();
+    cn_slow_hash(cryptoContext, rawHashingBlock.data(), rawHashingBlock.size(), blockLongHash.get());
   }
 
   return blockLongHash.get();
@@ -101,6 +93,16 @@ const BinaryArray& CachedBlock::getBlockHashingBinaryArray() const {
   return blockHashingBinaryArray.get();
 }
 
+const BinaryArray& CachedBlock::getBlockLongHashingBinaryArray() const {
+  if (block.majorVersion == BLOCK_MAJOR_VERSION_1) {
+    return getBlockHashingBinaryArray();
+  } else if (block.majorVersion >= BLOCK_MAJOR_VERSION_2) {
+    return getParentBlockHashingBinaryArray(true);
+  } else {
+    throw std::runtime_error("Unknown block major version.");
+  }
+}
+
 const BinaryArray& CachedBlock::getParentBlockBinaryArray(bool headerOnly) const {
   if (headerOnly) {
     if (!parentBlockBinaryArrayHeaderOnly.is_initialized()) {
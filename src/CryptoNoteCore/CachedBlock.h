@@ -37,6 +37,7 @@ public:
   const Crypto::Hash& getBlockLongHash(Crypto::cn_context& cryptoContext) const;
   const Crypto::Hash& getAuxiliaryBlockHeaderHash() const;
   const BinaryArray& getBlockHashingBinaryArray() const;
+  const BinaryArray& getBlockLongHashingBinaryArray() const;
   const BinaryArray& getParentBlockBinaryArray(bool headerOnly) const;
   const BinaryArray& getParentBlockHashingBinaryArray(bool headerOnly) const;
   uint32_t getBlockIndex() const;
@@ -49,7 +49,19 @@ const Crypto::Hash& CachedTransaction::getTransactionHash() const {
 
 const Crypto::Hash& CachedTransaction::getTransactionPrefixHash() const {
   if (!transactionPrefixHash.is_initialized()) {
-    transactionPrefixHash = getObjectHash(static_cast<const TransactionPrefix&>(transaction));
+    if (transactionBinaryArray.is_initialized()) {
+      // signatures are serialized after the prefix as plain POD array, so prefix is the head of the blob
+      size_t signaturesSize = 0;
+      for (const auto& inputSignatures : transaction.signatures) {
+        signaturesSize += inputSignatures.size() * sizeof(Crypto::Signature);
+      }
+
+      const auto& binaryArray = transactionBinaryArray.get();
+      assert(signaturesSize <= binaryArray.size());
+      transactionPrefixHash = Crypto::cn_fast_hash(binaryArray.data(), binaryArray.size() - signaturesSize);
+    } else {
+      transactionPrefixHash = getObjectHash(static_cast<const TransactionPrefix&>(transaction));
+    }
   }
 
   return transactionPrefixHash.get();
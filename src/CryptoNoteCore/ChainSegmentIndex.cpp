@@ -0,0 +1,127 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ChainSegmentIndex.h"
+
+#include <cassert>
+#include <stdexcept>
+
+#include "CryptoNoteTools.h"
+
+namespace CryptoNote {
+
+namespace {
+
+bool isIndexed(const IBlockchainCache* segment) {
+  return segment->getParent() != nullptr;
+}
+
+}
+
+void ChainSegmentIndex::addBlock(IBlockchainCache* segment, const Crypto::Hash& blockHash, const BlockTemplate& block) {
+  if (!isIndexed(segment)) {
+    return;
+  }
+
+  blockSegments[blockHash] = segment;
+  transactionSegments.emplace(getObjectHash(block.baseTransaction), segment);
+  for (const auto& transactionHash : block.transactionHashes) {
+    transactionSegments.emplace(transactionHash, segment);
+  }
+}
+
+void ChainSegmentIndex::moveSplitBlocks(IBlockchainCache* lowerSegment, IBlockchainCache* upperSegment) {
+  assert(isIndexed(upperSegment));
+
+  forEachBlock(upperSegment, [&](const Crypto::Hash& blockHash, const BlockTemplate& block) {
+    blockSegments[blockHash] = upperSegment;
+    moveTransaction(getObjectHash(block.baseTransaction), lowerSegment, upperSegment);
+    for (const auto& transactionHash : block.transactionHashes) {
+      moveTransaction(transactionHash, lowerSegment, upperSegment);
+    }
+  });
+}
+
+void ChainSegmentIndex::removeSegment(IBlockchainCache* segment) {
+  if (!isIndexed(segment)) {
+    return;
+  }
+
+  forEachBlock(segment, [&](const Crypto::Hash& blockHash, const BlockTemplate& block) {
+    auto it = blockSegments.find(blockHash);
+    if (it != blockSegments.end() && it->second == segment) {
+      blockSegments.erase(it);
+    }
+
+    removeTransaction(getObjectHash(block.baseTransaction), segment);
+    for (const auto& transactionHash : block.transactionHashes) {
+      removeTransaction(transactionHash, segment);
+    }
+  });
+}
+
+void ChainSegmentIndex::clear() {
+  blockSegments.clear();
+  transactionSegments.clear();
+}
+
+IBlockchainCache* ChainSegmentIndex::findBlock(const Crypto::Hash& blockHash) const {
+  auto it = blockSegments.find(blockHash);
+  return it != blockSegments.end() ? it->second : nullptr;
+}
+
+template<class Visitor> void ChainSegmentIndex::forEachBlock(IBlockchainCache* segment, Visitor visitor) {
+  if (segment->getBlockCount() == 0) {
+    return;
+  }
+
+  auto startIndex = segment->getStartBlockIndex();
+  auto blockHashes = segment->getBlockHashes(startIndex, segment->getBlockCount());
+  for (uint32_t i = 0; i < blockHashes.size(); ++i) {
+    BlockTemplate block;
+    if (!fromBinaryArray(block, segment->getBlockByIndex(startIndex + i).block)) {
+      throw std::runtime_error("Couldn't deserialize BlockTemplate");
+    }
+
+    visitor(blockHashes[i], block);
+  }
+}
+
+void ChainSegmentIndex::moveTransaction(const Crypto::Hash& transactionHash, IBlockchainCache* from, IBlockchainCache* to) {
+  auto range = transactionSegments.equal_range(transactionHash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == from) {
+      it->second = to;
+      return;
+    }
+  }
+
+  // lower segment is the root one, it isn't indexed
+  transactionSegments.emplace(transactionHash, to);
+}
+
+void ChainSegmentIndex::removeTransaction(const Crypto::Hash& transactionHash, IBlockchainCache* segment) {
+  auto range = transactionSegments.equal_range(transactionHash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == segment) {
+      transactionSegments.erase(it);
+      return;
+    }
+  }
+}
+
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <unordered_map>
+
+#include "CryptoNote.h"
+#include "IBlockchainCache.h"
+
+namespace CryptoNote {
+
+/*
+ * Maps block and transaction hashes to the segment containing them, so that Core doesn't walk
+ * the segment tree calling hasBlock/hasTransaction on every segment.
+ * Only in-memory segments are indexed. The root segment (the one without parent) is backed by
+ * the database, lookups that miss the index fall back to it.
+ * Transactions may be contained in several segments (same transaction in main and alternative chains),
+ * blocks are contained in exactly one.
+ */
+class ChainSegmentIndex {
+public:
+  // Call after the block was pushed to segment
+  void addBlock(IBlockchainCache* segment, const Crypto::Hash& blockHash, const BlockTemplate& block);
+  // Call after upperSegment was split from lowerSegment: everything upperSegment holds used to belong to lowerSegment
+  void moveSplitBlocks(IBlockchainCache* lowerSegment, IBlockchainCache* upperSegment);
+  // Call before segment is destroyed
+  void removeSegment(IBlockchainCache* segment);
+  void clear();
+
+  IBlockchainCache* findBlock(const Crypto::Hash& blockHash) const;
+
+  // Returns first indexed segment containing the transaction and satisfying pred, nullptr if none
+  template<class Predicate>
+  IBlockchainCache* findTransaction(const Crypto::Hash& transactionHash, Predicate pred) const {
+    auto range = transactionSegments.equal_range(transactionHash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (pred(it->second)) {
+        return it->second;
+      }
+    }
+
+    return nullptr;
+  }
+
+private:
+  template<class Visitor> static void forEachBlock(IBlockchainCache* segment, Visitor visitor);
+  void moveTransaction(const Crypto::Hash& transactionHash, IBlockchainCache* from, IBlockchainCache* to);
+  void removeTransaction(const Crypto::Hash& transactionHash, IBlockchainCache* segment);
+
+  std::unordered_map<Crypto::Hash, IBlockchainCache*> blockSegments;
+  std::unordered_multimap<Crypto::Hash, IBlockchainCache*> transactionSegments;
+};
+
+}
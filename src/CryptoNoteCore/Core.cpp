@@ -16,14 +16,17 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <chrono>
 #include <numeric>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "Core.h"
 #include "Common/ShuffleGenerator.h"
 #include "Common/Math.h"
 #include "Common/MemoryInputStream.h"
+#include "Common/Metrics.h"
 #include "CryptoNoteTools.h"
 #include "CryptoNoteFormatUtils.h"
 #include "BlockchainCache.h"
@@ -56,6 +59,18 @@ std::vector<T> preallocateVector(size_t elements) {
 }
 UseGenesis addGenesisBlock = UseGenesis(true);
 
+Common::MetricHistogram& addBlockDuration() {
+  static Common::MetricHistogram& histogram = Common::MetricsRegistry::instance().histogram(
+    "core_add_block_duration_microseconds", "Time of block validation and insertion");
+  return histogram;
+}
+
+Common::MetricHistogram& transactionValidationDuration() {
+  static Common::MetricHistogram& histogram = Common::MetricsRegistry::instance().histogram(
+    "core_transaction_validation_duration_microseconds", "Time of transaction validation, ring signatures of block transactions are checked with the block");
+  return histogram;
+}
+
 class TransactionSpentInputsChecker {
 public:
   bool haveSpentInputs(const Transaction& transaction) {
@@ -199,6 +214,8 @@ uint32_t findCommonRoot(IMainChainStorage& storage, IBlockchainCache& rootSegmen
 }
 
 const std::chrono::seconds OUTDATED_TRANSACTION_POLLING_INTERVAL = std::chrono::seconds(60);
+const std::chrono::milliseconds EXPLORER_INDEXES_BUILDING_INTERVAL = std::chrono::milliseconds(10);
+const uint32_t EXPLORER_INDEXES_BLOCKS_PER_STEP = 100;
 
 }
 
@@ -206,13 +223,15 @@ Core::Core(const Currency& currency, Logging::ILogger& logger, Checkpoints&& che
            std::unique_ptr<IBlockchainCacheFactory>&& blockchainCacheFactory, std::unique_ptr<IMainChainStorage>&& mainchainStorage)
     : currency(currency), dispatcher(dispatcher), contextGroup(dispatcher), logger(logger, "Core"), checkpoints(std::move(checkpoints)),
       upgradeManager(new UpgradeManager()), blockchainCacheFactory(std::move(blockchainCacheFactory)),
-      mainChainStorage(std::move(mainchainStorage)), initialized(false) {
+      mainChainStorage(std::move(mainchainStorage)), initialized(false), blockTemplateBuildTime(0), blockTemplateChanged(dispatcher),
+      blockFullInfoCache(QUERY_BLOCKS_CACHE_SIZE), blockShortInfoCache(QUERY_BLOCKS_CACHE_SIZE) {
+  blockTemplateCache.valid = false;
 
   upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_2, currency.upgradeHeight(BLOCK_MAJOR_VERSION_2));
   upgradeManager->addMajorBlockVersion(BLOCK_MAJOR_VERSION_3, currency.upgradeHeight(BLOCK_MAJOR_VERSION_3));
 
   transactionPool = std::unique_ptr<ITransactionPoolCleanWrapper>(new TransactionPoolCleanWrapper(
-    std::unique_ptr<ITransactionPool>(new TransactionPool(logger)),
+    std::unique_ptr<ITransactionPool>(new TransactionPool(logger, currency.mempoolMaxTransactionCount(), currency.mempoolMaxSize())),
     std::unique_ptr<ITimeProvider>(new RealTimeProvider()),
     logger,
     currency.mempoolTxLiveTime()));
@@ -236,6 +255,13 @@ bool Core::notifyObservers(BlockchainMessage&& msg) /* noexcept */ {
     for (auto& queue : queueList) {
       queue.push(std::move(msg));
     }
+
+    // Every other message moves the top block or changes the pool, wake up block template long polls
+    if (msg.getType() != BlockchainMessage::Type::NewAlternativeBlock) {
+      blockTemplateChanged.set();
+      blockTemplateChanged.clear();
+    }
+
     return true;
   } catch (std::exception& e) {
     logger(Logging::WARNING) << "failed to notify observers: " << e.what();
@@ -536,6 +562,7 @@ std::vector<Crypto::Hash> Core::findBlockchainSupplement(const std::vector<Crypt
 
 std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlock) {
   throwIfNotInitialized();
+  Common::MetricTimer durationTimer(addBlockDuration());
   logger(Logging::DEBUGGING) << "Request to add block came for block " << cachedBlock.getBlockHash();
 
   if (hasBlock(cachedBlock.getBlockHash())) {
@@ -589,9 +616,10 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
   }
 
   uint64_t cumulativeFee = 0;
+  std::vector<DeferredRingSignature> deferredSignatures;
   for (const auto& transaction : transactions) {
     uint64_t fee = 0;
-    auto transactionValidationResult = validateTransaction(transaction, validatorState, cache, fee, previousBlockIndex);
+    auto transactionValidationResult = validateTransaction(transaction, validatorState, cache, fee, previousBlockIndex, &deferredSignatures);
     if (transactionValidationResult) {
       logger(Logging::DEBUGGING) << "Failed to validate transaction " << transaction.getTransactionHash() << ": " << transactionValidationResult.message();
       return transactionValidationResult;
@@ -600,6 +628,10 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
     cumulativeFee += fee;
   }
 
+  if (auto signaturesValidationResult = checkDeferredRingSignatures(deferredSignatures)) {
+    return signaturesValidationResult;
+  }
+
   uint64_t reward = 0;
   int64_t emissionChange = 0;
   auto alreadyGeneratedCoins = cache->getAlreadyGeneratedCoins(previousBlockIndex);
@@ -640,6 +672,7 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
         mainChainStorage->pushBlock(rawBlock);
 
         cache->pushBlock(cachedBlock, transactions, validatorState, cumulativeBlockSize, emissionChange, currentDifficulty, std::move(rawBlock));
+        segmentIndex.addBlock(cache, cachedBlock.getBlockHash(), blockTemplate);
 
         actualizePoolTransactions();
 
@@ -652,6 +685,7 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
         notifyObservers(makeDelTransactionMessage(std::move(hashes), Messages::DeleteTransaction::Reason::InBlock));
       } else {
         cache->pushBlock(cachedBlock, transactions, validatorState, cumulativeBlockSize, emissionChange, currentDifficulty, std::move(rawBlock));
+        segmentIndex.addBlock(cache, cachedBlock.getBlockHash(), blockTemplate);
         logger(Logging::WARNING) << "Block " << cachedBlock.getBlockHash() << " added to alternative chain. Index: " << (previousBlockIndex + 1);
 
         auto mainChainCache = chainsLeaves[0];
@@ -686,6 +720,7 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
 
       newlyForkedChainPtr->pushBlock(cachedBlock, transactions, validatorState, cumulativeBlockSize, emissionChange,
                                      currentDifficulty, std::move(rawBlock));
+      segmentIndex.addBlock(newlyForkedChainPtr, cachedBlock.getBlockHash(), blockTemplate);
 
       updateMainChainSet();
     }
@@ -699,6 +734,7 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
 
     assert(upperSegment->getBlockCount() > 0);
     assert(cache->getBlockCount() > 0);
+    segmentIndex.moveSplitBlocks(cache, upperSegment.get());
 
     if (upperSegment->getChildCount() == 0) {
       //newly created segment is leaf node
@@ -720,6 +756,7 @@ std::error_code Core::addBlock(const CachedBlock& cachedBlock, RawBlock&& rawBlo
 
     newlyForkedChainPtr->pushBlock(cachedBlock, transactions, validatorState, cumulativeBlockSize, emissionChange,
       currentDifficulty, std::move(rawBlock));
+    segmentIndex.addBlock(newlyForkedChainPtr, cachedBlock.getBlockHash(), blockTemplate);
 
     updateMainChainSet();
   }
@@ -755,6 +792,10 @@ void Core::switchMainChainStorage(uint32_t splitBlockIndex, IBlockchainCache& ne
   for (uint32_t index = splitBlockIndex; index <= newChain.getTopBlockIndex(); ++index) {
     mainChainStorage->pushBlock(newChain.getBlockByIndex(index));
   }
+
+  // cached blocks stay valid, but the popped ones are not going to be requested anymore
+  blockFullInfoCache.clear();
+  blockShortInfoCache.clear();
 }
 
 void Core::notifyOnSuccess(error::AddBlockErrorCode opResult, uint32_t previousBlockIndex,
@@ -910,8 +951,15 @@ bool Core::addTransactionToPool(CachedTransaction&& cachedTransaction) {
   }
 
   auto transactionHash = cachedTransaction.getTransactionHash();
-  if (!transactionPool->pushTransaction(std::move(cachedTransaction), std::move(validatorState))) {
-    logger(Logging::DEBUGGING) << "Failed to push transaction " << transactionHash << " to pool, already exists";
+  bool pushed = transactionPool->pushTransaction(std::move(cachedTransaction), std::move(validatorState));
+  auto evictedTransactions = transactionPool->takeEvictedTransactions();
+  if (!evictedTransactions.empty()) {
+    logger(Logging::DEBUGGING) << evictedTransactions.size() << " transactions with the lowest fee evicted from full pool";
+    notifyObservers(makeDelTransactionMessage(std::move(evictedTransactions), Messages::DeleteTransaction::Reason::Evicted));
+  }
+
+  if (!pushed) {
+    logger(Logging::DEBUGGING) << "Failed to push transaction " << transactionHash << " to pool, already exists or pool is full";
     return false;
   }
 
@@ -1000,53 +1048,51 @@ bool Core::getPoolChangesLite(const Crypto::Hash& lastBlockHash, const std::vect
   return getTopBlockHash() == lastBlockHash;
 }
 
-bool Core::getBlockTemplate(BlockTemplate& b, const AccountPublicAddress& adr, const BinaryArray& extraNonce,
-                            Difficulty& difficulty, uint32_t& height) const {
+bool Core::getPoolChangesLiteSince(const Crypto::Hash& lastBlockHash, uint64_t& poolVersion,
+                                   const std::vector<Crypto::Hash>& knownHashes,
+                                   std::vector<TransactionPrefixInfo>& addedTransactions,
+                                   std::vector<Crypto::Hash>& deletedTransactions, bool& isDelta) const {
   throwIfNotInitialized();
 
-  height = getTopBlockIndex() + 1;
-  difficulty = getDifficultyForNextBlock();
-  if (difficulty == 0) {
-    logger(Logging::ERROR, Logging::BRIGHT_RED) << "difficulty overhead.";
-    return false;
+  std::vector<Crypto::Hash> newTransactions;
+  // Zero means the client has no version yet
+  isDelta = poolVersion != 0 && transactionPool->getChangesSince(poolVersion, newTransactions, deletedTransactions);
+  if (!isDelta) {
+    getTransactionPoolDifference(knownHashes, newTransactions, deletedTransactions);
   }
 
-  b = boost::value_initialized<BlockTemplate>();
-  b.majorVersion = getBlockMajorVersionForHeight(height);
+  poolVersion = transactionPool->getGeneration();
 
-  if (b.majorVersion == BLOCK_MAJOR_VERSION_1) {
-    b.minorVersion = currency.upgradeHeight(BLOCK_MAJOR_VERSION_2) == IUpgradeDetector::UNDEF_HEIGHT ? BLOCK_MINOR_VERSION_1 : BLOCK_MINOR_VERSION_0;
-  } else if (b.majorVersion >= BLOCK_MAJOR_VERSION_2) {
-    if (currency.upgradeHeight(BLOCK_MAJOR_VERSION_3) == IUpgradeDetector::UNDEF_HEIGHT) {
-      b.minorVersion = b.majorVersion == BLOCK_MAJOR_VERSION_2 ? BLOCK_MINOR_VERSION_1 : BLOCK_MINOR_VERSION_0;
-    } else {
-      b.minorVersion = BLOCK_MINOR_VERSION_0;
-    }
+  addedTransactions.reserve(newTransactions.size());
+  for (const auto& hash : newTransactions) {
+    TransactionPrefixInfo transactionPrefixInfo;
+    transactionPrefixInfo.txHash = hash;
+    transactionPrefixInfo.txPrefix =
+        static_cast<const TransactionPrefix&>(transactionPool->getTransaction(hash).getTransaction());
+    addedTransactions.emplace_back(std::move(transactionPrefixInfo));
+  }
 
-    b.parentBlock.majorVersion = BLOCK_MAJOR_VERSION_1;
-    b.parentBlock.majorVersion = BLOCK_MINOR_VERSION_0;
-    b.parentBlock.transactionCount = 1;
+  return getTopBlockHash() == lastBlockHash;
+}
 
-    TransactionExtraMergeMiningTag mmTag = boost::value_initialized<decltype(mmTag)>();
-    if (!appendMergeMiningTagToExtra(b.parentBlock.baseTransaction.extra, mmTag)) {
-      logger(Logging::ERROR, Logging::BRIGHT_RED)
-          << "Failed to append merge mining tag to extra of the parent block miner transaction";
-      return false;
-    }
-  }
+bool Core::getBlockTemplate(BlockTemplate& b, const AccountPublicAddress& adr, const BinaryArray& extraNonce,
+                            Difficulty& difficulty, uint32_t& height) const {
+  throwIfNotInitialized();
 
-  b.previousBlockHash = getTopBlockHash();
-  b.timestamp = time(nullptr);
+  if (!updateBlockTemplateCache()) {
+    return false;
+  }
 
-  size_t medianSize = calculateCumulativeBlocksizeLimit(height) / 2;
+  height = blockTemplateCache.height;
+  difficulty = blockTemplateCache.difficulty;
 
-  assert(!chainsStorage.empty());
-  assert(!chainsLeaves.empty());
-  uint64_t alreadyGeneratedCoins = chainsLeaves[0]->getAlreadyGeneratedCoins();
+  b = blockTemplateCache.block;
+  b.timestamp = time(nullptr);
 
-  size_t transactionsSize;
-  uint64_t fee;
-  fillBlockTemplate(b, medianSize, currency.maxBlockCumulativeSize(height), transactionsSize, fee);
+  size_t medianSize = blockTemplateCache.medianSize;
+  uint64_t alreadyGeneratedCoins = blockTemplateCache.alreadyGeneratedCoins;
+  size_t transactionsSize = blockTemplateCache.transactionsSize;
+  uint64_t fee = blockTemplateCache.fee;
 
   /*
      two-phase miner transaction generation: we don't know exact block size until we prepare block, but we don't know
@@ -1121,11 +1167,28 @@ bool Core::getBlockTemplate(BlockTemplate& b, const AccountPublicAddress& adr, c
   return false;
 }
 
+uint64_t Core::getPoolGeneration() const {
+  return transactionPool->getGeneration();
+}
+
+void Core::waitForBlockTemplateChange() {
+  blockTemplateChanged.wait();
+}
+
 CoreStatistics Core::getCoreStatistics() const {
-  // TODO: implement it
-  assert(false);
+  throwIfNotInitialized();
+
   CoreStatistics result;
-  std::fill(reinterpret_cast<uint8_t*>(&result), reinterpret_cast<uint8_t*>(&result) + sizeof(result), 0);
+  result.transactionPoolSize = transactionPool->getTransactionCount();
+  result.blockchainHeight = getTopBlockIndex() + 1;
+  result.miningSpeed = 0;
+  result.alternativeBlockCount = getAlternativeBlockCount();
+  result.topBlockHashString = Common::podToHex(getTopBlockHash());
+  result.transactionPoolBytes = transactionPool->getTransactionsSize();
+  result.transactionPoolEvictions = transactionPool->getEvictedTransactionCount();
+  result.blockTemplateBuildTime = blockTemplateBuildTime;
+  result.queryBlocksCacheHits = blockFullInfoCache.getHits() + blockShortInfoCache.getHits();
+  result.queryBlocksCacheMisses = blockFullInfoCache.getMisses() + blockShortInfoCache.getMisses();
   return result;
 }
 
@@ -1184,6 +1247,7 @@ std::vector<Transaction> Core::getPoolTransactions() const {
 
 bool Core::extractTransactions(const std::vector<BinaryArray>& rawTransactions,
                                std::vector<CachedTransaction>& transactions, uint64_t& cumulativeSize) {
+  transactions.reserve(transactions.size() + rawTransactions.size());
   try {
     for (auto& rawTransaction : rawTransactions) {
       if (rawTransaction.size() > currency.maxTxSize()) {
@@ -1203,8 +1267,10 @@ bool Core::extractTransactions(const std::vector<BinaryArray>& rawTransactions,
 }
 
 std::error_code Core::validateTransaction(const CachedTransaction& cachedTransaction, TransactionValidatorState& state,
-                                          IBlockchainCache* cache, uint64_t& fee, uint32_t blockIndex) {
+                                          IBlockchainCache* cache, uint64_t& fee, uint32_t blockIndex,
+                                          std::vector<DeferredRingSignature>* deferredSignatures) {
   // TransactionValidatorState currentState;
+  Common::MetricTimer durationTimer(transactionValidationDuration());
   const auto& transaction = cachedTransaction.getTransaction();
   auto error = validateSemantic(transaction, fee);
   if (error != error::TransactionValidationError::VALIDATION_SUCCESS) {
@@ -1242,6 +1308,12 @@ std::error_code Core::validateTransaction(const CachedTransaction& cachedTransac
           return error::TransactionValidationError::INPUT_SPEND_LOCKED_OUT;
         }
 
+        if (deferredSignatures != nullptr) {
+          deferredSignatures->push_back({&cachedTransaction, inputIndex, std::move(outputKeys)});
+          inputIndex++;
+          continue;
+        }
+
         std::vector<const Crypto::PublicKey*> outputKeyPointers;
         outputKeyPointers.reserve(outputKeys.size());
         std::for_each(outputKeys.begin(), outputKeys.end(), [&outputKeyPointers] (const Crypto::PublicKey& key) { outputKeyPointers.push_back(&key); });
@@ -1301,6 +1373,36 @@ std::error_code Core::validateTransaction(const CachedTransaction& cachedTransac
   return error::TransactionValidationError::VALIDATION_SUCCESS;
 }
 
+std::error_code Core::checkDeferredRingSignatures(const std::vector<DeferredRingSignature>& signatures) {
+  std::vector<std::vector<const Crypto::PublicKey*>> outputKeyPointers(signatures.size());
+  std::vector<Crypto::ring_signature_check> checks;
+  checks.reserve(signatures.size());
+  for (size_t i = 0; i < signatures.size(); ++i) {
+    const auto& signature = signatures[i];
+    const auto& transaction = signature.transaction->getTransaction();
+    for (const auto& key : signature.outputKeys) {
+      outputKeyPointers[i].push_back(&key);
+    }
+
+    checks.push_back({&signature.transaction->getTransactionPrefixHash(),
+                      &boost::get<KeyInput>(transaction.inputs[signature.inputIndex]).keyImage,
+                      outputKeyPointers[i].data(), outputKeyPointers[i].size(),
+                      transaction.signatures[signature.inputIndex].data()});
+  }
+
+  std::unique_ptr<bool[]> results(new bool[checks.size()]);
+  Crypto::check_ring_signatures(checks.data(), checks.size(), results.get());
+  for (size_t i = 0; i < checks.size(); ++i) {
+    if (!results[i]) {
+      std::error_code error = error::TransactionValidationError::INPUT_INVALID_SIGNATURES;
+      logger(Logging::DEBUGGING) << "Failed to validate transaction " << signatures[i].transaction->getTransactionHash() << ": " << error.message();
+      return error;
+    }
+  }
+
+  return error::TransactionValidationError::VALIDATION_SUCCESS;
+}
+
 std::error_code Core::validateSemantic(const Transaction& transaction, uint64_t& fee) {
   if (transaction.inputs.empty()) {
     return error::TransactionValidationError::EMPTY_INPUTS;
@@ -1531,6 +1633,10 @@ void Core::load() {
     logger(Logging::DEBUGGING) << "Blockchain storage and root segment are on the same height and chain";
   }
 
+  if (getRootSegment()->getExplorerIndexesStatus() == ExplorerIndexesStatus::BUILDING) {
+    contextGroup.spawn(std::bind(&Core::explorerIndexesBuildingProcedure, this));
+  }
+
   initialized = true;
 }
 
@@ -1615,28 +1721,43 @@ void Core::updateMainChainSet() {
   } while (chainPtr != nullptr);
 }
 
+IBlockchainCache* Core::getRootSegment() const {
+  assert(!chainsLeaves.empty());
+
+  IBlockchainCache* segment = chainsLeaves[0];
+  while (segment->getParent() != nullptr) {
+    segment = segment->getParent();
+  }
+
+  return segment;
+}
+
 IBlockchainCache* Core::findSegmentContainingBlock(const Crypto::Hash& blockHash) const {
   assert(chainsLeaves.size() > 0);
 
-  // first search in main chain
-  auto blockSegment = findMainChainSegmentContainingBlock(blockHash);
+  auto blockSegment = segmentIndex.findBlock(blockHash);
   if (blockSegment != nullptr) {
     return blockSegment;
   }
 
-  // than search in alternative chains
-  return findAlternativeSegmentContainingBlock(blockHash);
+  auto root = getRootSegment();
+  return root->hasBlock(blockHash) ? root : nullptr;
 }
 
 IBlockchainCache* Core::findAlternativeSegmentContainingBlock(const Crypto::Hash& blockHash) const {
-  IBlockchainCache* cache = nullptr;
-  std::find_if(++chainsLeaves.begin(), chainsLeaves.end(),
-               [&](IBlockchainCache* chain) { return cache = findIndexInChain(chain, blockHash); });
-  return cache;
+  // root segment belongs to the main chain, so only indexed segments can be alternative
+  auto blockSegment = segmentIndex.findBlock(blockHash);
+  return blockSegment != nullptr && mainChainSet.count(blockSegment) == 0 ? blockSegment : nullptr;
 }
 
 IBlockchainCache* Core::findMainChainSegmentContainingBlock(const Crypto::Hash& blockHash) const {
-  return findIndexInChain(chainsLeaves[0], blockHash);
+  auto blockSegment = segmentIndex.findBlock(blockHash);
+  if (blockSegment != nullptr) {
+    return mainChainSet.count(blockSegment) != 0 ? blockSegment : nullptr;
+  }
+
+  auto root = getRootSegment();
+  return root->hasBlock(blockHash) ? root : nullptr;
 }
 
 IBlockchainCache* Core::findMainChainSegmentContainingBlock(uint32_t blockIndex) const {
@@ -1745,8 +1866,12 @@ void Core::fillQueryBlockFullInfo(uint32_t fullOffset, uint32_t currentIndex, si
     IBlockchainCache* segment = findMainChainSegmentContainingBlock(blockIndex);
 
     BlockFullInfo blockFullInfo;
-    blockFullInfo.block_id = segment->getBlockHash(blockIndex);
-    static_cast<RawBlock&>(blockFullInfo) = getRawBlock(segment, blockIndex);
+    Crypto::Hash blockHash = segment->getBlockHash(blockIndex);
+    if (!blockFullInfoCache.get(blockHash, blockFullInfo)) {
+      blockFullInfo.block_id = blockHash;
+      static_cast<RawBlock&>(blockFullInfo) = getRawBlock(segment, blockIndex);
+      blockFullInfoCache.put(blockHash, blockFullInfo);
+    }
 
     entries.emplace_back(std::move(blockFullInfo));
   }
@@ -1761,11 +1886,17 @@ void Core::fillQueryBlockShortInfo(uint32_t fullOffset, uint32_t currentIndex, s
 
   for (uint32_t blockIndex = fullOffset; blockIndex < fullOffset + fullBlocksCount; ++blockIndex) {
     IBlockchainCache* segment = findMainChainSegmentContainingBlock(blockIndex);
-    RawBlock rawBlock = getRawBlock(segment, blockIndex);
 
     BlockShortInfo blockShortInfo;
+    Crypto::Hash blockHash = segment->getBlockHash(blockIndex);
+    if (blockShortInfoCache.get(blockHash, blockShortInfo)) {
+      entries.emplace_back(std::move(blockShortInfo));
+      continue;
+    }
+
+    RawBlock rawBlock = getRawBlock(segment, blockIndex);
     blockShortInfo.block = std::move(rawBlock.block);
-    blockShortInfo.blockId = segment->getBlockHash(blockIndex);
+    blockShortInfo.blockId = blockHash;
 
     blockShortInfo.txPrefixes.reserve(rawBlock.transactions.size());
     for (auto& rawTransaction : rawBlock.transactions) {
@@ -1783,6 +1914,7 @@ void Core::fillQueryBlockShortInfo(uint32_t fullOffset, uint32_t currentIndex, s
       blockShortInfo.txPrefixes.emplace_back(std::move(prefixInfo));
     }
 
+    blockShortInfoCache.put(blockHash, blockShortInfo);
     entries.emplace_back(std::move(blockShortInfo));
   }
 }
@@ -1829,6 +1961,68 @@ size_t Core::calculateCumulativeBlocksizeLimit(uint32_t height) const {
   return median * 2;
 }
 
+bool Core::updateBlockTemplateCache() const {
+  Crypto::Hash topBlockHash = getTopBlockHash();
+  uint64_t poolGeneration = transactionPool->getGeneration();
+  if (blockTemplateCache.valid && blockTemplateCache.topBlockHash == topBlockHash && blockTemplateCache.poolGeneration == poolGeneration) {
+    return true;
+  }
+
+  blockTemplateCache.valid = false;
+
+  uint32_t height = getTopBlockIndex() + 1;
+  Difficulty difficulty = getDifficultyForNextBlock();
+  if (difficulty == 0) {
+    logger(Logging::ERROR, Logging::BRIGHT_RED) << "difficulty overhead.";
+    return false;
+  }
+
+  BlockTemplate& b = blockTemplateCache.block;
+  b = boost::value_initialized<BlockTemplate>();
+  b.majorVersion = getBlockMajorVersionForHeight(height);
+
+  if (b.majorVersion == BLOCK_MAJOR_VERSION_1) {
+    b.minorVersion = currency.upgradeHeight(BLOCK_MAJOR_VERSION_2) == IUpgradeDetector::UNDEF_HEIGHT ? BLOCK_MINOR_VERSION_1 : BLOCK_MINOR_VERSION_0;
+  } else if (b.majorVersion >= BLOCK_MAJOR_VERSION_2) {
+    if (currency.upgradeHeight(BLOCK_MAJOR_VERSION_3) == IUpgradeDetector::UNDEF_HEIGHT) {
+      b.minorVersion = b.majorVersion == BLOCK_MAJOR_VERSION_2 ? BLOCK_MINOR_VERSION_1 : BLOCK_MINOR_VERSION_0;
+    } else {
+      b.minorVersion = BLOCK_MINOR_VERSION_0;
+    }
+
+    b.parentBlock.majorVersion = BLOCK_MAJOR_VERSION_1;
+    b.parentBlock.majorVersion = BLOCK_MINOR_VERSION_0;
+    b.parentBlock.transactionCount = 1;
+
+    TransactionExtraMergeMiningTag mmTag = boost::value_initialized<decltype(mmTag)>();
+    if (!appendMergeMiningTagToExtra(b.parentBlock.baseTransaction.extra, mmTag)) {
+      logger(Logging::ERROR, Logging::BRIGHT_RED)
+          << "Failed to append merge mining tag to extra of the parent block miner transaction";
+      return false;
+    }
+  }
+
+  b.previousBlockHash = topBlockHash;
+
+  size_t medianSize = calculateCumulativeBlocksizeLimit(height) / 2;
+
+  assert(!chainsStorage.empty());
+  assert(!chainsLeaves.empty());
+
+  auto fillStart = std::chrono::steady_clock::now();
+  fillBlockTemplate(b, medianSize, currency.maxBlockCumulativeSize(height), blockTemplateCache.transactionsSize, blockTemplateCache.fee);
+  blockTemplateBuildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - fillStart).count();
+
+  blockTemplateCache.topBlockHash = topBlockHash;
+  blockTemplateCache.poolGeneration = poolGeneration;
+  blockTemplateCache.difficulty = difficulty;
+  blockTemplateCache.height = height;
+  blockTemplateCache.medianSize = medianSize;
+  blockTemplateCache.alreadyGeneratedCoins = chainsLeaves[0]->getAlreadyGeneratedCoins();
+  blockTemplateCache.valid = true;
+  return true;
+}
+
 void Core::fillBlockTemplate(BlockTemplate& block, size_t medianSize, size_t maxCumulativeSize,
                              size_t& transactionsSize, uint64_t& fee) const {
   transactionsSize = 0;
@@ -1896,6 +2090,8 @@ void Core::deleteLeaf(size_t leafIndex) {
 
   assert(segmentIt != chainsStorage.end());
 
+  segmentIndex.removeSegment(leaf);
+
   if (leafIndex != 0) {
     if (parent->getChildCount() == 0) {
       chainsLeaves.push_back(parent);
@@ -1940,6 +2136,7 @@ void Core::mergeMainChainSegments() {
   }
 
   chainsStorage.erase(++chainsStorage.begin(), chainsStorage.end());
+  segmentIndex.clear();
   chainsLeaves.clear();
   chainsLeaves.push_back(chainsStorage.begin()->get());
 }
@@ -1970,80 +2167,186 @@ void Core::mergeSegments(IBlockchainCache* acceptingSegment, IBlockchainCache* s
 }
 
 BlockDetails Core::getBlockDetails(const Crypto::Hash& blockHash) const {
+  return getBlocksDetails({ blockHash }).front();
+}
+
+std::vector<BlockDetails> Core::getBlocksDetails(const std::vector<Crypto::Hash>& blockHashes) const {
   throwIfNotInitialized();
 
-  IBlockchainCache* segment = findSegmentContainingBlock(blockHash);
-  if (segment == nullptr) {
-    throw std::runtime_error("Requested hash wasn't found in blockchain.");
+  std::vector<BlockDetails> blocksDetails(blockHashes.size());
+  std::unordered_map<IBlockchainCache*, std::vector<size_t>> segmentsBlocks;
+  for (size_t i = 0; i < blockHashes.size(); ++i) {
+    IBlockchainCache* segment = findSegmentContainingBlock(blockHashes[i]);
+    if (segment == nullptr) {
+      throw std::runtime_error("Requested hash wasn't found in blockchain.");
+    }
+
+    blocksDetails[i].hash = blockHashes[i];
+    blocksDetails[i].index = segment->getBlockIndex(blockHashes[i]);
+    segmentsBlocks[segment].push_back(i);
   }
 
-  uint32_t blockIndex = segment->getBlockIndex(blockHash);
-  BlockTemplate blockTemplate = restoreBlockTemplate(segment, blockIndex);
-  
-  BlockDetails blockDetails;
-  blockDetails.majorVersion = blockTemplate.majorVersion;
-  blockDetails.minorVersion = blockTemplate.minorVersion;
-  blockDetails.timestamp = blockTemplate.timestamp;
-  blockDetails.prevBlockHash = blockTemplate.previousBlockHash;
-  blockDetails.nonce = blockTemplate.nonce;
-  blockDetails.hash = blockHash;
+  for (auto& segmentBlocks : segmentsBlocks) {
+    fillBlocksDetails(segmentBlocks.first, segmentBlocks.second, blocksDetails);
+  }
+
+  return blocksDetails;
+}
 
-  blockDetails.reward = 0;
-  for (const TransactionOutput& out : blockTemplate.baseTransaction.outputs) {
-    blockDetails.reward += out.amount;
+void Core::fillBlocksDetails(IBlockchainCache* segment, std::vector<size_t>& positions, std::vector<BlockDetails>& blocksDetails) const {
+  std::sort(positions.begin(), positions.end(), [&blocksDetails](size_t left, size_t right) {
+    return blocksDetails[left].index < blocksDetails[right].index;
+  });
+
+  std::vector<uint32_t> blockIndexes;
+  blockIndexes.reserve(positions.size());
+  for (size_t position : positions) {
+    blockIndexes.push_back(blocksDetails[position].index);
   }
 
-  blockDetails.index = blockIndex;
-  blockDetails.isAlternative = mainChainSet.count(segment) == 0;
+  std::vector<RawBlock> rawBlocks = segment->getBlocksByIndexes(blockIndexes);
+  assert(rawBlocks.size() == positions.size());
 
-  blockDetails.difficulty = getBlockDifficulty(blockIndex);
+  bool isAlternative = mainChainSet.count(segment) == 0;
+  const size_t medianWindow = currency.rewardBlocksWindow();
 
-  std::vector<uint64_t> sizes = segment->getLastBlocksSizes(1, blockDetails.index, addGenesisBlock);
-  assert(sizes.size() == 1);
-  blockDetails.transactionsCumulativeSize = sizes.front();
+  std::vector<std::vector<CachedTransaction>> blocksTransactions(positions.size());
+  std::vector<Crypto::Hash> transactionHashes;
 
-  uint64_t blockBlobSize = getObjectBinarySize(blockTemplate);
-  uint64_t coinbaseTransactionSize = getObjectBinarySize(blockTemplate.baseTransaction);
-  blockDetails.blockSize = blockBlobSize + blockDetails.transactionsCumulativeSize - coinbaseTransactionSize;
+  // Blocks closer to each other than the median window form a run that shares one read of every per-block unit
+  size_t runBegin = 0;
+  while (runBegin < positions.size()) {
+    size_t runEnd = runBegin + 1;
+    while (runEnd < positions.size() && blockIndexes[runEnd] - blockIndexes[runEnd - 1] <= medianWindow) {
+      ++runEnd;
+    }
 
-  blockDetails.alreadyGeneratedCoins = segment->getAlreadyGeneratedCoins(blockDetails.index);
-  blockDetails.alreadyGeneratedTransactions = segment->getAlreadyGeneratedTransactions(blockDetails.index);
+    uint32_t lastIndex = blockIndexes[runEnd - 1];
+    size_t runLength = lastIndex - blockIndexes[runBegin] + 1;
 
-  uint64_t prevBlockGeneratedCoins = 0;
-  blockDetails.sizeMedian = 0;
-  if (blockDetails.index > 0) {
-    auto lastBlocksSizes = segment->getLastBlocksSizes(currency.rewardBlocksWindow(), blockDetails.index - 1, addGenesisBlock);
-    blockDetails.sizeMedian = Common::medianValue(lastBlocksSizes);
-    prevBlockGeneratedCoins = segment->getAlreadyGeneratedCoins(blockDetails.index - 1);
-  }
+    auto sizes = segment->getLastBlocksSizes(runLength + medianWindow, lastIndex, addGenesisBlock);
+    auto cumulativeDifficulties = segment->getLastCumulativeDifficulties(runLength + 1, lastIndex, addGenesisBlock);
+    auto generatedCoins = segment->getLastUnits(runLength + 1, lastIndex, addGenesisBlock,
+                                                [](const CachedBlockInfo& info) { return info.alreadyGeneratedCoins; });
+    auto generatedTransactions = segment->getLastUnits(runLength, lastIndex, addGenesisBlock,
+                                                       [](const CachedBlockInfo& info) { return info.alreadyGeneratedTransactions; });
 
-  int64_t emissionChange = 0;
-  bool result = currency.getBlockReward(blockDetails.majorVersion, blockDetails.sizeMedian, 0, prevBlockGeneratedCoins, 0, blockDetails.baseReward, emissionChange);
-  assert(result);
+    // units vectors end at lastIndex
+    auto unitAt = [lastIndex](const std::vector<uint64_t>& units, uint32_t index) {
+      assert(lastIndex - index < units.size());
+      return units[units.size() - 1 - (lastIndex - index)];
+    };
 
-  uint64_t currentReward = 0;
-  result = currency.getBlockReward(blockDetails.majorVersion, blockDetails.sizeMedian, blockDetails.transactionsCumulativeSize,
-                                   prevBlockGeneratedCoins, 0, currentReward, emissionChange);
-  assert(result);
+    for (size_t i = runBegin; i < runEnd; ++i) {
+      BlockDetails& blockDetails = blocksDetails[positions[i]];
+      uint32_t blockIndex = blockIndexes[i];
 
-  if (blockDetails.baseReward == 0 && currentReward == 0) {
-    blockDetails.penalty = static_cast<double>(0);
-  } else {
-    assert(blockDetails.baseReward >= currentReward);
-    blockDetails.penalty = static_cast<double>(blockDetails.baseReward - currentReward) / static_cast<double>(blockDetails.baseReward);
-  }
+      BlockTemplate blockTemplate;
+      if (!fromBinaryArray(blockTemplate, rawBlocks[i].block)) {
+        throw std::runtime_error("Coulnd't deserialize BlockTemplate");
+      }
+
+      blockDetails.majorVersion = blockTemplate.majorVersion;
+      blockDetails.minorVersion = blockTemplate.minorVersion;
+      blockDetails.timestamp = blockTemplate.timestamp;
+      blockDetails.prevBlockHash = blockTemplate.previousBlockHash;
+      blockDetails.nonce = blockTemplate.nonce;
+
+      blockDetails.reward = 0;
+      for (const TransactionOutput& out : blockTemplate.baseTransaction.outputs) {
+        blockDetails.reward += out.amount;
+      }
+
+      blockDetails.isAlternative = isAlternative;
 
-  blockDetails.transactions.reserve(blockTemplate.transactionHashes.size() + 1);
-  CachedTransaction cachedBaseTx(std::move(blockTemplate.baseTransaction));
-  blockDetails.transactions.push_back(getTransactionDetails(cachedBaseTx.getTransactionHash(), segment, false));
+      blockDetails.difficulty = unitAt(cumulativeDifficulties, blockIndex);
+      if (blockIndex > 0) {
+        blockDetails.difficulty -= unitAt(cumulativeDifficulties, blockIndex - 1);
+      }
+
+      blockDetails.transactionsCumulativeSize = unitAt(sizes, blockIndex);
+
+      uint64_t blockBlobSize = getObjectBinarySize(blockTemplate);
+      uint64_t coinbaseTransactionSize = getObjectBinarySize(blockTemplate.baseTransaction);
+      blockDetails.blockSize = blockBlobSize + blockDetails.transactionsCumulativeSize - coinbaseTransactionSize;
+
+      blockDetails.alreadyGeneratedCoins = unitAt(generatedCoins, blockIndex);
+      blockDetails.alreadyGeneratedTransactions = unitAt(generatedTransactions, blockIndex);
+
+      uint64_t prevBlockGeneratedCoins = 0;
+      blockDetails.sizeMedian = 0;
+      if (blockIndex > 0) {
+        uint32_t windowBegin = blockIndex > medianWindow ? blockIndex - static_cast<uint32_t>(medianWindow) : 0;
+        std::vector<uint64_t> lastBlocksSizes;
+        lastBlocksSizes.reserve(blockIndex - windowBegin);
+        for (uint32_t index = windowBegin; index < blockIndex; ++index) {
+          lastBlocksSizes.push_back(unitAt(sizes, index));
+        }
+
+        blockDetails.sizeMedian = Common::medianValue(lastBlocksSizes);
+        prevBlockGeneratedCoins = unitAt(generatedCoins, blockIndex - 1);
+      }
 
-  blockDetails.totalFeeAmount = 0;
-  for (const Crypto::Hash& transactionHash : blockTemplate.transactionHashes) {
-    blockDetails.transactions.push_back(getTransactionDetails(transactionHash, segment, false));
-    blockDetails.totalFeeAmount += blockDetails.transactions.back().fee;
+      int64_t emissionChange = 0;
+      bool result = currency.getBlockReward(blockDetails.majorVersion, blockDetails.sizeMedian, 0, prevBlockGeneratedCoins, 0, blockDetails.baseReward, emissionChange);
+      assert(result);
+
+      uint64_t currentReward = 0;
+      result = currency.getBlockReward(blockDetails.majorVersion, blockDetails.sizeMedian, blockDetails.transactionsCumulativeSize,
+                                       prevBlockGeneratedCoins, 0, currentReward, emissionChange);
+      assert(result);
+
+      if (blockDetails.baseReward == 0 && currentReward == 0) {
+        blockDetails.penalty = static_cast<double>(0);
+      } else {
+        assert(blockDetails.baseReward >= currentReward);
+        blockDetails.penalty = static_cast<double>(blockDetails.baseReward - currentReward) / static_cast<double>(blockDetails.baseReward);
+      }
+
+      std::vector<CachedTransaction>& transactions = blocksTransactions[i];
+      transactions.reserve(blockTemplate.transactionHashes.size() + 1);
+      transactions.emplace_back(std::move(blockTemplate.baseTransaction));
+      if (!Utils::restoreCachedTransactions(rawBlocks[i].transactions, transactions)) {
+        throw std::runtime_error("Couldn't deserialize transactions");
+      }
+
+      for (const CachedTransaction& transaction : transactions) {
+        transactionHashes.push_back(transaction.getTransactionHash());
+      }
+    }
+
+    runBegin = runEnd;
   }
 
-  return blockDetails;
+  auto globalIndexes = segment->getTransactionsGlobalIndexes(transactionHashes);
+  assert(globalIndexes.size() == transactionHashes.size());
+
+  size_t transactionPosition = 0;
+  for (size_t i = 0; i < positions.size(); ++i) {
+    BlockDetails& blockDetails = blocksDetails[positions[i]];
+    blockDetails.transactions.clear();
+    blockDetails.transactions.reserve(blocksTransactions[i].size());
+    blockDetails.totalFeeAmount = 0;
+
+    for (const CachedTransaction& transaction : blocksTransactions[i]) {
+      TransactionDetails transactionDetails;
+      transactionDetails.hash = transaction.getTransactionHash();
+      transactionDetails.inBlockchain = true;
+      transactionDetails.blockIndex = blockDetails.index;
+      transactionDetails.blockHash = blockDetails.hash;
+      transactionDetails.timestamp = blockDetails.timestamp;
+      transactionDetails.size = transaction.getTransactionBinaryArray().size();
+      transactionDetails.fee = transaction.getTransactionFee();
+
+      fillTransactionDetails(transaction.getTransaction(), segment, globalIndexes[transactionPosition++], transactionDetails);
+      blockDetails.transactions.push_back(std::move(transactionDetails));
+    }
+
+    // base transaction doesn't pay fee
+    for (size_t j = 1; j < blockDetails.transactions.size(); ++j) {
+      blockDetails.totalFeeAmount += blockDetails.transactions[j].fee;
+    }
+  }
 }
 
 TransactionDetails Core::getTransactionDetails(const Crypto::Hash& transactionHash) const {
@@ -2064,7 +2367,6 @@ TransactionDetails Core::getTransactionDetails(const Crypto::Hash& transactionHa
     segment = chainsLeaves[0];
   }
 
-  std::unique_ptr<ITransaction> transaction;
   Transaction rawTransaction;
   TransactionDetails transactionDetails;
   if (!foundInPool) {
@@ -2093,7 +2395,6 @@ TransactionDetails Core::getTransactionDetails(const Crypto::Hash& transactionHa
     transactionDetails.fee = transactions.back().getTransactionFee();
 
     rawTransaction = transactions.back().getTransaction();
-    transaction = createTransaction(rawTransaction);
   } else {
     transactionDetails.inBlockchain = false;
     transactionDetails.timestamp = transactionPool->getTransactionReceiveTime(transactionHash);
@@ -2102,10 +2403,23 @@ TransactionDetails Core::getTransactionDetails(const Crypto::Hash& transactionHa
     transactionDetails.fee = transactionPool->getTransaction(transactionHash).getTransactionFee();
 
     rawTransaction = transactionPool->getTransaction(transactionHash).getTransaction();
-    transaction = createTransaction(rawTransaction);
   }
 
   transactionDetails.hash = transactionHash;
+
+  std::vector<uint32_t> globalIndexes;
+  if (transactionDetails.inBlockchain && !getTransactionGlobalIndexes(transactionDetails.hash, globalIndexes)) {
+    globalIndexes.clear();
+  }
+
+  fillTransactionDetails(rawTransaction, segment, globalIndexes, transactionDetails);
+  return transactionDetails;
+}
+
+void Core::fillTransactionDetails(const Transaction& rawTransaction, IBlockchainCache* segment, const std::vector<uint32_t>& globalIndexes,
+                                  TransactionDetails& transactionDetails) const {
+  std::unique_ptr<ITransaction> transaction = createTransaction(rawTransaction);
+
   transactionDetails.unlockTime = transaction->getUnlockTime();
 
   transactionDetails.totalOutputsAmount = transaction->getOutputTotalAmount();
@@ -2171,24 +2485,15 @@ TransactionDetails Core::getTransactionDetails(const Crypto::Hash& transactionHa
     transactionDetails.inputs.push_back(std::move(txInDetails));
   }
 
+  // pool transactions and transactions with unknown indexes get zero global indexes
+  assert(globalIndexes.empty() || transaction->getOutputCount() == globalIndexes.size());
   transactionDetails.outputs.reserve(transaction->getOutputCount());
-  std::vector<uint32_t> globalIndexes;
-  globalIndexes.reserve(transaction->getOutputCount());
-  if (!transactionDetails.inBlockchain || !getTransactionGlobalIndexes(transactionDetails.hash, globalIndexes)) {
-    for (size_t i = 0; i < transaction->getOutputCount(); ++i) {
-      globalIndexes.push_back(0);
-    }
-  }
-
-  assert(transaction->getOutputCount() == globalIndexes.size());
   for (size_t i = 0; i < transaction->getOutputCount(); ++i) {
     TransactionOutputDetails txOutDetails;
     txOutDetails.output = rawTransaction.outputs[i];
-    txOutDetails.globalIndex = globalIndexes[i];
+    txOutDetails.globalIndex = globalIndexes.empty() ? 0 : globalIndexes[i];
     transactionDetails.outputs.push_back(std::move(txOutDetails));
   }
-
-  return transactionDetails;
 }
 
 std::vector<Crypto::Hash> Core::getAlternativeBlockHashesByIndex(uint32_t blockIndex) const {
@@ -2248,6 +2553,46 @@ std::vector<Crypto::Hash> Core::getTransactionHashesByPaymentId(const Hash& paym
   return hashes;
 }
 
+std::vector<Crypto::Hash> Core::getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages) const {
+  throwIfNotInitialized();
+  throwIfExplorerIndexesNotReady();
+
+  std::vector<Crypto::Hash> hashes;
+  hashes.reserve(keyImages.size());
+  for (const auto& keyImage : keyImages) {
+    Crypto::Hash transactionHash;
+    hashes.push_back(chainsLeaves[0]->findTransactionSpendingKeyImage(keyImage, transactionHash) ? transactionHash : NULL_HASH);
+  }
+
+  return hashes;
+}
+
+std::vector<Crypto::Hash> Core::getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys) const {
+  throwIfNotInitialized();
+  throwIfExplorerIndexesNotReady();
+
+  std::vector<Crypto::Hash> hashes;
+  hashes.reserve(outputKeys.size());
+  for (const auto& outputKey : outputKeys) {
+    Crypto::Hash transactionHash;
+    uint16_t outputIndex;
+    hashes.push_back(chainsLeaves[0]->findTransactionByOutputKey(outputKey, transactionHash, outputIndex) ? transactionHash : NULL_HASH);
+  }
+
+  return hashes;
+}
+
+void Core::throwIfExplorerIndexesNotReady() const {
+  switch (getRootSegment()->getExplorerIndexesStatus()) {
+    case ExplorerIndexesStatus::DISABLED:
+      throw std::system_error(make_error_code(error::CoreErrorCode::EXPLORER_INDEXES_DISABLED));
+    case ExplorerIndexesStatus::BUILDING:
+      throw std::system_error(make_error_code(error::CoreErrorCode::EXPLORER_INDEXES_NOT_READY));
+    default:
+      break;
+  }
+}
+
 void Core::throwIfNotInitialized() const {
   if (!initialized) {
     throw std::system_error(make_error_code(error::CoreErrorCode::NOT_INITIALIZED));
@@ -2258,32 +2603,19 @@ IBlockchainCache* Core::findSegmentContainingTransaction(const Crypto::Hash& tra
   assert(!chainsLeaves.empty());
   assert(!chainsStorage.empty());
 
-  IBlockchainCache* segment = chainsLeaves[0];
-  assert(segment != nullptr);
-
   //find in main chain
-  do {
-    if (segment->hasTransaction(transactionHash)) {
-      return segment;
-    }
-
-    segment = segment->getParent();
-  } while (segment != nullptr);
-
-  //find in alternative chains
-  for (size_t chain = 1; chain < chainsLeaves.size(); ++chain) {
-    segment = chainsLeaves[chain];
-
-    while (mainChainSet.count(segment) == 0) {
-      if (segment->hasTransaction(transactionHash)) {
-        return segment;
-      }
+  auto segment = segmentIndex.findTransaction(transactionHash, [this](IBlockchainCache* s) { return mainChainSet.count(s) != 0; });
+  if (segment != nullptr) {
+    return segment;
+  }
 
-      segment = segment->getParent();
-    }
+  auto root = getRootSegment();
+  if (root->hasTransaction(transactionHash)) {
+    return root;
   }
 
-  return nullptr;
+  //find in alternative chains
+  return segmentIndex.findTransaction(transactionHash, [](IBlockchainCache*) { return true; });
 }
 
 bool Core::hasTransaction(const Crypto::Hash& transactionHash) const {
@@ -2308,6 +2640,21 @@ void Core::transactionPoolCleaningProcedure() {
   }
 }
 
+// Indexes old blocks in small steps, so that blocks and transactions are processed in between
+void Core::explorerIndexesBuildingProcedure() {
+  System::Timer timer(dispatcher);
+
+  try {
+    while (getRootSegment()->buildExplorerIndexes(EXPLORER_INDEXES_BLOCKS_PER_STEP)) {
+      timer.sleep(EXPLORER_INDEXES_BUILDING_INTERVAL);
+    }
+  } catch (System::InterruptedException&) {
+    logger(Logging::DEBUGGING) << "explorerIndexesBuildingProcedure has been interrupted";
+  } catch (std::exception& e) {
+    logger(Logging::ERROR) << "Error occurred while building explorer indexes: " << e.what();
+  }
+}
+
 void Core::updateBlockMedianSize() {
   auto mainChain = chainsLeaves[0];
 
@@ -16,12 +16,15 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include "BlockchainCache.h"
+#include "BlockInfoCache.h"
 #include "BlockchainMessages.h"
 #include "CachedBlock.h"
 #include "CachedTransaction.h"
+#include "ChainSegmentIndex.h"
 #include "Currency.h"
 #include "Checkpoints.h"
 #include "IBlockchainCache.h"
@@ -40,6 +43,7 @@
 #include "CryptoNoteCore/MinerConfig.h"
 
 #include <System/ContextGroup.h>
+#include <System/Event.h>
 
 namespace CryptoNote {
 
@@ -93,11 +97,18 @@ public:
     std::vector<Crypto::Hash>& deletedTransactions) const override;
   virtual bool getPoolChangesLite(const Crypto::Hash& lastBlockHash, const std::vector<Crypto::Hash>& knownHashes, std::vector<TransactionPrefixInfo>& addedTransactions,
     std::vector<Crypto::Hash>& deletedTransactions) const override;
+  virtual bool getPoolChangesLiteSince(const Crypto::Hash& lastBlockHash, uint64_t& poolVersion, const std::vector<Crypto::Hash>& knownHashes,
+    std::vector<TransactionPrefixInfo>& addedTransactions, std::vector<Crypto::Hash>& deletedTransactions, bool& isDelta) const override;
 
   virtual bool getBlockTemplate(BlockTemplate& b, const AccountPublicAddress& adr, const BinaryArray& extraNonce, Difficulty& difficulty, uint32_t& height) const override;
 
   virtual CoreStatistics getCoreStatistics() const override;
 
+  // Changes whenever a transaction enters or leaves the pool, together with the top block hash identifies a block template
+  uint64_t getPoolGeneration() const;
+  // Suspends the current context until the top block or the transaction pool changes
+  void waitForBlockTemplateChange();
+
   //ICoreInformation
   virtual size_t getPoolTransactionCount() const override;
   virtual size_t getBlockchainTransactionCount() const override;
@@ -114,10 +125,13 @@ public:
   virtual void load() override;
 
   virtual BlockDetails getBlockDetails(const Crypto::Hash& blockHash) const override;
+  virtual std::vector<BlockDetails> getBlocksDetails(const std::vector<Crypto::Hash>& blockHashes) const override;
   virtual TransactionDetails getTransactionDetails(const Crypto::Hash& transactionHash) const override;
   virtual std::vector<Crypto::Hash> getAlternativeBlockHashesByIndex(uint32_t blockIndex) const override;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const override;
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override;
+  virtual std::vector<Crypto::Hash> getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages) const override;
+  virtual std::vector<Crypto::Hash> getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys) const override;
 
 private:
   const Currency& currency;
@@ -131,6 +145,7 @@ private:
   std::vector<IBlockchainCache*> chainsLeaves;
   std::unique_ptr<ITransactionPoolCleanWrapper> transactionPool;
   std::unordered_set<IBlockchainCache*> mainChainSet;
+  ChainSegmentIndex segmentIndex;
 
   std::string dataFolder;
 
@@ -140,12 +155,43 @@ private:
   bool initialized;
 
   size_t blockMedianSize;
+  mutable std::atomic<uint64_t> blockTemplateBuildTime;
+  System::Event blockTemplateChanged;
+
+  // Part of the block template that depends only on the chain and the pool, the miner transaction is built per request
+  struct BlockTemplateCache {
+    bool valid;
+    Crypto::Hash topBlockHash;
+    uint64_t poolGeneration;
+    BlockTemplate block;
+    Difficulty difficulty;
+    uint32_t height;
+    size_t medianSize;
+    uint64_t alreadyGeneratedCoins;
+    size_t transactionsSize;
+    uint64_t fee;
+  };
+
+  mutable BlockTemplateCache blockTemplateCache;
+
+  // Blocks recently returned by queryBlocks and queryBlocksLite, many wallets usually synchronize the same top blocks
+  mutable BlockInfoCache<BlockFullInfo> blockFullInfoCache;
+  mutable BlockInfoCache<BlockShortInfo> blockShortInfoCache;
 
   void throwIfNotInitialized() const;
   bool extractTransactions(const std::vector<BinaryArray>& rawTransactions, std::vector<CachedTransaction>& transactions, uint64_t& cumulativeSize);
 
   std::error_code validateSemantic(const Transaction& transaction, uint64_t& fee);
-  std::error_code validateTransaction(const CachedTransaction& transaction, TransactionValidatorState& state, IBlockchainCache* cache, uint64_t& fee, uint32_t blockIndex);
+  // Ring signature of a key input, checked later together with the rest of its block
+  struct DeferredRingSignature {
+    const CachedTransaction* transaction;
+    size_t inputIndex;
+    std::vector<Crypto::PublicKey> outputKeys;
+  };
+
+  std::error_code validateTransaction(const CachedTransaction& transaction, TransactionValidatorState& state, IBlockchainCache* cache, uint64_t& fee, uint32_t blockIndex,
+                                      std::vector<DeferredRingSignature>* deferredSignatures = nullptr);
+  std::error_code checkDeferredRingSignatures(const std::vector<DeferredRingSignature>& signatures);
   
   uint32_t findBlockchainSupplement(const std::vector<Crypto::Hash>& remoteBlockIds) const;
   std::vector<Crypto::Hash> getBlockHashes(uint32_t startBlockIndex, uint32_t maxCount) const;
@@ -154,6 +200,7 @@ private:
 
   uint64_t getAdjustedTime() const;
   void updateMainChainSet();
+  IBlockchainCache* getRootSegment() const;
   IBlockchainCache* findSegmentContainingBlock(const Crypto::Hash& blockHash) const;
   IBlockchainCache* findMainChainSegmentContainingBlock(const Crypto::Hash& blockHash) const;
   IBlockchainCache* findAlternativeSegmentContainingBlock(const Crypto::Hash& blockHash) const;
@@ -179,17 +226,23 @@ private:
   uint8_t getBlockMajorVersionForHeight(uint32_t height) const;
   size_t calculateCumulativeBlocksizeLimit(uint32_t height) const;
   void fillBlockTemplate(BlockTemplate& block, size_t medianSize, size_t maxCumulativeSize, size_t& transactionsSize, uint64_t& fee) const;
+  bool updateBlockTemplateCache() const;
   void deleteAlternativeChains();
   void deleteLeaf(size_t leafIndex);
   void mergeMainChainSegments();
   void mergeSegments(IBlockchainCache* acceptingSegment, IBlockchainCache* segment);
   TransactionDetails getTransactionDetails(const Crypto::Hash& transactionHash, IBlockchainCache* segment, bool foundInPool) const;
+  void fillTransactionDetails(const Transaction& rawTransaction, IBlockchainCache* segment, const std::vector<uint32_t>& globalIndexes,
+                              TransactionDetails& transactionDetails) const;
+  void fillBlocksDetails(IBlockchainCache* segment, std::vector<size_t>& positions, std::vector<BlockDetails>& blocksDetails) const;
   void notifyOnSuccess(error::AddBlockErrorCode opResult, uint32_t previousBlockIndex, const CachedBlock& cachedBlock,
                        const IBlockchainCache& cache);
   void copyTransactionsToPool(IBlockchainCache* alt);
   void actualizePoolTransactions();
 
   void transactionPoolCleaningProcedure();
+  void explorerIndexesBuildingProcedure();
+  void throwIfExplorerIndexesNotReady() const;
   void updateBlockMedianSize();
   bool addTransactionToPool(CachedTransaction&& cachedTransaction);
   bool isTransactionValidForPool(const CachedTransaction& cachedTransaction, TransactionValidatorState& validatorState);
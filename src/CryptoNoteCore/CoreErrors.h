@@ -25,7 +25,9 @@ namespace error {
 
 enum class CoreErrorCode {
   NOT_INITIALIZED,
-  CORRUPTED_BLOCKCHAIN
+  CORRUPTED_BLOCKCHAIN,
+  EXPLORER_INDEXES_DISABLED,
+  EXPLORER_INDEXES_NOT_READY
 };
 
 // custom category:
@@ -47,6 +49,8 @@ public:
     switch (code) {
       case CoreErrorCode::NOT_INITIALIZED: return "Core is not initialized";
       case CoreErrorCode::CORRUPTED_BLOCKCHAIN: return "Blockchain storage is corrupted";
+      case CoreErrorCode::EXPLORER_INDEXES_DISABLED: return "Explorer indexes are disabled";
+      case CoreErrorCode::EXPLORER_INDEXES_NOT_READY: return "Explorer indexes are being built";
       default: return "Unknown error";
     }
   }
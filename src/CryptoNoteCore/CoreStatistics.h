@@ -27,6 +27,11 @@ struct CoreStatistics {
   uint64_t miningSpeed;
   uint64_t alternativeBlockCount;
   std::string topBlockHashString;
+  uint64_t transactionPoolBytes;
+  uint64_t transactionPoolEvictions;
+  uint64_t blockTemplateBuildTime; //microseconds, last getBlockTemplate
+  uint64_t queryBlocksCacheHits;
+  uint64_t queryBlocksCacheMisses;
 
   void serialize(ISerializer& s) {    
     s(transactionPoolSize, "tx_pool_size");
@@ -34,6 +39,11 @@ struct CoreStatistics {
     s(miningSpeed, "mining_speed");
     s(alternativeBlockCount, "alternative_blocks");
     s(topBlockHashString, "top_block_id_str");
+    s(transactionPoolBytes, "tx_pool_bytes");
+    s(transactionPoolEvictions, "tx_pool_evictions");
+    s(blockTemplateBuildTime, "block_template_build_time");
+    s(queryBlocksCacheHits, "query_blocks_cache_hits");
+    s(queryBlocksCacheMisses, "query_blocks_cache_misses");
   }
 };
 
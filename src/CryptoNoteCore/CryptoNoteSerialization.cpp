@@ -80,19 +80,19 @@ void getVariantValue(CryptoNote::ISerializer& serializer, uint8_t tag, CryptoNot
   case 0xff: {
     CryptoNote::BaseInput v;
     serializer(v, "value");
-    in = v;
+    in = std::move(v);
     break;
   }
   case 0x2: {
     CryptoNote::KeyInput v;
     serializer(v, "value");
-    in = v;
+    in = std::move(v);
     break;
   }
   case 0x3: {
     CryptoNote::MultisignatureInput v;
     serializer(v, "value");
-    in = v;
+    in = std::move(v);
     break;
   }
   default:
@@ -105,13 +105,13 @@ void getVariantValue(CryptoNote::ISerializer& serializer, uint8_t tag, CryptoNot
   case 0x2: {
     CryptoNote::KeyOutput v;
     serializer(v, "data");
-    out = v;
+    out = std::move(v);
     break;
   }
   case 0x3: {
     CryptoNote::MultisignatureOutput v;
     serializer(v, "data");
-    out = v;
+    out = std::move(v);
     break;
   }
   default:
@@ -245,12 +245,10 @@ void serialize(Transaction& tx, ISerializer& serializer) {
       }
 
     } else {
-      std::vector<Crypto::Signature> signatures(signatureSize);
-      for (Crypto::Signature& sig : signatures) {
+      tx.signatures[i].resize(signatureSize);
+      for (Crypto::Signature& sig : tx.signatures[i]) {
         serializePod(sig, "", serializer);
       }
-
-      tx.signatures[i] = std::move(signatures);
     }
   }
 //  serializer.endArray();
@@ -545,6 +545,8 @@ m_lockedTxAllowedDeltaSeconds(currency.m_lockedTxAllowedDeltaSeconds),
 m_lockedTxAllowedDeltaBlocks(currency.m_lockedTxAllowedDeltaBlocks),
 m_mempoolTxLiveTime(currency.m_mempoolTxLiveTime),
 m_numberOfPeriodsToForgetTxDeletedFromPool(currency.m_numberOfPeriodsToForgetTxDeletedFromPool),
+m_mempoolMaxTransactionCount(currency.m_mempoolMaxTransactionCount),
+m_mempoolMaxSize(currency.m_mempoolMaxSize),
 m_fusionTxMaxSize(currency.m_fusionTxMaxSize),
 m_fusionTxMinInputCount(currency.m_fusionTxMinInputCount),
 m_fusionTxMinInOutCountRatio(currency.m_fusionTxMinInOutCountRatio),
@@ -599,6 +601,8 @@ CurrencyBuilder::CurrencyBuilder(Logging::ILogger& log) : m_currency(log) {
   mempoolTxLiveTime(parameters::CRYPTONOTE_MEMPOOL_TX_LIVETIME);
   mempoolTxFromAltBlockLiveTime(parameters::CRYPTONOTE_MEMPOOL_TX_FROM_ALT_BLOCK_LIVETIME);
   numberOfPeriodsToForgetTxDeletedFromPool(parameters::CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL);
+  mempoolMaxTransactionCount(parameters::CRYPTONOTE_MEMPOOL_MAX_TRANSACTION_COUNT);
+  mempoolMaxSize(parameters::CRYPTONOTE_MEMPOOL_MAX_SIZE);
 
   fusionTxMaxSize(parameters::FUSION_TX_MAX_SIZE);
   fusionTxMinInputCount(parameters::FUSION_TX_MIN_INPUT_COUNT);
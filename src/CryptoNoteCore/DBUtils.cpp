@@ -17,6 +17,8 @@
 
 #include "DBUtils.h"
 
+#include "Serialization/KVBinaryCommon.h"
+
 namespace {
   const std::string RAW_BLOCK_NAME = "raw_block";
   const std::string RAW_TXS_NAME = "raw_txs";
@@ -42,5 +44,20 @@ namespace DB {
     serializer(value.block, RAW_BLOCK_NAME);
     serializer(value.transactions, RAW_TXS_NAME);
   }
+
+  std::string getKeyPrefix(const std::string& rawKey) {
+    // storage header, one byte varint of the entries count (always 1), one byte name length, name
+    const size_t nameLengthOffset = sizeof(KVBinaryStorageBlockHeader) + 1;
+    if (rawKey.size() <= nameLengthOffset) {
+      return std::string();
+    }
+
+    size_t nameLength = static_cast<uint8_t>(rawKey[nameLengthOffset]);
+    if (rawKey.size() < nameLengthOffset + 1 + nameLength) {
+      return std::string();
+    }
+
+    return rawKey.substr(nameLengthOffset + 1, nameLength);
+  }
 }
 }
@@ -66,6 +66,13 @@ namespace DB {
 
   const std::string KEY_OUTPUT_KEY_PREFIX = "j";
 
+  // explorer indexes, written only if enabled in DataBaseConfig
+  const std::string KEY_IMAGE_TO_SPENDING_TX_HASH_PREFIX = "k";
+  const std::string OUTPUT_KEY_TO_TX_HASH_PREFIX = "l";
+  const std::string EXPLORER_INDEXES_STATE_PREFIX = "m";
+
+  const std::string EXPLORER_INDEXES_STATE_KEY = "explorer_indexes_state";
+
   template <class Value>
   std::string serialize(const Value& value, const std::string& name) {
     CryptoNote::KVBinaryOutputStreamSerializer serializer;
@@ -80,6 +87,9 @@ namespace DB {
 
   std::string serialize(const RawBlock& value, const std::string& name);
 
+  // Returns the prefix of a key made by serializeKey, empty string for other keys
+  std::string getKeyPrefix(const std::string& rawKey);
+
   template <class Key, class Value>
   std::pair<std::string, std::string> serialize(const std::string& keyPrefix, const Key& key, const Value& value) {
     return{ DB::serialize(std::make_pair(keyPrefix, key), keyPrefix), DB::serialize(value, keyPrefix) };
@@ -17,6 +17,9 @@
 
 #include "DataBaseConfig.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include <boost/utility/value_init.hpp>
 
 #include <Common/Util.h>
@@ -33,6 +36,7 @@ const uint64_t WRITE_BUFFER_MB_DEFAULT_SIZE = 256;
 const uint64_t READ_BUFFER_MB_DEFAULT_SIZE = 10;
 const uint32_t DEFAULT_MAX_OPEN_FILES = 100;
 const uint16_t DEFAULT_BACKGROUND_THREADS_COUNT = 2;
+const std::string DEFAULT_PROFILE = "serving";
 
 const uint64_t MEGABYTE = 1024 * 1024;
 
@@ -40,6 +44,14 @@ const command_line::arg_descriptor<uint16_t>    argBackgroundThreadsCount = { "d
 const command_line::arg_descriptor<uint32_t>    argMaxOpenFiles = { "db-max-open-files", "Number of open files that can be used by the DB", DEFAULT_MAX_OPEN_FILES};
 const command_line::arg_descriptor<uint64_t>    argWriteBufferSize = { "db-write-buffer-size", "Size of data base write buffer in megabytes", WRITE_BUFFER_MB_DEFAULT_SIZE};
 const command_line::arg_descriptor<uint64_t>    argReadCacheSize = { "db-read-cache-size", "Size of data base read cache in megabytes", READ_BUFFER_MB_DEFAULT_SIZE};
+const command_line::arg_descriptor<std::string> argProfile = { "db-profile", "Data base tuning profile: bulk-sync, serving or low-memory", DEFAULT_PROFILE};
+const command_line::arg_descriptor<bool>        argExplorerIndexes = { "db-explorer-indexes", "Keep key image and output key indexes for block explorers, existing blocks are indexed in background"};
+
+const std::pair<DataBaseConfig::Profile, const char*> PROFILE_NAMES[] = {
+  { DataBaseConfig::Profile::BULK_SYNC, "bulk-sync" },
+  { DataBaseConfig::Profile::SERVING, "serving" },
+  { DataBaseConfig::Profile::LOW_MEMORY, "low-memory" }
+};
 
 } //namespace
 
@@ -48,6 +60,8 @@ void DataBaseConfig::initOptions(boost::program_options::options_description& de
   command_line::add_arg(desc, argMaxOpenFiles);
   command_line::add_arg(desc, argWriteBufferSize);
   command_line::add_arg(desc, argReadCacheSize);
+  command_line::add_arg(desc, argProfile);
+  command_line::add_arg(desc, argExplorerIndexes);
 }
 
 DataBaseConfig::DataBaseConfig() :
@@ -56,7 +70,9 @@ DataBaseConfig::DataBaseConfig() :
   maxOpenFiles(DEFAULT_MAX_OPEN_FILES),
   writeBufferSize(WRITE_BUFFER_MB_DEFAULT_SIZE * MEGABYTE),
   readCacheSize(READ_BUFFER_MB_DEFAULT_SIZE * MEGABYTE),
-  testnet(false) {
+  testnet(false),
+  profile(Profile::SERVING),
+  explorerIndexes(false) {
 }
 
 bool DataBaseConfig::init(const boost::program_options::variables_map& vm) {
@@ -76,6 +92,21 @@ bool DataBaseConfig::init(const boost::program_options::variables_map& vm) {
     readCacheSize = command_line::get_arg(vm, argReadCacheSize) * MEGABYTE;
   }
 
+  if (vm.count(argProfile.name) != 0) {
+    std::string profileName = command_line::get_arg(vm, argProfile);
+    auto it = std::find_if(std::begin(PROFILE_NAMES), std::end(PROFILE_NAMES),
+      [&profileName](const std::pair<Profile, const char*>& name) { return profileName == name.second; });
+    if (it == std::end(PROFILE_NAMES)) {
+      throw std::runtime_error("Unknown data base profile: " + profileName);
+    }
+
+    profile = it->first;
+  }
+
+  if (command_line::has_arg(vm, argExplorerIndexes)) {
+    explorerIndexes = true;
+  }
+
   if (vm.count(command_line::arg_data_dir.name) != 0 && (!vm[command_line::arg_data_dir.name].defaulted() || dataDir == Tools::getDefaultDataDirectory())) {
     dataDir = command_line::get_arg(vm, command_line::arg_data_dir);
   }
@@ -113,6 +144,14 @@ bool DataBaseConfig::getTestnet() const {
   return testnet;
 }
 
+DataBaseConfig::Profile DataBaseConfig::getProfile() const {
+  return profile;
+}
+
+bool DataBaseConfig::getExplorerIndexes() const {
+  return explorerIndexes;
+}
+
 void DataBaseConfig::setConfigFolderDefaulted(bool defaulted) {
   configFolderDefaulted = defaulted;
 }
@@ -140,3 +179,21 @@ void DataBaseConfig::setReadCacheSize(uint64_t readCacheSize) {
 void DataBaseConfig::setTestnet(bool testnet) {
   this->testnet = testnet;
 }
+
+void DataBaseConfig::setProfile(Profile profile) {
+  this->profile = profile;
+}
+
+void DataBaseConfig::setExplorerIndexes(bool explorerIndexes) {
+  this->explorerIndexes = explorerIndexes;
+}
+
+std::string DataBaseConfig::profileToString(Profile profile) {
+  for (const auto& name : PROFILE_NAMES) {
+    if (name.first == profile) {
+      return name.second;
+    }
+  }
+
+  return "unknown";
+}
@@ -27,6 +27,14 @@ namespace CryptoNote {
 
 class DataBaseConfig {
 public:
+  // RocksDB tuning: BULK_SYNC favours write throughput for initial synchronization,
+  // SERVING favours point lookups of a synchronized node, LOW_MEMORY bounds memtables and filter memory
+  enum class Profile {
+    BULK_SYNC,
+    SERVING,
+    LOW_MEMORY
+  };
+
   DataBaseConfig();
   static void initOptions(boost::program_options::options_description& desc);
   bool init(const boost::program_options::variables_map& vm);
@@ -38,6 +46,8 @@ public:
   uint64_t getWriteBufferSize() const; //Bytes
   uint64_t getReadCacheSize() const; //Bytes
   bool getTestnet() const;
+  Profile getProfile() const;
+  bool getExplorerIndexes() const;
 
   void setConfigFolderDefaulted(bool defaulted);
   void setDataDir(const std::string& dataDir);
@@ -46,6 +56,10 @@ public:
   void setWriteBufferSize(uint64_t writeBufferSize); //Bytes
   void setReadCacheSize(uint64_t readCacheSize); //Bytes
   void setTestnet(bool testnet);
+  void setProfile(Profile profile);
+  void setExplorerIndexes(bool explorerIndexes);
+
+  static std::string profileToString(Profile profile);
 
 private:
   bool configFolderDefaulted;
@@ -55,5 +69,7 @@ private:
   uint64_t writeBufferSize;
   uint64_t readCacheSize;
   bool testnet;
+  Profile profile;
+  bool explorerIndexes;
 };
 } //namespace CryptoNote
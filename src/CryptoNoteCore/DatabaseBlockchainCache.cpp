@@ -19,10 +19,13 @@
 
 #include <ctime>
 #include <cstdlib>
+#include <fstream>
 
 #include <boost/iterator/iterator_facade.hpp>
 
 #include <Common/ShuffleGenerator.h>
+#include <Common/StdInputStream.h>
+#include <Common/StdOutputStream.h>
 
 #include "BlockchainUtils.h"
 
@@ -32,12 +35,17 @@
 #include <CryptoNoteCore/CryptoNoteTools.h>
 #include <CryptoNoteCore/CryptoNoteBasicImpl.h>
 #include "CryptoNoteCore/TransactionExtra.h"
+#include "CryptoNoteCore/CryptoNoteSerialization.h"
+#include "Serialization/BinaryInputStreamSerializer.h"
+#include "Serialization/BinaryOutputStreamSerializer.h"
+#include "Serialization/SerializationOverloads.h"
 
 namespace CryptoNote {
 
 namespace {
 
 const uint32_t ONE_DAY_SECONDS = 60 * 60 * 24;
+const uint32_t CACHE_SNAPSHOT_VERSION = 1;
 const CachedBlockInfo NULL_CACHED_BLOCK_INFO {NULL_HASH, 0, 0, 0, 0, 0};
 
 bool requestPackedOutputs(IBlockchainCache::Amount amount, Common::ArrayView<uint32_t> globalIndexes, IDataBase& database, std::vector<PackedOutIndex>& result) {
@@ -460,8 +468,10 @@ struct DatabaseBlockchainCache::ExtendedPushedBlockInfo {
 };
 
 
-DatabaseBlockchainCache::DatabaseBlockchainCache(const Currency& curr, IDataBase& dataBase, IBlockchainCacheFactory& blockchainCacheFactory, Logging::ILogger& _logger)
-    : currency(curr), database(dataBase), blockchainCacheFactory(blockchainCacheFactory), logger(_logger, "DatabaseBlockchainCache") {
+DatabaseBlockchainCache::DatabaseBlockchainCache(const Currency& curr, IDataBase& dataBase, IBlockchainCacheFactory& blockchainCacheFactory, Logging::ILogger& _logger,
+                                                 bool explorerIndexes, const std::string& snapshotFilename)
+    : currency(curr), database(dataBase), blockchainCacheFactory(blockchainCacheFactory), logger(_logger, "DatabaseBlockchainCache"),
+      explorerIndexes(explorerIndexes), explorerIndexesState({0, 0}), snapshotFilename(snapshotFilename) {
   DatabaseVersionReadBatch readBatch;
   auto ec = database.read(readBatch);
   if (ec) {
@@ -485,6 +495,42 @@ DatabaseBlockchainCache::DatabaseBlockchainCache(const Currency& curr, IDataBase
     logger(Logging::DEBUGGING) << "top block index is nill, add genesis block";
     addGenesisBlock(CachedBlock (currency.genesisBlock()));
   }
+
+  initExplorerIndexesState();
+}
+
+void DatabaseBlockchainCache::initExplorerIndexesState() {
+  auto state = readDatabase(BlockchainReadBatch().requestExplorerIndexesState()).getExplorerIndexesState();
+  if (!explorerIndexes) {
+    if (state.second) {
+      // indexes can't be maintained while disabled, so they are built from scratch when enabled again
+      logger(Logging::INFO) << "Explorer indexes are disabled, the existing ones are abandoned";
+      BlockchainWriteBatch writeBatch;
+      auto err = database.write(writeBatch.removeExplorerIndexesState());
+      if (err) {
+        throw std::system_error(err);
+      }
+    }
+
+    return;
+  }
+
+  if (state.second) {
+    explorerIndexesState = state.first;
+    logger(Logging::DEBUGGING) << "Explorer indexes cover blocks below " << explorerIndexesState.backfilledBlockCount
+                               << " and from " << explorerIndexesState.maintainedFromBlockIndex;
+    return;
+  }
+
+  explorerIndexesState.backfilledBlockCount = 0;
+  explorerIndexesState.maintainedFromBlockIndex = getTopBlockIndex() + 1;
+  logger(Logging::INFO) << "Explorer indexes enabled, " << explorerIndexesState.maintainedFromBlockIndex << " blocks are to be indexed";
+
+  BlockchainWriteBatch writeBatch;
+  auto err = database.write(writeBatch.insertExplorerIndexesState(explorerIndexesState));
+  if (err) {
+    throw std::system_error(err);
+  }
 }
 
 void DatabaseBlockchainCache::deleteClosestTimestampBlockIndex(BlockchainWriteBatch& writeBatch, uint32_t splitBlockIndex) {
@@ -565,6 +611,16 @@ std::unique_ptr<IBlockchainCache> DatabaseBlockchainCache::split(uint32_t splitB
     throw std::runtime_error("failed to request extended transaction info"); //TODO: make error codes
   }
 
+  if (explorerIndexes) {
+    std::vector<Crypto::KeyImage> deletingKeyImages;
+    for (const auto& deletingBlock : deletingBlocks) {
+      const auto& spentKeyImages = std::get<2>(deletingBlock).spentKeyImages;
+      deletingKeyImages.insert(deletingKeyImages.end(), spentKeyImages.begin(), spentKeyImages.end());
+    }
+
+    requestDeleteExplorerIndexes(writeBatch, splitBlockIndex, deletingKeyImages, extendedTransactions);
+  }
+
   std::map<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex> keyIndexSplitBoundaries;
   std::map<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex> multisigIndexSplitBoundaries;
   for (const auto& transaction: extendedTransactions) {
@@ -670,6 +726,44 @@ void DatabaseBlockchainCache::requestDeletePaymentIds(BlockchainWriteBatch& writ
   }
 }
 
+void DatabaseBlockchainCache::requestDeleteExplorerIndexes(BlockchainWriteBatch& writeBatch, uint32_t splitBlockIndex,
+                                                           const std::vector<Crypto::KeyImage>& keyImages,
+                                                           const std::vector<ExtendedTransactionInfo>& transactions) {
+  for (const auto& keyImage : keyImages) {
+    writeBatch.removeSpendingTransaction(keyImage);
+  }
+
+  BlockchainReadBatch readBatch;
+  for (const auto& transaction : transactions) {
+    for (const auto& output : transaction.outputs) {
+      if (output.type() == typeid(KeyOutput)) {
+        readBatch.requestOutputKeyReference(boost::get<KeyOutput>(output).key);
+      }
+    }
+  }
+
+  // an output key may repeat an older one, its reference is kept unless it points to a deleted transaction
+  auto references = readDatabase(readBatch).getOutputKeyReferences();
+  for (const auto& transaction : transactions) {
+    for (const auto& output : transaction.outputs) {
+      if (output.type() != typeid(KeyOutput)) {
+        continue;
+      }
+
+      const auto& key = boost::get<KeyOutput>(output).key;
+      auto it = references.find(key);
+      if (it != references.end() && it->second.transactionHash == transaction.transactionHash) {
+        writeBatch.removeOutputKeyReference(key);
+      }
+    }
+  }
+
+  // blocks pushed after the split are indexed in pushBlock
+  explorerIndexesState.backfilledBlockCount = std::min(explorerIndexesState.backfilledBlockCount, splitBlockIndex);
+  explorerIndexesState.maintainedFromBlockIndex = std::min(explorerIndexesState.maintainedFromBlockIndex, splitBlockIndex);
+  writeBatch.insertExplorerIndexesState(explorerIndexesState);
+}
+
 void DatabaseBlockchainCache::requestDeletePaymentId(BlockchainWriteBatch& writeBatch, const Crypto::Hash& paymentId, size_t toDelete) {
   size_t count = requestPaymentIdTransactionsCount(database, paymentId);
   assert(count > 0);
@@ -868,6 +962,10 @@ void DatabaseBlockchainCache::pushTransaction(const CachedTransaction& cachedTra
     insertPaymentId(batch, cachedTransaction.getTransactionHash(), paymentId);
   }
 
+  if (explorerIndexes) {
+    insertExplorerIndexes(batch, cachedTransaction);
+  }
+
   batch.insertCachedTransaction(transactionCacheInfo, getCachedTransactionsCount() + 1);
   transactionsCount = *transactionsCount + 1;
   logger(Logging::DEBUGGING) << "push transaction with hash " << cachedTransaction.getTransactionHash() << " finished";
@@ -948,6 +1046,24 @@ void DatabaseBlockchainCache::insertPaymentId(BlockchainWriteBatch& batch, const
   batch.insertPaymentId(transactionHash, paymentId, count);
 }
 
+void DatabaseBlockchainCache::insertExplorerIndexes(BlockchainWriteBatch& batch, const CachedTransaction& cachedTransaction) {
+  const auto& transaction = cachedTransaction.getTransaction();
+  for (const auto& input : transaction.inputs) {
+    if (input.type() == typeid(KeyInput)) {
+      batch.insertSpendingTransaction(boost::get<KeyInput>(input).keyImage, cachedTransaction.getTransactionHash());
+    }
+  }
+
+  for (size_t i = 0; i < transaction.outputs.size(); ++i) {
+    if (transaction.outputs[i].target.type() == typeid(KeyOutput)) {
+      OutputKeyReference reference;
+      reference.transactionHash = cachedTransaction.getTransactionHash();
+      reference.outputIndex = static_cast<uint16_t>(i);
+      batch.insertOutputKeyReference(boost::get<KeyOutput>(transaction.outputs[i].target).key, reference);
+    }
+  }
+}
+
 void DatabaseBlockchainCache::insertBlockTimestamp(BlockchainWriteBatch& batch, uint64_t timestamp, const Crypto::Hash& blockHash) {
   BlockchainReadBatch readBatch;
   readBatch.requestBlockHashesByTimestamp(timestamp);
@@ -1028,17 +1144,99 @@ void DatabaseBlockchainCache::pushBlock(const CachedBlock& cachedBlock,
   topBlockHash = cachedBlock.getBlockHash();
   logger(Logging::DEBUGGING) << "push block " << cachedBlock.getBlockHash() << " completed";
 
+  if (blockHashesFilter) {
+    if (blockHashesFilter->isFull()) {
+      // rebuilt with a bigger capacity on next lookup
+      blockHashesFilter.reset();
+    } else {
+      blockHashesFilter->insert(cachedBlock.getBlockHash());
+    }
+  }
+
+  if (spentKeyImagesFilter) {
+    for (const auto& keyImage : validatorState.spentKeyImages) {
+      if (spentKeyImagesFilter->isFull()) {
+        spentKeyImagesFilter.reset();
+        break;
+      }
+
+      spentKeyImagesFilter->insert(keyImage);
+    }
+  }
+
   unitsCache.push_back(blockInfo);
   if (unitsCache.size() > unitsCacheSize) {
     unitsCache.pop_front();
   }
 }
 
+void DatabaseBlockchainCache::buildBlockHashesFilter() const {
+  const size_t MIN_FILTER_CAPACITY = 1 << 16;
+  const size_t HASHES_PER_READ = 10000;
+
+  uint32_t blockCount = getTopBlockIndex() + 1;
+  logger(Logging::DEBUGGING) << "Building block hashes filter for " << blockCount << " blocks";
+
+  std::unique_ptr<BloomFilter> filter(new BloomFilter(std::max(MIN_FILTER_CAPACITY, size_t(blockCount) * 2)));
+  for (uint32_t startIndex = 0; startIndex < blockCount; startIndex += HASHES_PER_READ) {
+    for (const auto& hash : getBlockHashes(startIndex, HASHES_PER_READ)) {
+      filter->insert(hash);
+    }
+  }
+
+  blockHashesFilter = std::move(filter);
+}
+
+void DatabaseBlockchainCache::buildSpentKeyImagesFilter() const {
+  const size_t MIN_FILTER_CAPACITY = 1 << 16;
+  const uint32_t BLOCKS_PER_READ = 1000;
+
+  uint32_t blockCount = getTopBlockIndex() + 1;
+  logger(Logging::DEBUGGING) << "Building spent key images filter for " << blockCount << " blocks";
+
+  // Key images are not counted in the database, start from the transactions count and retry if it was too low
+  size_t capacity = std::max(MIN_FILTER_CAPACITY, static_cast<size_t>(getCachedTransactionsCount()) * 2);
+  for (;;) {
+    std::unique_ptr<BloomFilter> filter(new BloomFilter(capacity));
+    size_t keyImagesCount = 0;
+    for (uint32_t startIndex = 0; startIndex < blockCount; startIndex += BLOCKS_PER_READ) {
+      BlockchainReadBatch batch;
+      for (uint32_t blockIndex = startIndex; blockIndex < std::min(blockCount, startIndex + BLOCKS_PER_READ); ++blockIndex) {
+        batch.requestSpentKeyImagesByBlock(blockIndex);
+      }
+
+      auto result = readDatabase(batch);
+      for (const auto& blockKeyImages : result.getSpentKeyImagesByBlock()) {
+        for (const auto& keyImage : blockKeyImages.second) {
+          filter->insert(keyImage);
+        }
+
+        keyImagesCount += blockKeyImages.second.size();
+      }
+    }
+
+    if (!filter->isFull()) {
+      spentKeyImagesFilter = std::move(filter);
+      return;
+    }
+
+    capacity = keyImagesCount * 2;
+  }
+}
+
 PushedBlockInfo DatabaseBlockchainCache::getPushedBlockInfo(uint32_t blockIndex) const {
   return getExtendedPushedBlockInfo(blockIndex).pushedBlockInfo;
 }
 
 bool DatabaseBlockchainCache::checkIfSpent(const Crypto::KeyImage& keyImage, uint32_t blockIndex) const {
+  if (!spentKeyImagesFilter) {
+    buildSpentKeyImagesFilter();
+  }
+
+  if (!spentKeyImagesFilter->mayContain(keyImage)) {
+    return false;
+  }
+
   auto batch = BlockchainReadBatch().requestBlockIndexBySpentKeyImage(keyImage);
   auto res = database.read(batch);
   if (res) {
@@ -1255,6 +1453,14 @@ uint32_t DatabaseBlockchainCache::getBlockCount() const {
 }
 
 bool DatabaseBlockchainCache::hasBlock(const Crypto::Hash& blockHash) const {
+  if (!blockHashesFilter) {
+    buildBlockHashesFilter();
+  }
+
+  if (!blockHashesFilter->mayContain(blockHash)) {
+    return false;
+  }
+
   auto batch = BlockchainReadBatch().requestBlockIndexByBlockHash(blockHash);
   auto result = database.read(batch);
   return !result && batch.extractResult().getBlockIndexesByBlockHashes().count(blockHash);
@@ -1568,6 +1774,30 @@ bool DatabaseBlockchainCache::getTransactionGlobalIndexes(const Crypto::Hash& tr
   return true;
 }
 
+std::vector<std::vector<uint32_t>>
+DatabaseBlockchainCache::getTransactionsGlobalIndexes(const std::vector<Crypto::Hash>& transactionHashes) const {
+  BlockchainReadBatch batch;
+  for (const auto& hash : transactionHashes) {
+    batch.requestCachedTransaction(hash);
+  }
+
+  auto result = readDatabase(batch);
+  auto& cachedTransactions = result.getCachedTransactions();
+
+  std::vector<std::vector<uint32_t>> globalIndexes(transactionHashes.size());
+  for (size_t i = 0; i < transactionHashes.size(); ++i) {
+    auto it = cachedTransactions.find(transactionHashes[i]);
+    if (it == cachedTransactions.end()) {
+      logger(Logging::DEBUGGING) << "getTransactionsGlobalIndexes: cached transaction for hash " << transactionHashes[i] << " not present";
+      continue;
+    }
+
+    globalIndexes[i] = it->second.globalIndexes;
+  }
+
+  return globalIndexes;
+}
+
 size_t DatabaseBlockchainCache::getTransactionCount() const {
   return static_cast<size_t>(getCachedTransactionsCount());
 }
@@ -1586,10 +1816,147 @@ size_t DatabaseBlockchainCache::getChildCount() const {
   return children.size();
 }
 
+// In-memory caches of DatabaseBlockchainCache, valid only for the chain ending with topBlockHash
+struct DatabaseBlockchainCache::CacheSnapshot {
+  uint32_t topBlockIndex;
+  Crypto::Hash topBlockHash;
+  uint64_t transactionsCount;
+  uint32_t keyOutputAmountsCount;
+  uint32_t multiOutputAmountsCount;
+  std::unordered_map<Amount, int32_t> keyOutputCountsForAmounts;
+  std::unordered_map<Amount, int32_t> multiOutputCountsForAmounts;
+  std::vector<CachedBlockInfo> units;
+  std::unique_ptr<BloomFilter> blockHashesFilter;
+  std::unique_ptr<BloomFilter> spentKeyImagesFilter;
+
+  void serialize(ISerializer& s) {
+    s(topBlockIndex, "top_block_index");
+    s(topBlockHash, "top_block_hash");
+    s(transactionsCount, "transactions_count");
+    s(keyOutputAmountsCount, "key_output_amounts_count");
+    s(multiOutputAmountsCount, "multisignature_output_amounts_count");
+    s(keyOutputCountsForAmounts, "key_output_counts_for_amounts");
+    s(multiOutputCountsForAmounts, "multisignature_output_counts_for_amounts");
+    s(units, "units");
+    serializeFilter(blockHashesFilter, "block_hashes_filter", s);
+    serializeFilter(spentKeyImagesFilter, "spent_key_images_filter", s);
+  }
+
+  static void serializeFilter(std::unique_ptr<BloomFilter>& filter, const std::string& name, ISerializer& s) {
+    bool present = filter != nullptr;
+    s(present, name + "_present");
+    if (!present) {
+      return;
+    }
+
+    if (s.type() == ISerializer::INPUT) {
+      filter.reset(new BloomFilter(1));
+    }
+
+    s(*filter, name);
+  }
+};
+
 void DatabaseBlockchainCache::save() {
+  if (snapshotFilename.empty()) {
+    return;
+  }
+
+  CacheSnapshot snapshot;
+  snapshot.topBlockIndex = getTopBlockIndex();
+  snapshot.topBlockHash = getTopBlockHash();
+  snapshot.transactionsCount = getCachedTransactionsCount();
+
+  if (!keyOutputAmountsCount) {
+    keyOutputAmountsCount = readDatabase(BlockchainReadBatch().requestKeyOutputAmountsCount()).getKeyOutputAmountsCount();
+  }
+
+  if (!multiOutputAmountsCount) {
+    multiOutputAmountsCount = readDatabase(BlockchainReadBatch().requestMultisignatureOutputAmountsCount()).getMultisignatureOutputAmountsCount();
+  }
+
+  // units are cached for pushed blocks only, a node restarted recently would save few of them
+  if (unitsCache.size() < unitsCacheSize && unitsCache.size() < snapshot.topBlockIndex + 1) {
+    uint32_t cacheStart = snapshot.topBlockIndex + 1 - static_cast<uint32_t>(unitsCache.size());
+    auto dbUnits = getLastDbUnits(cacheStart - 1, unitsCacheSize - unitsCache.size(), UseGenesis{true});
+    unitsCache.insert(unitsCache.begin(), dbUnits.begin(), dbUnits.end());
+  }
+
+  snapshot.keyOutputAmountsCount = *keyOutputAmountsCount;
+  snapshot.multiOutputAmountsCount = *multiOutputAmountsCount;
+  snapshot.keyOutputCountsForAmounts = keyOutputCountsForAmounts;
+  snapshot.multiOutputCountsForAmounts = multiOutputCountsForAmounts;
+  snapshot.units.assign(unitsCache.begin(), unitsCache.end());
+  snapshot.blockHashesFilter = std::move(blockHashesFilter);
+  snapshot.spentKeyImagesFilter = std::move(spentKeyImagesFilter);
+
+  std::ofstream file(snapshotFilename, std::ios::binary | std::ios::trunc);
+  Common::StdOutputStream stream(file);
+  BinaryOutputStreamSerializer s(stream);
+
+  uint32_t version = CACHE_SNAPSHOT_VERSION;
+  s(version, "version");
+  s(snapshot, "snapshot");
+
+  blockHashesFilter = std::move(snapshot.blockHashesFilter);
+  spentKeyImagesFilter = std::move(snapshot.spentKeyImagesFilter);
+
+  file.flush();
+  if (!file) {
+    logger(Logging::WARNING) << "Failed to write cache snapshot to " << snapshotFilename;
+    return;
+  }
+
+  logger(Logging::INFO) << "Cache snapshot saved at block " << snapshot.topBlockIndex;
 }
 
 void DatabaseBlockchainCache::load() {
+  if (snapshotFilename.empty()) {
+    return;
+  }
+
+  std::ifstream file(snapshotFilename, std::ios::binary);
+  if (!file) {
+    logger(Logging::DEBUGGING) << "Cache snapshot " << snapshotFilename << " not found";
+    return;
+  }
+
+  CacheSnapshot snapshot;
+  try {
+    Common::StdInputStream stream(file);
+    BinaryInputStreamSerializer s(stream);
+
+    uint32_t version;
+    s(version, "version");
+    if (version != CACHE_SNAPSHOT_VERSION) {
+      logger(Logging::INFO) << "Cache snapshot version " << version << " is not supported, ignoring it";
+      return;
+    }
+
+    s(snapshot, "snapshot");
+  } catch (std::exception& e) {
+    logger(Logging::WARNING) << "Failed to read cache snapshot " << snapshotFilename << ": " << e.what();
+    return;
+  }
+
+  // the snapshot is written at shutdown, a node which crashed afterwards could have changed the chain
+  if (snapshot.topBlockIndex != getTopBlockIndex() || snapshot.topBlockHash != getTopBlockHash() ||
+      snapshot.units.size() > snapshot.topBlockIndex + 1 ||
+      (!snapshot.units.empty() && snapshot.units.back().blockHash != snapshot.topBlockHash)) {
+    logger(Logging::INFO) << "Cache snapshot doesn't match top block " << getTopBlockIndex() << ", ignoring it";
+    return;
+  }
+
+  transactionsCount = snapshot.transactionsCount;
+  keyOutputAmountsCount = snapshot.keyOutputAmountsCount;
+  multiOutputAmountsCount = snapshot.multiOutputAmountsCount;
+  keyOutputCountsForAmounts = std::move(snapshot.keyOutputCountsForAmounts);
+  multiOutputCountsForAmounts = std::move(snapshot.multiOutputCountsForAmounts);
+  unitsCache.assign(snapshot.units.begin(), snapshot.units.end());
+  blockHashesFilter = std::move(snapshot.blockHashesFilter);
+  spentKeyImagesFilter = std::move(snapshot.spentKeyImagesFilter);
+
+  logger(Logging::INFO) << "Caches are restored from snapshot at block " << snapshot.topBlockIndex;
 }
 
 std::vector<BinaryArray>
@@ -1657,6 +2024,24 @@ RawBlock DatabaseBlockchainCache::getBlockByIndex(uint32_t index) const {
   return std::move(res.getRawBlocks().at(index));
 }
 
+std::vector<RawBlock> DatabaseBlockchainCache::getBlocksByIndexes(const std::vector<uint32_t>& blockIndexes) const {
+  BlockchainReadBatch batch;
+  for (uint32_t index : blockIndexes) {
+    batch.requestRawBlock(index);
+  }
+
+  auto res = readDatabase(batch);
+  auto& rawBlocks = res.getRawBlocks();
+
+  std::vector<RawBlock> blocks;
+  blocks.reserve(blockIndexes.size());
+  for (uint32_t index : blockIndexes) {
+    blocks.push_back(rawBlocks.at(index));
+  }
+
+  return blocks;
+}
+
 BinaryArray DatabaseBlockchainCache::getRawTransaction(uint32_t blockIndex, uint32_t transactionIndex) const {
   return getBlockByIndex(blockIndex).transactions.at(transactionIndex);
 }
@@ -1796,6 +2181,97 @@ std::vector<Crypto::Hash> DatabaseBlockchainCache::getBlockHashesByTimestamps(ui
   return blockHashes;
 }
 
+bool DatabaseBlockchainCache::findTransactionSpendingKeyImage(const Crypto::KeyImage& keyImage, Crypto::Hash& transactionHash) const {
+  if (!explorerIndexes) {
+    return false;
+  }
+
+  auto result = readDatabase(BlockchainReadBatch().requestSpendingTransaction(keyImage));
+  auto it = result.getSpendingTransactionsByKeyImages().find(keyImage);
+  if (it == result.getSpendingTransactionsByKeyImages().end()) {
+    return false;
+  }
+
+  transactionHash = it->second;
+  return true;
+}
+
+bool DatabaseBlockchainCache::findTransactionByOutputKey(const Crypto::PublicKey& outputKey, Crypto::Hash& transactionHash, uint16_t& outputIndex) const {
+  if (!explorerIndexes) {
+    return false;
+  }
+
+  auto result = readDatabase(BlockchainReadBatch().requestOutputKeyReference(outputKey));
+  auto it = result.getOutputKeyReferences().find(outputKey);
+  if (it == result.getOutputKeyReferences().end()) {
+    return false;
+  }
+
+  transactionHash = it->second.transactionHash;
+  outputIndex = it->second.outputIndex;
+  return true;
+}
+
+ExplorerIndexesStatus DatabaseBlockchainCache::getExplorerIndexesStatus() const {
+  if (!explorerIndexes) {
+    return ExplorerIndexesStatus::DISABLED;
+  }
+
+  return explorerIndexesState.backfilledBlockCount < explorerIndexesState.maintainedFromBlockIndex ?
+    ExplorerIndexesStatus::BUILDING : ExplorerIndexesStatus::READY;
+}
+
+bool DatabaseBlockchainCache::buildExplorerIndexes(uint32_t blockCount) {
+  if (getExplorerIndexesStatus() != ExplorerIndexesStatus::BUILDING) {
+    return false;
+  }
+
+  uint32_t startIndex = explorerIndexesState.backfilledBlockCount;
+  uint32_t endIndex = std::min(startIndex + blockCount, explorerIndexesState.maintainedFromBlockIndex);
+
+  BlockchainReadBatch readBatch;
+  for (uint32_t blockIndex = startIndex; blockIndex < endIndex; ++blockIndex) {
+    readBatch.requestRawBlock(blockIndex);
+  }
+
+  auto readResult = readDatabase(readBatch);
+  BlockchainWriteBatch writeBatch;
+  for (uint32_t blockIndex = startIndex; blockIndex < endIndex; ++blockIndex) {
+    const auto& rawBlock = readResult.getRawBlocks().at(blockIndex);
+
+    BlockTemplate block;
+    std::vector<CachedTransaction> transactions;
+    if (!fromBinaryArray(block, rawBlock.block) || !Utils::restoreCachedTransactions(rawBlock.transactions, transactions)) {
+      logger(Logging::ERROR) << "Failed to parse block " << blockIndex << " while building explorer indexes";
+      throw std::runtime_error("Couldn't parse raw block");
+    }
+
+    insertExplorerIndexes(writeBatch, CachedTransaction(std::move(block.baseTransaction)));
+    for (const auto& transaction : transactions) {
+      insertExplorerIndexes(writeBatch, transaction);
+    }
+  }
+
+  ExplorerIndexesState state = explorerIndexesState;
+  state.backfilledBlockCount = endIndex;
+  writeBatch.insertExplorerIndexesState(state);
+
+  auto err = database.write(writeBatch);
+  if (err) {
+    logger(Logging::ERROR) << "Explorer indexes write failed: " << err.message();
+    throw std::runtime_error(err.message());
+  }
+
+  explorerIndexesState = state;
+  if (getExplorerIndexesStatus() == ExplorerIndexesStatus::READY) {
+    logger(Logging::INFO) << "Explorer indexes are built";
+    return false;
+  }
+
+  logger(Logging::DEBUGGING) << "Explorer indexes are built for " << endIndex << " of " << explorerIndexesState.maintainedFromBlockIndex << " blocks";
+  return true;
+}
+
 DatabaseBlockchainCache::ExtendedPushedBlockInfo DatabaseBlockchainCache::getExtendedPushedBlockInfo(uint32_t blockIndex) const {
   assert(blockIndex <= getTopBlockIndex());
 
@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "Common/StringView.h"
+#include "BloomFilter.h"
 #include "Currency.h"
 #include "Difficulty.h"
 #include "IBlockchainCache.h"
@@ -46,7 +49,8 @@ public:
    * BlockchainCache objects as children are supported.
    */
   DatabaseBlockchainCache(const Currency& currency, IDataBase& dataBase,
-                          IBlockchainCacheFactory& blockchainCacheFactory, Logging::ILogger& logger);
+                          IBlockchainCacheFactory& blockchainCacheFactory, Logging::ILogger& logger,
+                          bool explorerIndexes = false, const std::string& snapshotFilename = std::string());
 
   /*
    * This methods splits cache, upper part (ie blocks with indexes larger than splitBlockIndex)
@@ -129,6 +133,8 @@ public:
   virtual uint32_t getTimestampLowerBoundBlockIndex(uint64_t timestamp) const override;
   virtual bool getTransactionGlobalIndexes(const Crypto::Hash& transactionHash,
                                            std::vector<uint32_t>& globalIndexes) const override;
+  virtual std::vector<std::vector<uint32_t>>
+  getTransactionsGlobalIndexes(const std::vector<Crypto::Hash>& transactionHashes) const override;
   virtual size_t getTransactionCount() const override;
   virtual void addSpentMultisignature(uint64_t amount, uint32_t globalIndex, uint32_t blockIndex) override;
   virtual uint32_t getBlockIndexContainingTx(const Crypto::Hash& transactionHash) const override;
@@ -146,6 +152,10 @@ public:
   virtual void addChild(IBlockchainCache* ptr) override;
   virtual bool deleteChild(IBlockchainCache* ptr) override;
 
+  /*
+   * Saves in-memory caches to the snapshot file, load() restores them if the snapshot matches the top block,
+   * so that a restarted node doesn't read them key by key from the database. No-op without snapshot file name
+   */
   virtual void save() override;
   virtual void load() override;
 
@@ -155,6 +165,7 @@ public:
   void getRawTransactions(const std::vector<Crypto::Hash>& transactions, std::vector<BinaryArray>& foundTransactions,
                           std::vector<Crypto::Hash>& missedTransactions) const override;
   virtual RawBlock getBlockByIndex(uint32_t index) const override;
+  virtual std::vector<RawBlock> getBlocksByIndexes(const std::vector<uint32_t>& blockIndexes) const override;
   virtual BinaryArray getRawTransaction(uint32_t blockIndex, uint32_t transactionIndex) const override;
   virtual std::vector<Crypto::Hash> getTransactionHashes() const override;
   virtual std::vector<uint32_t> getRandomOutsByAmount(uint64_t amount, size_t count,
@@ -167,6 +178,15 @@ public:
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const override;
 
+  virtual bool findTransactionSpendingKeyImage(const Crypto::KeyImage& keyImage, Crypto::Hash& transactionHash) const override;
+  virtual bool findTransactionByOutputKey(const Crypto::PublicKey& outputKey, Crypto::Hash& transactionHash, uint16_t& outputIndex) const override;
+  virtual ExplorerIndexesStatus getExplorerIndexesStatus() const override;
+  /*
+   * Indexes blocks which were stored before explorer indexes were enabled, lowest blocks first.
+   * Blocks pushed meanwhile are indexed in pushBlock
+   */
+  virtual bool buildExplorerIndexes(uint32_t blockCount) override;
+
 private:
   const Currency& currency;
   IDataBase& database;
@@ -182,12 +202,24 @@ private:
   Logging::LoggerRef logger;
   std::deque<CachedBlockInfo> unitsCache;
   const size_t unitsCacheSize = 1000;
+  // Answers hasBlock for unknown hashes (new blocks from peers, alternative blocks) without a database read.
+  // Built on first use, split blocks stay in it as false positives
+  mutable std::unique_ptr<BloomFilter> blockHashesFilter;
+  // Answers checkIfSpent for unspent key images, which is the common case of transaction validation.
+  // Built on first use, key images of split blocks stay in it as false positives
+  mutable std::unique_ptr<BloomFilter> spentKeyImagesFilter;
+  const bool explorerIndexes;
+  ExplorerIndexesState explorerIndexesState;
+  const std::string snapshotFilename;
 
   struct ExtendedPushedBlockInfo;
+  struct CacheSnapshot;
   ExtendedPushedBlockInfo getExtendedPushedBlockInfo(uint32_t blockIndex) const;
 
   void deleteClosestTimestampBlockIndex(BlockchainWriteBatch& writeBatch, uint32_t splitBlockIndex);
   CachedBlockInfo getCachedBlockInfo(uint32_t index) const;
+  void buildBlockHashesFilter() const;
+  void buildSpentKeyImagesFilter() const;
   BlockchainReadResult readDatabase(BlockchainReadBatch& batch) const;
 
   void addSpentKeyImage(const Crypto::KeyImage& keyImage, uint32_t blockIndex);
@@ -202,6 +234,8 @@ private:
   uint32_t updateMultiOutputCount(Amount amount, int32_t diff) const;
   void insertPaymentId(BlockchainWriteBatch& batch, const Crypto::Hash& transactionHash, const Crypto::Hash& paymentId);
   void insertBlockTimestamp(BlockchainWriteBatch& batch, uint64_t timestamp, const Crypto::Hash& blockHash);
+  void insertExplorerIndexes(BlockchainWriteBatch& batch, const CachedTransaction& cachedTransaction);
+  void initExplorerIndexesState();
 
   void addGenesisBlock(CachedBlock&& genesisBlock);
 
@@ -223,6 +257,8 @@ private:
   void requestDeleteTransactions(BlockchainWriteBatch& writeBatch, const std::vector<Crypto::Hash>& transactionHashes);
   void requestDeletePaymentIds(BlockchainWriteBatch& writeBatch, const std::vector<Crypto::Hash>& transactionHashes);
   void requestDeletePaymentId(BlockchainWriteBatch& writeBatch, const Crypto::Hash& paymentId, size_t toDelete);
+  void requestDeleteExplorerIndexes(BlockchainWriteBatch& writeBatch, uint32_t splitBlockIndex, const std::vector<Crypto::KeyImage>& keyImages,
+                                    const std::vector<ExtendedTransactionInfo>& transactions);
   void requestDeleteKeyOutputs(BlockchainWriteBatch& writeBatch, const std::map<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex>& boundaries);
   void requestDeleteKeyOutputsAmount(BlockchainWriteBatch& writeBatch, IBlockchainCache::Amount amount, IBlockchainCache::GlobalOutputIndex boundary, uint32_t outputsCount);
   void requestDeleteMultisignatureOutputs(BlockchainWriteBatch& writeBatch, const std::map<IBlockchainCache::Amount, IBlockchainCache::GlobalOutputIndex>& boundaries);
@@ -26,7 +26,8 @@ class IDataBase;
 
 class DatabaseBlockchainCacheFactory: public IBlockchainCacheFactory {
 public:
-  explicit DatabaseBlockchainCacheFactory(IDataBase& database, Logging::ILogger& logger);
+  explicit DatabaseBlockchainCacheFactory(IDataBase& database, Logging::ILogger& logger, bool explorerIndexes = false,
+    const std::string& snapshotFilename = std::string());
   virtual ~DatabaseBlockchainCacheFactory();
 
   virtual std::unique_ptr<IBlockchainCache> createRootBlockchainCache(const Currency& currency) override;
@@ -35,6 +36,8 @@ public:
 private:
   IDataBase& database;
   Logging::ILogger& logger;
+  bool explorerIndexes;
+  std::string snapshotFilename;
 };
 
 } //namespace CryptoNote
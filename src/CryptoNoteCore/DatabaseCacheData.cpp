@@ -35,4 +35,14 @@ void KeyOutputInfo::serialize(ISerializer& s) {
   s(outputIndex, "output_index");
 }
 
+void OutputKeyReference::serialize(ISerializer& s) {
+  s(transactionHash, "transaction_hash");
+  s(outputIndex, "output_index");
+}
+
+void ExplorerIndexesState::serialize(ISerializer& s) {
+  s(backfilledBlockCount, "backfilled_block_count");
+  s(maintainedFromBlockIndex, "maintained_from_block_index");
+}
+
 }
@@ -31,6 +31,21 @@ struct KeyOutputInfo {
   void serialize(CryptoNote::ISerializer& s);
 };
 
+struct OutputKeyReference {
+  Crypto::Hash transactionHash;
+  uint16_t outputIndex;
+
+  void serialize(CryptoNote::ISerializer& s);
+};
+
+// Blocks below backfilledBlockCount and from maintainedFromBlockIndex on are in the explorer indexes
+struct ExplorerIndexesState {
+  uint32_t backfilledBlockCount;
+  uint32_t maintainedFromBlockIndex;
+
+  void serialize(CryptoNote::ISerializer& s);
+};
+
 // inherit here to avoid breaking IBlockchainCache interface
 struct ExtendedTransactionInfo : CachedTransactionInfo {
   //CachedTransactionInfo tx;
@@ -39,6 +39,12 @@ enum class ExtractOutputKeysResult {
   OUTPUT_LOCKED
 };
 
+enum class ExplorerIndexesStatus {
+  DISABLED,
+  BUILDING,
+  READY
+};
+
 union PackedOutIndex {
   struct {
     uint32_t blockIndex;
@@ -84,6 +90,7 @@ public:
   virtual ~IBlockchainCache() {}
 
   virtual RawBlock getBlockByIndex(uint32_t index) const = 0;
+  virtual std::vector<RawBlock> getBlocksByIndexes(const std::vector<uint32_t>& blockIndexes) const = 0;
   virtual BinaryArray getRawTransaction(uint32_t blockIndex, uint32_t transactionIndex) const = 0;
   virtual std::unique_ptr<IBlockchainCache> split(uint32_t splitBlockIndex) = 0;
   virtual void pushBlock(
@@ -169,6 +176,8 @@ public:
 
   //NOTE: not recursive!
   virtual bool getTransactionGlobalIndexes(const Crypto::Hash& transactionHash, std::vector<uint32_t>& globalIndexes) const = 0;
+  //NOTE: not recursive! Indexes of missing transactions are left empty
+  virtual std::vector<std::vector<uint32_t>> getTransactionsGlobalIndexes(const std::vector<Crypto::Hash>& transactionHashes) const = 0;
 
   virtual size_t getTransactionCount() const = 0;
 
@@ -188,6 +197,13 @@ public:
 
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const = 0;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const = 0;
+
+  // Explorer indexes, lookups are meaningful only if the root segment reports ExplorerIndexesStatus::READY
+  virtual bool findTransactionSpendingKeyImage(const Crypto::KeyImage& keyImage, Crypto::Hash& transactionHash) const = 0;
+  virtual bool findTransactionByOutputKey(const Crypto::PublicKey& outputKey, Crypto::Hash& transactionHash, uint16_t& outputIndex) const = 0;
+  virtual ExplorerIndexesStatus getExplorerIndexesStatus() const = 0;
+  // Indexes up to blockCount more blocks stored before the indexes were enabled, returns false if nothing is left
+  virtual bool buildExplorerIndexes(uint32_t blockCount) = 0;
 };
 
 }
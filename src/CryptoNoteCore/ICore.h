@@ -95,6 +95,12 @@ public:
   virtual bool getPoolChangesLite(const Crypto::Hash& lastBlockHash, const std::vector<Crypto::Hash>& knownHashes,
                                   std::vector<TransactionPrefixInfo>& addedTransactions,
                                   std::vector<Crypto::Hash>& deletedTransactions) const = 0;
+  // If the pool still remembers poolVersion, returns changes since it and sets isDelta, otherwise returns the difference with knownHashes.
+  // poolVersion is updated to the current pool version in both cases
+  virtual bool getPoolChangesLiteSince(const Crypto::Hash& lastBlockHash, uint64_t& poolVersion,
+                                       const std::vector<Crypto::Hash>& knownHashes,
+                                       std::vector<TransactionPrefixInfo>& addedTransactions,
+                                       std::vector<Crypto::Hash>& deletedTransactions, bool& isDelta) const = 0;
 
   virtual bool getBlockTemplate(BlockTemplate& b, const AccountPublicAddress& adr, const BinaryArray& extraNonce,
                                 Difficulty& difficulty, uint32_t& height) const = 0;
@@ -105,9 +111,13 @@ public:
   virtual void load() = 0;
 
   virtual BlockDetails getBlockDetails(const Crypto::Hash& blockHash) const = 0;
+  virtual std::vector<BlockDetails> getBlocksDetails(const std::vector<Crypto::Hash>& blockHashes) const = 0;
   virtual TransactionDetails getTransactionDetails(const Crypto::Hash& transactionHash) const = 0;
   virtual std::vector<Crypto::Hash> getAlternativeBlockHashesByIndex(uint32_t blockIndex) const = 0;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const = 0;
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const = 0;
+  // Main chain lookups in explorer indexes, NULL_HASH stands for a key which isn't found
+  virtual std::vector<Crypto::Hash> getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages) const = 0;
+  virtual std::vector<Crypto::Hash> getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys) const = 0;
 };
 }
@@ -37,6 +37,15 @@ public:
 
   virtual uint64_t getTransactionReceiveTime(const Crypto::Hash& hash) const = 0;
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const = 0;
+
+  virtual uint64_t getTransactionsSize() const = 0;
+  virtual uint64_t getEvictedTransactionCount() const = 0;
+  // Transactions evicted to keep the pool within its limits since the previous call
+  virtual std::vector<Crypto::Hash> takeEvictedTransactions() = 0;
+  // Changes whenever a transaction is added to or removed from the pool
+  virtual uint64_t getGeneration() const = 0;
+  // Net changes between the given generation and the current one, false if the generation is too old or unknown
+  virtual bool getChangesSince(uint64_t generation, std::vector<Crypto::Hash>& addedTransactions, std::vector<Crypto::Hash>& removedTransactions) const = 0;
 };
 
 }
@@ -17,6 +17,7 @@
 
 #include "Miner.h"
 
+#include <algorithm>
 #include <future>
 #include <numeric>
 #include <sstream>
@@ -52,6 +53,7 @@ namespace CryptoNote
     m_handler(handler),
     m_pausers_count(0),
     m_threads_total(0),
+    m_hashes_per_thread(1),
     m_starter_nonce(0),
     m_last_hr_merge_time(0),
     m_hashes(0),
@@ -208,6 +210,12 @@ namespace CryptoNote
       }
     }
 
+    if (config.miningHashesPerThread == 0 || config.miningHashesPerThread > Crypto::SLOW_HASH_MAX_MULTI_COUNT) {
+      logger(ERROR) << "Mining hashes per thread must be 1.." << Crypto::SLOW_HASH_MAX_MULTI_COUNT << ", got " << config.miningHashesPerThread;
+      return false;
+    }
+    m_hashes_per_thread = config.miningHashesPerThread;
+
     return true;
   }
   //-----------------------------------------------------------------------------------------------------
@@ -376,8 +384,14 @@ namespace CryptoNote
     uint32_t nonce = m_starter_nonce + th_local_index;
     Difficulty local_diff = 0;
     uint32_t local_template_ver = 0;
-    Crypto::cn_context context;
-    BlockTemplate b;
+    // Lane i hashes nonce + i * m_threads_total, so sequences of all threads still don't intersect
+    Crypto::cn_multi_context context(m_hashes_per_thread);
+    std::vector<BlockTemplate> blocks(m_hashes_per_thread);
+    std::vector<CachedBlock> cachedBlocks;
+    cachedBlocks.reserve(m_hashes_per_thread);
+    std::vector<const void*> hashingData(m_hashes_per_thread);
+    std::vector<size_t> hashingDataLengths(m_hashes_per_thread);
+    std::vector<Crypto::Hash> hashes(m_hashes_per_thread);
 
     while(!m_stop)
     {
@@ -389,7 +403,7 @@ namespace CryptoNote
 
       if(local_template_ver != m_template_no) {
         std::unique_lock<std::mutex> lk(m_template_lock);
-        b = m_template;
+        std::fill(blocks.begin(), blocks.end(), m_template);
         local_diff = m_diffic;
         lk.unlock();
 
@@ -404,36 +418,43 @@ namespace CryptoNote
         continue;
       }
 
-      b.nonce = nonce;
-      Crypto::Hash h;
-
-      CachedBlock cb(b);
       if (!m_stop) {
         try {
-          h = cb.getBlockLongHash(context);
+          cachedBlocks.clear();
+          for (size_t i = 0; i < blocks.size(); ++i) {
+            blocks[i].nonce = nonce + static_cast<uint32_t>(i) * m_threads_total;
+            cachedBlocks.emplace_back(blocks[i]);
+            const auto& hashingBlob = cachedBlocks.back().getBlockLongHashingBinaryArray();
+            hashingData[i] = hashingBlob.data();
+            hashingDataLengths[i] = hashingBlob.size();
+          }
+
+          Crypto::cn_slow_hash_multi(context, hashingData.data(), hashingDataLengths.data(), hashes.data());
         } catch (std::exception& e) {
           logger(ERROR) << "getBlockLongHash failed: " << e.what();
           m_stop = true;
         }
       }
 
-      if (!m_stop && check_hash(h, local_diff))
-      {
-        //we lucky!
-        ++m_config.current_extra_message_index;
+      for (size_t i = 0; i < blocks.size() && !m_stop; ++i) {
+        if (check_hash(hashes[i], local_diff))
+        {
+          //we lucky!
+          ++m_config.current_extra_message_index;
 
-        logger(INFO, GREEN) << "Found block for difficulty: " << local_diff;
+          logger(INFO, GREEN) << "Found block for difficulty: " << local_diff;
 
-        if(!m_handler.handle_block_found(b)) {
-          --m_config.current_extra_message_index;
-        } else {
-          //success update, lets update config
-          Common::saveStringToFile(m_config_folder_path + "/" + CryptoNote::parameters::MINER_CONFIG_FILE_NAME, storeToJson(m_config));
+          if(!m_handler.handle_block_found(blocks[i])) {
+            --m_config.current_extra_message_index;
+          } else {
+            //success update, lets update config
+            Common::saveStringToFile(m_config_folder_path + "/" + CryptoNote::parameters::MINER_CONFIG_FILE_NAME, storeToJson(m_config));
+          }
         }
       }
 
-      nonce += m_threads_total;
-      ++m_hashes;
+      nonce += static_cast<uint32_t>(blocks.size()) * m_threads_total;
+      m_hashes += blocks.size();
     }
     logger(INFO) << "Miner thread stopped ["<< th_local_index << "]";
     return true;
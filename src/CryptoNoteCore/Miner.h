@@ -79,6 +79,7 @@ namespace CryptoNote {
     Difficulty m_diffic;
 
     std::atomic<uint32_t> m_threads_total;
+    size_t m_hashes_per_thread;
     std::atomic<int32_t> m_pausers_count;
     std::mutex m_miners_count_lock;
 
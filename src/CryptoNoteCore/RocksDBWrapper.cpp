@@ -17,12 +17,18 @@
 
 #include "RocksDBWrapper.h"
 
+#include <algorithm>
+
 #include "rocksdb/cache.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/db.h"
 #include "rocksdb/utilities/backupable_db.h"
 
+#include "Common/Metrics.h"
 #include "DataBaseErrors.h"
+#include "DBUtils.h"
 
 using namespace CryptoNote;
 using namespace Logging;
@@ -30,14 +36,46 @@ using namespace Logging;
 namespace {
   const std::string DB_NAME = "DB";
   const std::string TESTNET_DB_NAME = "testnet_DB";
+
+  const std::string RAW_BLOCKS_FAMILY = "raw_blocks";
+  const std::string KEY_IMAGES_FAMILY = "key_images";
+  const std::string OUTPUTS_FAMILY = "outputs";
+  const std::string EXPLORER_INDEXES_FAMILY = "explorer_indexes";
+
+  // Column families following the default one in RocksDBWrapper::columnFamilies, the default family holds every prefix not listed in PREFIX_FAMILIES
+  const std::string DEDICATED_FAMILIES[] = { RAW_BLOCKS_FAMILY, KEY_IMAGES_FAMILY, OUTPUTS_FAMILY, EXPLORER_INDEXES_FAMILY };
+
+  // indexes in RocksDBWrapper::columnFamilies
+  const std::pair<std::string, size_t> PREFIX_FAMILIES[] = {
+    { "4", 1 }, // raw blocks
+    { "7", 2 }, // key image to block index
+    { "b", 3 }, // key output amounts
+    { "j", 3 }, // key output keys
+    { "k", 4 }, // key image to spending transaction hash
+    { "l", 4 }  // output key to transaction hash
+  };
+
+  const int BLOOM_FILTER_BITS_PER_KEY = 10;
+
+  Common::MetricHistogram& readDuration() {
+    static Common::MetricHistogram& histogram = Common::MetricsRegistry::instance().histogram(
+      "rocksdb_read_duration_microseconds", "Time of RocksDB read batches");
+    return histogram;
+  }
+
+  Common::MetricHistogram& writeDuration() {
+    static Common::MetricHistogram& histogram = Common::MetricsRegistry::instance().histogram(
+      "rocksdb_write_duration_microseconds", "Time of RocksDB write batches");
+    return histogram;
+  }
 }
 
-RocksDBWrapper::RocksDBWrapper(Logging::ILogger& logger) : logger(logger, "RocksDBWrapper"), state(NOT_INITIALIZED){
+RocksDBWrapper::RocksDBWrapper(Logging::ILogger& logger) : logger(logger, "RocksDBWrapper"), profile(DataBaseConfig::Profile::SERVING), state(NOT_INITIALIZED){
 
 }
 
 RocksDBWrapper::~RocksDBWrapper() {
-
+  closeColumnFamilies();
 }
 
 void RocksDBWrapper::init(const DataBaseConfig& config) {
@@ -52,29 +90,100 @@ void RocksDBWrapper::init(const DataBaseConfig& config) {
     dataDir = config.getDataDir() + '/' + DB_NAME;
   }
 
-  logger(INFO) << "Opening DB in " << dataDir;
-
-  rocksdb::DB* dbPtr;
+  profile = config.getProfile();
+  logger(INFO) << "Opening DB in " << dataDir << " with " << DataBaseConfig::profileToString(profile) << " profile";
 
   rocksdb::DBOptions dbOptions;
   dbOptions.IncreaseParallelism(config.getBackgroundThreadsCount());
   dbOptions.info_log_level = rocksdb::InfoLogLevel::WARN_LEVEL;
   dbOptions.max_open_files = config.getMaxOpenFiles();
+  statistics = rocksdb::CreateDBStatistics();
+  dbOptions.statistics = statistics;
+
+  blockCache = rocksdb::NewLRUCache(config.getReadCacheSize());
 
+  std::vector<std::string> existingFamilies;
+  std::vector<std::string> familyNames = { rocksdb::kDefaultColumnFamilyName };
+  rocksdb::Status status = rocksdb::DB::ListColumnFamilies(dbOptions, dataDir, &existingFamilies);
+  if (status.ok() && existingFamilies.size() == 1) {
+    logger(WARNING) << "DB in " << dataDir << " keeps all data in one column family. "
+      "Remove it and resynchronize to get per family tuning";
+  } else {
+    if (!status.ok()) {
+      logger(INFO) << "DB not found in " << dataDir << ". Creating new DB...";
+    }
+
+    familyNames.insert(familyNames.end(), std::begin(DEDICATED_FAMILIES), std::end(DEDICATED_FAMILIES));
+    dbOptions.create_if_missing = true;
+    dbOptions.create_missing_column_families = true;
+  }
+
+  status = open(dbOptions, config, dataDir, familyNames, true);
+  if (status.IsInvalidArgument()) {
+    logger(INFO) << "Raw blocks compression is not available: " << status.ToString() << " Opening DB without compression";
+    status = open(dbOptions, config, dataDir, familyNames, false);
+  }
+
+  if (!status.ok()) {
+    logger(ERROR) << "DB Error. DB can't be opened in " << dataDir << ". Error: " << status.ToString();
+    throw std::system_error(make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR));
+  }
+
+  logger(INFO) << "DB opened in " << dataDir;
+  state.store(INITIALIZED);
+}
+
+rocksdb::Status RocksDBWrapper::open(const rocksdb::DBOptions& dbOptions, const DataBaseConfig& config, const std::string& dataDir,
+  const std::vector<std::string>& familyNames, bool compress) {
+  std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+  for (const std::string& name : familyNames) {
+    descriptors.emplace_back(name, getColumnFamilyOptions(config, name, compress));
+  }
+
+  rocksdb::DB* dbPtr = nullptr;
+  rocksdb::Status status = rocksdb::DB::Open(dbOptions, dataDir, descriptors, &columnFamilies, &dbPtr);
+  if (status.ok()) {
+    db.reset(dbPtr);
+  }
+
+  return status;
+}
+
+rocksdb::ColumnFamilyOptions RocksDBWrapper::getColumnFamilyOptions(const DataBaseConfig& config, const std::string& columnFamily, bool compress) const {
   rocksdb::ColumnFamilyOptions fOptions;
   fOptions.write_buffer_size = static_cast<size_t>(config.getWriteBufferSize());
-  // merge two memtables when flushing to L0
-  fOptions.min_write_buffer_number_to_merge = 2;
-  // this means we'll use 50% extra memory in the worst case, but will reduce
-  // write stalls.
-  fOptions.max_write_buffer_number = 6;
-  // start flushing L0->L1 as soon as possible. each file on level0 is
-  // (memtable_memory_budget / 2). This will flush level 0 when it's bigger than
-  // memtable_memory_budget.
-  fOptions.level0_file_num_compaction_trigger = 20;
-
-  fOptions.level0_slowdown_writes_trigger = 30;
-  fOptions.level0_stop_writes_trigger = 40;
+
+  switch (profile) {
+  case DataBaseConfig::Profile::BULK_SYNC:
+    // merge two memtables when flushing to L0
+    fOptions.min_write_buffer_number_to_merge = 2;
+    // this means we'll use 50% extra memory in the worst case, but will reduce
+    // write stalls.
+    fOptions.max_write_buffer_number = 6;
+    // start flushing L0->L1 as soon as possible. each file on level0 is
+    // (memtable_memory_budget / 2). This will flush level 0 when it's bigger than
+    // memtable_memory_budget.
+    fOptions.level0_file_num_compaction_trigger = 20;
+
+    fOptions.level0_slowdown_writes_trigger = 30;
+    fOptions.level0_stop_writes_trigger = 40;
+    break;
+  case DataBaseConfig::Profile::SERVING:
+    // few L0 files, so that a point lookup checks as few tables as possible
+    fOptions.min_write_buffer_number_to_merge = 1;
+    fOptions.max_write_buffer_number = 4;
+    fOptions.level0_file_num_compaction_trigger = 4;
+    fOptions.level0_slowdown_writes_trigger = 20;
+    fOptions.level0_stop_writes_trigger = 36;
+    break;
+  case DataBaseConfig::Profile::LOW_MEMORY:
+    fOptions.min_write_buffer_number_to_merge = 1;
+    fOptions.max_write_buffer_number = 2;
+    fOptions.level0_file_num_compaction_trigger = 4;
+    fOptions.level0_slowdown_writes_trigger = 20;
+    fOptions.level0_stop_writes_trigger = 36;
+    break;
+  }
 
   // doesn't really matter much, but we don't want to create too many files
   fOptions.target_file_size_base = config.getWriteBufferSize() / 10;
@@ -87,32 +196,28 @@ void RocksDBWrapper::init(const DataBaseConfig& config) {
 
   fOptions.compression_per_level.resize(fOptions.num_levels);
   for (int i = 0; i < fOptions.num_levels; ++i) {
+    // raw blocks are written once and rarely read, compress them below the two hot levels
+    if (compress && columnFamily == RAW_BLOCKS_FAMILY && i >= 2) {
+      fOptions.compression_per_level[i] = rocksdb::kSnappyCompression;
+    } else {
       fOptions.compression_per_level[i] = rocksdb::kNoCompression;
+    }
   }
 
   rocksdb::BlockBasedTableOptions tableOptions;
-  tableOptions.block_cache = rocksdb::NewLRUCache(config.getReadCacheSize());
+  tableOptions.block_cache = blockCache;
+  // key images and outputs are looked up by keys which often are not in the data base
+  if (columnFamily == KEY_IMAGES_FAMILY || columnFamily == OUTPUTS_FAMILY || columnFamily == EXPLORER_INDEXES_FAMILY) {
+    tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(BLOOM_FILTER_BITS_PER_KEY, false));
+  }
+
+  // charge index and filter blocks to the block cache instead of keeping them all in memory
+  tableOptions.cache_index_and_filter_blocks = profile == DataBaseConfig::Profile::LOW_MEMORY;
+
   std::shared_ptr<rocksdb::TableFactory> tfp(NewBlockBasedTableFactory(tableOptions));
   fOptions.table_factory = tfp;
 
-  rocksdb::Status status = rocksdb::DB::Open(rocksdb::Options(dbOptions, fOptions), dataDir, &dbPtr);
-  if (status.ok()) {
-    logger(INFO) << "DB opened in " << dataDir;
-  } else if (!status.ok() || status.IsNotFound()) {
-    logger(INFO) << "DB not found in " << dataDir << ". Creating new DB...";
-    dbOptions.create_if_missing = true;
-    rocksdb::Status status = rocksdb::DB::Open(rocksdb::Options(dbOptions, fOptions), dataDir, &dbPtr);
-    if (!status.ok()) {
-      logger(ERROR) << "DB Error. DB can't be created in " << dataDir << ". Error: " << status.ToString();
-      throw std::system_error(make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR));
-    }
-  } else {
-    logger(ERROR) << "DB Error. DB can't be opened in " << dataDir << ". Error: " << status.ToString();
-    throw std::system_error(make_error_code(CryptoNote::error::DataBaseErrorCodes::INTERNAL_ERROR));
-  }
-
-  db.reset(dbPtr);
-  state.store(INITIALIZED);
+  return fOptions;
 }
 
 void RocksDBWrapper::shutdown() {
@@ -121,12 +226,71 @@ void RocksDBWrapper::shutdown() {
   }
 
   logger(INFO) << "Closing DB.";
-  db->Flush(rocksdb::FlushOptions());
+  for (rocksdb::ColumnFamilyHandle* columnFamily : columnFamilies) {
+    db->Flush(rocksdb::FlushOptions(), columnFamily);
+  }
+
   db->SyncWAL();
+  closeColumnFamilies();
   db.reset();
   state.store(NOT_INITIALIZED);
 }
 
+void RocksDBWrapper::closeColumnFamilies() {
+  for (rocksdb::ColumnFamilyHandle* columnFamily : columnFamilies) {
+    delete columnFamily;
+  }
+
+  columnFamilies.clear();
+}
+
+rocksdb::ColumnFamilyHandle* RocksDBWrapper::getColumnFamily(const std::string& rawKey) const {
+  if (columnFamilies.size() == 1) {
+    return columnFamilies.front();
+  }
+
+  std::string prefix = DB::getKeyPrefix(rawKey);
+  auto it = std::find_if(std::begin(PREFIX_FAMILIES), std::end(PREFIX_FAMILIES),
+    [&prefix](const std::pair<std::string, size_t>& family) { return family.first == prefix; });
+
+  return it == std::end(PREFIX_FAMILIES) ? columnFamilies.front() : columnFamilies[it->second];
+}
+
+DataBaseConfig::Profile RocksDBWrapper::getProfile() const {
+  return profile;
+}
+
+bool RocksDBWrapper::hasColumnFamilies() const {
+  return columnFamilies.size() > 1;
+}
+
+DataBaseStatistics RocksDBWrapper::getStatistics() const {
+  if (state.load() != INITIALIZED) {
+    throw std::system_error(make_error_code(CryptoNote::error::DataBaseErrorCodes::NOT_INITIALIZED));
+  }
+
+  DataBaseStatistics result;
+  result.blockCacheHits = statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+  result.blockCacheMisses = statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS);
+  result.bloomFilterUseful = statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+  result.stallMicros = statistics->getTickerCount(rocksdb::STALL_MICROS);
+  result.pendingCompactionBytes = 0;
+  result.memTablesSize = 0;
+
+  for (rocksdb::ColumnFamilyHandle* columnFamily : columnFamilies) {
+    uint64_t value;
+    if (db->GetIntProperty(columnFamily, rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &value)) {
+      result.pendingCompactionBytes += value;
+    }
+
+    if (db->GetIntProperty(columnFamily, rocksdb::DB::Properties::kCurSizeAllMemTables, &value)) {
+      result.memTablesSize += value;
+    }
+  }
+
+  return result;
+}
+
 std::error_code RocksDBWrapper::write(IWriteBatch& batch) {
   if (state.load() != INITIALIZED) {
     throw std::system_error(make_error_code(CryptoNote::error::DataBaseErrorCodes::NOT_INITIALIZED));
@@ -144,18 +308,19 @@ std::error_code RocksDBWrapper::writeSync(IWriteBatch& batch) {
 }
 
 std::error_code RocksDBWrapper::write(IWriteBatch& batch, bool sync) {
+  Common::MetricTimer durationTimer(writeDuration());
   rocksdb::WriteOptions writeOptions;
   writeOptions.sync = sync;
 
   rocksdb::WriteBatch rocksdbBatch;
   std::vector<std::pair<std::string, std::string>> rawData(batch.extractRawDataToInsert());
   for (const std::pair<std::string, std::string>& kvPair : rawData) {
-    rocksdbBatch.Put(rocksdb::Slice(kvPair.first), rocksdb::Slice(kvPair.second));
+    rocksdbBatch.Put(getColumnFamily(kvPair.first), rocksdb::Slice(kvPair.first), rocksdb::Slice(kvPair.second));
   }
 
   std::vector<std::string> rawKeys(batch.extractRawKeysToRemove());
   for (const std::string& key : rawKeys) {
-    rocksdbBatch.Delete(rocksdb::Slice(key));
+    rocksdbBatch.Delete(getColumnFamily(key), rocksdb::Slice(key));
   }
 
   rocksdb::Status status = db->Write(writeOptions, &rocksdbBatch);
@@ -173,18 +338,22 @@ std::error_code RocksDBWrapper::read(IReadBatch& batch) {
     throw std::runtime_error("Not initialized.");
   }
 
+  Common::MetricTimer durationTimer(readDuration());
   rocksdb::ReadOptions readOptions;
 
   std::vector<std::string> rawKeys(batch.getRawKeys());
   std::vector<rocksdb::Slice> keySlices;
+  std::vector<rocksdb::ColumnFamilyHandle*> keyFamilies;
   keySlices.reserve(rawKeys.size());
+  keyFamilies.reserve(rawKeys.size());
   for (const std::string& key : rawKeys) {
     keySlices.emplace_back(rocksdb::Slice(key));
+    keyFamilies.push_back(getColumnFamily(key));
   }
 
   std::vector<std::string> values;
   values.reserve(rawKeys.size());
-  std::vector<rocksdb::Status> statuses = db->MultiGet(readOptions, keySlices, &values);
+  std::vector<rocksdb::Status> statuses = db->MultiGet(readOptions, keyFamilies, keySlices, &values);
 
   std::error_code error;
   std::vector<bool> resultStates;
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/db.h"
 
@@ -30,6 +31,15 @@
 
 namespace CryptoNote {
 
+struct DataBaseStatistics {
+  uint64_t blockCacheHits;
+  uint64_t blockCacheMisses;
+  uint64_t bloomFilterUseful;
+  uint64_t stallMicros;
+  uint64_t pendingCompactionBytes;
+  uint64_t memTablesSize;
+};
+
 class RocksDBWrapper : public IDataBase {
 public:
   RocksDBWrapper(Logging::ILogger& logger);
@@ -48,8 +58,18 @@ public:
   std::error_code writeSync(IWriteBatch& batch) override;
   std::error_code read(IReadBatch& batch) override;
 
+  DataBaseConfig::Profile getProfile() const;
+  // false if the data base was created before column families were introduced and keeps everything in the default family
+  bool hasColumnFamilies() const;
+  DataBaseStatistics getStatistics() const;
+
 private:
   std::error_code write(IWriteBatch& batch, bool sync);
+  rocksdb::ColumnFamilyOptions getColumnFamilyOptions(const DataBaseConfig& config, const std::string& columnFamily, bool compress) const;
+  rocksdb::Status open(const rocksdb::DBOptions& dbOptions, const DataBaseConfig& config, const std::string& dataDir,
+    const std::vector<std::string>& familyNames, bool compress);
+  rocksdb::ColumnFamilyHandle* getColumnFamily(const std::string& rawKey) const;
+  void closeColumnFamilies();
 
   enum State {
     NOT_INITIALIZED,
@@ -58,6 +78,10 @@ private:
 
   Logging::LoggerRef logger;
   std::unique_ptr<rocksdb::DB> db;
+  std::vector<rocksdb::ColumnFamilyHandle*> columnFamilies;
+  std::shared_ptr<rocksdb::Cache> blockCache;
+  std::shared_ptr<rocksdb::Statistics> statistics;
+  DataBaseConfig::Profile profile;
   std::atomic<State> state;
 };
 }
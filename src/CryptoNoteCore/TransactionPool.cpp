@@ -17,7 +17,10 @@
 
 #include "TransactionPool.h"
 
+#include <unordered_map>
+
 #include "Common/int-util.h"
+#include "CryptoNoteConfig.h"
 #include "CryptoNoteBasicImpl.h"
 #include "CryptoNoteCore/TransactionExtra.h"
 
@@ -57,7 +60,13 @@ size_t TransactionPool::PaymentIdHasher::operator() (const boost::optional<Crypt
   return std::hash<Crypto::Hash>{}(*paymentId);
 }
 
-TransactionPool::TransactionPool(Logging::ILogger& logger) :
+TransactionPool::TransactionPool(Logging::ILogger& logger, size_t maxTransactionCount, uint64_t maxSize) :
+  maxTransactionCount(maxTransactionCount),
+  maxSize(maxSize),
+  transactionsSize(0),
+  evictedTransactionCount(0),
+  // a random start keeps generations of a restarted daemon from matching the ones clients got before the restart
+  generation(static_cast<uint64_t>(Crypto::rand<uint32_t>()) << 32),
   transactionHashIndex(transactions.get<TransactionHashTag>()),
   transactionCostIndex(transactions.get<TransactionCostTag>()),
   paymentIdIndex(transactions.get<PaymentIdTag>()),
@@ -82,8 +91,27 @@ bool TransactionPool::pushTransaction(CachedTransaction&& transaction, Transacti
     return false;
   }
 
-  logger(Logging::DEBUGGING) << "pushed transaction " << pendingTx.getTransactionHash() << " to pool";
-  return transactionHashIndex.emplace(std::move(pendingTx)).second;
+  Crypto::Hash transactionHash = pendingTx.getTransactionHash();
+  transactionsSize += pendingTx.cachedTransaction.getTransactionBinaryArray().size();
+  transactionHashIndex.emplace(std::move(pendingTx));
+  logChange(transactionHash, true);
+
+  // The cost index is ordered from the best fee per byte to the worst, so eviction takes from its end
+  while (transactionHashIndex.size() > maxTransactionCount || transactionsSize > maxSize) {
+    Crypto::Hash worstTransactionHash = std::prev(transactionCostIndex.end())->getTransactionHash();
+    removeTransaction(worstTransactionHash);
+    if (worstTransactionHash == transactionHash) {
+      logger(Logging::DEBUGGING) << "pushTransaction: pool is full and transaction " << transactionHash << " has the lowest fee per byte";
+      return false;
+    }
+
+    logger(Logging::DEBUGGING) << "transaction " << worstTransactionHash << " evicted from full pool";
+    evictedTransactions.push_back(worstTransactionHash);
+    ++evictedTransactionCount;
+  }
+
+  logger(Logging::DEBUGGING) << "pushed transaction " << transactionHash << " to pool";
+  return true;
 }
 
 const CachedTransaction& TransactionPool::getTransaction(const Crypto::Hash& hash) const {
@@ -101,7 +129,9 @@ bool TransactionPool::removeTransaction(const Crypto::Hash& hash) {
   }
 
   excludeFromState(poolState, it->cachedTransaction);
+  transactionsSize -= it->cachedTransaction.getTransactionBinaryArray().size();
   transactionHashIndex.erase(it);
+  logChange(hash, false);
 
   logger(Logging::DEBUGGING) << "transaction " << hash << " removed from pool";
   return true;
@@ -159,4 +189,54 @@ std::vector<Crypto::Hash> TransactionPool::getTransactionHashesByPaymentId(const
   return transactionHashes;
 }
 
+uint64_t TransactionPool::getTransactionsSize() const {
+  return transactionsSize;
+}
+
+uint64_t TransactionPool::getEvictedTransactionCount() const {
+  return evictedTransactionCount;
+}
+
+std::vector<Crypto::Hash> TransactionPool::takeEvictedTransactions() {
+  std::vector<Crypto::Hash> result;
+  result.swap(evictedTransactions);
+  return result;
+}
+
+uint64_t TransactionPool::getGeneration() const {
+  return generation;
+}
+
+bool TransactionPool::getChangesSince(uint64_t since, std::vector<Crypto::Hash>& addedTransactions, std::vector<Crypto::Hash>& removedTransactions) const {
+  if (since > generation || generation - since > changeLog.size()) {
+    return false;
+  }
+
+  // The first change of a transaction after 'since' tells whether it was in the pool then
+  std::unordered_map<Crypto::Hash, bool> wasPresent;
+  for (auto it = changeLog.end() - static_cast<ptrdiff_t>(generation - since); it != changeLog.end(); ++it) {
+    wasPresent.emplace(it->first, !it->second);
+  }
+
+  for (const auto& transaction : wasPresent) {
+    bool isPresent = checkIfTransactionPresent(transaction.first);
+    if (isPresent && !transaction.second) {
+      addedTransactions.push_back(transaction.first);
+    } else if (!isPresent && transaction.second) {
+      removedTransactions.push_back(transaction.first);
+    }
+  }
+
+  return true;
+}
+
+void TransactionPool::logChange(const Crypto::Hash& hash, bool added) {
+  changeLog.emplace_back(hash, added);
+  if (changeLog.size() > parameters::CRYPTONOTE_MEMPOOL_CHANGE_LOG_SIZE) {
+    changeLog.pop_front();
+  }
+
+  ++generation;
+}
+
 }
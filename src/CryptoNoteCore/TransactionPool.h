@@ -16,6 +16,8 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
+#include <deque>
+#include <limits>
 #include <unordered_map>
 
 #include "crypto/crypto.h"
@@ -36,7 +38,7 @@ namespace CryptoNote {
 
 class TransactionPool : public ITransactionPool {
 public:
-  TransactionPool(Logging::ILogger& logger);
+  TransactionPool(Logging::ILogger& logger, size_t maxTransactionCount = std::numeric_limits<size_t>::max(), uint64_t maxSize = std::numeric_limits<uint64_t>::max());
 
   virtual bool pushTransaction(CachedTransaction&& transaction, TransactionValidatorState&& transactionState) override;
   virtual const CachedTransaction& getTransaction(const Crypto::Hash& hash) const override;
@@ -51,8 +53,24 @@ public:
 
   virtual uint64_t getTransactionReceiveTime(const Crypto::Hash& hash) const override;
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override;
+
+  virtual uint64_t getTransactionsSize() const override;
+  virtual uint64_t getEvictedTransactionCount() const override;
+  virtual std::vector<Crypto::Hash> takeEvictedTransactions() override;
+  virtual uint64_t getGeneration() const override;
+  virtual bool getChangesSince(uint64_t generation, std::vector<Crypto::Hash>& addedTransactions, std::vector<Crypto::Hash>& removedTransactions) const override;
 private:
+  void logChange(const Crypto::Hash& hash, bool added);
+
   TransactionValidatorState poolState;
+  size_t maxTransactionCount;
+  uint64_t maxSize;
+  uint64_t transactionsSize;
+  uint64_t evictedTransactionCount;
+  uint64_t generation;
+  // Transactions added (true) or removed (false) by the last changes, the last entry made the current generation
+  std::deque<std::pair<Crypto::Hash, bool>> changeLog;
+  std::vector<Crypto::Hash> evictedTransactions;
 
   struct PendingTransactionInfo {
     uint64_t receiveTime;
@@ -81,6 +81,26 @@ std::vector<Crypto::Hash> TransactionPoolCleanWrapper::getTransactionHashesByPay
   return transactionPool->getTransactionHashesByPaymentId(paymentId);
 }
 
+uint64_t TransactionPoolCleanWrapper::getTransactionsSize() const {
+  return transactionPool->getTransactionsSize();
+}
+
+uint64_t TransactionPoolCleanWrapper::getEvictedTransactionCount() const {
+  return transactionPool->getEvictedTransactionCount();
+}
+
+std::vector<Crypto::Hash> TransactionPoolCleanWrapper::takeEvictedTransactions() {
+  return transactionPool->takeEvictedTransactions();
+}
+
+uint64_t TransactionPoolCleanWrapper::getGeneration() const {
+  return transactionPool->getGeneration();
+}
+
+bool TransactionPoolCleanWrapper::getChangesSince(uint64_t generation, std::vector<Crypto::Hash>& addedTransactions, std::vector<Crypto::Hash>& removedTransactions) const {
+  return transactionPool->getChangesSince(generation, addedTransactions, removedTransactions);
+}
+
 std::vector<Crypto::Hash> TransactionPoolCleanWrapper::clean() {
   try {
     uint64_t currentTime = timeProvider->now();
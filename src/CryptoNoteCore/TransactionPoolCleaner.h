@@ -63,6 +63,12 @@ public:
   virtual uint64_t getTransactionReceiveTime(const Crypto::Hash& hash) const override;
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override;
 
+  virtual uint64_t getTransactionsSize() const override;
+  virtual uint64_t getEvictedTransactionCount() const override;
+  virtual std::vector<Crypto::Hash> takeEvictedTransactions() override;
+  virtual uint64_t getGeneration() const override;
+  virtual bool getChangesSince(uint64_t generation, std::vector<Crypto::Hash>& addedTransactions, std::vector<Crypto::Hash>& removedTransactions) const override;
+
   virtual std::vector<Crypto::Hash> clean() override;
 
 private:
@@ -22,12 +22,14 @@
 
 #include "DaemonCommandsHandler.h"
 
+#include "Common/Metrics.h"
 #include "Common/ScopeExit.h"
 #include "Common/SignalHandler.h"
 #include "Common/StdOutputStream.h"
 #include "Common/StdInputStream.h"
 #include "Common/PathTools.h"
 #include "Common/Util.h"
+#include "crypto/crypto.h"
 #include "crypto/hash.h"
 #include "CryptoNoteCore/Core.h"
 #include "CryptoNoteCore/Currency.h"
@@ -100,6 +102,9 @@ namespace
   const command_line::arg_descriptor<bool>        arg_console     = {"no-console", "Disable daemon console commands"};
   const command_line::arg_descriptor<bool>        arg_testnet_on  = {"testnet", "Used to deploy test nets. Checkpoints and hardcoded seeds are ignored, "
     "network id is changed. Use it with --data-dir flag. The wallet must be launched with --testnet flag.", false};
+  const command_line::arg_descriptor<size_t>      arg_point_cache_size = {"point-cache-size", "Number of decompressed public keys cached "
+    "for signature checks, 0 disables the cache", 65536};
+  const command_line::arg_descriptor<bool>        arg_enable_metrics = {"enable-metrics", "Collect hot path metrics and serve them on the /metrics RPC url"};
 }
 
 sqlite3* dbs;
@@ -199,6 +204,8 @@ int main(int argc, char* argv[])
     command_line::add_arg(desc_cmd_sett, arg_log_level);
     command_line::add_arg(desc_cmd_sett, arg_console);
     command_line::add_arg(desc_cmd_sett, arg_testnet_on);
+    command_line::add_arg(desc_cmd_sett, arg_point_cache_size);
+    command_line::add_arg(desc_cmd_sett, arg_enable_metrics);
 
     RpcServerConfig::initOptions(desc_cmd_sett);
     NetNodeConfig::initOptions(desc_cmd_sett);
@@ -269,6 +276,11 @@ int main(int argc, char* argv[])
       logger(INFO) << "Starting in testnet mode!";
     }
 
+    Crypto::set_point_cache_capacity(command_line::get_arg(vm, arg_point_cache_size));
+    if (command_line::get_arg(vm, arg_enable_metrics)) {
+      Common::MetricsRegistry::instance().enable();
+    }
+
     //create objects and link them
     CryptoNote::CurrencyBuilder currencyBuilder(logManager);
     currencyBuilder.testnet(testnet_mode);
@@ -305,6 +317,9 @@ int main(int argc, char* argv[])
     database.init(dbConfig);
     Tools::ScopeExit dbShutdownOnExit([&database] () { database.shutdown(); });
 
+    std::string dbCacheSnapshotFilename = (testnet_mode ? "testnet_" : "") + std::string(parameters::CRYPTONOTE_DB_CACHE_SNAPSHOT_FILENAME);
+    boost::filesystem::path dbCacheSnapshotPath = boost::filesystem::path(dbConfig.getDataDir()) / dbCacheSnapshotFilename;
+
     System::Dispatcher dispatcher;
     logger(INFO) << "Initializing core...";
     CryptoNote::Core ccore(
@@ -312,7 +327,8 @@ int main(int argc, char* argv[])
       logManager,
       std::move(checkpoints),
       dispatcher,
-      std::unique_ptr<IBlockchainCacheFactory>(new DatabaseBlockchainCacheFactory(database, logger.getLogger())),
+      std::unique_ptr<IBlockchainCacheFactory>(new DatabaseBlockchainCacheFactory(database, logger.getLogger(), dbConfig.getExplorerIndexes(),
+        dbCacheSnapshotPath.string())),
       createSwappedMainChainStorage(data_dir_path.string(), currency));
 
     ccore.load();
@@ -439,7 +455,7 @@ int main(int argc, char* argv[])
 
     CryptoNote::CryptoNoteProtocolHandler cprotocol(currency, dispatcher, ccore, nullptr, logManager);
     CryptoNote::NodeServer p2psrv(dispatcher, cprotocol, logManager);
-    CryptoNote::RpcServer rpcServer(dispatcher, logManager, ccore, p2psrv, cprotocol);
+    CryptoNote::RpcServer rpcServer(dispatcher, logManager, ccore, p2psrv, cprotocol, database);
 
     cprotocol.set_p2p_endpoint(&p2psrv);
     DaemonCommandsHandler dch(ccore, p2psrv, logManager);
@@ -456,7 +472,12 @@ int main(int argc, char* argv[])
     }
 
     logger(INFO) << "Starting core rpc server on address " << rpcConfig.getBindAddress();
-    rpcServer.start(rpcConfig.bindIp, rpcConfig.bindPort);
+    rpcServer.start(rpcConfig.bindIp, rpcConfig.bindPort, rpcConfig.ioThreads);
+    if (rpcConfig.binaryPort != 0) {
+      logger(INFO) << "Starting binary rpc connections on port " << rpcConfig.binaryPort;
+      rpcServer.startBinary(rpcConfig.bindIp, rpcConfig.binaryPort);
+    }
+
     logger(INFO) << "Core rpc server started ok";
 
     Tools::SignalHandler::install([&dch, &p2psrv] {
@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <future>
+#include <iterator>
 #include <boost/utility/value_init.hpp>
 #include <CryptoNoteCore/TransactionApi.h>
 
@@ -595,6 +596,50 @@ void InProcessNode::getTransactionHashesByPaymentId(const Crypto::Hash& paymentI
   });
 }
 
+void InProcessNode::getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (state != INITIALIZED) {
+    throw std::system_error(make_error_code(CryptoNote::error::NOT_INITIALIZED));
+  }
+  lock.unlock();
+
+  executeInDispatcherThread([this, &keyImages, &transactionHashes, callback] () mutable {
+    std::error_code ec;
+
+    try {
+      transactionHashes = core.getTransactionHashesByKeyImages(keyImages);
+    } catch (std::system_error& e) {
+      ec = e.code();
+    } catch (std::exception&) {
+      ec = make_error_code(error::INTERNAL_NODE_ERROR);
+    }
+
+    executeInRemoteThread([callback, ec] () { callback(ec); });
+  });
+}
+
+void InProcessNode::getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (state != INITIALIZED) {
+    throw std::system_error(make_error_code(CryptoNote::error::NOT_INITIALIZED));
+  }
+  lock.unlock();
+
+  executeInDispatcherThread([this, &outputKeys, &transactionHashes, callback] () mutable {
+    std::error_code ec;
+
+    try {
+      transactionHashes = core.getTransactionHashesByOutputKeys(outputKeys);
+    } catch (std::system_error& e) {
+      ec = e.code();
+    } catch (std::exception&) {
+      ec = make_error_code(error::INTERNAL_NODE_ERROR);
+    }
+
+    executeInRemoteThread([callback, ec] () { callback(ec); });
+  });
+}
+
 void InProcessNode::peerCountUpdated(size_t count) {
   observerManager.notify(&INodeObserver::peerCountUpdated, count);
 }
@@ -753,6 +798,45 @@ std::error_code InProcessNode::doGetPoolSymmetricDifference(std::vector<Crypto::
   return ec;
 }
 
+void InProcessNode::getPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId,
+                                        bool& isBcActual, bool& isDelta,
+                                        std::vector<std::unique_ptr<ITransactionReader>>& newTxs,
+                                        std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (state != INITIALIZED) {
+    lock.unlock();
+    callback(make_error_code(CryptoNote::error::NOT_INITIALIZED));
+    return;
+  }
+
+  executeInDispatcherThread([=, &poolVersion, &isBcActual, &isDelta, &newTxs, &deletedTxIds] () mutable {
+    auto ec = doGetPoolChangesSince(poolVersion, std::move(knownPoolTxIds), knownBlockId, isBcActual, isDelta, newTxs, deletedTxIds);
+    executeInRemoteThread([callback, ec] () { callback(ec); });
+  });
+}
+
+std::error_code InProcessNode::doGetPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId,
+                                                     bool& isBcActual, bool& isDelta,
+                                                     std::vector<std::unique_ptr<ITransactionReader>>& newTxs,
+                                                     std::vector<Crypto::Hash>& deletedTxIds) {
+  std::error_code ec;
+
+  std::vector<TransactionPrefixInfo> added;
+  isBcActual = core.getPoolChangesLiteSince(knownBlockId, poolVersion, knownPoolTxIds, added, deletedTxIds, isDelta);
+
+  try {
+    for (const auto& tx : added) {
+      newTxs.push_back(createTransactionPrefix(tx.txPrefix, tx.txHash));
+    }
+  } catch (std::system_error& ex) {
+    ec = ex.code();
+  } catch (std::exception&) {
+    ec = make_error_code(std::errc::invalid_argument);
+  }
+
+  return ec;
+}
+
 void InProcessNode::getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, MultisignatureOutput& out,
                                                          const Callback& callback) {
   std::unique_lock<std::mutex> lock(mutex);
@@ -799,22 +883,29 @@ std::error_code InProcessNode::doGetBlocks(const std::vector<uint32_t>& blockInd
                                            std::vector<std::vector<BlockDetails>>& blocks) {
   try {
     auto topIndex = core.getTopBlockIndex();
+    std::vector<Crypto::Hash> blockHashes;
+    std::vector<size_t> blocksOnSameIndexCounts;
+    blockHashes.reserve(blockIndexes.size());
+    blocksOnSameIndexCounts.reserve(blockIndexes.size());
     for (auto index : blockIndexes) {
       if (index > topIndex) {
         return make_error_code(CryptoNote::error::REQUEST_ERROR);
       }
-      Crypto::Hash hash = core.getBlockHashByIndex(index);
-      BlockDetails blockDetails = core.getBlockDetails(hash);
-      std::vector<BlockDetails> blocksOnSameIndex;
-      blocksOnSameIndex.push_back(std::move(blockDetails));
+
+      blockHashes.push_back(core.getBlockHashByIndex(index));
 
       // Getting alternative blocks
       std::vector<Crypto::Hash> alternativeBlocks = core.getAlternativeBlockHashesByIndex(index);
-      for (const auto& alternativeBlockHash : alternativeBlocks) {
-        BlockDetails alternativeBlockDetails = core.getBlockDetails(alternativeBlockHash);
-        blocksOnSameIndex.push_back(std::move(alternativeBlockDetails));
-      }
+      blockHashes.insert(blockHashes.end(), alternativeBlocks.begin(), alternativeBlocks.end());
+      blocksOnSameIndexCounts.push_back(alternativeBlocks.size() + 1);
+    }
+
+    std::vector<BlockDetails> blocksDetails = core.getBlocksDetails(blockHashes);
+    auto it = blocksDetails.begin();
+    for (size_t count : blocksOnSameIndexCounts) {
+      std::vector<BlockDetails> blocksOnSameIndex(std::make_move_iterator(it), std::make_move_iterator(it + count));
       blocks.push_back(std::move(blocksOnSameIndex));
+      it += count;
     }
   } catch (std::system_error& e) {
     return e.code();
@@ -846,9 +937,10 @@ std::error_code InProcessNode::doGetBlocks(const std::vector<Crypto::Hash>& bloc
       if (!core.hasBlock(hash)) {
         return make_error_code(CryptoNote::error::REQUEST_ERROR);
       }
-      BlockDetails blockDetails = core.getBlockDetails(hash);
-      blocks.push_back(std::move(blockDetails));
     }
+
+    std::vector<BlockDetails> blocksDetails = core.getBlocksDetails(blockHashes);
+    blocks.insert(blocks.end(), std::make_move_iterator(blocksDetails.begin()), std::make_move_iterator(blocksDetails.end()));
   } catch (std::system_error& e) {
     return e.code();
   } catch (std::exception&) {
@@ -32,6 +32,7 @@
 #include "HTTP/HttpResponse.h"
 
 #include "Common/JsonValue.h"
+#include "Common/Metrics.h"
 #include "Serialization/JsonInputValueSerializer.h"
 #include "Serialization/JsonOutputStreamSerializer.h"
 
@@ -78,6 +79,11 @@ void JsonRpcServer::processRequest(const CryptoNote::HttpRequest& req, CryptoNot
       resp.setStatus(CryptoNote::HttpResponse::STATUS_200);
       resp.setBody(jsonOutputStream.str());
 
+    } else if (req.getUrl() == "/metrics" && Common::MetricsRegistry::instance().isEnabled()) {
+      resp.addHeader("Content-Type", "text/plain; version=0.0.4");
+      resp.setStatus(CryptoNote::HttpResponse::STATUS_200);
+      resp.setBody(Common::MetricsRegistry::instance().toPrometheusText());
+
     } else {
       logger(Logging::WARNING) << "Requested url \"" << req.getUrl() << "\" is not found";
       resp.setStatus(CryptoNote::HttpResponse::STATUS_404);
@@ -38,11 +38,15 @@ Miner::~Miner() {
   assert(m_state != MiningState::MINING_IN_PROGRESS);
 }
 
-BlockTemplate Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount) {
+BlockTemplate Miner::mine(const BlockMiningParameters& blockMiningParameters, size_t threadCount, size_t hashesPerThread) {
   if (threadCount == 0) {
     throw std::runtime_error("Miner requires at least one thread");
   }
 
+  if (hashesPerThread == 0 || hashesPerThread > Crypto::SLOW_HASH_MAX_MULTI_COUNT) {
+    throw std::runtime_error("Miner supports 1.." + std::to_string(Crypto::SLOW_HASH_MAX_MULTI_COUNT) + " hashes per thread");
+  }
+
   if (m_state == MiningState::MINING_IN_PROGRESS) {
     throw std::runtime_error("Mining is already in progress");
   }
@@ -50,7 +54,7 @@ BlockTemplate Miner::mine(const BlockMiningParameters& blockMiningParameters, si
   m_state = MiningState::MINING_IN_PROGRESS;
   m_miningStopped.clear();
 
-  runWorkers(blockMiningParameters, threadCount);
+  runWorkers(blockMiningParameters, threadCount, hashesPerThread);
 
   assert(m_state != MiningState::MINING_IN_PROGRESS);
   if (m_state == MiningState::MINING_STOPPED) {
@@ -71,7 +75,7 @@ void Miner::stop() {
   }
 }
 
-void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount) {
+void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threadCount, size_t hashesPerThread) {
   assert(threadCount > 0);
 
   m_logger(Logging::INFO) << "Starting mining for difficulty " << blockMiningParameters.difficulty;
@@ -81,7 +85,7 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
 
     for (size_t i = 0; i < threadCount; ++i) {
       m_workers.emplace_back(std::unique_ptr<System::RemoteContext<void>> (
-        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this, blockMiningParameters.blockTemplate, blockMiningParameters.difficulty, threadCount)))
+        new System::RemoteContext<void>(m_dispatcher, std::bind(&Miner::workerFunc, this, blockMiningParameters.blockTemplate, blockMiningParameters.difficulty, threadCount, hashesPerThread)))
       );
 
       blockMiningParameters.blockTemplate.nonce++;
@@ -97,27 +101,55 @@ void Miner::runWorkers(BlockMiningParameters blockMiningParameters, size_t threa
   m_miningStopped.set();
 }
 
-void Miner::workerFunc(const BlockTemplate& blockTemplate, Difficulty difficulty, uint32_t nonceStep) {
+void Miner::workerFunc(const BlockTemplate& blockTemplate, Difficulty difficulty, uint32_t nonceStep, size_t hashesPerThread) {
   try {
-    BlockTemplate block = blockTemplate;
-    Crypto::cn_context cryptoContext;
+    // Thread hashes several nonces of its sequence at once, sequences of all threads don't intersect
+    std::vector<BlockTemplate> blocks(hashesPerThread, blockTemplate);
+    for (size_t i = 0; i < hashesPerThread; ++i) {
+      blocks[i].nonce = blockTemplate.nonce + static_cast<uint32_t>(i) * nonceStep;
+    }
+
+    uint32_t batchNonceStep = nonceStep * static_cast<uint32_t>(hashesPerThread);
+    Crypto::cn_multi_context cryptoContext(hashesPerThread);
+    if (!cryptoContext.usesHugePages()) {
+      m_logger(Logging::DEBUGGING) << "Huge pages are not available, regular pages are used for scratchpads";
+    }
+
+    std::vector<const void*> hashingData(hashesPerThread);
+    std::vector<size_t> hashingDataLengths(hashesPerThread);
+    std::vector<Crypto::Hash> hashes(hashesPerThread);
+    // CachedBlock caches hashing blobs of a nonce, so it is recreated every batch, the storage is not
+    std::vector<CachedBlock> cachedBlocks;
+    cachedBlocks.reserve(hashesPerThread);
 
     while (m_state == MiningState::MINING_IN_PROGRESS) {
-      CachedBlock cachedBlock(block);
-      Crypto::Hash hash = cachedBlock.getBlockLongHash(cryptoContext);
-      if (check_hash(hash, difficulty)) {
-        m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
+      cachedBlocks.clear();
+      for (size_t i = 0; i < hashesPerThread; ++i) {
+        cachedBlocks.emplace_back(blocks[i]);
+        const auto& hashingBlob = cachedBlocks.back().getBlockLongHashingBinaryArray();
+        hashingData[i] = hashingBlob.data();
+        hashingDataLengths[i] = hashingBlob.size();
+      }
+
+      Crypto::cn_slow_hash_multi(cryptoContext, hashingData.data(), hashingDataLengths.data(), hashes.data());
+
+      for (size_t i = 0; i < hashesPerThread; ++i) {
+        if (check_hash(hashes[i], difficulty)) {
+          m_logger(Logging::INFO) << "Found block for difficulty " << difficulty;
 
-        if (!setStateBlockFound()) {
-          m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+          if (!setStateBlockFound()) {
+            m_logger(Logging::DEBUGGING) << "block is already found or mining stopped";
+            return;
+          }
+
+          m_block = blocks[i];
           return;
         }
-
-        m_block = block;
-        return;
       }
 
-      block.nonce += nonceStep;
+      for (auto& block : blocks) {
+        block.nonce += batchNonceStep;
+      }
     }
   } catch (std::exception& e) {
     m_logger(Logging::ERROR) << "Miner got error: " << e.what();
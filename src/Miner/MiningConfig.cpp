@@ -27,6 +27,7 @@
 
 #include "CryptoNoteConfig.h"
 #include "Logging/ILogger.h"
+#include "crypto/hash.h"
 
 namespace po = boost::program_options;
 
@@ -71,6 +72,7 @@ MiningConfig::MiningConfig(): help(false) {
       ("daemon-rpc-port", po::value<uint16_t>()->default_value(static_cast<uint16_t>(RPC_DEFAULT_PORT)), "Daemon's RPC port")
       ("daemon-address", po::value<std::string>(), "Daemon host:port. If you use this option you must not use --daemon-host and --daemon-port options")
       ("threads", po::value<size_t>()->default_value(CONCURRENCY_LEVEL), "Mining threads count. Must not be greater than you concurrency level. Default value is your hardware concurrency level")
+      ("hashes-per-thread", po::value<size_t>()->default_value(1), "Hashes computed at once by each thread, 1..4. Greater values hide memory latency at the cost of 2 MB per hash")
       ("scan-time", po::value<size_t>()->default_value(DEFAULT_SCANT_PERIOD), "Blockchain polling interval (seconds). How often miner will check blockchain for updates")
       ("log-level", po::value<int>()->default_value(1), "Log level. Must be 0..5")
       ("limit", po::value<size_t>()->default_value(0), "Mine exact quantity of blocks. 0 means no limit")
@@ -111,6 +113,11 @@ void MiningConfig::parse(int argc, char** argv) {
     throw std::runtime_error("--threads option must be 1.." + std::to_string(CONCURRENCY_LEVEL));
   }
 
+  hashesPerThread = options["hashes-per-thread"].as<size_t>();
+  if (hashesPerThread == 0 || hashesPerThread > Crypto::SLOW_HASH_MAX_MULTI_COUNT) {
+    throw std::runtime_error("--hashes-per-thread option must be 1.." + std::to_string(Crypto::SLOW_HASH_MAX_MULTI_COUNT));
+  }
+
   scanPeriod = options["scan-time"].as<size_t>();
   if (scanPeriod == 0) {
     throw std::runtime_error("--scan-time must not be zero");
@@ -28,12 +28,14 @@
 #include <System/Dispatcher.h>
 #include <System/Event.h>
 #include <System/EventLock.h>
+#include <System/InterruptedException.h>
 #include <System/Timer.h>
 #include <CryptoNoteCore/TransactionApi.h>
 
 #include "Common/StringTools.h"
 #include "CryptoNoteCore/CryptoNoteBasicImpl.h"
 #include "CryptoNoteCore/CryptoNoteTools.h"
+#include "Rpc/BinaryRpcClient.h"
 #include "Rpc/CoreRpcServerCommandsDefinitions.h"
 #include "Rpc/HttpClient.h"
 #include "Rpc/JsonRpc.h"
@@ -61,11 +63,12 @@ std::error_code interpretResponseStatus(const std::string& status) {
 
 }
 
-NodeRpcProxy::NodeRpcProxy(const std::string& nodeHost, unsigned short nodePort) :
+NodeRpcProxy::NodeRpcProxy(const std::string& nodeHost, unsigned short nodePort, unsigned short binaryRpcPort) :
     m_rpcTimeout(10000),
     m_pullInterval(5000),
     m_nodeHost(nodeHost),
     m_nodePort(nodePort),
+    m_binaryRpcPort(binaryRpcPort),
     m_connected(true) {
   resetInternalState();
 }
@@ -79,6 +82,8 @@ NodeRpcProxy::~NodeRpcProxy() {
 
 void NodeRpcProxy::resetInternalState() {
   m_stop = false;
+  m_poolChangesSinceSupported = true;
+  m_binaryRpcAvailable = true;
   m_peerCount.store(0, std::memory_order_relaxed);
   m_networkHeight.store(0, std::memory_order_relaxed);
   lastLocalBlockHeaderInfo.index = 0;
@@ -127,6 +132,7 @@ bool NodeRpcProxy::shutdown() {
 
   m_dispatcher->remoteSpawn([this]() {
     m_stop = true;
+    m_nodeStatusEvent->set();
     // Run all spawned contexts
     m_dispatcher->yield();
   });
@@ -150,6 +156,15 @@ void NodeRpcProxy::workerThread(const INode::Callback& initialized_callback) {
     Event httpEvent(dispatcher);
     m_httpEvent = &httpEvent;
     m_httpEvent->set();
+    Event nodeStatusEvent(dispatcher);
+    m_nodeStatusEvent = &nodeStatusEvent;
+    std::unique_ptr<BinaryRpcClient> binaryRpcClient;
+    if (m_binaryRpcPort != 0) {
+      binaryRpcClient.reset(new BinaryRpcClient(dispatcher, m_nodeHost, m_binaryRpcPort, [this](const std::string&, const std::string&) {
+        m_nodeStatusEvent->set();
+      }));
+      m_binaryRpcClient = binaryRpcClient.get();
+    }
 
     {
       std::lock_guard<std::mutex> lock(m_mutex);
@@ -161,11 +176,10 @@ void NodeRpcProxy::workerThread(const INode::Callback& initialized_callback) {
     initialized_callback(std::error_code());
 
     contextGroup.spawn([this]() {
-      Timer pullTimer(*m_dispatcher);
       while (!m_stop) {
         updateNodeStatus();
         if (!m_stop) {
-          pullTimer.sleep(std::chrono::milliseconds(m_pullInterval));
+          waitForNodeStatusUpdate();
         }
       }
     });
@@ -180,11 +194,32 @@ void NodeRpcProxy::workerThread(const INode::Callback& initialized_callback) {
   m_context_group = nullptr;
   m_httpClient = nullptr;
   m_httpEvent = nullptr;
+  m_binaryRpcClient = nullptr;
+  m_nodeStatusEvent = nullptr;
   m_connected = false;
   m_rpcProxyObserverManager.notify(&INodeRpcProxyObserver::connectionStatusUpdated, m_connected);
 }
 
+void NodeRpcProxy::waitForNodeStatusUpdate() {
+  ContextGroup pullTimerContext(*m_dispatcher);
+  pullTimerContext.spawn([this] {
+    try {
+      Timer(*m_dispatcher).sleep(std::chrono::milliseconds(m_pullInterval));
+      m_nodeStatusEvent->set();
+    } catch (InterruptedException&) {
+    }
+  });
+
+  while (!m_nodeStatusEvent->get()) {
+    m_nodeStatusEvent->wait();
+  }
+
+  m_nodeStatusEvent->clear();
+}
+
 void NodeRpcProxy::updateNodeStatus() {
+  // try the binary connection again, the daemon might be restarted with it
+  m_binaryRpcAvailable = true;
   bool updateBlockchain = true;
   while (updateBlockchain) {
     updateBlockchainStatus();
@@ -267,10 +302,7 @@ void NodeRpcProxy::updateBlockchainStatus() {
     updatePeerCount(getInfoResp.incoming_connections_count + getInfoResp.outgoing_connections_count);
   }
 
-  if (m_connected != m_httpClient->isConnected()) {
-    m_connected = m_httpClient->isConnected();
-    m_rpcProxyObserverManager.notify(&INodeRpcProxyObserver::connectionStatusUpdated, m_connected);
-  }
+  updateConnectionStatus();
 }
 
 void NodeRpcProxy::updatePeerCount(size_t peerCount) {
@@ -364,6 +396,26 @@ void NodeRpcProxy::getTransactionHashesByPaymentId(const Crypto::Hash& paymentId
   scheduleRequest(std::bind(&NodeRpcProxy::doGetTransactionHashesByPaymentId, this, std::cref(paymentId), std::ref(transactionHashes)), callback);
 }
 
+void NodeRpcProxy::getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes, const INode::Callback& callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_state != STATE_INITIALIZED) {
+    callback(make_error_code(error::NOT_INITIALIZED));
+    return;
+  }
+
+  scheduleRequest(std::bind(&NodeRpcProxy::doGetTransactionHashesByKeyImages, this, std::cref(keyImages), std::ref(transactionHashes)), callback);
+}
+
+void NodeRpcProxy::getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes, const INode::Callback& callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_state != STATE_INITIALIZED) {
+    callback(make_error_code(error::NOT_INITIALIZED));
+    return;
+  }
+
+  scheduleRequest(std::bind(&NodeRpcProxy::doGetTransactionHashesByOutputKeys, this, std::cref(outputKeys), std::ref(transactionHashes)), callback);
+}
+
 std::error_code NodeRpcProxy::doGetBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount, std::vector<Crypto::Hash>& blockHashes) {
   COMMAND_RPC_GET_BLOCKS_HASHES_BY_TIMESTAMPS::request req = AUTO_VAL_INIT(req);
   COMMAND_RPC_GET_BLOCKS_HASHES_BY_TIMESTAMPS::response rsp = AUTO_VAL_INIT(rsp);
@@ -452,6 +504,18 @@ void NodeRpcProxy::getPoolSymmetricDifference(std::vector<Crypto::Hash>&& knownP
     return this->doGetPoolSymmetricDifference(std::move(knownPoolTxIds), knownBlockId, isBcActual, newTxs, deletedTxIds); } , callback);
 }
 
+void NodeRpcProxy::getPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual,
+        bool& isDelta, std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_state != STATE_INITIALIZED) {
+    callback(make_error_code(error::NOT_INITIALIZED));
+    return;
+  }
+
+  scheduleRequest([this, &poolVersion, knownPoolTxIds, knownBlockId, &isBcActual, &isDelta, &newTxs, &deletedTxIds] () mutable -> std::error_code {
+    return this->doGetPoolChangesSince(poolVersion, std::move(knownPoolTxIds), knownBlockId, isBcActual, isDelta, newTxs, deletedTxIds); } , callback);
+}
+
 void NodeRpcProxy::getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, MultisignatureOutput& out, const Callback& callback) {
   std::lock_guard<std::mutex> lock(m_mutex);
   if (m_state != STATE_INITIALIZED) {
@@ -470,8 +534,7 @@ void NodeRpcProxy::getBlocks(const std::vector<uint32_t>& blockHeights, std::vec
     return;
   }
 
-  // TODO NOT IMPLEMENTED
-  callback(std::error_code());
+  scheduleRequest(std::bind(&NodeRpcProxy::doGetBlocksByHeights, this, std::cref(blockHeights), std::ref(blocks)), callback);
 }
 
 void NodeRpcProxy::getBlocks(const std::vector<Crypto::Hash>& blockHashes, std::vector<BlockDetails>& blocks, const Callback& callback) {
@@ -633,6 +696,46 @@ std::error_code NodeRpcProxy::doGetPoolSymmetricDifference(std::vector<Crypto::H
   return ec;
 }
 
+std::error_code NodeRpcProxy::doGetPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId,
+        bool& isBcActual, bool& isDelta, std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds) {
+  if (m_poolChangesSinceSupported) {
+    CryptoNote::COMMAND_RPC_GET_POOL_CHANGES_SINCE::request req = AUTO_VAL_INIT(req);
+    CryptoNote::COMMAND_RPC_GET_POOL_CHANGES_SINCE::response rsp = AUTO_VAL_INIT(rsp);
+
+    req.tailBlockId = knownBlockId;
+    req.poolVersion = poolVersion;
+    req.knownTxsIds = knownPoolTxIds;
+
+    std::error_code ec = binaryCommand("/get_pool_changes_since.bin", req, rsp);
+    if (!ec) {
+      isBcActual = rsp.isTailBlockActual;
+      isDelta = rsp.isDelta;
+      poolVersion = rsp.poolVersion;
+      deletedTxIds = std::move(rsp.deletedTxsIds);
+
+      for (const auto& tpi : rsp.addedTxs) {
+        newTxs.push_back(createTransactionPrefix(tpi.txPrefix, tpi.txHash));
+      }
+
+      return ec;
+    }
+
+    if (ec == make_error_code(error::CONNECT_ERROR)) {
+      return ec;
+    }
+  }
+
+  // Daemons without /get_pool_changes_since.bin answer with an error, use the full difference with them
+  isDelta = false;
+  poolVersion = 0;
+  std::error_code ec = doGetPoolSymmetricDifference(std::move(knownPoolTxIds), knownBlockId, isBcActual, newTxs, deletedTxIds);
+  if (!ec) {
+    m_poolChangesSinceSupported = false;
+  }
+
+  return ec;
+}
+
 std::error_code NodeRpcProxy::doGetBlocks(const std::vector<Crypto::Hash>& blockHashes, std::vector<BlockDetails>& blocks) {
   COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES::request req = AUTO_VAL_INIT(req);
   COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES::response resp = AUTO_VAL_INIT(resp);
@@ -648,6 +751,45 @@ std::error_code NodeRpcProxy::doGetBlocks(const std::vector<Crypto::Hash>& block
   return ec;
 }
 
+std::error_code NodeRpcProxy::doGetBlocksByHeights(const std::vector<uint32_t>& blockHeights, std::vector<std::vector<BlockDetails>>& blocks) {
+  COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS::request req = AUTO_VAL_INIT(req);
+  COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS::response resp = AUTO_VAL_INIT(resp);
+
+  req.blockHeights = blockHeights;
+
+  std::error_code ec = binaryCommand("/get_blocks_details_by_heights.bin", req, resp);
+  if (ec) {
+    return ec;
+  }
+
+  if (!splitBlocksByHeights(blockHeights, std::move(resp.blocks), blocks)) {
+    return make_error_code(error::INTERNAL_NODE_ERROR);
+  }
+
+  return ec;
+}
+
+bool splitBlocksByHeights(const std::vector<uint32_t>& blockHeights, std::vector<BlockDetails>&& blocks,
+                          std::vector<std::vector<BlockDetails>>& blocksByHeights) {
+  // blocks come flat: main chain block and then alternative blocks for every requested height
+  auto it = blocks.begin();
+  for (uint32_t height : blockHeights) {
+    std::vector<BlockDetails> blocksOnSameHeight;
+    while (it != blocks.end() && it->index == height && (blocksOnSameHeight.empty() || it->isAlternative)) {
+      blocksOnSameHeight.push_back(std::move(*it));
+      ++it;
+    }
+
+    if (blocksOnSameHeight.empty() || blocksOnSameHeight.front().isAlternative) {
+      return false;
+    }
+
+    blocksByHeights.push_back(std::move(blocksOnSameHeight));
+  }
+
+  return it == blocks.end();
+}
+
 std::error_code NodeRpcProxy::doGetTransactionHashesByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes) {
   COMMAND_RPC_GET_TRANSACTION_HASHES_BY_PAYMENT_ID::request req = AUTO_VAL_INIT(req);
   COMMAND_RPC_GET_TRANSACTION_HASHES_BY_PAYMENT_ID::response resp = AUTO_VAL_INIT(resp);
@@ -662,6 +804,34 @@ std::error_code NodeRpcProxy::doGetTransactionHashesByPaymentId(const Crypto::Ha
   return ec;
 }
 
+std::error_code NodeRpcProxy::doGetTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes) {
+  COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES::request req = AUTO_VAL_INIT(req);
+  COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES::response resp = AUTO_VAL_INIT(resp);
+
+  req.keyImages = keyImages;
+  std::error_code ec = binaryCommand("/get_transaction_hashes_by_key_images.bin", req, resp);
+  if (ec) {
+    return ec;
+  }
+
+  transactionHashes = std::move(resp.transactionHashes);
+  return ec;
+}
+
+std::error_code NodeRpcProxy::doGetTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes) {
+  COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS::request req = AUTO_VAL_INIT(req);
+  COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS::response resp = AUTO_VAL_INIT(resp);
+
+  req.outputKeys = outputKeys;
+  std::error_code ec = binaryCommand("/get_transaction_hashes_by_output_keys.bin", req, resp);
+  if (ec) {
+    return ec;
+  }
+
+  transactionHashes = std::move(resp.transactionHashes);
+  return ec;
+}
+
 std::error_code NodeRpcProxy::doGetTransactions(const std::vector<Crypto::Hash>& transactionHashes, std::vector<TransactionDetails>& transactions) {
   COMMAND_RPC_GET_TRANSACTION_DETAILS_BY_HASHES::request req = AUTO_VAL_INIT(req);
   COMMAND_RPC_GET_TRANSACTION_DETAILS_BY_HASHES::response resp = AUTO_VAL_INIT(resp);
@@ -705,23 +875,53 @@ void NodeRpcProxy::scheduleRequest(std::function<std::error_code()>&& procedure,
           callback(std::make_error_code(std::errc::operation_canceled));
         } else {
           std::error_code ec = procedure();
-          if (m_connected != m_httpClient->isConnected()) {
-            m_connected = m_httpClient->isConnected();
-            m_rpcProxyObserverManager.notify(&INodeRpcProxyObserver::connectionStatusUpdated, m_connected);
-          }
+          updateConnectionStatus();
           callback(m_stop ? std::make_error_code(std::errc::operation_canceled) : ec);
         }
       }, std::move(procedure), std::move(callback)));
     }, std::move(procedure), callback));
 }
 
+void NodeRpcProxy::request(const HttpRequest& req, HttpResponse& res) {
+  if (m_binaryRpcClient != nullptr && m_binaryRpcAvailable) {
+    try {
+      m_binaryRpcClient->request(req, res);
+      return;
+    } catch (const ConnectException&) {
+      m_binaryRpcAvailable = false;
+    }
+  }
+
+  EventLock eventLock(*m_httpEvent);
+  m_httpClient->request(req, res);
+}
+
+bool NodeRpcProxy::isNodeConnected() const {
+  return m_httpClient->isConnected() || (m_binaryRpcClient != nullptr && m_binaryRpcClient->isConnected());
+}
+
+void NodeRpcProxy::updateConnectionStatus() {
+  if (m_connected != isNodeConnected()) {
+    m_connected = isNodeConnected();
+    m_rpcProxyObserverManager.notify(&INodeRpcProxyObserver::connectionStatusUpdated, m_connected);
+  }
+}
+
 template <typename Request, typename Response>
 std::error_code NodeRpcProxy::binaryCommand(const std::string& url, const Request& req, Response& res) {
   std::error_code ec;
 
   try {
-    EventLock eventLock(*m_httpEvent);
-    invokeBinaryCommand(*m_httpClient, url, req, res);
+    HttpRequest httpReq;
+    HttpResponse httpRes;
+
+    httpReq.setUrl(url);
+    httpReq.setBody(storeToBinaryKeyValue(req));
+    request(httpReq, httpRes);
+    if (!loadFromBinaryKeyValue(res, httpRes.getBody())) {
+      throw std::runtime_error("Failed to parse binary response");
+    }
+
     ec = interpretResponseStatus(res.status);
   } catch (const ConnectException&) {
     ec = make_error_code(error::CONNECT_ERROR);
@@ -737,8 +937,20 @@ std::error_code NodeRpcProxy::jsonCommand(const std::string& url, const Request&
   std::error_code ec;
 
   try {
-    EventLock eventLock(*m_httpEvent);
-    invokeJsonCommand(*m_httpClient, url, req, res);
+    HttpRequest httpReq;
+    HttpResponse httpRes;
+
+    httpReq.setUrl(url);
+    httpReq.setBody(storeToJson(req));
+    request(httpReq, httpRes);
+    if (httpRes.getStatus() != HttpResponse::STATUS_200) {
+      throw std::runtime_error("HTTP status: " + std::to_string(httpRes.getStatus()));
+    }
+
+    if (!loadFromJson(res, httpRes.getBody())) {
+      throw std::runtime_error("Failed to parse JSON response");
+    }
+
     ec = interpretResponseStatus(res.status);
   } catch (const ConnectException&) {
     ec = make_error_code(error::CONNECT_ERROR);
@@ -754,8 +966,6 @@ std::error_code NodeRpcProxy::jsonRpcCommand(const std::string& method, const Re
   std::error_code ec = make_error_code(error::INTERNAL_NODE_ERROR);
 
   try {
-    EventLock eventLock(*m_httpEvent);
-
     JsonRpc::JsonRpcRequest jsReq;
 
     jsReq.setMethod(method);
@@ -767,7 +977,7 @@ std::error_code NodeRpcProxy::jsonRpcCommand(const std::string& method, const Re
     httpReq.setUrl("/json_rpc");
     httpReq.setBody(jsReq.getBody());
 
-    m_httpClient->request(httpReq, httpRes);
+    request(httpReq, httpRes);
 
     JsonRpc::JsonRpcResponse jsRes;
 
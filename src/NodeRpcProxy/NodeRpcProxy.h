@@ -35,7 +35,10 @@ namespace System {
 
 namespace CryptoNote {
 
+class BinaryRpcClient;
 class HttpClient;
+class HttpRequest;
+class HttpResponse;
 
 class INodeRpcProxyObserver {
 public:
@@ -45,7 +48,9 @@ public:
 
 class NodeRpcProxy : public CryptoNote::INode {
 public:
-  NodeRpcProxy(const std::string& nodeHost, unsigned short nodePort);
+  // With binaryRpcPort requests go over a persistent binary connection to that port, which also brings notifications
+  // about new blocks and pool changes, HTTP is used while the connection can't be established
+  NodeRpcProxy(const std::string& nodeHost, unsigned short nodePort, unsigned short binaryRpcPort = 0);
   virtual ~NodeRpcProxy();
 
   virtual bool addObserver(CryptoNote::INodeObserver* observer) override;
@@ -66,6 +71,8 @@ public:
 
   virtual void getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount, std::vector<Crypto::Hash>& blockHashes, const Callback& callback) override;
   virtual void getTransactionHashesByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) override;
+  virtual void getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) override;
+  virtual void getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes, const Callback& callback) override;
 
   virtual BlockHeaderInfo getLastLocalBlockHeaderInfo() const override;
 
@@ -76,6 +83,8 @@ public:
   virtual void queryBlocks(std::vector<Crypto::Hash>&& knownBlockIds, uint64_t timestamp, std::vector<BlockShortEntry>& newBlocks, uint32_t& startHeight, const Callback& callback) override;
   virtual void getPoolSymmetricDifference(std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual,
           std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) override;
+  virtual void getPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual, bool& isDelta,
+          std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds, const Callback& callback) override;
   virtual void getMultisignatureOutputByGlobalIndex(uint64_t amount, uint32_t gindex, MultisignatureOutput& out, const Callback& callback) override;
   virtual void getBlocks(const std::vector<uint32_t>& blockHeights, std::vector<std::vector<BlockDetails>>& blocks, const Callback& callback) override;
   virtual void getBlocks(const std::vector<Crypto::Hash>& blockHashes, std::vector<BlockDetails>& blocks, const Callback& callback) override;
@@ -91,6 +100,7 @@ private:
 
   std::vector<Crypto::Hash> getKnownTxsVector() const;
   void pullNodeStatusAndScheduleTheNext();
+  void waitForNodeStatusUpdate();
   void updateNodeStatus();
   void updateBlockchainStatus();
   bool updatePoolStatus();
@@ -109,11 +119,19 @@ private:
     std::vector<CryptoNote::BlockShortEntry>& newBlocks, uint32_t& startHeight);
   std::error_code doGetPoolSymmetricDifference(std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual,
           std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds);
+  std::error_code doGetPoolChangesSince(uint64_t& poolVersion, std::vector<Crypto::Hash>&& knownPoolTxIds, Crypto::Hash knownBlockId, bool& isBcActual,
+          bool& isDelta, std::vector<std::unique_ptr<ITransactionReader>>& newTxs, std::vector<Crypto::Hash>& deletedTxIds);
   std::error_code doGetBlocks(const std::vector<Crypto::Hash>& blockHashes, std::vector<BlockDetails>& blocks);
+  std::error_code doGetBlocksByHeights(const std::vector<uint32_t>& blockHeights, std::vector<std::vector<BlockDetails>>& blocks);
   std::error_code doGetTransactionHashesByPaymentId(const Crypto::Hash& paymentId, std::vector<Crypto::Hash>& transactionHashes);
+  std::error_code doGetTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages, std::vector<Crypto::Hash>& transactionHashes);
+  std::error_code doGetTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys, std::vector<Crypto::Hash>& transactionHashes);
   std::error_code doGetTransactions(const std::vector<Crypto::Hash>& transactionHashes, std::vector<TransactionDetails>& transactions);
 
   void scheduleRequest(std::function<std::error_code()>&& procedure, const Callback& callback);
+  void request(const HttpRequest& req, HttpResponse& res);
+  bool isNodeConnected() const;
+  void updateConnectionStatus();
   template <typename Request, typename Response>
   std::error_code binaryCommand(const std::string& url, const Request& req, Response& res);
   template <typename Request, typename Response>
@@ -139,9 +157,13 @@ private:
 
   const std::string m_nodeHost;
   const unsigned short m_nodePort;
+  const unsigned short m_binaryRpcPort;
   unsigned int m_rpcTimeout;
   HttpClient* m_httpClient = nullptr;
   System::Event* m_httpEvent = nullptr;
+  BinaryRpcClient* m_binaryRpcClient = nullptr;
+  // Set by daemon notifications and the pull timer
+  System::Event* m_nodeStatusEvent = nullptr;
 
   uint64_t m_pullInterval;
 
@@ -155,5 +177,13 @@ private:
   std::unordered_set<Crypto::Hash> m_knownTxs;
 
   bool m_connected;
+  // Cleared when the daemon doesn't answer /get_pool_changes_since.bin, accessed from the worker thread only
+  bool m_poolChangesSinceSupported;
+  // Cleared when the binary connection can't be established, requests use HTTP until the next node status update
+  bool m_binaryRpcAvailable;
 };
+
+// Groups flat /get_blocks_details_by_heights.bin response per requested height, returns false if response doesn't match request
+bool splitBlocksByHeights(const std::vector<uint32_t>& blockHeights, std::vector<BlockDetails>&& blocks,
+                          std::vector<std::vector<BlockDetails>>& blocksByHeights);
 }
@@ -38,6 +38,7 @@
 #include <System/TcpConnector.h>
  
 #include "version.h"
+#include "Common/Metrics.h"
 #include "Common/StdInputStream.h"
 #include "Common/StdOutputStream.h"
 #include "Common/Util.h"
@@ -132,6 +133,18 @@ std::string print_peerlist_to_string(const std::list<PeerlistEntry>& pl) {
   return ss.str();
 }
 
+Common::MetricHistogram& writeQueueBytes() {
+  static Common::MetricHistogram& histogram = Common::MetricsRegistry::instance().histogram(
+    "p2p_write_queue_bytes", "Bytes queued to a P2P connection when its write starts");
+  return histogram;
+}
+
+Common::MetricCounter& writeQueueOverflows() {
+  static Common::MetricCounter& counter = Common::MetricsRegistry::instance().counter(
+    "p2p_write_queue_overflows_total", "P2P connections interrupted because of write queue overflow");
+  return counter;
+}
+
 }
 
 
@@ -144,6 +157,7 @@ std::string print_peerlist_to_string(const std::list<PeerlistEntry>& pl) {
 
     if (writeQueueSize > P2P_CONNECTION_MAX_WRITE_BUFFER_SIZE) {
       logger(DEBUGGING) << *this << "Write queue overflows. Interrupt connection";
+      writeQueueOverflows().increment();
       interrupt();
       return false;
     }
@@ -160,6 +174,10 @@ std::string print_peerlist_to_string(const std::list<PeerlistEntry>& pl) {
       queueEvent.wait();
     }
 
+    if (!writeQueue.empty()) {
+      writeQueueBytes().record(writeQueueSize);
+    }
+
     std::vector<P2pMessage> msgs(std::move(writeQueue));
     writeQueue.clear();
     writeQueueSize = 0;
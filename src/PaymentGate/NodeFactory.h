@@ -25,7 +25,7 @@ namespace PaymentService {
 
 class NodeFactory {
 public:
-  static CryptoNote::INode* createNode(const std::string& daemonAddress, uint16_t daemonPort);
+  static CryptoNote::INode* createNode(const std::string& daemonAddress, uint16_t daemonPort, uint16_t daemonBinaryPort = 0);
   static CryptoNote::INode* createNodeStub();
 private:
   NodeFactory();
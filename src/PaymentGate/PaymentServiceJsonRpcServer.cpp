@@ -22,6 +22,7 @@
 #include "PaymentServiceJsonRpcMessages.h"
 #include "WalletService.h"
 
+#include "Common/Metrics.h"
 #include "Serialization/JsonInputValueSerializer.h"
 #include "Serialization/JsonOutputStreamSerializer.h"
 
@@ -89,6 +90,9 @@ void PaymentServiceJsonRpcServer::processJsonRpcRequest(const Common::JsonValue&
       params = req("params");
     }
 
+    Common::MetricsRegistry& metrics = Common::MetricsRegistry::instance();
+    Common::MetricTimer durationTimer(metrics.isEnabled() ?
+      &metrics.histogram("walletd_request_duration_microseconds", "Time of walletd JSON-RPC method processing", "method=\"" + method + "\"") : nullptr);
     it->second(params, resp);
   } catch (std::exception& e) {
     logger(Logging::WARNING) << "Error occurred while processing JsonRpc request: " << e.what();
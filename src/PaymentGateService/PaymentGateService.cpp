@@ -19,6 +19,7 @@
 
 #include <future>
 
+#include "Common/Metrics.h"
 #include "Common/SignalHandler.h"
 #include "Common/Util.h"
 #include "InProcessNode/InProcessNode.h"
@@ -87,6 +88,10 @@ bool PaymentGateService::init(int argc, char** argv) {
     currencyBuilder.testnet(true);
   }
 
+  if (config.gateConfiguration.enableMetrics) {
+    Common::MetricsRegistry::instance().enable();
+  }
+
   if (!config.gateConfiguration.serverRoot.empty()) {
     changeDirectory(config.gateConfiguration.serverRoot);
     log(Logging::INFO) << "Current working directory now is " << config.gateConfiguration.serverRoot;
@@ -243,7 +248,8 @@ void PaymentGateService::runRpcProxy(Logging::LoggerRef& log) {
   std::unique_ptr<CryptoNote::INode> node(
     PaymentService::NodeFactory::createNode(
       config.remoteNodeConfig.daemonHost, 
-      config.remoteNodeConfig.daemonPort));
+      config.remoteNodeConfig.daemonPort,
+      config.remoteNodeConfig.daemonBinaryPort));
 
   runWalletService(currency, *node);
 }
@@ -36,6 +36,7 @@ Configuration::Configuration() {
   logFile = "walletd.log";
   testnet = false;
   printAddresses = false;
+  enableMetrics = false;
   logLevel = Logging::INFO;
   bindAddress = "";
   bindPort = 0;
@@ -56,7 +57,8 @@ void Configuration::initOptions(boost::program_options::options_description& des
       ("log-file,l", po::value<std::string>(), "log file")
       ("server-root", po::value<std::string>(), "server root. The service will use it as working directory. Don't set it if don't want to change it")
       ("log-level", po::value<size_t>(), "log level")
-      ("address", "print wallet addresses and exit");
+      ("address", "print wallet addresses and exit")
+      ("enable-metrics", "collect hot path metrics and serve them on the /metrics url");
 }
 
 void Configuration::init(const boost::program_options::variables_map& options) {
@@ -120,6 +122,10 @@ void Configuration::init(const boost::program_options::variables_map& options) {
     printAddresses = true;
   }
 
+  if (options.count("enable-metrics") != 0) {
+    enableMetrics = true;
+  }
+
   if (!registerService && !unregisterService) {
     if (containerFile.empty()) {
       throw ConfigurationError("container-file parameter are required");
@@ -50,6 +50,7 @@ struct Configuration {
   bool unregisterService;
   bool testnet;
   bool printAddresses;
+  bool enableMetrics;
 
   size_t logLevel;
 };
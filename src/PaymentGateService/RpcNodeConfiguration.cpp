@@ -24,12 +24,14 @@ namespace po = boost::program_options;
 RpcNodeConfiguration::RpcNodeConfiguration() {
   daemonHost = "";
   daemonPort = 0;
+  daemonBinaryPort = 0;
 }
 
 void RpcNodeConfiguration::initOptions(boost::program_options::options_description& desc) {
   desc.add_options()
     ("daemon-address", po::value<std::string>()->default_value("localhost"), "bytecoind address")
-    ("daemon-port", po::value<uint16_t>()->default_value(8081), "bytecoind port");
+    ("daemon-port", po::value<uint16_t>()->default_value(8081), "bytecoind port")
+    ("daemon-binary-port", po::value<uint16_t>()->default_value(0), "bytecoind binary RPC port, 0 to use HTTP only");
 }
 
 void RpcNodeConfiguration::init(const boost::program_options::variables_map& options) {
@@ -40,6 +42,10 @@ void RpcNodeConfiguration::init(const boost::program_options::variables_map& opt
   if (options.count("daemon-port") != 0 && (!options["daemon-port"].defaulted() || daemonPort == 0)) {
     daemonPort = options["daemon-port"].as<uint16_t>();
   }
+
+  if (options.count("daemon-binary-port") != 0 && (!options["daemon-binary-port"].defaulted() || daemonBinaryPort == 0)) {
+    daemonBinaryPort = options["daemon-binary-port"].as<uint16_t>();
+  }
 }
 
 } //namespace PaymentService
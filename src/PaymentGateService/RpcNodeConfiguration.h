@@ -31,6 +31,7 @@ public:
 
   std::string daemonHost;
   uint16_t daemonPort;
+  uint16_t daemonBinaryPort;
 };
 
 } //namespace PaymentService
@@ -17,10 +17,11 @@
 
 #include "Dispatcher.h"
 #include <cassert>
+#include <limits>
+#include <memory>
 
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
-#include <sys/timerfd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <ucontext.h>
@@ -36,30 +37,16 @@ struct ContextMakingData {
   void* ucontext;
 };
 
-class MutextGuard {
-public:
-  MutextGuard(pthread_mutex_t& _mutex) : mutex(_mutex) {
-    auto ret = pthread_mutex_lock(&mutex);
-    if (ret != 0) {
-      throw std::runtime_error("pthread_mutex_lock failed, " + errorMessage(ret));
-    }
-  }
-
-  ~MutextGuard() {
-    pthread_mutex_unlock(&mutex);
-  }
-
-private:
-  pthread_mutex_t& mutex;
-};
-
-static_assert(Dispatcher::SIZEOF_PTHREAD_MUTEX_T == sizeof(pthread_mutex_t), "invalid pthread mutex size");
-
 const size_t STACK_SIZE = 64 * 1024;
 
+// timer wheel ticks are milliseconds of the monotonic clock
+uint64_t getCurrentTick() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 };
 
-Dispatcher::Dispatcher() {
+Dispatcher::Dispatcher() : timers(getCurrentTick()) {
   std::string message;
   epoll = ::epoll_create1(0);
   if (epoll == -1) {
@@ -83,8 +70,7 @@ Dispatcher::Dispatcher() {
         if (epoll_ctl(epoll, EPOLL_CTL_ADD, remoteSpawnEvent, &remoteSpawnEventEpollEvent) == -1) {
           message = "epoll_ctl failed, " + lastErrorMessage();
         } else {
-          *reinterpret_cast<pthread_mutex_t*>(this->mutex) = pthread_mutex_t(PTHREAD_MUTEX_INITIALIZER);
-
+          remoteSpawnPending = false;
           mainContext.interrupted = false;
           mainContext.group = &contextGroup;
           mainContext.groupPrev = nullptr;
@@ -122,6 +108,7 @@ Dispatcher::~Dispatcher() {
   assert(contextGroup.firstWaiter == nullptr);
   assert(firstResumingContext == nullptr);
   assert(runningContextCount == 0);
+  assert(timers.empty());
   while (firstReusableContext != nullptr) {
     auto ucontext = static_cast<ucontext_t*>(firstReusableContext->ucontext);
     auto stackPtr = static_cast<uint8_t *>(firstReusableContext->stackPtr);
@@ -130,18 +117,13 @@ Dispatcher::~Dispatcher() {
     delete ucontext;
   }
 
-  while (!timers.empty()) {
-    int result = ::close(timers.top());
-    assert(result == 0);
-    timers.pop();
-  }
-
   auto result = close(epoll);
   assert(result == 0);
   result = close(remoteSpawnEvent);
   assert(result == 0);
-  result = pthread_mutex_destroy(reinterpret_cast<pthread_mutex_t*>(this->mutex));
-  assert(result == 0);
+  while (RemoteSpawnNode* node = remoteSpawningProcedures.pop()) {
+    delete static_cast<RemoteProcedure*>(node);
+  }
 }
 
 void Dispatcher::clear() {
@@ -152,15 +134,6 @@ void Dispatcher::clear() {
     delete[] stackPtr;
     delete ucontext;
   }
-
-  while (!timers.empty()) {
-    int result = ::close(timers.top());
-    if (result == -1) {
-      throw std::runtime_error("Dispatcher::clear, close failed, "  + lastErrorMessage());
-    }
-
-    timers.pop();
-  }
 }
 
 void Dispatcher::dispatch() {
@@ -172,23 +145,17 @@ void Dispatcher::dispatch() {
       break;
     }
 
+    expireTimers();
+    if (firstResumingContext != nullptr) {
+      continue;
+    }
+
     epoll_event event;
-    int count = epoll_wait(epoll, &event, 1, -1);
+    int count = epoll_wait(epoll, &event, 1, getEpollTimeout());
     if (count == 1) {
       ContextPair *contextPair = static_cast<ContextPair*>(event.data.ptr);
       if(((event.events & (EPOLLIN | EPOLLOUT)) != 0) && contextPair->readContext == nullptr && contextPair->writeContext == nullptr) {
-        uint64_t buf;
-        auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
-        if(transferred == -1) {
-            throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
-        }
-
-        MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
-        while (!remoteSpawningProcedures.empty()) {
-          spawn(std::move(remoteSpawningProcedures.front()));
-          remoteSpawningProcedures.pop();
-        }
-
+        spawnRemoteProcedures();
         continue;
       }
 
@@ -206,6 +173,10 @@ void Dispatcher::dispatch() {
       break;
     }
 
+    if (count == 0) {
+      continue;
+    }
+
     if (errno != EINTR) {
       throw std::runtime_error("Dispatcher::dispatch, epoll_wait failed, "  + lastErrorMessage());
     }
@@ -263,15 +234,7 @@ void Dispatcher::pushContext(NativeContext* context) {
 }
 
 void Dispatcher::remoteSpawn(std::function<void()>&& procedure) {
-  {
-    MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
-    remoteSpawningProcedures.push(std::move(procedure));
-  }
-  uint64_t one = 1;
-  auto transferred = write(remoteSpawnEvent, &one, sizeof one);
-  if(transferred == - 1) {
-    throw std::runtime_error("Dispatcher::remoteSpawn, write failed, " + lastErrorMessage());
-  }
+  pushRemoteProcedure(new RemoteProcedureHolder<std::function<void()>>(std::move(procedure)));
 }
 
 void Dispatcher::spawn(std::function<void()>&& procedure) {
@@ -306,18 +269,7 @@ void Dispatcher::yield() {
       for(int i = 0; i < count; ++i) {
         ContextPair *contextPair = static_cast<ContextPair*>(events[i].data.ptr);
         if(((events[i].events & (EPOLLIN | EPOLLOUT)) != 0) && contextPair->readContext == nullptr && contextPair->writeContext == nullptr) {
-          uint64_t buf;
-          auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
-          if(transferred == -1) {
-            throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
-          }
-
-          MutextGuard guard(*reinterpret_cast<pthread_mutex_t*>(this->mutex));
-          while (!remoteSpawningProcedures.empty()) {
-            spawn(std::move(remoteSpawningProcedures.front()));
-            remoteSpawningProcedures.pop();
-          }
-
+          spawnRemoteProcedures();
           continue;
         }
 
@@ -340,6 +292,7 @@ void Dispatcher::yield() {
     }
   }
 
+  expireTimers();
   if (firstResumingContext != nullptr) {
     pushContext(currentContext);
     dispatch();
@@ -385,27 +338,78 @@ void Dispatcher::pushReusableContext(NativeContext& context) {
   --runningContextCount;
 }
 
-int Dispatcher::getTimer() {
-  int timer;
+void Dispatcher::addTimer(TimerContext* timer, std::chrono::nanoseconds duration) {
+  assert(timer != nullptr);
   if (timers.empty()) {
-    timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
-    epoll_event timerEvent;
-    timerEvent.events = 0;
-    timerEvent.data.ptr = nullptr;
+    // catch up with the clock, the wheel doesn't move while there are no timers
+    timers.advance(getCurrentTick());
+  }
+
+  // rounded up, so that the timer doesn't expire earlier than requested
+  auto expireTime = std::chrono::steady_clock::now().time_since_epoch() + duration + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1);
+  timer->expireTick = std::chrono::duration_cast<std::chrono::milliseconds>(expireTime).count();
+  timers.add(timer);
+}
 
-    if (epoll_ctl(getEpoll(), EPOLL_CTL_ADD, timer, &timerEvent) == -1) {
-      throw std::runtime_error("Dispatcher::getTimer, epoll_ctl failed, "  + lastErrorMessage());
+void Dispatcher::removeTimer(TimerContext* timer) {
+  timers.remove(timer);
+}
+
+void Dispatcher::pushRemoteProcedure(RemoteProcedure* procedure) {
+  remoteSpawningProcedures.push(procedure);
+  if (!remoteSpawnPending.exchange(true)) {
+    uint64_t one = 1;
+    auto transferred = write(remoteSpawnEvent, &one, sizeof one);
+    if(transferred == - 1) {
+      throw std::runtime_error("Dispatcher::remoteSpawn, write failed, " + lastErrorMessage());
     }
-  } else {
-    timer = timers.top();
-    timers.pop();
+  }
+}
+
+void Dispatcher::spawnRemoteProcedures() {
+  uint64_t buf;
+  auto transferred = read(remoteSpawnEvent, &buf, sizeof buf);
+  if(transferred == -1) {
+    throw std::runtime_error("Dispatcher::dispatch, read(remoteSpawnEvent) failed, " + lastErrorMessage());
+  }
+
+  // cleared before the queue is drained, a procedure which is not popped below writes the event again
+  remoteSpawnPending = false;
+  while (RemoteSpawnNode* node = remoteSpawningProcedures.pop()) {
+    RemoteProcedure* procedure = static_cast<RemoteProcedure*>(node);
+    spawn([procedure] {
+      std::unique_ptr<RemoteProcedure> guard(procedure);
+      procedure->call();
+    });
+  }
+}
+
+void Dispatcher::expireTimers() {
+  if (timers.empty()) {
+    return;
   }
 
-  return timer;
+  TimerContext* timer = timers.advance(getCurrentTick());
+  while (timer != nullptr) {
+    TimerContext* next = timer->next;
+    timer->context->interruptProcedure = nullptr;
+    pushContext(timer->context);
+    timer = next;
+  }
 }
 
-void Dispatcher::pushTimer(int timer) {
-  timers.push(timer);
+int Dispatcher::getEpollTimeout() const {
+  uint64_t nextTick = timers.getNextTick();
+  if (nextTick == std::numeric_limits<uint64_t>::max()) {
+    return -1;
+  }
+
+  uint64_t currentTick = getCurrentTick();
+  if (nextTick <= currentTick) {
+    return 0;
+  }
+
+  return static_cast<int>(std::min<uint64_t>(nextTick - currentTick, std::numeric_limits<int>::max()));
 }
 
 void Dispatcher::contextProcedure(void* ucontext) {
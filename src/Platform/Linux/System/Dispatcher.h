@@ -17,10 +17,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <functional>
-#include <queue>
-#include <stack>
+#include <type_traits>
+#include <utility>
+
+#include "RemoteSpawnQueue.h"
+#include "TimerWheel.h"
 
 namespace System {
 
@@ -56,6 +61,31 @@ struct ContextPair {
   OperationContext *writeContext;
 };
 
+struct TimerContext {
+  uint64_t expireTick;
+  NativeContext* context;
+  bool interrupted;
+  unsigned slot;
+  TimerContext* prev;
+  TimerContext* next;
+};
+
+struct RemoteProcedure : RemoteSpawnNode {
+  virtual ~RemoteProcedure() {}
+  virtual void call() = 0;
+};
+
+template<class Procedure> struct RemoteProcedureHolder : RemoteProcedure {
+  template<class P> explicit RemoteProcedureHolder(P&& procedure) : procedure(std::forward<P>(procedure)) {
+  }
+
+  void call() override {
+    procedure();
+  }
+
+  Procedure procedure;
+};
+
 class Dispatcher {
 public:
   Dispatcher();
@@ -70,33 +100,32 @@ public:
   bool interrupted();
   void pushContext(NativeContext* context);
   void remoteSpawn(std::function<void()>&& procedure);
+
+  // The closure is stored in the queue node, so that it isn't allocated again as std::function
+  template<class Procedure> void remoteSpawn(Procedure&& procedure) {
+    pushRemoteProcedure(new RemoteProcedureHolder<typename std::decay<Procedure>::type>(std::forward<Procedure>(procedure)));
+  }
+
   void yield();
 
   // system-dependent
   int getEpoll() const;
   NativeContext& getReusableContext();
   void pushReusableContext(NativeContext&);
-  int getTimer();
-  void pushTimer(int timer);
-
-#ifdef __x86_64__
-# if __WORDSIZE == 64
-  static const int SIZEOF_PTHREAD_MUTEX_T = 40;
-# else
-  static const int SIZEOF_PTHREAD_MUTEX_T = 32;
-# endif
-#else
-  static const int SIZEOF_PTHREAD_MUTEX_T = 24;
-#endif
+  void addTimer(TimerContext* timer, std::chrono::nanoseconds duration);
+  void removeTimer(TimerContext* timer);
 
 private:
   void spawn(std::function<void()>&& procedure);
+  void pushRemoteProcedure(RemoteProcedure* procedure);
+  void spawnRemoteProcedures();
   int epoll;
-  alignas(void*) uint8_t mutex[SIZEOF_PTHREAD_MUTEX_T];
   int remoteSpawnEvent;
   ContextPair remoteSpawnEventContext;
-  std::queue<std::function<void()>> remoteSpawningProcedures;
-  std::stack<int> timers;
+  RemoteSpawnQueue remoteSpawningProcedures;
+  // set by the producer which finds the dispatcher idle, only that one writes remoteSpawnEvent
+  std::atomic<bool> remoteSpawnPending;
+  TimerWheel timers;
 
   NativeContext mainContext;
   NativeContextGroup contextGroup;
@@ -106,6 +135,8 @@ private:
   NativeContext* firstReusableContext;
   size_t runningContextCount;
 
+  void expireTimers();
+  int getEpollTimeout() const;
   void contextProcedure(void* ucontext);
   static void contextProcedureStatic(void* context);
 };
@@ -0,0 +1,68 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RemoteSpawnQueue.h"
+#include <cassert>
+
+namespace System {
+
+RemoteSpawnQueue::RemoteSpawnQueue() : back(&stub), front(&stub) {
+  stub.next.store(nullptr, std::memory_order_relaxed);
+}
+
+void RemoteSpawnQueue::push(RemoteSpawnNode* node) {
+  assert(node != nullptr);
+  node->next.store(nullptr, std::memory_order_relaxed);
+  // the node is reachable from the front only after the previous back is linked to it
+  RemoteSpawnNode* previous = back.exchange(node, std::memory_order_acq_rel);
+  previous->next.store(node, std::memory_order_release);
+}
+
+RemoteSpawnNode* RemoteSpawnQueue::pop() {
+  RemoteSpawnNode* node = front;
+  RemoteSpawnNode* next = node->next.load(std::memory_order_acquire);
+  if (node == &stub) {
+    if (next == nullptr) {
+      return nullptr;
+    }
+
+    front = next;
+    node = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (next != nullptr) {
+    front = next;
+    return node;
+  }
+
+  if (node != back.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  // the last node can't be returned while it is the back, put the stub behind it
+  push(&stub);
+  next = node->next.load(std::memory_order_acquire);
+  if (next != nullptr) {
+    front = next;
+    return node;
+  }
+
+  return nullptr;
+}
+
+}
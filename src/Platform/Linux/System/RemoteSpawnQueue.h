@@ -0,0 +1,47 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+
+namespace System {
+
+struct RemoteSpawnNode {
+  std::atomic<RemoteSpawnNode*> next;
+};
+
+// Intrusive lock-free queue with multiple producers and a single consumer (D. Vyukov's algorithm).
+// push is wait-free and may be called from any thread, pop is called from the dispatcher thread only.
+class RemoteSpawnQueue {
+public:
+  RemoteSpawnQueue();
+  RemoteSpawnQueue(const RemoteSpawnQueue&) = delete;
+  RemoteSpawnQueue& operator=(const RemoteSpawnQueue&) = delete;
+
+  void push(RemoteSpawnNode* node);
+
+  // Returns nullptr when the queue is empty or the next node is being pushed right now
+  RemoteSpawnNode* pop();
+
+private:
+  std::atomic<RemoteSpawnNode*> back;
+  RemoteSpawnNode* front;
+  RemoteSpawnNode stub;
+};
+
+}
@@ -0,0 +1,196 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "Dispatcher.h"
+
+namespace System {
+
+namespace {
+
+uint64_t rotateRight(uint64_t value, unsigned shift) {
+  return shift == 0 ? value : (value >> shift) | (value << (64 - shift));
+}
+
+}
+
+TimerWheel::TimerWheel(uint64_t currentTick) : nextTick(currentTick), timerCount(0) {
+  for (unsigned level = 0; level < LEVELS; ++level) {
+    occupiedSlots[level] = 0;
+    for (unsigned slot = 0; slot < SLOT_COUNT; ++slot) {
+      slots[level][slot] = nullptr;
+    }
+  }
+}
+
+bool TimerWheel::empty() const {
+  return timerCount == 0;
+}
+
+size_t TimerWheel::size() const {
+  return timerCount;
+}
+
+void TimerWheel::add(TimerContext* timer) {
+  assert(timer != nullptr);
+  insert(timer);
+  ++timerCount;
+}
+
+void TimerWheel::remove(TimerContext* timer) {
+  assert(timer != nullptr);
+  assert(timerCount > 0);
+  unsigned level = timer->slot / SLOT_COUNT;
+  unsigned slot = timer->slot % SLOT_COUNT;
+  if (timer->prev != nullptr) {
+    timer->prev->next = timer->next;
+  } else {
+    assert(slots[level][slot] == timer);
+    slots[level][slot] = timer->next;
+    if (timer->next == nullptr) {
+      occupiedSlots[level] &= ~(UINT64_C(1) << slot);
+    }
+  }
+
+  if (timer->next != nullptr) {
+    timer->next->prev = timer->prev;
+  }
+
+  timer->prev = nullptr;
+  timer->next = nullptr;
+  --timerCount;
+}
+
+TimerContext* TimerWheel::advance(uint64_t tick) {
+  TimerContext* firstExpired = nullptr;
+  TimerContext* lastExpired = nullptr;
+  while (nextTick <= tick) {
+    // skip ticks without expirations and cascades instead of visiting each of them
+    uint64_t next = getNextTick();
+    if (next > tick) {
+      nextTick = tick + 1;
+      break;
+    }
+
+    nextTick = std::max(nextTick, next);
+    unsigned index = nextTick & (SLOT_COUNT - 1);
+    if (index == 0) {
+      for (unsigned level = 1; level < LEVELS; ++level) {
+        unsigned slot = (nextTick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1);
+        cascade(level, slot);
+        if (slot != 0) {
+          break;
+        }
+      }
+    }
+
+    TimerContext* expired = slots[0][index];
+    if (expired != nullptr) {
+      slots[0][index] = nullptr;
+      occupiedSlots[0] &= ~(UINT64_C(1) << index);
+      if (lastExpired != nullptr) {
+        lastExpired->next = expired;
+        expired->prev = lastExpired;
+      } else {
+        firstExpired = expired;
+      }
+
+      lastExpired = expired;
+      --timerCount;
+      while (lastExpired->next != nullptr) {
+        lastExpired = lastExpired->next;
+        --timerCount;
+      }
+    }
+
+    ++nextTick;
+  }
+
+  return firstExpired;
+}
+
+uint64_t TimerWheel::getNextTick() const {
+  if (timerCount == 0) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  uint64_t result = std::numeric_limits<uint64_t>::max();
+  if (occupiedSlots[0] != 0) {
+    unsigned index = nextTick & (SLOT_COUNT - 1);
+    result = nextTick + __builtin_ctzll(rotateRight(occupiedSlots[0], index));
+  }
+
+  for (unsigned level = 1; level < LEVELS; ++level) {
+    if (occupiedSlots[level] == 0) {
+      continue;
+    }
+
+    // a slot is cascaded when the tick reaches its beginning, current slot of an upper level was cascaded already
+    // unless the tick is at the beginning of it
+    unsigned shift = SLOT_BITS * level;
+    uint64_t base = nextTick >> shift;
+    unsigned index = base & (SLOT_COUNT - 1);
+    unsigned first = (nextTick & ((UINT64_C(1) << shift) - 1)) == 0 ? 0 : 1;
+    unsigned distance = first + __builtin_ctzll(rotateRight(occupiedSlots[level], (index + first) & (SLOT_COUNT - 1)));
+    result = std::min(result, (base + distance) << shift);
+  }
+
+  return result;
+}
+
+void TimerWheel::insert(TimerContext* timer) {
+  uint64_t expireTick = std::max(timer->expireTick, nextTick);
+  uint64_t delta = expireTick - nextTick;
+  unsigned level = 0;
+  while (level + 1 < LEVELS && delta >= (UINT64_C(1) << (SLOT_BITS * (level + 1)))) {
+    ++level;
+  }
+
+  // timers beyond the wheel range wait in the farthest slot and are placed again when it is cascaded
+  const uint64_t range = UINT64_C(1) << (SLOT_BITS * LEVELS);
+  if (delta >= range) {
+    expireTick = nextTick + range - 1;
+  }
+
+  unsigned slot = (expireTick >> (SLOT_BITS * level)) & (SLOT_COUNT - 1);
+  timer->slot = level * SLOT_COUNT + slot;
+  timer->prev = nullptr;
+  timer->next = slots[level][slot];
+  if (timer->next != nullptr) {
+    timer->next->prev = timer;
+  }
+
+  slots[level][slot] = timer;
+  occupiedSlots[level] |= UINT64_C(1) << slot;
+}
+
+void TimerWheel::cascade(unsigned level, unsigned slot) {
+  TimerContext* timer = slots[level][slot];
+  slots[level][slot] = nullptr;
+  occupiedSlots[level] &= ~(UINT64_C(1) << slot);
+  while (timer != nullptr) {
+    TimerContext* next = timer->next;
+    insert(timer);
+    timer = next;
+  }
+}
+
+}
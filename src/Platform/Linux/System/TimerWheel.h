@@ -0,0 +1,62 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace System {
+
+struct TimerContext;
+
+// Hierarchical timer wheel with millisecond ticks. Adding and removing a timer is O(1),
+// timers due in more than 64^(LEVELS - 1) ticks are moved to lower levels as time goes.
+class TimerWheel {
+public:
+  explicit TimerWheel(uint64_t currentTick);
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  bool empty() const;
+  size_t size() const;
+
+  // timer->expireTick must be set, timers which are already due expire on the next advance()
+  void add(TimerContext* timer);
+  void remove(TimerContext* timer);
+
+  // Removes timers due at or before tick and returns them as a list linked by TimerContext::next
+  TimerContext* advance(uint64_t tick);
+
+  // The earliest tick at which advance() may return a timer, UINT64_MAX if there are no timers
+  uint64_t getNextTick() const;
+
+private:
+  static const unsigned SLOT_BITS = 6;
+  static const unsigned SLOT_COUNT = 1 << SLOT_BITS;
+  static const unsigned LEVELS = 6;
+
+  void insert(TimerContext* timer);
+  void cascade(unsigned level, unsigned slot);
+
+  TimerContext* slots[LEVELS][SLOT_COUNT];
+  uint64_t occupiedSlots[LEVELS];
+  uint64_t nextTick;
+  size_t timerCount;
+};
+
+}
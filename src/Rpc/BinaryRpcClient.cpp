@@ -0,0 +1,148 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "BinaryRpcClient.h"
+
+#include <System/EventLock.h>
+#include <System/InterruptedException.h>
+#include <System/Ipv4Resolver.h>
+#include <System/Ipv4Address.h>
+#include <System/TcpConnector.h>
+
+#include "BinaryRpcProtocol.h"
+#include "HttpClient.h"
+
+namespace CryptoNote {
+
+struct BinaryRpcClient::PendingRequest {
+  PendingRequest(System::Dispatcher& dispatcher, HttpResponse& response) : done(dispatcher), response(response), failed(false) {
+  }
+
+  System::Event done;
+  HttpResponse& response;
+  bool failed;
+};
+
+BinaryRpcClient::BinaryRpcClient(System::Dispatcher& dispatcher, const std::string& address, uint16_t port, NotificationHandler&& notificationHandler) :
+  m_dispatcher(dispatcher), m_address(address), m_port(port), m_notificationHandler(std::move(notificationHandler)), m_connected(false),
+  m_nextRequestId(0), m_connectEvent(dispatcher), m_writeEvent(dispatcher), m_readContext(dispatcher) {
+  m_connectEvent.set();
+  m_writeEvent.set();
+}
+
+BinaryRpcClient::~BinaryRpcClient() {
+  m_readContext.interrupt();
+  m_readContext.wait();
+}
+
+void BinaryRpcClient::request(const HttpRequest& req, HttpResponse& res) {
+  if (!m_connected) {
+    System::EventLock connectLock(m_connectEvent);
+    if (!m_connected) {
+      connect();
+    }
+  }
+
+  BinaryRpcFrame frame;
+  frame.type = BinaryRpcFrame::REQUEST;
+  frame.id = m_nextRequestId++;
+  frame.status = 0;
+  frame.url = req.getUrl();
+  frame.body = req.getBody();
+
+  PendingRequest pendingRequest(m_dispatcher, res);
+  m_pendingRequests[frame.id] = &pendingRequest;
+  try {
+    {
+      System::EventLock writeLock(m_writeEvent);
+      BinaryRpcProtocol(m_connection).writeFrame(frame);
+    }
+
+    pendingRequest.done.wait();
+  } catch (std::exception&) {
+    // the response may still come, it is dropped then
+    m_pendingRequests.erase(frame.id);
+    throw;
+  }
+
+  if (pendingRequest.failed) {
+    throw std::runtime_error("Binary RPC connection is closed");
+  }
+}
+
+bool BinaryRpcClient::isConnected() const {
+  return m_connected;
+}
+
+void BinaryRpcClient::connect() {
+  try {
+    auto ipAddr = System::Ipv4Resolver(m_dispatcher).resolve(m_address);
+    System::TcpConnection connection = System::TcpConnector(m_dispatcher).connect(ipAddr, m_port);
+
+    // a request of the previous connection may still be writing
+    System::EventLock writeLock(m_writeEvent);
+    m_connection = std::move(connection);
+    m_connected = true;
+  } catch (System::InterruptedException&) {
+    throw;
+  } catch (const std::exception& e) {
+    throw ConnectException(e.what());
+  }
+
+  m_readContext.spawn(std::bind(&BinaryRpcClient::readLoop, this));
+}
+
+void BinaryRpcClient::readLoop() {
+  try {
+    BinaryRpcProtocol protocol(m_connection);
+    BinaryRpcFrame frame;
+    while (protocol.readFrame(frame)) {
+      if (frame.type == BinaryRpcFrame::NOTIFICATION) {
+        if (m_notificationHandler) {
+          m_notificationHandler(frame.url, frame.body);
+        }
+
+        continue;
+      }
+
+      if (frame.type != BinaryRpcFrame::RESPONSE) {
+        throw std::runtime_error("Unexpected binary RPC frame");
+      }
+
+      auto it = m_pendingRequests.find(frame.id);
+      if (it != m_pendingRequests.end()) {
+        PendingRequest* pendingRequest = it->second;
+        m_pendingRequests.erase(it);
+        pendingRequest->response.setStatus(fromBinaryRpcStatus(frame.status));
+        pendingRequest->response.setBody(frame.body);
+        pendingRequest->done.set();
+      }
+    }
+  } catch (std::exception&) {
+  }
+
+  // the connection is replaced by the next request, writers of this one fail when it is closed by the peer
+  m_connected = false;
+  for (auto& pendingRequest : m_pendingRequests) {
+    pendingRequest.second->failed = true;
+    pendingRequest.second->done.set();
+  }
+
+  m_pendingRequests.clear();
+}
+
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include <HTTP/HttpRequest.h>
+#include <HTTP/HttpResponse.h>
+#include <System/ContextGroup.h>
+#include <System/Event.h>
+#include <System/TcpConnection.h>
+
+namespace CryptoNote {
+
+// Client of a persistent binary RPC connection (see BinaryRpcProtocol). Requests of several contexts share
+// the connection and are answered as soon as the server processes them, the connection is established on demand.
+class BinaryRpcClient {
+public:
+  typedef std::function<void(const std::string& url, const std::string& body)> NotificationHandler;
+
+  BinaryRpcClient(System::Dispatcher& dispatcher, const std::string& address, uint16_t port, NotificationHandler&& notificationHandler = NotificationHandler());
+  ~BinaryRpcClient();
+
+  // Throws ConnectException if the connection can't be established
+  void request(const HttpRequest& req, HttpResponse& res);
+
+  bool isConnected() const;
+
+private:
+  struct PendingRequest;
+
+  void connect();
+  void readLoop();
+
+  System::Dispatcher& m_dispatcher;
+  const std::string m_address;
+  const uint16_t m_port;
+  NotificationHandler m_notificationHandler;
+
+  bool m_connected;
+  uint32_t m_nextRequestId;
+  System::TcpConnection m_connection;
+  System::Event m_connectEvent;
+  System::Event m_writeEvent;
+  std::unordered_map<uint32_t, PendingRequest*> m_pendingRequests;
+  System::ContextGroup m_readContext;
+};
+
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "BinaryRpcProtocol.h"
+
+#include <stdexcept>
+#include <vector>
+
+#include <System/TcpConnection.h>
+
+namespace CryptoNote {
+
+namespace {
+
+const uint64_t BINARY_RPC_SIGNATURE = 0x0101010101012102LL;
+const uint32_t BINARY_RPC_MAX_URL_SIZE = 1024;
+const uint64_t BINARY_RPC_MAX_BODY_SIZE = 100000000; //100MB, as for levin packets
+
+#pragma pack(push)
+#pragma pack(1)
+struct BinaryRpcFrameHead {
+  uint64_t signature;
+  uint32_t type;
+  uint32_t id;
+  uint32_t status;
+  uint32_t urlSize;
+  uint64_t bodySize;
+};
+#pragma pack(pop)
+
+}
+
+uint32_t toBinaryRpcStatus(HttpResponse::HTTP_STATUS status) {
+  switch (status) {
+  case HttpResponse::STATUS_200:
+    return 200;
+  case HttpResponse::STATUS_404:
+    return 404;
+  default:
+    return 500;
+  }
+}
+
+HttpResponse::HTTP_STATUS fromBinaryRpcStatus(uint32_t status) {
+  switch (status) {
+  case 200:
+    return HttpResponse::STATUS_200;
+  case 404:
+    return HttpResponse::STATUS_404;
+  default:
+    return HttpResponse::STATUS_500;
+  }
+}
+
+BinaryRpcProtocol::BinaryRpcProtocol(System::TcpConnection& connection) : m_conn(connection) {
+}
+
+bool BinaryRpcProtocol::readFrame(BinaryRpcFrame& frame) {
+  BinaryRpcFrameHead head = { 0 };
+  if (!readStrict(reinterpret_cast<uint8_t*>(&head), sizeof(head))) {
+    return false;
+  }
+
+  if (head.signature != BINARY_RPC_SIGNATURE) {
+    throw std::runtime_error("Binary RPC signature mismatch");
+  }
+
+  if (head.type < BinaryRpcFrame::REQUEST || head.type > BinaryRpcFrame::NOTIFICATION) {
+    throw std::runtime_error("Binary RPC frame type is unknown");
+  }
+
+  if (head.urlSize > BINARY_RPC_MAX_URL_SIZE || head.bodySize > BINARY_RPC_MAX_BODY_SIZE) {
+    throw std::runtime_error("Binary RPC frame is too big");
+  }
+
+  frame.type = head.type;
+  frame.id = head.id;
+  frame.status = head.status;
+  frame.url.resize(head.urlSize);
+  frame.body.resize(static_cast<size_t>(head.bodySize));
+  if (head.urlSize != 0 && !readStrict(reinterpret_cast<uint8_t*>(&frame.url[0]), frame.url.size())) {
+    return false;
+  }
+
+  if (head.bodySize != 0 && !readStrict(reinterpret_cast<uint8_t*>(&frame.body[0]), frame.body.size())) {
+    return false;
+  }
+
+  return true;
+}
+
+void BinaryRpcProtocol::writeFrame(const BinaryRpcFrame& frame) {
+  BinaryRpcFrameHead head = { 0 };
+  head.signature = BINARY_RPC_SIGNATURE;
+  head.type = frame.type;
+  head.id = frame.id;
+  head.status = frame.status;
+  head.urlSize = static_cast<uint32_t>(frame.url.size());
+  head.bodySize = frame.body.size();
+
+  // write header and body in one operation
+  std::vector<uint8_t> writeBuffer;
+  writeBuffer.reserve(sizeof(head) + frame.url.size() + frame.body.size());
+  writeBuffer.insert(writeBuffer.end(), reinterpret_cast<const uint8_t*>(&head), reinterpret_cast<const uint8_t*>(&head) + sizeof(head));
+  writeBuffer.insert(writeBuffer.end(), frame.url.begin(), frame.url.end());
+  writeBuffer.insert(writeBuffer.end(), frame.body.begin(), frame.body.end());
+  writeStrict(writeBuffer.data(), writeBuffer.size());
+}
+
+void BinaryRpcProtocol::writeStrict(const uint8_t* ptr, size_t size) {
+  size_t offset = 0;
+  while (offset < size) {
+    offset += m_conn.write(ptr + offset, size - offset);
+  }
+}
+
+bool BinaryRpcProtocol::readStrict(uint8_t* ptr, size_t size) {
+  size_t offset = 0;
+  while (offset < size) {
+    size_t read = m_conn.read(ptr + offset, size - offset);
+    if (read == 0) {
+      return false;
+    }
+
+    offset += read;
+  }
+
+  return true;
+}
+
+}
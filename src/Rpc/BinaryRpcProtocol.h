@@ -0,0 +1,69 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <HTTP/HttpResponse.h>
+
+namespace System {
+class TcpConnection;
+}
+
+namespace CryptoNote {
+
+// Frame of a persistent binary RPC connection. A request carries the URL and body of the HTTP request it replaces,
+// a response carries the request id, HTTP status and body. Requests are answered in any order, several of them
+// may be in flight at once. Notifications are sent by the server without a request, with the URL naming the event.
+struct BinaryRpcFrame {
+  enum Type : uint32_t {
+    REQUEST = 1,
+    RESPONSE = 2,
+    NOTIFICATION = 3
+  };
+
+  uint32_t type;
+  uint32_t id;
+  uint32_t status;
+  std::string url;
+  std::string body;
+};
+
+const char BINARY_RPC_NOTIFY_BLOCKCHAIN_UPDATED[] = "/notify/blockchain_updated";
+const char BINARY_RPC_NOTIFY_POOL_CHANGED[] = "/notify/pool_changed";
+
+uint32_t toBinaryRpcStatus(HttpResponse::HTTP_STATUS status);
+HttpResponse::HTTP_STATUS fromBinaryRpcStatus(uint32_t status);
+
+class BinaryRpcProtocol {
+public:
+  explicit BinaryRpcProtocol(System::TcpConnection& connection);
+
+  // Returns false if the connection is closed by the peer
+  bool readFrame(BinaryRpcFrame& frame);
+  void writeFrame(const BinaryRpcFrame& frame);
+
+private:
+  bool readStrict(uint8_t* ptr, size_t size);
+  void writeStrict(const uint8_t* ptr, size_t size);
+
+  System::TcpConnection& m_conn;
+};
+
+}
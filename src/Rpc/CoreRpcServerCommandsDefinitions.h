@@ -125,6 +125,39 @@ struct COMMAND_RPC_GET_POOL_CHANGES {
   };
 };
 
+//-----------------------------------------------
+struct COMMAND_RPC_GET_POOL_CHANGES_SINCE {
+  struct request {
+    Crypto::Hash tailBlockId;
+    uint64_t poolVersion;                    // Version returned by the previous call, 0 if none
+    std::vector<Crypto::Hash> knownTxsIds;   // Used only if the daemon doesn't remember poolVersion
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(tailBlockId)
+      KV_MEMBER(poolVersion)
+      serializeAsBinary(knownTxsIds, "knownTxsIds", s);
+    }
+  };
+
+  struct response {
+    bool isTailBlockActual;
+    bool isDelta;                            // Changes are relative to poolVersion of the request, not to knownTxsIds
+    uint64_t poolVersion;
+    std::vector<TransactionPrefixInfo> addedTxs;
+    std::vector<Crypto::Hash> deletedTxsIds;
+    std::string status;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(isTailBlockActual)
+      KV_MEMBER(isDelta)
+      KV_MEMBER(poolVersion)
+      KV_MEMBER(addedTxs)
+      serializeAsBinary(deletedTxsIds, "deletedTxsIds", s);
+      KV_MEMBER(status)
+    }
+  };
+};
+
 struct COMMAND_RPC_GET_POOL_CHANGES_LITE {
   struct request {
     Crypto::Hash tailBlockId;
@@ -269,6 +302,11 @@ struct COMMAND_RPC_GET_INFO {
     uint64_t difficulty;
     uint64_t tx_count;
     uint64_t tx_pool_size;
+    uint64_t tx_pool_bytes;
+    uint64_t tx_pool_evictions;
+    uint64_t block_template_build_time;
+    uint64_t query_blocks_cache_hits;
+    uint64_t query_blocks_cache_misses;
     uint64_t alt_blocks_count;
     uint64_t outgoing_connections_count;
     uint64_t incoming_connections_count;
@@ -282,6 +320,11 @@ struct COMMAND_RPC_GET_INFO {
       KV_MEMBER(difficulty)
       KV_MEMBER(tx_count)
       KV_MEMBER(tx_pool_size)
+      KV_MEMBER(tx_pool_bytes)
+      KV_MEMBER(tx_pool_evictions)
+      KV_MEMBER(block_template_build_time)
+      KV_MEMBER(query_blocks_cache_hits)
+      KV_MEMBER(query_blocks_cache_misses)
       KV_MEMBER(alt_blocks_count)
       KV_MEMBER(outgoing_connections_count)
       KV_MEMBER(incoming_connections_count)
@@ -292,6 +335,35 @@ struct COMMAND_RPC_GET_INFO {
   };
 };
 
+//-----------------------------------------------
+struct COMMAND_RPC_GET_DB_STATS {
+  typedef EMPTY_STRUCT request;
+
+  struct response {
+    std::string status;
+    std::string profile;
+    bool column_families;
+    uint64_t block_cache_hits;
+    uint64_t block_cache_misses;
+    uint64_t bloom_filter_useful;
+    uint64_t stall_micros;
+    uint64_t pending_compaction_bytes;
+    uint64_t memtables_size;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(status)
+      KV_MEMBER(profile)
+      KV_MEMBER(column_families)
+      KV_MEMBER(block_cache_hits)
+      KV_MEMBER(block_cache_misses)
+      KV_MEMBER(bloom_filter_useful)
+      KV_MEMBER(stall_micros)
+      KV_MEMBER(pending_compaction_bytes)
+      KV_MEMBER(memtables_size)
+    }
+  };
+};
+
 //-----------------------------------------------
 struct COMMAND_RPC_STOP_MINING {
   typedef EMPTY_STRUCT request;
@@ -328,10 +400,12 @@ struct COMMAND_RPC_GETBLOCKTEMPLATE {
   struct request {
     uint64_t reserve_size; //max 255 bytes
     std::string wallet_address;
+    std::string longpoll_id; //optional, wait until the template differs from the one with this id
 
     void serialize(ISerializer &s) {
       KV_MEMBER(reserve_size)
       KV_MEMBER(wallet_address)
+      KV_MEMBER(longpoll_id)
     }
   };
 
@@ -340,6 +414,7 @@ struct COMMAND_RPC_GETBLOCKTEMPLATE {
     uint32_t height;
     uint64_t reserved_offset;
     std::string blocktemplate_blob;
+    std::string longpoll_id;
     std::string status;
 
     void serialize(ISerializer &s) {
@@ -347,6 +422,7 @@ struct COMMAND_RPC_GETBLOCKTEMPLATE {
       KV_MEMBER(height)
       KV_MEMBER(reserved_offset)
       KV_MEMBER(blocktemplate_blob)
+      KV_MEMBER(longpoll_id)
       KV_MEMBER(status)
     }
   };
@@ -513,6 +589,27 @@ struct COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES {
   };
 };
 
+struct COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS {
+  struct request {
+    std::vector<uint32_t> blockHeights;
+
+    void serialize(ISerializer& s) {
+      KV_MEMBER(blockHeights)
+    }
+  };
+
+  struct response {
+    // for every requested height: main chain block followed by alternative blocks on the same height
+    std::vector<BlockDetails> blocks;
+    std::string status;
+
+    void serialize(ISerializer& s) {
+      KV_MEMBER(status)
+      KV_MEMBER(blocks)
+    }
+  };
+};
+
 struct COMMAND_RPC_GET_BLOCKS_HASHES_BY_TIMESTAMPS {
   struct request {
     uint64_t timestampBegin;
@@ -555,6 +652,48 @@ struct COMMAND_RPC_GET_TRANSACTION_HASHES_BY_PAYMENT_ID {
   };
 };
 
+// Hashes of transactions spending the key images, NULL_HASH for unspent ones
+struct COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES {
+  struct request {
+    std::vector<Crypto::KeyImage> keyImages;
+
+    void serialize(ISerializer &s) {
+      serializeAsBinary(keyImages, "keyImages", s);
+    }
+  };
+
+  struct response {
+    std::vector<Crypto::Hash> transactionHashes;
+    std::string status;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(status)
+      serializeAsBinary(transactionHashes, "transactionHashes", s);
+    }
+  };
+};
+
+// Hashes of transactions creating the output keys, NULL_HASH for unknown ones
+struct COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS {
+  struct request {
+    std::vector<Crypto::PublicKey> outputKeys;
+
+    void serialize(ISerializer &s) {
+      serializeAsBinary(outputKeys, "outputKeys", s);
+    }
+  };
+
+  struct response {
+    std::vector<Crypto::Hash> transactionHashes;
+    std::string status;
+
+    void serialize(ISerializer &s) {
+      KV_MEMBER(status)
+      serializeAsBinary(transactionHashes, "transactionHashes", s);
+    }
+  };
+};
+
 struct COMMAND_RPC_GET_TRANSACTION_DETAILS_BY_HASHES {
   struct request {
     std::vector<Crypto::Hash> transactionHashes;
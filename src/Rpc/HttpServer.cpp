@@ -16,40 +16,228 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "HttpServer.h"
+#include <chrono>
+#include <future>
+#include <thread>
 #include <boost/scope_exit.hpp>
 
+#include <Common/Metrics.h>
 #include <HTTP/HttpParser.h>
+#include <System/EventLock.h>
 #include <System/InterruptedException.h>
+#include <System/RemoteContext.h>
 #include <System/TcpStream.h>
+#include <System/Timer.h>
 #include <System/Ipv4Address.h>
 
+#include "BinaryRpcProtocol.h"
+
+#undef ERROR
+
 using namespace Logging;
 
 namespace CryptoNote {
 
+namespace {
+
+const std::chrono::milliseconds DISPATCHER_LAG_PROBE_INTERVAL(100);
+
+}
+
+struct HttpServer::IoThread {
+  std::thread thread;
+  System::Dispatcher* dispatcher;
+  System::ContextGroup* contextGroup;
+  std::promise<void> started;
+  std::shared_future<void> allStarted;
+};
+
+struct HttpServer::BinaryConnection {
+  BinaryConnection(System::Dispatcher& dispatcher, System::TcpConnection&& connection) :
+    connection(std::move(connection)), writeEvent(dispatcher), contextGroup(dispatcher) {
+    writeEvent.set();
+  }
+
+  System::TcpConnection connection;
+  System::Event writeEvent;
+  // requests and notifications of the connection, declared last to be stopped before the connection is closed
+  System::ContextGroup contextGroup;
+};
+
 HttpServer::HttpServer(System::Dispatcher& dispatcher, Logging::ILogger& log)
-  : m_dispatcher(dispatcher), workingContextGroup(dispatcher), logger(log, "HttpServer") {
+  : m_dispatcher(dispatcher), workingContextGroup(dispatcher), logger(log, "HttpServer"), m_connectionCount(0) {
 
 }
 
-void HttpServer::start(const std::string& address, uint16_t port) {
-  m_listener = System::TcpListener(m_dispatcher, System::Ipv4Address(address), port);
-  workingContextGroup.spawn(std::bind(&HttpServer::acceptLoop, this));
+HttpServer::~HttpServer() {
+}
+
+void HttpServer::start(const std::string& address, uint16_t port, size_t ioThreadCount) {
+  if (Common::MetricsRegistry::instance().isEnabled()) {
+    workingContextGroup.spawn(std::bind(&HttpServer::dispatcherLagLoop, this));
+  }
+
+  if (ioThreadCount == 0) {
+    m_listener = System::TcpListener(m_dispatcher, System::Ipv4Address(address), port);
+    workingContextGroup.spawn(std::bind(&HttpServer::acceptLoop, this, std::ref(m_listener), std::ref(workingContextGroup)));
+    return;
+  }
+
+  // threads don't accept connections until all of them are started, so m_ioThreads isn't changed while it is read
+  std::promise<void> allStarted;
+  std::shared_future<void> allStartedFuture = allStarted.get_future().share();
+  for (size_t i = 0; i < ioThreadCount; ++i) {
+    std::unique_ptr<IoThread> ioThread(new IoThread);
+    ioThread->dispatcher = nullptr;
+    ioThread->contextGroup = nullptr;
+    ioThread->allStarted = allStartedFuture;
+    auto started = ioThread->started.get_future();
+    ioThread->thread = std::thread(&HttpServer::ioThreadProcedure, this, std::ref(*ioThread), address, port);
+    m_ioThreads.push_back(std::move(ioThread));
+
+    try {
+      started.get();
+    } catch (std::exception&) {
+      allStarted.set_exception(std::current_exception());
+      for (auto& startedThread : m_ioThreads) {
+        startedThread->thread.join();
+      }
+
+      m_ioThreads.clear();
+      throw;
+    }
+  }
+
+  allStarted.set_value();
+}
+
+void HttpServer::startBinary(const std::string& address, uint16_t port) {
+  m_binaryListener = System::TcpListener(m_dispatcher, System::Ipv4Address(address), port);
+  workingContextGroup.spawn(std::bind(&HttpServer::binaryAcceptLoop, this));
 }
 
 void HttpServer::stop() {
   workingContextGroup.interrupt();
+  if (!m_ioThreads.empty()) {
+    for (auto& ioThread : m_ioThreads) {
+      System::ContextGroup* contextGroup = ioThread->contextGroup;
+      ioThread->dispatcher->remoteSpawn([contextGroup] { contextGroup->interrupt(); });
+    }
+
+    // I/O threads may wait for procedures in this dispatcher, it has to work until they are stopped
+    System::RemoteContext<void>(m_dispatcher, [this] {
+      for (auto& ioThread : m_ioThreads) {
+        ioThread->thread.join();
+      }
+    }).get();
+
+    m_ioThreads.clear();
+  }
+
   workingContextGroup.wait();
 }
 
-void HttpServer::acceptLoop() {
+void HttpServer::invokeInDispatcher(std::function<void()>&& procedure) {
+  System::Dispatcher* ioDispatcher = getIoDispatcher();
+  if (ioDispatcher == nullptr) {
+    procedure();
+    return;
+  }
+
+  System::Event done(*ioDispatcher);
+  std::exception_ptr error;
+  m_dispatcher.remoteSpawn([&] {
+    workingContextGroup.spawn([&] {
+      try {
+        procedure();
+      } catch (std::exception&) {
+        error = std::current_exception();
+      }
+
+      ioDispatcher->remoteSpawn([&] { done.set(); });
+    });
+  });
+
+  // procedure refers to this frame, so it is waited for even if the context is interrupted
+  bool interrupted = false;
+  while (!done.get()) {
+    try {
+      done.wait();
+    } catch (System::InterruptedException&) {
+      interrupted = true;
+    }
+  }
+
+  if (interrupted) {
+    throw System::InterruptedException();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void HttpServer::ioThreadProcedure(IoThread& ioThread, const std::string& address, uint16_t port) {
+  bool started = false;
+  try {
+    System::Dispatcher dispatcher;
+    System::ContextGroup contextGroup(dispatcher);
+    System::TcpListener listener(dispatcher, System::Ipv4Address(address), port, true);
+    ioThread.dispatcher = &dispatcher;
+    ioThread.contextGroup = &contextGroup;
+    ioThread.started.set_value();
+    started = true;
+
+    try {
+      ioThread.allStarted.get();
+    } catch (std::exception&) {
+      return;
+    }
+
+    contextGroup.spawn(std::bind(&HttpServer::acceptLoop, this, std::ref(listener), std::ref(contextGroup)));
+    contextGroup.wait();
+  } catch (std::exception& e) {
+    if (started) {
+      logger(ERROR) << "I/O thread failed: " << e.what();
+    } else {
+      ioThread.started.set_exception(std::current_exception());
+    }
+  }
+}
+
+void HttpServer::notifyBinaryConnections(const std::string& url, const std::string& body) {
+  auto frame = std::make_shared<BinaryRpcFrame>();
+  frame->type = BinaryRpcFrame::NOTIFICATION;
+  frame->id = 0;
+  frame->status = 0;
+  frame->url = url;
+  frame->body = body;
+  for (BinaryConnection* connection : m_binaryConnections) {
+    connection->contextGroup.spawn([this, connection, frame] {
+      writeBinaryFrame(*connection, *frame);
+    });
+  }
+}
+
+System::Dispatcher* HttpServer::getIoDispatcher() const {
+  auto threadId = std::this_thread::get_id();
+  for (auto& ioThread : m_ioThreads) {
+    if (ioThread->thread.get_id() == threadId) {
+      return ioThread->dispatcher;
+    }
+  }
+
+  return nullptr;
+}
+
+void HttpServer::acceptLoop(System::TcpListener& listener, System::ContextGroup& contextGroup) {
   try {
     System::TcpConnection connection;
     bool accepted = false;
 
     while (!accepted) {
       try {
-        connection = m_listener.accept();
+        connection = listener.accept();
         accepted = true;
       } catch (System::InterruptedException&) {
         throw;
@@ -58,15 +246,15 @@ void HttpServer::acceptLoop() {
       }
     }
 
-    m_connections.insert(&connection);
-    BOOST_SCOPE_EXIT_ALL(this, &connection) { 
-      m_connections.erase(&connection); };
+    ++m_connectionCount;
+    BOOST_SCOPE_EXIT_ALL(this) { 
+      --m_connectionCount; };
 
     auto addr = connection.getPeerAddressAndPort();
 
     logger(DEBUGGING) << "Incoming connection from " << addr.first.toDottedDecimal() << ":" << addr.second;
 
-    workingContextGroup.spawn(std::bind(&HttpServer::acceptLoop, this));
+    contextGroup.spawn(std::bind(&HttpServer::acceptLoop, this, std::ref(listener), std::ref(contextGroup)));
 
     System::TcpStreambuf streambuf(connection);
     std::iostream stream(&streambuf);
@@ -87,7 +275,7 @@ void HttpServer::acceptLoop() {
       }
     }
 
-    logger(DEBUGGING) << "Closing connection from " << addr.first.toDottedDecimal() << ":" << addr.second << " total=" << m_connections.size();
+    logger(DEBUGGING) << "Closing connection from " << addr.first.toDottedDecimal() << ":" << addr.second << " total=" << m_connectionCount;
 
   } catch (System::InterruptedException&) {
   } catch (std::exception& e) {
@@ -95,4 +283,98 @@ void HttpServer::acceptLoop() {
   }
 }
 
+void HttpServer::binaryAcceptLoop() {
+  try {
+    System::TcpConnection tcpConnection;
+    bool accepted = false;
+
+    while (!accepted) {
+      try {
+        tcpConnection = m_binaryListener.accept();
+        accepted = true;
+      } catch (System::InterruptedException&) {
+        throw;
+      } catch (std::exception&) {
+        // try again
+      }
+    }
+
+    workingContextGroup.spawn(std::bind(&HttpServer::binaryAcceptLoop, this));
+
+    auto addr = tcpConnection.getPeerAddressAndPort();
+    logger(DEBUGGING) << "Incoming binary connection from " << addr.first.toDottedDecimal() << ":" << addr.second;
+
+    BinaryConnection connection(m_dispatcher, std::move(tcpConnection));
+    auto connectionIt = m_binaryConnections.insert(m_binaryConnections.end(), &connection);
+    BOOST_SCOPE_EXIT_ALL(this, connectionIt) {
+      m_binaryConnections.erase(connectionIt); };
+
+    BinaryRpcProtocol protocol(connection.connection);
+    BinaryRpcFrame frame;
+    while (protocol.readFrame(frame)) {
+      if (frame.type != BinaryRpcFrame::REQUEST) {
+        throw std::runtime_error("Unexpected binary RPC frame");
+      }
+
+      auto request = std::make_shared<HttpRequest>();
+      request->setUrl(frame.url);
+      request->setBody(frame.body);
+      uint32_t requestId = frame.id;
+      connection.contextGroup.spawn([this, &connection, request, requestId] {
+        processBinaryRequest(connection, *request, requestId);
+      });
+    }
+
+    logger(DEBUGGING) << "Closing binary connection from " << addr.first.toDottedDecimal() << ":" << addr.second;
+
+  } catch (System::InterruptedException&) {
+  } catch (std::exception& e) {
+    logger(WARNING) << "Binary connection error: " << e.what();
+  }
+}
+
+// Measures how late a timer wakes up, that is how long other contexts of the dispatcher run without switching
+void HttpServer::dispatcherLagLoop() {
+  Common::MetricHistogram& lag = Common::MetricsRegistry::instance().histogram("dispatcher_lag_microseconds",
+    "Delay of timer wakeups in the dispatcher processing RPC requests");
+  System::Timer timer(m_dispatcher);
+  try {
+    for (;;) {
+      auto start = std::chrono::steady_clock::now();
+      timer.sleep(DISPATCHER_LAG_PROBE_INTERVAL);
+      auto delay = std::chrono::steady_clock::now() - start - DISPATCHER_LAG_PROBE_INTERVAL;
+      lag.record(delay.count() > 0 ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(delay).count()) : 0);
+    }
+  } catch (System::InterruptedException&) {
+  }
+}
+
+void HttpServer::processBinaryRequest(BinaryConnection& connection, const HttpRequest& request, uint32_t requestId) {
+  HttpResponse response;
+  try {
+    processRequest(request, response);
+  } catch (System::InterruptedException&) {
+    return;
+  } catch (std::exception& e) {
+    logger(WARNING) << "Binary request error: " << e.what();
+    response.setStatus(HttpResponse::STATUS_500);
+  }
+
+  BinaryRpcFrame frame;
+  frame.type = BinaryRpcFrame::RESPONSE;
+  frame.id = requestId;
+  frame.status = toBinaryRpcStatus(response.getStatus());
+  frame.body = response.getBody();
+  writeBinaryFrame(connection, frame);
+}
+
+void HttpServer::writeBinaryFrame(BinaryConnection& connection, const BinaryRpcFrame& frame) {
+  try {
+    System::EventLock writeLock(connection.writeEvent);
+    BinaryRpcProtocol(connection.connection).writeFrame(frame);
+  } catch (std::exception&) {
+    // the connection is closed, its reading context stops
+  }
+}
+
 }
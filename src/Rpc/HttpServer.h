@@ -17,7 +17,11 @@
 
 #pragma once 
 
-#include <unordered_set>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
 
 #include <HTTP/HttpRequest.h>
 #include <HTTP/HttpResponse.h>
@@ -32,30 +36,57 @@
 
 namespace CryptoNote {
 
+struct BinaryRpcFrame;
+
 class HttpServer {
 
 public:
 
   HttpServer(System::Dispatcher& dispatcher, Logging::ILogger& log);
+  virtual ~HttpServer();
+
+  // With ioThreadCount > 0 connections are accepted, read and written in that many threads with their own dispatchers,
+  // so processRequest is called in them too. With metrics enabled the server also reports lag of its dispatcher
+  void start(const std::string& address, uint16_t port, size_t ioThreadCount = 0);
 
-  void start(const std::string& address, uint16_t port);
+  // Accepts persistent connections with binary framed requests (see BinaryRpcProtocol), they are passed to processRequest
+  // in the server dispatcher, several requests of a connection are processed concurrently
+  virtual void startBinary(const std::string& address, uint16_t port);
   void stop();
 
   virtual void processRequest(const HttpRequest& request, HttpResponse& response) = 0;
 
+  // Runs procedure in the server dispatcher and waits for it, rethrows its exception
+  void invokeInDispatcher(std::function<void()>&& procedure);
+
 protected:
 
+  // Sends a notification frame to every binary connection, must be called in the server dispatcher
+  void notifyBinaryConnections(const std::string& url, const std::string& body);
+
   System::Dispatcher& m_dispatcher;
 
 private:
 
-  void acceptLoop();
+  struct IoThread;
+  struct BinaryConnection;
+
+  void acceptLoop(System::TcpListener& listener, System::ContextGroup& contextGroup);
+  void binaryAcceptLoop();
+  void dispatcherLagLoop();
+  void processBinaryRequest(BinaryConnection& connection, const HttpRequest& request, uint32_t requestId);
+  void writeBinaryFrame(BinaryConnection& connection, const BinaryRpcFrame& frame);
   void connectionHandler(System::TcpConnection&& conn);
+  void ioThreadProcedure(IoThread& ioThread, const std::string& address, uint16_t port);
+  System::Dispatcher* getIoDispatcher() const;
 
   System::ContextGroup workingContextGroup;
   Logging::LoggerRef logger;
   System::TcpListener m_listener;
-  std::unordered_set<System::TcpConnection*> m_connections;
+  System::TcpListener m_binaryListener;
+  std::list<BinaryConnection*> m_binaryConnections;
+  std::atomic<size_t> m_connectionCount;
+  std::vector<std::unique_ptr<IoThread>> m_ioThreads;
 };
 
 }
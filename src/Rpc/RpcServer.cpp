@@ -21,16 +21,23 @@
 #include <unordered_map>
 
 // CryptoNote
+#include "Common/Metrics.h"
 #include "Common/StringTools.h"
 #include "CryptoNoteCore/CryptoNoteTools.h"
 #include "CryptoNoteCore/Core.h"
+#include "CryptoNoteCore/MessageQueue.h"
 #include "CryptoNoteCore/Miner.h"
+#include "CryptoNoteCore/RocksDBWrapper.h"
 #include "CryptoNoteCore/TransactionExtra.h"
 
 #include "CryptoNoteProtocol/CryptoNoteProtocolHandlerCommon.h"
 
 #include "P2p/NetNode.h"
 
+#include <System/InterruptedException.h>
+#include <System/Timer.h>
+
+#include "BinaryRpcProtocol.h"
 #include "CoreRpcServerErrorCodes.h"
 #include "JsonRpc.h"
 
@@ -68,6 +75,18 @@ void serialize(BlockShortInfo& blockShortInfo, ISerializer& s) {
 
 namespace {
 
+const std::chrono::seconds BLOCK_TEMPLATE_LONG_POLL_TIMEOUT(60);
+
+// looking a histogram up takes the registry lock, so it is done only when metrics are enabled
+Common::MetricHistogram* findDurationHistogram(const char* name, const char* help, const char* label, const std::string& value) {
+  Common::MetricsRegistry& registry = Common::MetricsRegistry::instance();
+  if (!registry.isEnabled()) {
+    return nullptr;
+  }
+
+  return &registry.histogram(name, help, std::string(label) + "=\"" + value + "\"");
+}
+
 template <typename Command>
 RpcServer::HandlerFunction binMethod(bool (RpcServer::*handler)(typename Command::request const&, typename Command::response&)) {
   return [handler](RpcServer* obj, const HttpRequest& request, HttpResponse& response) {
@@ -79,7 +98,8 @@ RpcServer::HandlerFunction binMethod(bool (RpcServer::*handler)(typename Command
       return false;
     }
 
-    bool result = (obj->*handler)(req, res);
+    bool result;
+    obj->invokeInDispatcher([&] { result = (obj->*handler)(req, res); });
     response.setBody(storeToBinaryKeyValue(res.data()));
     return result;
   };
@@ -96,7 +116,8 @@ RpcServer::HandlerFunction jsonMethod(bool (RpcServer::*handler)(typename Comman
       return false;
     }
 
-    bool result = (obj->*handler)(req, res);
+    bool result;
+    obj->invokeInDispatcher([&] { result = (obj->*handler)(req, res); });
     response.setBody(storeToJson(res.data()));
     return result;
   };
@@ -115,24 +136,65 @@ std::unordered_map<std::string, RpcServer::RpcHandler<RpcServer::HandlerFunction
   { "/getrandom_outs.bin", { binMethod<COMMAND_RPC_GET_RANDOM_OUTPUTS_FOR_AMOUNTS>(&RpcServer::on_get_random_outs), false } },
   { "/get_pool_changes.bin", { binMethod<COMMAND_RPC_GET_POOL_CHANGES>(&RpcServer::onGetPoolChanges), false } },
   { "/get_pool_changes_lite.bin", { binMethod<COMMAND_RPC_GET_POOL_CHANGES_LITE>(&RpcServer::onGetPoolChangesLite), false } },
+  { "/get_pool_changes_since.bin", { binMethod<COMMAND_RPC_GET_POOL_CHANGES_SINCE>(&RpcServer::onGetPoolChangesSince), false } },
   { "/get_blocks_details_by_hashes.bin", { binMethod<COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES>(&RpcServer::onGetBlocksDetailsByHashes), false } },
+  { "/get_blocks_details_by_heights.bin", { binMethod<COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS>(&RpcServer::onGetBlocksDetailsByHeights), false } },
   { "/get_blocks_hashes_by_timestamps.bin", { binMethod<COMMAND_RPC_GET_BLOCKS_HASHES_BY_TIMESTAMPS>(&RpcServer::onGetBlocksHashesByTimestamps), false } },
   { "/get_transaction_details_by_hashes.bin", { binMethod<COMMAND_RPC_GET_TRANSACTION_DETAILS_BY_HASHES>(&RpcServer::onGetTransactionDetailsByHashes), false } },
   { "/get_transaction_hashes_by_payment_id.bin", { binMethod<COMMAND_RPC_GET_TRANSACTION_HASHES_BY_PAYMENT_ID>(&RpcServer::onGetTransactionHashesByPaymentId), false } },
+  { "/get_transaction_hashes_by_key_images.bin", { binMethod<COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES>(&RpcServer::onGetTransactionHashesByKeyImages), false } },
+  { "/get_transaction_hashes_by_output_keys.bin", { binMethod<COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS>(&RpcServer::onGetTransactionHashesByOutputKeys), false } },
 
   // json handlers
   { "/getinfo", { jsonMethod<COMMAND_RPC_GET_INFO>(&RpcServer::on_get_info), true } },
+  { "/getdbstats", { jsonMethod<COMMAND_RPC_GET_DB_STATS>(&RpcServer::on_get_db_stats), true } },
   { "/getheight", { jsonMethod<COMMAND_RPC_GET_HEIGHT>(&RpcServer::on_get_height), true } },
   { "/gettransactions", { jsonMethod<COMMAND_RPC_GET_TRANSACTIONS>(&RpcServer::on_get_transactions), false } },
   { "/sendrawtransaction", { jsonMethod<COMMAND_RPC_SEND_RAW_TX>(&RpcServer::on_send_raw_tx), false } },
   { "/stop_daemon", { jsonMethod<COMMAND_RPC_STOP_DAEMON>(&RpcServer::on_stop_daemon), true } },
 
   // json rpc
-  { "/json_rpc", { std::bind(&RpcServer::processJsonRpcRequest, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), true } }
+  { "/json_rpc", { std::bind(&RpcServer::processJsonRpcRequest, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), true } },
+
+  // prometheus text
+  { "/metrics", { std::bind(&RpcServer::onMetrics, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), true } }
 };
 
-RpcServer::RpcServer(System::Dispatcher& dispatcher, Logging::ILogger& log, Core& c, NodeServer& p2p, ICryptoNoteProtocolHandler& protocol) :
-  HttpServer(dispatcher, log), logger(log, "RpcServer"), m_core(c), m_p2p(p2p), m_protocol(protocol) {
+RpcServer::RpcServer(System::Dispatcher& dispatcher, Logging::ILogger& log, Core& c, NodeServer& p2p, ICryptoNoteProtocolHandler& protocol, RocksDBWrapper& database) :
+  HttpServer(dispatcher, log), logger(log, "RpcServer"), m_core(c), m_p2p(p2p), m_protocol(protocol), m_database(database),
+  m_notificationContext(dispatcher) {
+}
+
+RpcServer::~RpcServer() {
+  if (m_blockchainMessages) {
+    m_blockchainMessages->stop();
+    m_notificationContext.wait();
+    m_core.removeMessageQueue(*m_blockchainMessages);
+    // messages are pushed to the queue with remote spawns, run them before it is destroyed
+    m_dispatcher.yield();
+  }
+}
+
+void RpcServer::startBinary(const std::string& address, uint16_t port) {
+  HttpServer::startBinary(address, port);
+  m_blockchainMessages.reset(new MessageQueue<BlockchainMessage>(m_dispatcher));
+  m_core.addMessageQueue(*m_blockchainMessages);
+  m_notificationContext.spawn(std::bind(&RpcServer::notificationLoop, this));
+}
+
+void RpcServer::notificationLoop() {
+  try {
+    for (;;) {
+      BlockchainMessage::Type type = m_blockchainMessages->front().getType();
+      m_blockchainMessages->pop();
+      if (type == BlockchainMessage::Type::AddTransaction || type == BlockchainMessage::Type::DeleteTransaction) {
+        notifyBinaryConnections(BINARY_RPC_NOTIFY_POOL_CHANGED, "");
+      } else if (type != BlockchainMessage::Type::NewAlternativeBlock) {
+        notifyBinaryConnections(BINARY_RPC_NOTIFY_BLOCKCHAIN_UPDATED, "");
+      }
+    }
+  } catch (System::InterruptedException&) {
+  }
 }
 
 void RpcServer::processRequest(const HttpRequest& request, HttpResponse& response) {
@@ -152,6 +214,7 @@ void RpcServer::processRequest(const HttpRequest& request, HttpResponse& respons
     return;
   }
 
+  Common::MetricTimer durationTimer(findDurationHistogram("rpc_request_duration_microseconds", "Time of RPC request processing", "url", url));
   it->second.handler(this, request, response);
 }
 
@@ -189,7 +252,9 @@ bool RpcServer::processJsonRpcRequest(const HttpRequest& request, HttpResponse&
       throw JsonRpcError(CORE_RPC_ERROR_CODE_CORE_BUSY, "Core is busy");
     }
 
-    it->second.handler(this, jsonRequest, jsonResponse);
+    Common::MetricTimer durationTimer(findDurationHistogram("rpc_json_rpc_duration_microseconds", "Time of JSON-RPC method processing",
+      "method", jsonRequest.getMethod()));
+    invokeInDispatcher([&] { it->second.handler(this, jsonRequest, jsonResponse); });
 
   } catch (const JsonRpcError& err) {
     jsonResponse.setError(err);
@@ -202,6 +267,19 @@ bool RpcServer::processJsonRpcRequest(const HttpRequest& request, HttpResponse&
   return true;
 }
 
+bool RpcServer::onMetrics(const HttpRequest& request, HttpResponse& response) {
+  Common::MetricsRegistry& registry = Common::MetricsRegistry::instance();
+  if (!registry.isEnabled()) {
+    response.setStatus(HttpResponse::STATUS_404);
+    return false;
+  }
+
+  response.addHeader("Content-Type", "text/plain; version=0.0.4");
+  response.setBody(registry.toPrometheusText());
+  return true;
+}
+
+// Called in I/O threads too, reads atomic flag only
 bool RpcServer::isCoreReady() {
   return m_core.getCurrency().isTestnet() || m_p2p.get_payload_object().isSynchronized();
 }
@@ -338,14 +416,45 @@ bool RpcServer::onGetPoolChangesLite(const COMMAND_RPC_GET_POOL_CHANGES_LITE::re
   return true;
 }
 
+bool RpcServer::onGetPoolChangesSince(const COMMAND_RPC_GET_POOL_CHANGES_SINCE::request& req, COMMAND_RPC_GET_POOL_CHANGES_SINCE::response& rsp) {
+  rsp.status = CORE_RPC_STATUS_OK;
+  rsp.poolVersion = req.poolVersion;
+  rsp.isTailBlockActual = m_core.getPoolChangesLiteSince(req.tailBlockId, rsp.poolVersion, req.knownTxsIds, rsp.addedTxs, rsp.deletedTxsIds, rsp.isDelta);
+
+  return true;
+}
+
 bool RpcServer::onGetBlocksDetailsByHashes(const COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES::request& req, COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HASHES::response& rsp) {
   try {
-    std::vector<BlockDetails> blockDetails;
-    for (const Crypto::Hash& hash : req.blockHashes) {
-      blockDetails.push_back(m_core.getBlockDetails(hash));
+    rsp.blocks = m_core.getBlocksDetails(req.blockHashes);
+  } catch (std::system_error& e) {
+    rsp.status = e.what();
+    return false;
+  } catch (std::exception& e) {
+    rsp.status = "Error: " + std::string(e.what());
+    return false;
+  }
+
+  rsp.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool RpcServer::onGetBlocksDetailsByHeights(const COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS::request& req, COMMAND_RPC_GET_BLOCKS_DETAILS_BY_HEIGHTS::response& rsp) {
+  try {
+    uint32_t topIndex = m_core.getTopBlockIndex();
+    std::vector<Crypto::Hash> blockHashes;
+    blockHashes.reserve(req.blockHeights.size());
+    for (uint32_t height : req.blockHeights) {
+      if (height > topIndex) {
+        throw std::runtime_error("Requested height " + std::to_string(height) + " is greater than top block index " + std::to_string(topIndex));
+      }
+
+      blockHashes.push_back(m_core.getBlockHashByIndex(height));
+      std::vector<Crypto::Hash> alternativeBlockHashes = m_core.getAlternativeBlockHashesByIndex(height);
+      blockHashes.insert(blockHashes.end(), alternativeBlockHashes.begin(), alternativeBlockHashes.end());
     }
 
-    rsp.blocks = std::move(blockDetails);
+    rsp.blocks = m_core.getBlocksDetails(blockHashes);
   } catch (std::system_error& e) {
     rsp.status = e.what();
     return false;
@@ -411,6 +520,36 @@ bool RpcServer::onGetTransactionHashesByPaymentId(const COMMAND_RPC_GET_TRANSACT
   return true;
 }
 
+bool RpcServer::onGetTransactionHashesByKeyImages(const COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES::request& req, COMMAND_RPC_GET_TRANSACTION_HASHES_BY_KEY_IMAGES::response& rsp) {
+  try {
+    rsp.transactionHashes = m_core.getTransactionHashesByKeyImages(req.keyImages);
+  } catch (std::system_error& e) {
+    rsp.status = e.what();
+    return false;
+  } catch (std::exception& e) {
+    rsp.status = "Error: " + std::string(e.what());
+    return false;
+  }
+
+  rsp.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool RpcServer::onGetTransactionHashesByOutputKeys(const COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS::request& req, COMMAND_RPC_GET_TRANSACTION_HASHES_BY_OUTPUT_KEYS::response& rsp) {
+  try {
+    rsp.transactionHashes = m_core.getTransactionHashesByOutputKeys(req.outputKeys);
+  } catch (std::system_error& e) {
+    rsp.status = e.what();
+    return false;
+  } catch (std::exception& e) {
+    rsp.status = "Error: " + std::string(e.what());
+    return false;
+  }
+
+  rsp.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
 //
 // JSON handlers
 //
@@ -419,8 +558,14 @@ bool RpcServer::on_get_info(const COMMAND_RPC_GET_INFO::request& req, COMMAND_RP
   res.height = m_core.getTopBlockIndex() + 1;
   res.difficulty = m_core.getDifficultyForNextBlock();
   res.tx_count = m_core.getBlockchainTransactionCount() - res.height; //without coinbase
-  res.tx_pool_size = m_core.getPoolTransactionCount();
-  res.alt_blocks_count = m_core.getAlternativeBlockCount();
+  CoreStatistics statistics = m_core.getCoreStatistics();
+  res.tx_pool_size = statistics.transactionPoolSize;
+  res.tx_pool_bytes = statistics.transactionPoolBytes;
+  res.tx_pool_evictions = statistics.transactionPoolEvictions;
+  res.block_template_build_time = statistics.blockTemplateBuildTime;
+  res.query_blocks_cache_hits = statistics.queryBlocksCacheHits;
+  res.query_blocks_cache_misses = statistics.queryBlocksCacheMisses;
+  res.alt_blocks_count = statistics.alternativeBlockCount;
   uint64_t total_conn = m_p2p.get_connections_count();
   res.outgoing_connections_count = m_p2p.get_outgoing_connections_count();
   res.incoming_connections_count = total_conn - res.outgoing_connections_count;
@@ -431,6 +576,20 @@ bool RpcServer::on_get_info(const COMMAND_RPC_GET_INFO::request& req, COMMAND_RP
   return true;
 }
 
+bool RpcServer::on_get_db_stats(const COMMAND_RPC_GET_DB_STATS::request& req, COMMAND_RPC_GET_DB_STATS::response& res) {
+  DataBaseStatistics statistics = m_database.getStatistics();
+  res.profile = DataBaseConfig::profileToString(m_database.getProfile());
+  res.column_families = m_database.hasColumnFamilies();
+  res.block_cache_hits = statistics.blockCacheHits;
+  res.block_cache_misses = statistics.blockCacheMisses;
+  res.bloom_filter_useful = statistics.bloomFilterUseful;
+  res.stall_micros = statistics.stallMicros;
+  res.pending_compaction_bytes = statistics.pendingCompactionBytes;
+  res.memtables_size = statistics.memTablesSize;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
 bool RpcServer::on_get_height(const COMMAND_RPC_GET_HEIGHT::request& req, COMMAND_RPC_GET_HEIGHT::response& res) {
   res.height = m_core.getTopBlockIndex() + 1;
   res.status = CORE_RPC_STATUS_OK;
@@ -559,6 +718,10 @@ bool RpcServer::on_getblocktemplate(const COMMAND_RPC_GETBLOCKTEMPLATE::request&
     throw JsonRpc::JsonRpcError{ CORE_RPC_ERROR_CODE_WRONG_WALLET_ADDRESS, "Failed to parse wallet address" };
   }
 
+  if (!req.longpoll_id.empty()) {
+    waitForBlockTemplateChange(req.longpoll_id);
+  }
+
   BlockTemplate blockTemplate = boost::value_initialized<BlockTemplate>();
   CryptoNote::BinaryArray blob_reserve;
   blob_reserve.resize(req.reserve_size, 0);
@@ -591,11 +754,43 @@ bool RpcServer::on_getblocktemplate(const COMMAND_RPC_GETBLOCKTEMPLATE::request&
   }
 
   res.blocktemplate_blob = toHex(block_blob);
+  res.longpoll_id = getBlockTemplateId();
   res.status = CORE_RPC_STATUS_OK;
 
   return true;
 }
 
+std::string RpcServer::getBlockTemplateId() const {
+  return podToHex(m_core.getTopBlockHash()) + std::to_string(m_core.getPoolGeneration());
+}
+
+void RpcServer::waitForBlockTemplateChange(const std::string& blockTemplateId) {
+  System::Event waitFinished(m_dispatcher);
+  System::ContextGroup waitGroup(m_dispatcher);
+
+  waitGroup.spawn([&] {
+    try {
+      while (getBlockTemplateId() == blockTemplateId) {
+        m_core.waitForBlockTemplateChange();
+      }
+    } catch (System::InterruptedException&) {
+    }
+
+    waitFinished.set();
+  });
+
+  waitGroup.spawn([&] {
+    try {
+      System::Timer(m_dispatcher).sleep(BLOCK_TEMPLATE_LONG_POLL_TIMEOUT);
+    } catch (System::InterruptedException&) {
+    }
+
+    waitFinished.set();
+  });
+
+  waitFinished.wait();
+}
+
 bool RpcServer::on_get_currency_id(const COMMAND_RPC_GET_CURRENCY_ID::request& /*req*/, COMMAND_RPC_GET_CURRENCY_ID::response& res) {
   Hash genesisBlockHash = m_core.getCurrency().genesisBlockHash();
   res.currency_id_blob = Common::podToHex(genesisBlockHash);
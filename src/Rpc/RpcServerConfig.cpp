@@ -28,10 +28,14 @@ namespace CryptoNote {
 
     const command_line::arg_descriptor<std::string> arg_rpc_bind_ip = { "rpc-bind-ip", "", DEFAULT_RPC_IP };
     const command_line::arg_descriptor<uint16_t> arg_rpc_bind_port = { "rpc-bind-port", "", DEFAULT_RPC_PORT };
+    const command_line::arg_descriptor<uint16_t> arg_rpc_io_threads = { "rpc-io-threads",
+      "Number of threads reading, decoding and encoding RPC requests, 0 to do it in the core thread", 0 };
+    const command_line::arg_descriptor<uint16_t> arg_rpc_bind_binary_port = { "rpc-bind-binary-port",
+      "Port for persistent binary RPC connections of wallets and payment gates, 0 to disable them", 0 };
   }
 
 
-  RpcServerConfig::RpcServerConfig() : bindIp(DEFAULT_RPC_IP), bindPort(DEFAULT_RPC_PORT) {
+  RpcServerConfig::RpcServerConfig() : bindIp(DEFAULT_RPC_IP), bindPort(DEFAULT_RPC_PORT), ioThreads(0), binaryPort(0) {
   }
 
   std::string RpcServerConfig::getBindAddress() const {
@@ -41,11 +45,15 @@ namespace CryptoNote {
   void RpcServerConfig::initOptions(boost::program_options::options_description& desc) {
     command_line::add_arg(desc, arg_rpc_bind_ip);
     command_line::add_arg(desc, arg_rpc_bind_port);
+    command_line::add_arg(desc, arg_rpc_io_threads);
+    command_line::add_arg(desc, arg_rpc_bind_binary_port);
   }
 
   void RpcServerConfig::init(const boost::program_options::variables_map& vm)  {
     bindIp = command_line::get_arg(vm, arg_rpc_bind_ip);
     bindPort = command_line::get_arg(vm, arg_rpc_bind_port);
+    ioThreads = command_line::get_arg(vm, arg_rpc_io_threads);
+    binaryPort = command_line::get_arg(vm, arg_rpc_bind_binary_port);
   }
 
 }
@@ -33,6 +33,8 @@ public:
 
   std::string bindIp;
   uint16_t bindPort;
+  uint16_t ioThreads;
+  uint16_t binaryPort;
 };
 
 }
@@ -77,7 +77,8 @@ BlockchainSynchronizer::BlockchainSynchronizer(INode& node, Logging::ILogger& lo
   m_node(node),
   m_genesisBlockHash(genesisBlockHash),
   m_currentState(State::stopped),
-  m_futureState(State::stopped) {
+  m_futureState(State::stopped),
+  m_poolVersion(0) {
 }
 
 BlockchainSynchronizer::~BlockchainSynchronizer() {
@@ -336,6 +337,8 @@ void BlockchainSynchronizer::workingProcedure() {
   }
 
   actualizeFutureState();
+  // query may still be in progress, the node callback keeps it alive
+  m_prefetchedBlocks.reset();
 
   m_logger(DEBUGGING) << "Working thread stopped";
 }
@@ -446,33 +449,36 @@ BlockchainSynchronizer::GetBlocksRequest BlockchainSynchronizer::getCommonHistor
 void BlockchainSynchronizer::startBlockchainSync() {
   m_logger(DEBUGGING) << "Starting blockchain synchronization...";
 
-  GetBlocksResponse response;
   GetBlocksRequest req = getCommonHistory();
 
   try {
     if (!req.knownBlocks.empty()) {
-      auto queryBlocksCompleted = std::promise<std::error_code>();
-      auto queryBlocksWaitFuture = queryBlocksCompleted.get_future();
-
-      m_node.queryBlocks(
-        std::move(req.knownBlocks),
-        req.syncStart.timestamp,
-        response.newBlocks,
-        response.startHeight,
-        [&queryBlocksCompleted](std::error_code ec) {
-          auto detachedPromise = std::move(queryBlocksCompleted);
-          detachedPromise.set_value(ec);
-        });
+      std::error_code ec;
+      auto query = takePrefetchedBlocks(req);
+      if (query) {
+        auto waitStart = std::chrono::steady_clock::now();
+        ec = query->completed.get();
+        m_logger(DEBUGGING) << "Prefetched blocks waited for " <<
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - waitStart).count() << " ms";
+        if (ec) {
+          m_logger(DEBUGGING) << "Prefetched blocks query failed, request them again: " << ec << ", " << ec.message();
+          query.reset();
+        }
+      }
 
-      std::error_code ec = queryBlocksWaitFuture.get();
+      if (!query) {
+        query = startBlocksQuery(std::move(req));
+        ec = query->completed.get();
+      }
 
       if (ec) {
         m_logger(ERROR, BRIGHT_RED) << "Failed to query blocks: " << ec << ", " << ec.message();
         setFutureStateIf(State::idle, [this] { return m_futureState != State::stopped; });
         m_observerManager.notify(&IBlockchainSynchronizerObserver::synchronizationCompleted, ec);
       } else {
-        m_logger(DEBUGGING) << "Blocks received, start index " << response.startHeight << ", count " << response.newBlocks.size();
-        processBlocks(response);
+        m_logger(DEBUGGING) << "Blocks received, start index " << query->response.startHeight << ", count " << query->response.newBlocks.size();
+        prefetchBlocks(*query);
+        processBlocks(query->response);
       }
     }
   } catch (const std::exception& e) {
@@ -482,6 +488,83 @@ void BlockchainSynchronizer::startBlockchainSync() {
   }
 }
 
+std::shared_ptr<BlockchainSynchronizer::BlocksQuery> BlockchainSynchronizer::startBlocksQuery(GetBlocksRequest&& request) {
+  auto query = std::make_shared<BlocksQuery>();
+  query->request = std::move(request);
+
+  auto queryCompleted = std::make_shared<std::promise<std::error_code>>();
+  query->completed = queryCompleted->get_future();
+
+  // query is owned by the callback as well: a prefetched query can be dropped before the node completes it
+  m_node.queryBlocks(
+    std::vector<Crypto::Hash>(query->request.knownBlocks),
+    query->request.syncStart.timestamp,
+    query->response.newBlocks,
+    query->response.startHeight,
+    [query, queryCompleted](std::error_code ec) {
+      queryCompleted->set_value(ec);
+    });
+
+  return query;
+}
+
+std::shared_ptr<BlockchainSynchronizer::BlocksQuery> BlockchainSynchronizer::takePrefetchedBlocks(const GetBlocksRequest& request) {
+  auto query = std::move(m_prefetchedBlocks);
+  m_prefetchedBlocks.reset();
+  if (!query) {
+    return query;
+  }
+
+  // prefetched request was predicted from the previous response, it is usable only if consumers ended up where it expected
+  if (query->request.knownBlocks != request.knownBlocks ||
+      query->request.syncStart.timestamp != request.syncStart.timestamp ||
+      query->request.syncStart.height != request.syncStart.height) {
+    m_logger(DEBUGGING) << "Prefetched blocks discarded, consumers state differs from the predicted one";
+    query.reset();
+  }
+
+  return query;
+}
+
+void BlockchainSynchronizer::prefetchBlocks(const BlocksQuery& query) {
+  const auto& response = query.response;
+  if (response.newBlocks.empty() || checkIfShouldStop()) {
+    return;
+  }
+
+  uint32_t responseEnd = response.startHeight + static_cast<uint32_t>(response.newBlocks.size());
+  if (responseEnd >= std::max(m_node.getKnownBlockCount(), m_node.getLocalBlockCount())) {
+    return;
+  }
+
+  std::vector<Crypto::Hash> blockHashes;
+  blockHashes.reserve(response.newBlocks.size());
+  for (const auto& block : response.newBlocks) {
+    blockHashes.push_back(block.blockHash);
+  }
+
+  GetBlocksRequest request;
+  request.syncStart = query.request.syncStart;
+
+  {
+    std::unique_lock<std::mutex> lk(m_consumersMutex);
+    auto shortest = std::min_element(m_consumers.begin(), m_consumers.end(), [](const ConsumersMap::value_type& a, const ConsumersMap::value_type& b) {
+      return a.second->getHeight() < b.second->getHeight();
+    });
+
+    if (shortest == m_consumers.end() || shortest->second->getHeight() < response.startHeight) {
+      return;
+    }
+
+    // after the response is processed every consumer holds its blocks on top of the common part
+    request.knownBlocks = shortest->second->getShortHistory(m_node.getLastLocalBlockHeight(), response.startHeight,
+      blockHashes.data(), static_cast<uint32_t>(blockHashes.size()));
+  }
+
+  m_logger(DEBUGGING) << "Prefetching blocks after index " << (responseEnd - 1);
+  m_prefetchedBlocks = startBlocksQuery(std::move(request));
+}
+
 void BlockchainSynchronizer::processBlocks(GetBlocksResponse& response) {
   m_logger(DEBUGGING) << "Process blocks, start index " << response.startHeight << ", count " << response.newBlocks.size();
 
@@ -561,8 +644,16 @@ void BlockchainSynchronizer::processBlocks(GetBlocksResponse& response) {
 
 /// \pre m_consumersMutex is locked
 BlockchainSynchronizer::UpdateConsumersResult BlockchainSynchronizer::updateConsumers(const BlockchainInterval& interval, const std::vector<CompleteBlock>& blocks) {
-  bool smthChanged = false;
-
+  struct ConsumerUpdate {
+    IBlockchainConsumer* consumer;
+    SynchronizationState* state;
+    uint32_t startOffset;
+    uint32_t newBlockHeight;
+    bool succeeded;
+    std::exception_ptr exception;
+  };
+
+  std::vector<ConsumerUpdate> updates;
   for (auto& kv : m_consumers) {
     auto result = kv.second->checkInterval(interval);
 
@@ -574,20 +665,60 @@ BlockchainSynchronizer::UpdateConsumersResult BlockchainSynchronizer::updateCons
 
     if (result.hasNewBlocks) {
       uint32_t startOffset = result.newBlockHeight - interval.startHeight;
-      // update consumer
       uint32_t blockCount = static_cast<uint32_t>(blocks.size()) - startOffset;
       m_logger(DEBUGGING) << "Adding blocks to consumer, consumer " << kv.first << ", start index " << result.newBlockHeight << ", count " << blockCount;
-      if (kv.first->onNewBlocks(blocks.data() + startOffset, result.newBlockHeight, blockCount)) {
-        // update state if consumer succeeded
-        kv.second->addBlocks(interval.blocks.data() + startOffset, result.newBlockHeight, static_cast<uint32_t>(interval.blocks.size()) - startOffset);
-        smthChanged = true;
-      } else {
-        m_logger(ERROR, BRIGHT_RED) << "Failed to add blocks to consumer, consumer " << kv.first;
-        return UpdateConsumersResult::errorOccurred;
+      updates.push_back({kv.first, kv.second.get(), startOffset, result.newBlockHeight, false, nullptr});
+    }
+  }
+
+  // consumers don't share any state, so they scan the same immutable blocks concurrently
+  auto updateConsumer = [&blocks](ConsumerUpdate& update) {
+    try {
+      uint32_t blockCount = static_cast<uint32_t>(blocks.size()) - update.startOffset;
+      update.succeeded = update.consumer->onNewBlocks(blocks.data() + update.startOffset, update.newBlockHeight, blockCount);
+    } catch (...) {
+      update.exception = std::current_exception();
+    }
+  };
+
+  std::vector<std::future<void>> updateTasks;
+  for (size_t i = 1; i < updates.size(); ++i) {
+    updateTasks.push_back(std::async(std::launch::async, updateConsumer, std::ref(updates[i])));
+  }
+
+  if (!updates.empty()) {
+    updateConsumer(updates.front());
+  }
+
+  for (auto& task : updateTasks) {
+    task.wait();
+  }
+
+  // states are committed in consumers order, whatever order consumers finished in
+  bool smthChanged = false;
+  bool errorOccurred = false;
+  std::exception_ptr exception;
+  for (auto& update : updates) {
+    if (update.succeeded) {
+      update.state->addBlocks(interval.blocks.data() + update.startOffset, update.newBlockHeight, static_cast<uint32_t>(interval.blocks.size()) - update.startOffset);
+      smthChanged = true;
+    } else {
+      m_logger(ERROR, BRIGHT_RED) << "Failed to add blocks to consumer, consumer " << update.consumer;
+      errorOccurred = true;
+      if (!exception) {
+        exception = update.exception;
       }
     }
   }
 
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+
+  if (errorOccurred) {
+    return UpdateConsumersResult::errorOccurred;
+  }
+
   if (smthChanged) {
     m_logger(DEBUGGING) << "Blocks added to consumers";
     return UpdateConsumersResult::addedNewBlocks;
@@ -652,16 +783,44 @@ void BlockchainSynchronizer::startPoolSync() {
   std::unordered_set<Crypto::Hash> intersectedPoolHistory;
   getPoolUnionAndIntersection(unionPoolHistory, intersectedPoolHistory);
 
+  //while all consumers still hold the transactions of the remembered pool version only the changes since it are requested
+  bool useVersion = m_poolVersion != 0 && unionPoolHistory == intersectedPoolHistory && unionPoolHistory == m_poolVersionTxs;
+
   GetPoolRequest unionRequest;
-  unionRequest.knownTxIds.assign(unionPoolHistory.begin(), unionPoolHistory.end());
+  if (!useVersion) {
+    unionRequest.knownTxIds.assign(unionPoolHistory.begin(), unionPoolHistory.end());
+  }
   unionRequest.lastKnownBlock = lastBlockId;
+  unionRequest.poolVersion = useVersion ? m_poolVersion : 0;
 
   GetPoolResponse unionResponse;
   unionResponse.isLastKnownBlockActual = false;
+  unionResponse.isDelta = false;
+  unionResponse.poolVersion = 0;
+
+  std::error_code ec = getPoolChangesSinceSync(std::move(unionRequest), unionResponse);
+
+  if (!ec && useVersion && !unionResponse.isDelta) {
+    //node forgot the version and compared its pool with an empty list, turn the result into the difference with the union
+    std::unordered_set<Crypto::Hash> added;
+    std::vector<std::unique_ptr<ITransactionReader>> newTxs;
+    for (auto& tx : unionResponse.newTxs) {
+      added.insert(tx->getTransactionHash());
+      if (unionPoolHistory.count(tx->getTransactionHash()) == 0) {
+        newTxs.push_back(std::move(tx));
+      }
+    }
 
-  std::error_code ec = getPoolSymmetricDifferenceSync(std::move(unionRequest), unionResponse);
+    unionResponse.newTxs = std::move(newTxs);
+    for (const auto& hash : unionPoolHistory) {
+      if (added.count(hash) == 0) {
+        unionResponse.deletedTxIds.push_back(hash);
+      }
+    }
+  }
 
   if (ec) {
+    m_poolVersion = 0;
     m_logger(ERROR, BRIGHT_RED) << "Failed to query transaction pool changes: " << ec << ", " << ec.message();
     setFutureStateIf(State::idle, [this] { return m_futureState != State::stopped; });
     m_observerManager.notify(&IBlockchainSynchronizerObserver::synchronizationCompleted, ec);
@@ -674,8 +833,23 @@ void BlockchainSynchronizer::startPoolSync() {
         ", deleted " << unionResponse.deletedTxIds.size();
 
       if (unionPoolHistory == intersectedPoolHistory) { //usual case, start pool processing
-        m_observerManager.notify(&IBlockchainSynchronizerObserver::synchronizationCompleted, processPoolTxs(unionResponse));
+        std::unordered_set<Crypto::Hash> poolTxs = std::move(unionPoolHistory);
+        for (const auto& hash : unionResponse.deletedTxIds) {
+          poolTxs.erase(hash);
+        }
+
+        for (const auto& tx : unionResponse.newTxs) {
+          poolTxs.insert(tx->getTransactionHash());
+        }
+
+        std::error_code processError = processPoolTxs(unionResponse);
+        m_poolVersion = processError ? 0 : unionResponse.poolVersion;
+        m_poolVersionTxs = std::move(poolTxs);
+
+        m_observerManager.notify(&IBlockchainSynchronizerObserver::synchronizationCompleted, processError);
       } else {
+        m_poolVersion = 0;
+
         GetPoolRequest intersectionRequest;
         intersectionRequest.knownTxIds.assign(intersectedPoolHistory.begin(), intersectedPoolHistory.end());
         intersectionRequest.lastKnownBlock = lastBlockId;
@@ -726,6 +900,27 @@ std::error_code BlockchainSynchronizer::getPoolSymmetricDifferenceSync(GetPoolRe
   return future.get();
 }
 
+std::error_code BlockchainSynchronizer::getPoolChangesSinceSync(GetPoolRequest&& request, GetPoolResponse& response) {
+  auto promise = std::promise<std::error_code>();
+  auto future = promise.get_future();
+
+  response.poolVersion = request.poolVersion;
+  m_node.getPoolChangesSince(
+    response.poolVersion,
+    std::move(request.knownTxIds),
+    std::move(request.lastKnownBlock),
+    response.isLastKnownBlockActual,
+    response.isDelta,
+    response.newTxs,
+    response.deletedTxIds,
+    [&promise](std::error_code ec) {
+      auto detachedPromise = std::move(promise);
+      detachedPromise.set_value(ec);
+    });
+
+  return future.get();
+}
+
 std::error_code BlockchainSynchronizer::processPoolTxs(GetPoolResponse& response) {
   m_logger(DEBUGGING) << "Starting to process pool transactions, added " << response.newTxs.size() << ':' << TransactionReaderListFormatter(response.newTxs) <<
     ", deleted " << response.deletedTxIds.size() << ':' << Common::makeContainerFormatter(response.deletedTxIds);
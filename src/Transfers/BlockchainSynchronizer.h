@@ -27,6 +27,7 @@
 #include <mutex>
 #include <atomic>
 #include <future>
+#include <unordered_set>
 
 #include "Logging/LoggerRef.h"
 
@@ -77,8 +78,17 @@ private:
     std::vector<Crypto::Hash> knownBlocks;
   };
 
+  //Blocks request sent to the node, response is filled when completed is ready
+  struct BlocksQuery {
+    GetBlocksRequest request;
+    GetBlocksResponse response;
+    std::future<std::error_code> completed;
+  };
+
   struct GetPoolResponse {
     bool isLastKnownBlockActual;
+    bool isDelta;
+    uint64_t poolVersion;
     std::vector<std::unique_ptr<ITransactionReader>> newTxs;
     std::vector<Crypto::Hash> deletedTxIds;
   };
@@ -86,6 +96,7 @@ private:
   struct GetPoolRequest {
     std::vector<Crypto::Hash> knownTxIds;
     Crypto::Hash lastKnownBlock;
+    uint64_t poolVersion;
   };
 
   enum class State { //prioritized finite states
@@ -106,11 +117,15 @@ private:
   void removeOutdatedTransactions();
   void startPoolSync();
   void startBlockchainSync();
+  std::shared_ptr<BlocksQuery> startBlocksQuery(GetBlocksRequest&& request);
+  std::shared_ptr<BlocksQuery> takePrefetchedBlocks(const GetBlocksRequest& request);
+  void prefetchBlocks(const BlocksQuery& query);
 
   void processBlocks(GetBlocksResponse& response);
   UpdateConsumersResult updateConsumers(const BlockchainInterval& interval, const std::vector<CompleteBlock>& blocks);
   std::error_code processPoolTxs(GetPoolResponse& response);
   std::error_code getPoolSymmetricDifferenceSync(GetPoolRequest&& request, GetPoolResponse& response);
+  std::error_code getPoolChangesSinceSync(GetPoolRequest&& request, GetPoolResponse& response);
   std::error_code doAddUnconfirmedTransaction(const ITransactionReader& transaction);
   void doRemoveUnconfirmedTransaction(const Crypto::Hash& transactionHash);
 
@@ -142,6 +157,12 @@ private:
   std::unique_ptr<std::thread> workingThread;
   std::list<std::pair<const ITransactionReader*, std::promise<std::error_code>>> m_addTransactionTasks;
   std::list<std::pair<const Crypto::Hash*, std::promise<void>>> m_removeTransactionTasks;
+  //Next blocks batch requested while the current one is processed, used by working thread only
+  std::shared_ptr<BlocksQuery> m_prefetchedBlocks;
+  //Node pool version the consumers are synchronized with and their pool transactions at that version, 0 if unknown.
+  //Used by working thread only
+  uint64_t m_poolVersion;
+  std::unordered_set<Crypto::Hash> m_poolVersionTxs;
 
   mutable std::mutex m_consumersMutex;
   mutable std::mutex m_stateMutex;
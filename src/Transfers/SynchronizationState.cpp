@@ -27,11 +27,14 @@ using namespace Common;
 
 namespace CryptoNote {
 
-SynchronizationState::ShortHistory SynchronizationState::getShortHistory(uint32_t localHeight) const {
-  ShortHistory history;
+namespace {
+
+template<class HashAt>
+SynchronizationState::ShortHistory buildShortHistory(uint32_t blockchainSize, uint32_t localHeight, HashAt hashAt) {
+  SynchronizationState::ShortHistory history;
   uint32_t i = 0;
   uint32_t current_multiplier = 1;
-  uint32_t sz = std::min(static_cast<uint32_t>(m_blockchain.size()), localHeight + 1);
+  uint32_t sz = std::min(blockchainSize, localHeight + 1);
 
   if (!sz)
     return history;
@@ -40,7 +43,7 @@ SynchronizationState::ShortHistory SynchronizationState::getShortHistory(uint32_
   bool genesis_included = false;
 
   while (current_back_offset < sz) {
-    history.push_back(m_blockchain[sz - current_back_offset]);
+    history.push_back(hashAt(sz - current_back_offset));
     if (sz - current_back_offset == 0)
       genesis_included = true;
     if (i < 10) {
@@ -52,12 +55,27 @@ SynchronizationState::ShortHistory SynchronizationState::getShortHistory(uint32_
   }
 
   if (!genesis_included) {
-    history.push_back(m_blockchain[0]);
+    history.push_back(hashAt(0));
   }
 
   return history;
 }
 
+}
+
+SynchronizationState::ShortHistory SynchronizationState::getShortHistory(uint32_t localHeight) const {
+  return buildShortHistory(static_cast<uint32_t>(m_blockchain.size()), localHeight, [this](uint32_t index) {
+    return m_blockchain[index];
+  });
+}
+
+SynchronizationState::ShortHistory SynchronizationState::getShortHistory(uint32_t localHeight, uint32_t height, const Crypto::Hash* blockHashes, uint32_t count) const {
+  assert(height <= m_blockchain.size());
+  return buildShortHistory(height + count, localHeight, [&](uint32_t index) {
+    return index < height ? m_blockchain[index] : blockHashes[index - height];
+  });
+}
+
 SynchronizationState::CheckResult SynchronizationState::checkInterval(const BlockchainInterval& interval) const {
   assert(interval.startHeight <= m_blockchain.size());
 
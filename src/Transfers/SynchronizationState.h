@@ -42,6 +42,8 @@ public:
   }
 
   ShortHistory getShortHistory(uint32_t localHeight) const;
+  // Short history the state would have after blockHashes were added at height, detaching everything above it
+  ShortHistory getShortHistory(uint32_t localHeight, uint32_t height, const Crypto::Hash* blockHashes, uint32_t count) const;
   CheckResult checkInterval(const BlockchainInterval& interval) const;
 
   void detach(uint32_t height);
@@ -168,11 +168,170 @@ size_t SpentOutputDescriptor::hash() const {
 }
 
 
+namespace {
+  void adjustAmount(uint64_t& value, uint64_t amount, bool add) {
+    if (add) {
+      value += amount;
+    } else {
+      assert(value >= amount);
+      value -= amount;
+    }
+  }
+
+  template<typename K>
+  void adjustAmount(std::map<K, uint64_t>& amounts, const K& key, uint64_t amount, bool add) {
+    if (add) {
+      amounts[key] += amount;
+    } else {
+      auto it = amounts.find(key);
+      assert(it != amounts.end());
+      adjustAmount(it->second, amount, false);
+      if (it->second == 0) {
+        amounts.erase(it);
+      }
+    }
+  }
+}
+
+TransfersBalance::TransfersBalance(const Currency& currency, size_t transactionSpendableAge) :
+  m_currency(currency),
+  m_transactionSpendableAge(transactionSpendableAge) {
+  clear(0);
+}
+
+void TransfersBalance::add(const TransactionOutputInformationEx& transfer) {
+  update(transfer, true);
+}
+
+void TransfersBalance::remove(const TransactionOutputInformationEx& transfer) {
+  update(transfer, false);
+}
+
+void TransfersBalance::setHeight(uint32_t height) {
+  uint64_t lower = std::min(height, m_height);
+  uint64_t upper = std::max(height, m_height);
+  bool up = height > m_height;
+
+  // Transfers with thresholds in (lower, upper] change their state
+  for (auto& balance : m_balances) {
+    for (auto it = balance.lockEnds.upper_bound(lower); it != balance.lockEnds.end() && it->first <= upper; ++it) {
+      adjustAmount(balance.locked, it->second, !up);
+    }
+
+    for (auto it = balance.unlockHeights.upper_bound(lower); it != balance.unlockHeights.end() && it->first <= upper; ++it) {
+      adjustAmount(balance.unlocked, it->second, up);
+    }
+  }
+
+  m_height = height;
+}
+
+void TransfersBalance::clear(uint32_t height) {
+  for (auto& balance : m_balances) {
+    balance.total = 0;
+    balance.locked = 0;
+    balance.unlocked = 0;
+    balance.lockEnds.clear();
+    balance.unlockHeights.clear();
+    balance.timeLocked.clear();
+  }
+
+  m_height = height;
+}
+
+uint64_t TransfersBalance::get(uint32_t flags) const {
+  uint64_t amount = 0;
+  if ((flags & ITransfersContainer::IncludeTypeKey) != 0) {
+    amount += get(m_balances[0], flags);
+  }
+
+  if ((flags & ITransfersContainer::IncludeTypeMultisignature) != 0) {
+    amount += get(m_balances[1], flags);
+  }
+
+  return amount;
+}
+
+uint64_t TransfersBalance::get(const TypeBalance& balance, uint32_t flags) const {
+  uint64_t amount = 0;
+  if ((flags & ITransfersContainer::IncludeStateLocked) != 0) {
+    amount += balance.locked;
+  }
+
+  if ((flags & ITransfersContainer::IncludeStateSoftLocked) != 0) {
+    amount += balance.total - balance.locked - balance.unlocked;
+  }
+
+  if ((flags & ITransfersContainer::IncludeStateUnlocked) != 0) {
+    amount += balance.unlocked;
+  }
+
+  if (!balance.timeLocked.empty()) {
+    uint64_t currentTime = static_cast<uint64_t>(time(NULL));
+    for (const auto& entry : balance.timeLocked) {
+      uint32_t state;
+      if (currentTime + m_currency.lockedTxAllowedDeltaSeconds() < entry.first.first) {
+        state = ITransfersContainer::IncludeStateLocked;
+      } else if (m_height < entry.first.second) {
+        state = ITransfersContainer::IncludeStateSoftLocked;
+      } else {
+        state = ITransfersContainer::IncludeStateUnlocked;
+      }
+
+      if ((flags & state) != 0) {
+        amount += entry.second;
+      }
+    }
+  }
+
+  return amount;
+}
+
+void TransfersBalance::update(const TransactionOutputInformationEx& transfer, bool add) {
+  if (!transfer.visible) {
+    return;
+  }
+
+  assert(transfer.type == TransactionTypes::OutputType::Key || transfer.type == TransactionTypes::OutputType::Multisignature);
+  TypeBalance& balance = m_balances[transfer.type == TransactionTypes::OutputType::Key ? 0 : 1];
+
+  if (transfer.blockHeight == WALLET_LEGACY_UNCONFIRMED_TRANSACTION_HEIGHT) {
+    // unconfirmed transfers are locked until confirmed
+    adjustAmount(balance.total, transfer.amount, add);
+    adjustAmount(balance.locked, transfer.amount, add);
+    return;
+  }
+
+  uint64_t spendableHeight = static_cast<uint64_t>(transfer.blockHeight) + m_transactionSpendableAge;
+  if (transfer.unlockTime >= m_currency.maxBlockHeight()) {
+    adjustAmount(balance.timeLocked, std::make_pair(transfer.unlockTime, spendableHeight), transfer.amount, add);
+    return;
+  }
+
+  // See TransfersContainer::isSpendTimeUnlocked()
+  uint64_t lockEnd = transfer.unlockTime > m_currency.lockedTxAllowedDeltaBlocks() ?
+    transfer.unlockTime - m_currency.lockedTxAllowedDeltaBlocks() : 0;
+  uint64_t unlockHeight = std::max(lockEnd, spendableHeight);
+
+  adjustAmount(balance.total, transfer.amount, add);
+  adjustAmount(balance.lockEnds, lockEnd, transfer.amount, add);
+  adjustAmount(balance.unlockHeights, unlockHeight, transfer.amount, add);
+
+  if (m_height < lockEnd) {
+    adjustAmount(balance.locked, transfer.amount, add);
+  }
+
+  if (unlockHeight <= m_height) {
+    adjustAmount(balance.unlocked, transfer.amount, add);
+  }
+}
+
 TransfersContainer::TransfersContainer(const Currency& currency, Logging::ILogger& logger, size_t transactionSpendableAge) :
   m_currentHeight(0),
   m_currency(currency),
   m_logger(logger, "TransfersContainer"),
-  m_transactionSpendableAge(transactionSpendableAge) {
+  m_transactionSpendableAge(transactionSpendableAge),
+  m_balance(currency, transactionSpendableAge) {
 }
 
 bool TransfersContainer::addTransaction(const TransactionBlockInfo& block, const ITransactionReader& tx,
@@ -206,6 +365,7 @@ bool TransfersContainer::addTransaction(const TransactionBlockInfo& block, const
 
     if (block.height != WALLET_LEGACY_UNCONFIRMED_TRANSACTION_HEIGHT) {
       m_currentHeight = block.height;
+      m_balance.setHeight(m_currentHeight);
     }
 
     return added;
@@ -276,8 +436,8 @@ bool TransfersContainer::addTransactionOutputs(const TransactionBlockInfo& block
 
     if (transferIsUnconfirmed) {
       auto result = m_unconfirmedTransfers.emplace(std::move(info));
-      (void)result; // Disable unused warning
       assert(result.second);
+      m_balance.add(*result.first);
     } else {
       if (info.type == TransactionTypes::OutputType::Key) {
         bool duplicate = false;
@@ -314,8 +474,8 @@ bool TransfersContainer::addTransactionOutputs(const TransactionBlockInfo& block
       }
 
       auto result = m_availableTransfers.emplace(std::move(info));
-      (void)result; // Disable unused warning
       assert(result.second);
+      m_balance.add(*result.first);
     }
 
     if (info.type == TransactionTypes::OutputType::Key) {
@@ -398,6 +558,7 @@ bool TransfersContainer::addTransactionInputs(const TransactionBlockInfo& block,
       assert(spendingTransferIt->keyImage == input.keyImage);
       copyToSpent(block, tx, i, *spendingTransferIt);
       // erase from available outputs
+      m_balance.remove(*spendingTransferIt);
       outputDescriptorIndex.erase(spendingTransferIt);
       updateTransfersVisibility(input.keyImage);
 
@@ -411,6 +572,7 @@ bool TransfersContainer::addTransactionInputs(const TransactionBlockInfo& block,
       if (availableOutputIt != outputDescriptorIndex.end()) {
         copyToSpent(block, tx, i, *availableOutputIt);
         // erase from available outputs
+        m_balance.remove(*availableOutputIt);
         outputDescriptorIndex.erase(availableOutputIt);
 
         inputsAdded = true;
@@ -489,9 +651,10 @@ bool TransfersContainer::markTransactionConfirmed(const TransactionBlockInfo& bl
     }
 
     auto result = m_availableTransfers.emplace(std::move(transfer));
-    (void)result; // Disable unused warning
     assert(result.second);
+    m_balance.add(*result.first);
 
+    m_balance.remove(*transferIt);
     transferIt = m_unconfirmedTransfers.get<ContainingTransactionIndex>().erase(transferIt);
 
     if (transfer.type == TransactionTypes::OutputType::Key) {
@@ -524,6 +687,7 @@ void TransfersContainer::deleteTransactionTransfers(const Hash& transactionHash)
 
     auto result = m_availableTransfers.emplace(static_cast<const TransactionOutputInformationEx&>(*it));
     assert(result.second);
+    m_balance.add(*result.first);
     it = spendingTransactionIndex.erase(it);
 
     if (result.first->type == TransactionTypes::OutputType::Key) {
@@ -533,6 +697,7 @@ void TransfersContainer::deleteTransactionTransfers(const Hash& transactionHash)
 
   auto unconfirmedTransfersRange = m_unconfirmedTransfers.get<ContainingTransactionIndex>().equal_range(transactionHash);
   for (auto it = unconfirmedTransfersRange.first; it != unconfirmedTransfersRange.second;) {
+    m_balance.remove(*it);
     if (it->type == TransactionTypes::OutputType::Key) {
       KeyImage keyImage = it->keyImage;
       it = m_unconfirmedTransfers.get<ContainingTransactionIndex>().erase(it);
@@ -545,6 +710,7 @@ void TransfersContainer::deleteTransactionTransfers(const Hash& transactionHash)
   auto& transactionTransfersIndex = m_availableTransfers.get<ContainingTransactionIndex>();
   auto transactionTransfersRange = transactionTransfersIndex.equal_range(transactionHash);
   for (auto it = transactionTransfersRange.first; it != transactionTransfersRange.second;) {
+    m_balance.remove(*it);
     if (it->type == TransactionTypes::OutputType::Key) {
       KeyImage keyImage = it->keyImage;
       it = transactionTransfersIndex.erase(it);
@@ -610,11 +776,23 @@ std::vector<Hash> TransfersContainer::detach(uint32_t height) {
 
   // TODO: notification on detach
   m_currentHeight = height == 0 ? 0 : height - 1;
+  m_balance.setHeight(m_currentHeight);
 
   return deletedTransactions;
 }
 
 namespace {
+  template<typename T>
+  void updateBalance(TransfersBalance& balance, const T& range, bool add) {
+    for (auto it = range.first; it != range.second; ++it) {
+      if (add) {
+        balance.add(*it);
+      } else {
+        balance.remove(*it);
+      }
+    }
+  }
+
   template<typename C, typename T>
   void updateVisibility(C& collection, const T& range, bool visible) {
     for (auto it = range.first; it != range.second; ++it) {
@@ -643,6 +821,10 @@ void TransfersContainer::updateTransfersVisibility(const KeyImage& keyImage) {
   size_t spentCount = std::distance(spentRange.first, spentRange.second);
   assert(spentCount == 0 || spentCount == 1);
 
+  // Only visible transfers are counted in the balance, it is updated for the whole range
+  updateBalance(m_balance, unconfirmedRange, false);
+  updateBalance(m_balance, availableRange, false);
+
   if (spentCount > 0) {
     updateVisibility(unconfirmedIndex, unconfirmedRange, false);
     updateVisibility(availableIndex, availableRange, false);
@@ -661,6 +843,9 @@ void TransfersContainer::updateTransfersVisibility(const KeyImage& keyImage) {
   } else {
     updateVisibility(unconfirmedIndex, unconfirmedRange, unconfirmedCount == 1);
   }
+
+  updateBalance(m_balance, unconfirmedIndex.equal_range(descriptor), true);
+  updateBalance(m_balance, availableIndex.equal_range(descriptor), true);
 }
 
 bool TransfersContainer::advanceHeight(uint32_t height) {
@@ -668,6 +853,7 @@ bool TransfersContainer::advanceHeight(uint32_t height) {
 
   if (m_currentHeight <= height) {
     m_currentHeight = height;
+    m_balance.setHeight(m_currentHeight);
     return true;
   }
 
@@ -686,6 +872,13 @@ size_t TransfersContainer::transactionsCount() const {
 
 uint64_t TransfersContainer::balance(uint32_t flags) const {
   std::lock_guard<std::mutex> lk(m_mutex);
+  return m_balance.get(flags);
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+uint64_t TransfersContainer::scanBalance(uint32_t flags) const {
   uint64_t amount = 0;
 
   for (const auto& t : m_availableTransfers) {
@@ -722,6 +915,41 @@ void TransfersContainer::getOutputs(std::vector<TransactionOutputInformation>& t
   }
 }
 
+size_t TransfersContainer::spendableOutputsCount(uint64_t minAmount, uint64_t maxAmount) const {
+  // Zero key marks unspendable outputs
+  minAmount = std::max<uint64_t>(minAmount, 1);
+  if (minAmount > maxAmount) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& amountIndex = m_availableTransfers.get<SpendableAmountIndex>();
+  return amountIndex.upper_bound_rank(maxAmount) - amountIndex.lower_bound_rank(minAmount);
+}
+
+bool TransfersContainer::getSpendableOutput(uint64_t minAmount, uint64_t maxAmount, size_t index, TransactionOutputInformation& output) const {
+  minAmount = std::max<uint64_t>(minAmount, 1);
+  if (minAmount > maxAmount) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto& amountIndex = m_availableTransfers.get<SpendableAmountIndex>();
+  auto rank = amountIndex.lower_bound_rank(minAmount) + index;
+  if (rank >= amountIndex.upper_bound_rank(maxAmount)) {
+    return false;
+  }
+
+  auto it = amountIndex.nth(rank);
+  assert(it->visible);
+  if (!isIncluded(*it, IncludeKeyUnlocked)) {
+    return false;
+  }
+
+  output = *it;
+  return true;
+}
+
 bool TransfersContainer::getTransactionInformation(const Hash& transactionHash, TransactionInformation& info, uint64_t* amountIn, uint64_t* amountOut) const {
   std::lock_guard<std::mutex> lk(m_mutex);
   auto it = m_transactions.find(transactionHash);
@@ -854,6 +1082,8 @@ void TransfersContainer::save(std::ostream& os) {
   StdOutputStream stream(os);
   CryptoNote::BinaryOutputStreamSerializer s(stream);
 
+  assert(isBalanceConsistent());
+
   s(const_cast<uint32_t&>(TRANSFERS_CONTAINER_STORAGE_VERSION), "version");
 
   s(m_currentHeight, "height");
@@ -894,10 +1124,13 @@ void TransfersContainer::load(std::istream& in) {
   m_unconfirmedTransfers = std::move(unconfirmedTransfers);
   m_availableTransfers = std::move(availableTransfers);
   m_spentTransfers = std::move(spentTransfers);
+  rebuildBalance();
 
   // Repair the container if it was broken while handling addTransaction() in previous version of the code
   // Hope it isn't necessary anymore
   //repair();
+
+  assert(isBalanceConsistent());
 }
 
 void TransfersContainer::repair() {
@@ -922,6 +1155,7 @@ void TransfersContainer::repair() {
 
       auto result = m_availableTransfers.emplace(static_cast<const TransactionOutputInformationEx&>(*it));
       assert(result.second);
+      m_balance.add(*result.first);
       it = m_spentTransfers.erase(it);
 
       if (result.first->type == TransactionTypes::OutputType::Key) {
@@ -944,6 +1178,7 @@ void TransfersContainer::repair() {
         ", output " << std::setw(2) << it->outputInTransaction <<
         ", amount " << m_currency.formatAmount(it->amount);
 
+      m_balance.remove(*it);
       if (it->type == TransactionTypes::OutputType::Key) {
         KeyImage keyImage = it->keyImage;
         it = m_unconfirmedTransfers.erase(it);
@@ -970,6 +1205,7 @@ void TransfersContainer::repair() {
         ", output " << std::setw(2) << it->outputInTransaction <<
         ", amount " << m_currency.formatAmount(it->amount);
 
+      m_balance.remove(*it);
       if (it->type == TransactionTypes::OutputType::Key) {
         KeyImage keyImage = it->keyImage;
         it = m_availableTransfers.erase(it);
@@ -994,6 +1230,35 @@ void TransfersContainer::repair() {
   }
 }
 
+/**
+ * \pre m_mutex is locked.
+ */
+void TransfersContainer::rebuildBalance() {
+  m_balance.clear(m_currentHeight);
+  for (const auto& t : m_unconfirmedTransfers) {
+    m_balance.add(t);
+  }
+
+  for (const auto& t : m_availableTransfers) {
+    m_balance.add(t);
+  }
+}
+
+/**
+ * \pre m_mutex is locked.
+ */
+bool TransfersContainer::isBalanceConsistent() const {
+  for (uint32_t type : {IncludeTypeKey, IncludeTypeMultisignature}) {
+    for (uint32_t state : {IncludeStateLocked, IncludeStateSoftLocked, IncludeStateUnlocked}) {
+      if (m_balance.get(type | state) != scanBalance(type | state)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 bool TransfersContainer::isSpendTimeUnlocked(uint64_t unlockTime) const {
   if (unlockTime < m_currency.maxBlockHeight()) {
     // interpret as block index
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <unordered_map>
 #include <mutex>
 
@@ -26,6 +27,7 @@
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/ranked_index.hpp>
 
 #include "crypto/crypto.h"
 #include "CryptoNoteCore/CryptoNoteBasic.h"
@@ -86,6 +88,8 @@ struct TransactionOutputInformationEx : public TransactionOutputInformationIn {
 
   SpentOutputDescriptor getSpentOutputDescriptor() const { return SpentOutputDescriptor(*this); }
   const Crypto::Hash& getTransactionHash() const { return transactionHash; }
+  // Zero for outputs that can't be used as transfer inputs, output amounts are never zero
+  uint64_t getSpendableAmount() const { return visible && type == TransactionTypes::OutputType::Key ? amount : 0; }
 
   void serialize(CryptoNote::ISerializer& s) {
     s(reinterpret_cast<uint8_t&>(type), "type");
@@ -149,6 +153,40 @@ struct KeyOutputInfo {
   size_t count;
 };
 
+// Running totals of visible unconfirmed and available transfers, split by output type and lock state.
+// Height locked transfers are kept in buckets keyed by the height they change state at, so moving the current
+// height touches only the transfers changing state. Transfers locked by time are few, they are checked on request.
+class TransfersBalance {
+public:
+  TransfersBalance(const CryptoNote::Currency& currency, size_t transactionSpendableAge);
+
+  // Invisible transfers are ignored
+  void add(const TransactionOutputInformationEx& transfer);
+  void remove(const TransactionOutputInformationEx& transfer);
+  void setHeight(uint32_t height);
+  void clear(uint32_t height);
+
+  uint64_t get(uint32_t flags) const;
+
+private:
+  struct TypeBalance {
+    uint64_t total;
+    uint64_t locked;
+    uint64_t unlocked;
+    std::map<uint64_t, uint64_t> lockEnds;      // first height the transfer isn't locked at -> amount
+    std::map<uint64_t, uint64_t> unlockHeights; // first height the transfer is unlocked at -> amount
+    std::map<std::pair<uint64_t, uint64_t>, uint64_t> timeLocked; // (unlock time, spendable height) -> amount
+  };
+
+  void update(const TransactionOutputInformationEx& transfer, bool add);
+  uint64_t get(const TypeBalance& balance, uint32_t flags) const;
+
+  const CryptoNote::Currency& m_currency;
+  size_t m_transactionSpendableAge;
+  uint32_t m_height;
+  TypeBalance m_balances[2]; // key, multisignature
+};
+
 class TransfersContainer : public ITransfersContainer {
 public:
   TransfersContainer(const CryptoNote::Currency& currency, Logging::ILogger& logger, size_t transactionSpendableAge);
@@ -165,6 +203,8 @@ public:
   virtual size_t transactionsCount() const override;
   virtual uint64_t balance(uint32_t flags) const override;
   virtual void getOutputs(std::vector<TransactionOutputInformation>& transfers, uint32_t flags) const override;
+  virtual size_t spendableOutputsCount(uint64_t minAmount, uint64_t maxAmount) const override;
+  virtual bool getSpendableOutput(uint64_t minAmount, uint64_t maxAmount, size_t index, TransactionOutputInformation& output) const override;
   virtual bool getTransactionInformation(const Crypto::Hash& transactionHash, TransactionInformation& info,
     uint64_t* amountIn = nullptr, uint64_t* amountOut = nullptr) const override;
   virtual std::vector<TransactionOutputInformation> getTransactionOutputs(const Crypto::Hash& transactionHash, uint32_t flags) const override;
@@ -181,6 +221,7 @@ private:
   struct ContainingTransactionIndex { };
   struct SpendingTransactionIndex { };
   struct SpentOutputDescriptorIndex { };
+  struct SpendableAmountIndex { };
 
   typedef boost::multi_index_container<
     TransactionInformation,
@@ -228,6 +269,15 @@ private:
           TransactionOutputInformationEx,
           const Crypto::Hash&,
           &TransactionOutputInformationEx::getTransactionHash>
+      >,
+      // Locked outputs are indexed too: lock state changes with height and time, keying on it would need reindexing
+      // on every block. getSpendableOutput rejects them at draw time
+      boost::multi_index::ranked_non_unique<
+        boost::multi_index::tag<SpendableAmountIndex>,
+        boost::multi_index::const_mem_fun<
+          TransactionOutputInformationEx,
+          uint64_t,
+          &TransactionOutputInformationEx::getSpendableAmount>
       >
     >
   > AvailableTransfersMultiIndex;
@@ -273,6 +323,9 @@ private:
 
   void copyToSpent(const TransactionBlockInfo& block, const ITransactionReader& tx, size_t inputIndex, const TransactionOutputInformationEx& output);
   void repair();
+  void rebuildBalance();
+  uint64_t scanBalance(uint32_t flags) const;
+  bool isBalanceConsistent() const;
 
 private:
   TransactionMultiIndex m_transactions;
@@ -282,6 +335,7 @@ private:
 
   uint32_t m_currentHeight; // current height is needed to check if a transfer is unlocked
   size_t m_transactionSpendableAge;
+  TransfersBalance m_balance;
   const CryptoNote::Currency& m_currency;
   mutable std::mutex m_mutex;
   Logging::LoggerRef m_logger;
@@ -126,6 +126,68 @@ uint64_t calculateDonationAmount(uint64_t freeAmount, uint64_t donationThreshold
   return donationAmount;
 }
 
+// Draws random spendable outputs from several containers without copying them.
+// Outputs of all containers are enumerated as one sequence, so each output has the same probability to be picked
+class SpendableOutputsSampler {
+public:
+  SpendableOutputsSampler(const std::vector<WalletRecord*>& wallets, uint64_t minAmount, uint64_t maxAmount) :
+    m_minAmount(minAmount),
+    m_maxAmount(maxAmount),
+    m_indexGenerator(countOutputs(wallets, minAmount, maxAmount, m_ranges)) {
+  }
+
+  bool empty() const {
+    return m_indexGenerator.empty();
+  }
+
+  // Returns false if the drawn output can't be spent right now
+  bool next(WalletRecord*& wallet, TransactionOutputInformation& output) {
+    size_t index = m_indexGenerator();
+    auto rangeIt = std::upper_bound(m_ranges.begin(), m_ranges.end(), index, [](size_t value, const WalletRange& range) {
+      return value < range.end;
+    });
+
+    assert(rangeIt != m_ranges.end());
+    size_t begin = rangeIt == m_ranges.begin() ? 0 : std::prev(rangeIt)->end;
+    if (!rangeIt->wallet->container->getSpendableOutput(m_minAmount, m_maxAmount, index - begin, output)) {
+      return false;
+    }
+
+    // Containers are updated by synchronizer concurrently, so the same output can be seen at another index
+    if (!m_selected.emplace(output.amount, output.globalOutputIndex).second) {
+      return false;
+    }
+
+    wallet = rangeIt->wallet;
+    return true;
+  }
+
+private:
+  struct WalletRange {
+    size_t end;
+    WalletRecord* wallet;
+  };
+
+  static size_t countOutputs(const std::vector<WalletRecord*>& wallets, uint64_t minAmount, uint64_t maxAmount, std::vector<WalletRange>& ranges) {
+    size_t total = 0;
+    for (auto wallet : wallets) {
+      size_t count = wallet->container->spendableOutputsCount(minAmount, maxAmount);
+      if (count != 0) {
+        total += count;
+        ranges.push_back(WalletRange{ total, wallet });
+      }
+    }
+
+    return total;
+  }
+
+  uint64_t m_minAmount;
+  uint64_t m_maxAmount;
+  std::vector<WalletRange> m_ranges;
+  ShuffleGenerator<size_t, Crypto::random_engine<size_t>> m_indexGenerator;
+  std::set<std::pair<uint64_t, uint32_t>> m_selected;
+};
+
 }
 
 namespace CryptoNote {
@@ -1286,7 +1348,7 @@ size_t WalletGreen::transfer(const TransactionParameters& transactionParameters)
   return id;
 }
 
-void WalletGreen::prepareTransaction(std::vector<WalletOuts>&& wallets,
+void WalletGreen::prepareTransaction(std::vector<WalletRecord*>&& wallets,
   const std::vector<WalletOrder>& orders,
   uint64_t fee,
   uint16_t mixIn,
@@ -1524,11 +1586,11 @@ size_t WalletGreen::doTransfer(const TransactionParameters& transactionParameter
   CryptoNote::AccountPublicAddress changeDestination = getChangeDestination(transactionParameters.changeDestination, transactionParameters.sourceAddresses);
   m_logger(DEBUGGING) << "Change address " << m_currency.accountAddressAsString(changeDestination);
 
-  std::vector<WalletOuts> wallets;
+  std::vector<WalletRecord*> wallets;
   if (!transactionParameters.sourceAddresses.empty()) {
-    wallets = pickWallets(transactionParameters.sourceAddresses);
+    wallets = pickSpendableWallets(transactionParameters.sourceAddresses);
   } else {
-    wallets = pickWalletsWithMoney();
+    wallets = pickSpendableWallets();
   }
 
   PreparedTransaction preparedTransaction;
@@ -1579,11 +1641,11 @@ size_t WalletGreen::makeTransaction(const TransactionParameters& sendingTransact
   CryptoNote::AccountPublicAddress changeDestination = getChangeDestination(sendingTransaction.changeDestination, sendingTransaction.sourceAddresses);
   m_logger(DEBUGGING) << "Change address " << m_currency.accountAddressAsString(changeDestination);
 
-  std::vector<WalletOuts> wallets;
+  std::vector<WalletRecord*> wallets;
   if (!sendingTransaction.sourceAddresses.empty()) {
-    wallets = pickWallets(sendingTransaction.sourceAddresses);
+    wallets = pickSpendableWallets(sendingTransaction.sourceAddresses);
   } else {
-    wallets = pickWalletsWithMoney();
+    wallets = pickSpendableWallets();
   }
 
   PreparedTransaction preparedTransaction;
@@ -2171,42 +2233,60 @@ uint64_t WalletGreen::selectTransfers(
   uint64_t neededMoney,
   bool dust,
   uint64_t dustThreshold,
-  std::vector<WalletOuts>&& wallets,
+  std::vector<WalletRecord*>&& wallets,
   std::vector<OutputToTransfer>& selectedTransfers) {
 
   uint64_t foundMoney = 0;
 
-  typedef std::pair<WalletRecord*, TransactionOutputInformation> OutputData;
-  std::vector<OutputData> dustOutputs;
-  std::vector<OutputData> walletOuts;
-  for (auto walletIt = wallets.begin(); walletIt != wallets.end(); ++walletIt) {
-    for (auto outIt = walletIt->outs.begin(); outIt != walletIt->outs.end(); ++outIt) {
-      if (outIt->amount > dustThreshold) {
-        walletOuts.emplace_back(std::piecewise_construct, std::forward_as_tuple(walletIt->wallet), std::forward_as_tuple(*outIt));
-      } else if (dust) {
-        dustOutputs.emplace_back(std::piecewise_construct, std::forward_as_tuple(walletIt->wallet), std::forward_as_tuple(*outIt));
+  WalletRecord* wallet;
+  TransactionOutputInformation out;
+  SpendableOutputsSampler outputsSampler(wallets, dustThreshold + 1, std::numeric_limits<uint64_t>::max());
+  while (foundMoney < neededMoney && !outputsSampler.empty()) {
+    if (outputsSampler.next(wallet, out)) {
+      foundMoney += out.amount;
+      selectedTransfers.emplace_back(OutputToTransfer{ out, wallet });
+    }
+  }
+
+  if (dust) {
+    // At least one dust output is added, if there is any
+    bool dustAdded = false;
+    SpendableOutputsSampler dustSampler(wallets, 0, dustThreshold);
+    while ((!dustAdded || foundMoney < neededMoney) && !dustSampler.empty()) {
+      if (dustSampler.next(wallet, out)) {
+        foundMoney += out.amount;
+        selectedTransfers.emplace_back(OutputToTransfer{ out, wallet });
+        dustAdded = true;
       }
     }
   }
 
-  ShuffleGenerator<size_t, Crypto::random_engine<size_t>> indexGenerator(walletOuts.size());
-  while (foundMoney < neededMoney && !indexGenerator.empty()) {
-    auto& out = walletOuts[indexGenerator()];
-    foundMoney += out.second.amount;
-    selectedTransfers.emplace_back(OutputToTransfer{ std::move(out.second), std::move(out.first) });
+  return foundMoney;
+};
+
+std::vector<WalletRecord*> WalletGreen::pickSpendableWallets() const {
+  auto& walletsIndex = m_walletsContainer.get<RandomAccessIndex>();
+
+  std::vector<WalletRecord*> wallets;
+  for (const auto& wallet: walletsIndex) {
+    if (wallet.actualBalance != 0) {
+      wallets.push_back(const_cast<WalletRecord *>(&wallet));
+    }
   }
 
-  if (dust && !dustOutputs.empty()) {
-    ShuffleGenerator<size_t, Crypto::random_engine<size_t>> dustIndexGenerator(dustOutputs.size());
-    do {
-      auto& out = dustOutputs[dustIndexGenerator()];
-      foundMoney += out.second.amount;
-      selectedTransfers.emplace_back(OutputToTransfer{ std::move(out.second), std::move(out.first) });
-    } while (foundMoney < neededMoney && !dustIndexGenerator.empty());
+  return wallets;
+}
+
+std::vector<WalletRecord*> WalletGreen::pickSpendableWallets(const std::vector<std::string>& addresses) const {
+  std::vector<WalletRecord*> wallets;
+  wallets.reserve(addresses.size());
+
+  for (const auto& address: addresses) {
+    wallets.push_back(const_cast<WalletRecord *>(&getWalletRecord(address)));
   }
 
-  return foundMoney;
-};
+  return wallets;
+}
 
 std::vector<WalletGreen::WalletOuts> WalletGreen::pickWalletsWithMoney() const {
   auto& walletsIndex = m_walletsContainer.get<RandomAccessIndex>();
@@ -196,6 +196,8 @@ protected:
   std::vector<WalletOuts> pickWalletsWithMoney() const;
   WalletOuts pickWallet(const std::string& address) const;
   std::vector<WalletOuts> pickWallets(const std::vector<std::string>& addresses) const;
+  std::vector<WalletRecord*> pickSpendableWallets() const;
+  std::vector<WalletRecord*> pickSpendableWallets(const std::vector<std::string>& addresses) const;
 
   void updateBalance(CryptoNote::ITransfersContainer* container);
   void unlockBalances(uint32_t height);
@@ -218,7 +220,7 @@ protected:
     uint64_t changeAmount;
   };
 
-  void prepareTransaction(std::vector<WalletOuts>&& wallets,
+  void prepareTransaction(std::vector<WalletRecord*>&& wallets,
     const std::vector<WalletOrder>& orders,
     uint64_t fee,
     uint16_t mixIn,
@@ -253,7 +255,7 @@ protected:
   uint64_t selectTransfers(uint64_t needeMoney,
     bool dust,
     uint64_t dustThreshold,
-    std::vector<WalletOuts>&& wallets,
+    std::vector<WalletRecord*>&& wallets,
     std::vector<OutputToTransfer>& selectedTransfers);
 
   std::vector<ReceiverAmounts> splitDestinations(const std::vector<WalletTransfer>& destinations,
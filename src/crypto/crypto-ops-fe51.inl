@@ -0,0 +1,266 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+/* Field arithmetic modulo 2^255-19 with five 51-bit limbs, included by crypto-ops.c when CRYPTO_FE51 is defined.
+
+Limbs of all results are below 2^52, except fe_cmov and fe_copy which keep their input.
+Inputs may have limbs up to 2^53, this covers the constants of crypto-ops-data.c.
+Field elements leave the field code through fe_tobytes only, so results are bit-identical to ref10. */
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+#define FE51_MASK ((uint64_t) 0x7ffffffffffff)
+
+static uint64_t load_8(const unsigned char *in) {
+  uint64_t result;
+  result = (uint64_t) in[0];
+  result |= ((uint64_t) in[1]) << 8;
+  result |= ((uint64_t) in[2]) << 16;
+  result |= ((uint64_t) in[3]) << 24;
+  result |= ((uint64_t) in[4]) << 32;
+  result |= ((uint64_t) in[5]) << 40;
+  result |= ((uint64_t) in[6]) << 48;
+  result |= ((uint64_t) in[7]) << 56;
+  return result;
+}
+
+static void store_8(unsigned char *out, uint64_t in) {
+  int i;
+  for (i = 0; i < 8; ++i) {
+    out[i] = (unsigned char) (in >> (8 * i));
+  }
+}
+
+/* Carries every limb into the next one, the carry out of h[4] goes to h[0] multiplied by 19 */
+static void fe_carry(fe h) {
+  h[1] += h[0] >> 51; h[0] &= FE51_MASK;
+  h[2] += h[1] >> 51; h[1] &= FE51_MASK;
+  h[3] += h[2] >> 51; h[2] &= FE51_MASK;
+  h[4] += h[3] >> 51; h[3] &= FE51_MASK;
+  h[0] += 19 * (h[4] >> 51); h[4] &= FE51_MASK;
+}
+
+static void fe_0(fe h) {
+  h[0] = 0;
+  h[1] = 0;
+  h[2] = 0;
+  h[3] = 0;
+  h[4] = 0;
+}
+
+static void fe_1(fe h) {
+  h[0] = 1;
+  h[1] = 0;
+  h[2] = 0;
+  h[3] = 0;
+  h[4] = 0;
+}
+
+static void fe_add(fe h, const fe f, const fe g) {
+  h[0] = f[0] + g[0];
+  h[1] = f[1] + g[1];
+  h[2] = f[2] + g[2];
+  h[3] = f[3] + g[3];
+  h[4] = f[4] + g[4];
+  fe_carry(h);
+}
+
+/*
+h = f - g, computed as f + 4p - g, limbs of 4p are above any g limb
+*/
+
+static void fe_sub(fe h, const fe f, const fe g) {
+  h[0] = (f[0] + 0x1fffffffffffb4) - g[0];
+  h[1] = (f[1] + 0x1ffffffffffffc) - g[1];
+  h[2] = (f[2] + 0x1ffffffffffffc) - g[2];
+  h[3] = (f[3] + 0x1ffffffffffffc) - g[3];
+  h[4] = (f[4] + 0x1ffffffffffffc) - g[4];
+  fe_carry(h);
+}
+
+static void fe_neg(fe h, const fe f) {
+  fe zero;
+  fe_0(zero);
+  fe_sub(h, zero, f);
+}
+
+/*
+Replace (f,g) with (g,g) if b == 1;
+replace (f,g) with (f,g) if b == 0.
+
+Preconditions: b in {0,1}.
+*/
+
+static void fe_cmov(fe f, const fe g, unsigned int b) {
+  uint64_t mask = (uint64_t) 0 - (uint64_t) b;
+  f[0] ^= (f[0] ^ g[0]) & mask;
+  f[1] ^= (f[1] ^ g[1]) & mask;
+  f[2] ^= (f[2] ^ g[2]) & mask;
+  f[3] ^= (f[3] ^ g[3]) & mask;
+  f[4] ^= (f[4] ^ g[4]) & mask;
+}
+
+static void fe_copy(fe h, const fe f) {
+  h[0] = f[0];
+  h[1] = f[1];
+  h[2] = f[2];
+  h[3] = f[3];
+  h[4] = f[4];
+}
+
+/* Reduces 128-bit limbs of a product, r4 must be below 2^110 so that 19 times its carry fits 64 bits */
+static void fe_reduce_wide(fe h, uint128_t r0, uint128_t r1, uint128_t r2, uint128_t r3, uint128_t r4) {
+  uint64_t carry;
+  r1 += (uint64_t) (r0 >> 51);
+  r2 += (uint64_t) (r1 >> 51);
+  r3 += (uint64_t) (r2 >> 51);
+  r4 += (uint64_t) (r3 >> 51);
+  carry = (uint64_t) (r4 >> 51);
+  h[0] = ((uint64_t) r0 & FE51_MASK) + 19 * carry;
+  h[1] = (uint64_t) r1 & FE51_MASK;
+  h[2] = (uint64_t) r2 & FE51_MASK;
+  h[3] = (uint64_t) r3 & FE51_MASK;
+  h[4] = (uint64_t) r4 & FE51_MASK;
+  h[1] += h[0] >> 51; h[0] &= FE51_MASK;
+}
+
+/*
+h = f * g
+Can overlap h with f or g.
+*/
+
+static void fe_mul(fe h, const fe f, const fe g) {
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+  uint64_t g1_19 = 19 * g1;
+  uint64_t g2_19 = 19 * g2;
+  uint64_t g3_19 = 19 * g3;
+  uint64_t g4_19 = 19 * g4;
+  uint128_t r0, r1, r2, r3, r4;
+
+  r0 = (uint128_t) f0 * g0 + (uint128_t) f1 * g4_19 + (uint128_t) f2 * g3_19 + (uint128_t) f3 * g2_19 + (uint128_t) f4 * g1_19;
+  r1 = (uint128_t) f0 * g1 + (uint128_t) f1 * g0 + (uint128_t) f2 * g4_19 + (uint128_t) f3 * g3_19 + (uint128_t) f4 * g2_19;
+  r2 = (uint128_t) f0 * g2 + (uint128_t) f1 * g1 + (uint128_t) f2 * g0 + (uint128_t) f3 * g4_19 + (uint128_t) f4 * g3_19;
+  r3 = (uint128_t) f0 * g3 + (uint128_t) f1 * g2 + (uint128_t) f2 * g1 + (uint128_t) f3 * g0 + (uint128_t) f4 * g4_19;
+  r4 = (uint128_t) f0 * g4 + (uint128_t) f1 * g3 + (uint128_t) f2 * g2 + (uint128_t) f3 * g1 + (uint128_t) f4 * g0;
+
+  fe_reduce_wide(h, r0, r1, r2, r3, r4);
+}
+
+static void fe_sq_wide(const fe f, uint128_t r[5]) {
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t f0_2 = 2 * f0;
+  uint64_t f1_2 = 2 * f1;
+  uint64_t f3_19 = 19 * f3;
+  uint64_t f4_19 = 19 * f4;
+  uint64_t f3_38 = 2 * f3_19;
+  uint64_t f4_38 = 2 * f4_19;
+
+  r[0] = (uint128_t) f0 * f0 + (uint128_t) f1 * f4_38 + (uint128_t) f2 * f3_38;
+  r[1] = (uint128_t) f0_2 * f1 + (uint128_t) f2 * f4_38 + (uint128_t) f3 * f3_19;
+  r[2] = (uint128_t) f0_2 * f2 + (uint128_t) f1 * f1 + (uint128_t) f3 * f4_38;
+  r[3] = (uint128_t) f0_2 * f3 + (uint128_t) f1_2 * f2 + (uint128_t) f4 * f4_19;
+  r[4] = (uint128_t) f0_2 * f4 + (uint128_t) f1_2 * f3 + (uint128_t) f2 * f2;
+}
+
+/*
+h = f * f
+Can overlap h with f.
+*/
+
+static void fe_sq(fe h, const fe f) {
+  uint128_t r[5];
+  fe_sq_wide(f, r);
+  fe_reduce_wide(h, r[0], r[1], r[2], r[3], r[4]);
+}
+
+/*
+h = 2 * f * f
+Can overlap h with f.
+*/
+
+static void fe_sq2(fe h, const fe f) {
+  uint128_t r[5];
+  fe_sq_wide(f, r);
+  fe_reduce_wide(h, 2 * r[0], 2 * r[1], 2 * r[2], 2 * r[3], 2 * r[4]);
+}
+
+/*
+Writes the unique representative of h in [0, 2^255-19) as 32 little-endian bytes.
+*/
+
+static void fe_tobytes(unsigned char *s, const fe h) {
+  fe t;
+  uint64_t q;
+
+  fe_copy(t, h);
+  fe_carry(t);
+  fe_carry(t);
+  /* Now t < 2^255 + 19 * 2, so t - p is either negative or below p: q = 1 if t >= p */
+  q = (t[0] + 19) >> 51;
+  q = (t[1] + q) >> 51;
+  q = (t[2] + q) >> 51;
+  q = (t[3] + q) >> 51;
+  q = (t[4] + q) >> 51;
+
+  /* t - q * p = t + 19 * q - q * 2^255 */
+  t[0] += 19 * q;
+  t[1] += t[0] >> 51; t[0] &= FE51_MASK;
+  t[2] += t[1] >> 51; t[1] &= FE51_MASK;
+  t[3] += t[2] >> 51; t[2] &= FE51_MASK;
+  t[4] += t[3] >> 51; t[3] &= FE51_MASK;
+  t[4] &= FE51_MASK;
+
+  store_8(s, t[0] | (t[1] << 51));
+  store_8(s + 8, (t[1] >> 13) | (t[2] << 38));
+  store_8(s + 16, (t[2] >> 26) | (t[3] << 25));
+  store_8(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+static void fe_frombytes_255(fe h, const unsigned char *s) {
+  uint64_t w0 = load_8(s);
+  uint64_t w1 = load_8(s + 8);
+  uint64_t w2 = load_8(s + 16);
+  uint64_t w3 = load_8(s + 24);
+  h[0] = w0 & FE51_MASK;
+  h[1] = ((w0 >> 51) | (w1 << 13)) & FE51_MASK;
+  h[2] = ((w1 >> 38) | (w2 << 26)) & FE51_MASK;
+  h[3] = ((w2 >> 25) | (w3 << 39)) & FE51_MASK;
+  h[4] = (w3 >> 12) & FE51_MASK;
+}
+
+/*
+Ignores top bit of s. Returns -1 if s encodes a number not less than 2^255-19.
+*/
+
+static int fe_frombytes_canonical(fe h, const unsigned char *s) {
+  fe_frombytes_255(h, s);
+  if (h[4] == FE51_MASK && h[3] == FE51_MASK && h[2] == FE51_MASK && h[1] == FE51_MASK && h[0] >= FE51_MASK - 18) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+Uses all 256 bits of s, reduces the number modulo 2^255-19.
+*/
+
+static void fe_frombytes_full(fe h, const unsigned char *s) {
+  fe_frombytes_255(h, s);
+  h[0] += 19 * (uint64_t) (s[31] >> 7);
+}
@@ -2,7 +2,28 @@
 
 /* From fe.h */
 
+#if defined(CRYPTO_FE51)
+
+#if !defined(__SIZEOF_INT128__)
+#error CRYPTO_FE51 requires a compiler with 128-bit integers
+#endif
+
+/* Five 51-bit limbs: h[0] + 2^51 h[1] + 2^102 h[2] + 2^153 h[3] + 2^204 h[4] */
+typedef uint64_t fe[5];
+
+/* Constants are written in ref10 limbs, pairs of them are joined into a 51-bit limb. 2 * (2^255 - 19) is added
+   limbwise, so that negative ref10 limbs give positive limbs below 2^53 */
+#define FE_LIMB51(lo, hi, twop) ((uint64_t) ((int64_t) (lo) + (int64_t) (hi) * 67108864 + (int64_t) (twop)))
+#define FE(h0, h1, h2, h3, h4, h5, h6, h7, h8, h9) { \
+  FE_LIMB51(h0, h1, 4503599627370458), FE_LIMB51(h2, h3, 4503599627370494), FE_LIMB51(h4, h5, 4503599627370494), \
+  FE_LIMB51(h6, h7, 4503599627370494), FE_LIMB51(h8, h9, 4503599627370494) }
+
+#else
+
 typedef int32_t fe[10];
+#define FE(h0, h1, h2, h3, h4, h5, h6, h7, h8, h9) {h0, h1, h2, h3, h4, h5, h6, h7, h8, h9}
+
+#endif
 
 /* From ge.h */
 
@@ -103,6 +124,7 @@ void sc_reduce(unsigned char *);
 void ge_scalarmult(ge_p2 *, const unsigned char *, const ge_p3 *);
 void ge_double_scalarmult_precomp_vartime(ge_p2 *, const unsigned char *, const ge_p3 *, const unsigned char *, const ge_dsmp);
 void ge_mul8(ge_p1p1 *, const ge_p2 *);
+void ge_tobytes_batch(unsigned char *, const ge_p2 *, size_t, fe *);
 extern const fe fe_ma2;
 extern const fe fe_ma;
 extern const fe fe_fffb1;
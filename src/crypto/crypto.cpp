@@ -16,6 +16,8 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <alloca.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -23,6 +25,8 @@
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "Common/Varint.h"
 #include "crypto.h"
@@ -42,6 +46,107 @@ namespace Crypto {
 
   mutex random_lock;
 
+  /* Decompressing a point takes a field square root. Ring members and spend keys are decompressed over and over,
+   * so the decompressed points may be cached. The cache is split into shards with their own locks to keep
+   * verification threads from contending, each shard evicts its oldest point when full.
+   */
+  namespace {
+    const size_t POINT_CACHE_SHARD_COUNT = 16;
+
+    struct point_hash {
+      size_t operator()(const EllipticCurvePoint &point) const {
+        size_t res;
+        memcpy(&res, point.data + 1, sizeof(res));
+        return res;
+      }
+    };
+
+    struct point_equal {
+      bool operator()(const EllipticCurvePoint &a, const EllipticCurvePoint &b) const {
+        return memcmp(a.data, b.data, sizeof(a.data)) == 0;
+      }
+    };
+
+    struct point_cache_shard {
+      mutex lock;
+      std::unordered_map<EllipticCurvePoint, ge_p3, point_hash, point_equal> points;
+      std::vector<EllipticCurvePoint> order;
+      size_t next = 0;
+    };
+
+    point_cache_shard point_cache[POINT_CACHE_SHARD_COUNT];
+    std::atomic<size_t> point_cache_shard_capacity(0);
+    std::atomic<uint64_t> point_cache_hits(0);
+    std::atomic<uint64_t> point_cache_misses(0);
+  }
+
+  static bool load_point(const EllipticCurvePoint &key, ge_p3 &point) {
+    if (point_cache_shard_capacity.load(std::memory_order_relaxed) == 0) {
+      return ge_frombytes_vartime(&point, key.data) == 0;
+    }
+
+    point_cache_shard &shard = point_cache[key.data[0] % POINT_CACHE_SHARD_COUNT];
+    {
+      lock_guard<mutex> lock(shard.lock);
+      auto it = shard.points.find(key);
+      if (it != shard.points.end()) {
+        point = it->second;
+        point_cache_hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+
+    point_cache_misses.fetch_add(1, std::memory_order_relaxed);
+    if (ge_frombytes_vartime(&point, key.data) != 0) {
+      return false;
+    }
+
+    lock_guard<mutex> lock(shard.lock);
+    size_t capacity = point_cache_shard_capacity.load(std::memory_order_relaxed);
+    if (capacity == 0 || !shard.points.emplace(key, point).second) {
+      return true;
+    }
+
+    if (shard.order.size() < capacity) {
+      shard.order.push_back(key);
+    } else {
+      shard.points.erase(shard.order[shard.next]);
+      shard.order[shard.next] = key;
+      shard.next = (shard.next + 1) % capacity;
+    }
+
+    return true;
+  }
+
+  static bool load_point(const PublicKey &key, ge_p3 &point) {
+    return load_point(reinterpret_cast<const EllipticCurvePoint &>(key), point);
+  }
+
+  void crypto_ops::set_point_cache_capacity(size_t capacity) {
+    // Points inserted with the old capacity are dropped below, later insertions see the new one
+    point_cache_shard_capacity = capacity == 0 ? 0 : (capacity + POINT_CACHE_SHARD_COUNT - 1) / POINT_CACHE_SHARD_COUNT;
+    for (auto &shard : point_cache) {
+      lock_guard<mutex> lock(shard.lock);
+      shard.points.clear();
+      shard.order.clear();
+      shard.order.shrink_to_fit();
+      shard.next = 0;
+    }
+  }
+
+  point_cache_stats crypto_ops::get_point_cache_stats() {
+    point_cache_stats stats;
+    stats.hits = point_cache_hits.load(std::memory_order_relaxed);
+    stats.misses = point_cache_misses.load(std::memory_order_relaxed);
+    stats.size = 0;
+    for (auto &shard : point_cache) {
+      lock_guard<mutex> lock(shard.lock);
+      stats.size += shard.points.size();
+    }
+
+    return stats;
+  }
+
   static inline void random_scalar(EllipticCurveScalar &res) {
     unsigned char tmp[64];
     generate_random_bytes(64, tmp);
@@ -82,7 +187,7 @@ namespace Crypto {
     ge_p2 point2;
     ge_p1p1 point3;
     assert(sc_check(reinterpret_cast<const unsigned char*>(&key2)) == 0);
-    if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char*>(&key1)) != 0) {
+    if (!load_point(key1, point)) {
       return false;
     }
     ge_scalarmult(&point2, reinterpret_cast<const unsigned char*>(&key2), &point);
@@ -127,7 +232,7 @@ namespace Crypto {
     ge_cached point3;
     ge_p1p1 point4;
     ge_p2 point5;
-    if (ge_frombytes_vartime(&point1, reinterpret_cast<const unsigned char*>(&base)) != 0) {
+    if (!load_point(base, point1)) {
       return false;
     }
     derivation_to_scalar(derivation, output_index, scalar);
@@ -147,7 +252,7 @@ namespace Crypto {
     ge_cached point3;
     ge_p1p1 point4;
     ge_p2 point5;
-    if (ge_frombytes_vartime(&point1, reinterpret_cast<const unsigned char*>(&base)) != 0) {
+    if (!load_point(base, point1)) {
       return false;
     }
     derivation_to_scalar(derivation, output_index, suffix, suffixLength, scalar);
@@ -275,7 +380,7 @@ namespace Crypto {
     assert(check_key(pub));
     buf.h = prefix_hash;
     buf.key = reinterpret_cast<const EllipticCurvePoint&>(pub);
-    if (ge_frombytes_vartime(&tmp3, reinterpret_cast<const unsigned char*>(&pub)) != 0) {
+    if (!load_point(pub, tmp3)) {
       abort();
     }
     if (sc_check(reinterpret_cast<const unsigned char*>(&sig)) != 0 || sc_check(reinterpret_cast<const unsigned char*>(&sig) + 32) != 0) {
@@ -401,43 +506,89 @@ namespace Crypto {
     sc_mulsub(reinterpret_cast<unsigned char*>(&sig[sec_index]) + 32, reinterpret_cast<unsigned char*>(&sig[sec_index]), reinterpret_cast<const unsigned char*>(&sec), reinterpret_cast<unsigned char*>(&k));
   }
 
-  bool crypto_ops::check_ring_signature(const Hash &prefix_hash, const KeyImage &image,
-    const PublicKey *const *pubs, size_t pubs_count,
-    const Signature *sig) {
+  /* Computes the unencoded a and b points of every ring member, two per member. Returns false if the key image
+   * or a scalar of the signature is invalid.
+   */
+  static bool ring_signature_points(const ring_signature_check &check, ge_p2 *points) {
     size_t i;
     ge_p3 image_unp;
     ge_dsmp image_pre;
-    EllipticCurveScalar sum, h;
-    rs_comm *const buf = reinterpret_cast<rs_comm *>(alloca(rs_comm_size(pubs_count)));
 #if !defined(NDEBUG)
-    for (i = 0; i < pubs_count; i++) {
-      assert(check_key(*pubs[i]));
+    for (i = 0; i < check.pubs_count; i++) {
+      assert(check_key(*check.pubs[i]));
     }
 #endif
-    if (ge_frombytes_vartime(&image_unp, reinterpret_cast<const unsigned char*>(&image)) != 0) {
+    if (!load_point(reinterpret_cast<const EllipticCurvePoint&>(*check.image), image_unp)) {
       return false;
     }
     ge_dsm_precomp(image_pre, &image_unp);
-    sc_0(reinterpret_cast<unsigned char*>(&sum));
-    buf->h = prefix_hash;
-    for (i = 0; i < pubs_count; i++) {
-      ge_p2 tmp2;
+    for (i = 0; i < check.pubs_count; i++) {
+      const unsigned char *c = reinterpret_cast<const unsigned char*>(&check.sig[i]);
+      const unsigned char *r = c + 32;
       ge_p3 tmp3;
-      if (sc_check(reinterpret_cast<const unsigned char*>(&sig[i])) != 0 || sc_check(reinterpret_cast<const unsigned char*>(&sig[i]) + 32) != 0) {
+      if (sc_check(c) != 0 || sc_check(r) != 0) {
         return false;
       }
-      if (ge_frombytes_vartime(&tmp3, reinterpret_cast<const unsigned char*>(&*pubs[i])) != 0) {
+      if (!load_point(*check.pubs[i], tmp3)) {
         abort();
       }
-      ge_double_scalarmult_base_vartime(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]), &tmp3, reinterpret_cast<const unsigned char*>(&sig[i]) + 32);
-      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].a), &tmp2);
-      hash_to_ec(*pubs[i], tmp3);
-      ge_double_scalarmult_precomp_vartime(&tmp2, reinterpret_cast<const unsigned char*>(&sig[i]) + 32, &tmp3, reinterpret_cast<const unsigned char*>(&sig[i]), image_pre);
-      ge_tobytes(reinterpret_cast<unsigned char*>(&buf->ab[i].b), &tmp2);
-      sc_add(reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<const unsigned char*>(&sig[i]));
+      ge_double_scalarmult_base_vartime(&points[2 * i], c, &tmp3, r);
+      hash_to_ec(*check.pubs[i], tmp3);
+      ge_double_scalarmult_precomp_vartime(&points[2 * i + 1], r, &tmp3, c, image_pre);
+    }
+    return true;
+  }
+
+  bool crypto_ops::check_ring_signature(const Hash &prefix_hash, const KeyImage &image,
+    const PublicKey *const *pubs, size_t pubs_count,
+    const Signature *sig) {
+    ring_signature_check check = { &prefix_hash, &image, pubs, pubs_count, sig };
+    bool result;
+    check_ring_signatures(&check, 1, &result);
+    return result;
+  }
+
+  void crypto_ops::check_ring_signatures(const ring_signature_check *checks, size_t count, bool *results) {
+    size_t points_count = 0;
+    size_t max_pubs_count = 0;
+    for (size_t j = 0; j < count; j++) {
+      points_count += 2 * checks[j].pubs_count;
+      max_pubs_count = std::max(max_pubs_count, checks[j].pubs_count);
+    }
+
+    std::vector<ge_p2> points(points_count);
+    size_t used = 0;
+    for (size_t j = 0; j < count; j++) {
+      results[j] = ring_signature_points(checks[j], points.data() + used);
+      if (results[j]) {
+        used += 2 * checks[j].pubs_count;
+      }
+    }
+
+    /* Encoding needs a field inversion per point, a single one is shared by the whole batch */
+    std::vector<EllipticCurvePoint> encoded(used);
+    std::unique_ptr<fe[]> scratch(new fe[used]);
+    ge_tobytes_batch(reinterpret_cast<unsigned char*>(encoded.data()), points.data(), used, scratch.get());
+
+    std::vector<uint8_t> buffer(rs_comm_size(max_pubs_count));
+    rs_comm *const buf = reinterpret_cast<rs_comm *>(buffer.data());
+    size_t offset = 0;
+    for (size_t j = 0; j < count; j++) {
+      if (!results[j]) {
+        continue;
+      }
+      const ring_signature_check &check = checks[j];
+      EllipticCurveScalar sum, h;
+      sc_0(reinterpret_cast<unsigned char*>(&sum));
+      for (size_t i = 0; i < check.pubs_count; i++) {
+        sc_add(reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<unsigned char*>(&sum), reinterpret_cast<const unsigned char*>(&check.sig[i]));
+      }
+      buf->h = *check.prefix_hash;
+      memcpy(buf->ab, encoded.data() + offset, 2 * check.pubs_count * sizeof(EllipticCurvePoint));
+      offset += 2 * check.pubs_count;
+      hash_to_scalar(buf, rs_comm_size(check.pubs_count), h);
+      sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
+      results[j] = sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
     }
-    hash_to_scalar(buf, rs_comm_size(pubs_count), h);
-    sc_sub(reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&h), reinterpret_cast<unsigned char*>(&sum));
-    return sc_isnonzero(reinterpret_cast<unsigned char*>(&h)) == 0;
   }
 }
@@ -44,6 +44,21 @@ struct EllipticCurveScalar {
   uint8_t data[32];
 };
 
+/* One ring signature for check_ring_signatures, all pointers must stay valid during the call */
+struct ring_signature_check {
+  const Hash *prefix_hash;
+  const KeyImage *image;
+  const PublicKey *const *pubs;
+  size_t pubs_count;
+  const Signature *sig;
+};
+
+struct point_cache_stats {
+  uint64_t hits;
+  uint64_t misses;
+  size_t size;
+};
+
   class crypto_ops {
     crypto_ops();
     crypto_ops(const crypto_ops &);
@@ -92,6 +107,12 @@ struct EllipticCurveScalar {
       const PublicKey *const *, size_t, const Signature *);
     friend bool check_ring_signature(const Hash &, const KeyImage &,
       const PublicKey *const *, size_t, const Signature *);
+    static void check_ring_signatures(const ring_signature_check *, size_t, bool *);
+    friend void check_ring_signatures(const ring_signature_check *, size_t, bool *);
+    static void set_point_cache_capacity(size_t);
+    friend void set_point_cache_capacity(size_t);
+    static point_cache_stats get_point_cache_stats();
+    friend point_cache_stats get_point_cache_stats();
   };
 
   /* Generate a value filled with random bytes.
@@ -249,6 +270,24 @@ struct EllipticCurveScalar {
     return check_ring_signature(prefix_hash, image, pubs.data(), pubs.size(), sig);
   }
 
+  /* Checks count ring signatures at once, results[i] is what check_ring_signature returns for checks[i].
+   * Faster than separate calls, as the work of encoding the ring points is shared by the whole batch.
+   */
+  inline void check_ring_signatures(const ring_signature_check *checks, size_t count, bool *results) {
+    crypto_ops::check_ring_signatures(checks, count, results);
+  }
+
+  /* Cache of decompressed points used by signature checks and key derivation. Capacity is the number of points,
+   * 0 disables the cache (default). Changing the capacity empties the cache.
+   */
+  inline void set_point_cache_capacity(size_t capacity) {
+    crypto_ops::set_point_cache_capacity(capacity);
+  }
+
+  inline point_cache_stats get_point_cache_stats() {
+    return crypto_ops::get_point_cache_stats();
+  }
+
 }
 
 CRYPTO_MAKE_HASHABLE(PublicKey)
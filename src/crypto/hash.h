@@ -62,6 +62,39 @@ namespace Crypto {
     (*cn_slow_hash_f)(context.data, data, length, reinterpret_cast<void *>(&hash));
   }
 
+  /*
+    Context for computing up to SLOW_HASH_MAX_MULTI_COUNT slow hashes at once.
+    Scratchpads are allocated once and reused, huge pages are used when the system provides them.
+    Each scratchpad occupies exactly one huge page, the rest of the hashing state is kept in a separate mapping.
+  */
+  class cn_multi_context {
+  public:
+
+    explicit cn_multi_context(size_t count);
+    ~cn_multi_context();
+#if !defined(_MSC_VER) || _MSC_VER >= 1800
+    cn_multi_context(const cn_multi_context &) = delete;
+    void operator=(const cn_multi_context &) = delete;
+#endif
+
+    size_t count() const { return hashCount; }
+    bool usesHugePages() const { return hugePages; }
+
+  private:
+
+    void *scratchpads;
+    size_t scratchpadsSize;
+    void *states;
+    size_t hashCount;
+    bool hugePages;
+    friend inline void cn_slow_hash_multi(cn_multi_context &, const void *const *, const size_t *, Hash *);
+  };
+
+  // Hashes context.count() inputs, result is the same as of cn_slow_hash for each of them
+  inline void cn_slow_hash_multi(cn_multi_context &context, const void *const *data, const size_t *lengths, Hash *hashes) {
+    (*cn_slow_hash_multi_f)(context.scratchpads, context.states, context.hashCount, data, lengths, reinterpret_cast<void *>(hashes));
+  }
+
   inline void tree_hash(const Hash *hashes, size_t count, Hash &root_hash) {
     tree_hash(reinterpret_cast<const char (*)[HASH_SIZE]>(hashes), count, reinterpret_cast<char *>(&root_hash));
   }
@@ -36,10 +36,16 @@
 
 void (*cn_slow_hash_fp)(void *, const void *, size_t, void *);
 
+void (*cn_slow_hash_multi_fp)(void *, void *, size_t, const void *const *, const size_t *, void *);
+
 void cn_slow_hash_f(void * a, const void * b, size_t c, void * d){
 (*cn_slow_hash_fp)(a, b, c, d);
 }
 
+void cn_slow_hash_multi_f(void * a, void * b, size_t c, const void *const * d, const size_t * e, void * f){
+(*cn_slow_hash_multi_fp)(a, b, c, d, e, f);
+}
+
 #if defined(__GNUC__)
 #define likely(x) (__builtin_expect(!!(x), 1))
 #define unlikely(x) (__builtin_expect(!!(x), 0))
@@ -78,8 +84,8 @@ union cn_slow_hash_state {
 #define ALIGNED_DECL(t, x) t ALIGNED_DATA(x)
 #endif
 
-struct cn_ctx {
-  ALIGNED_DECL(uint8_t long_state[MEMORY], 16);
+// Everything but the scratchpad, multi-hash contexts keep it apart so scratchpads stay huge page aligned
+struct cn_state {
   ALIGNED_DECL(union cn_slow_hash_state state, 16);
   ALIGNED_DECL(uint8_t text[INIT_SIZE_BYTE], 16);
   ALIGNED_DECL(uint64_t a[AES_BLOCK_SIZE >> 3], 16);
@@ -88,7 +94,14 @@ struct cn_ctx {
   oaes_ctx* aes_ctx;
 };
 
+struct cn_ctx {
+  ALIGNED_DECL(uint8_t long_state[MEMORY], 16);
+  struct cn_state st;
+};
+
 static_assert(sizeof(struct cn_ctx) == SLOW_HASH_CONTEXT_SIZE, "Invalid structure size");
+static_assert(sizeof(struct cn_state) == SLOW_HASH_STATE_SIZE, "Invalid structure size");
+static_assert(MEMORY == SLOW_HASH_SCRATCHPAD_SIZE, "Invalid scratchpad size");
 
 static inline void ExpandAESKey256_sub1(__m128i *tmp1, __m128i *tmp2)
 {
@@ -190,4 +203,5 @@ INITIALIZER(detect_aes) {
   __cpuid(1, a, b, ecx, d);
 #endif
   cn_slow_hash_fp = (ecx & (1 << 25)) ? &cn_slow_hash_aesni : &cn_slow_hash_noaesni;
+  cn_slow_hash_multi_fp = (ecx & (1 << 25)) ? &cn_slow_hash_multi_aesni : &cn_slow_hash_multi_noaesni;
 }
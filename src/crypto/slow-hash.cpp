@@ -16,6 +16,7 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <new>
+#include <stdexcept>
 
 #include "hash.h"
 
@@ -29,15 +30,31 @@
 #endif
 
 using std::bad_alloc;
+using std::invalid_argument;
 
 namespace Crypto {
 
   enum {
-    MAP_SIZE = SLOW_HASH_CONTEXT_SIZE + ((-SLOW_HASH_CONTEXT_SIZE) & 0xfff)
+    MAP_SIZE = SLOW_HASH_CONTEXT_SIZE + ((-SLOW_HASH_CONTEXT_SIZE) & 0xfff),
+    HUGE_PAGE_SIZE = 1 << 21,
+    STATES_MAP_SIZE = 0x1000
   };
 
+  static_assert(static_cast<size_t>(SLOW_HASH_SCRATCHPAD_SIZE) == HUGE_PAGE_SIZE, "Scratchpad doesn't fit a huge page");
+  static_assert(SLOW_HASH_MAX_MULTI_COUNT * SLOW_HASH_STATE_SIZE <= STATES_MAP_SIZE, "Slow hash states don't fit a page");
+
+  static void checkMultiHashCount(size_t count) {
+    if (count == 0 || count > SLOW_HASH_MAX_MULTI_COUNT) {
+      throw invalid_argument("Unsupported slow hash count");
+    }
+  }
+
 #if defined(WIN32)
 
+  static size_t roundUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
   cn_context::cn_context() {
     data = VirtualAlloc(nullptr, MAP_SIZE, MEM_COMMIT, PAGE_READWRITE);
     if (data == nullptr) {
@@ -51,6 +68,38 @@ namespace Crypto {
     }
   }
 
+  cn_multi_context::cn_multi_context(size_t count) : hashCount(count), hugePages(false) {
+    checkMultiHashCount(count);
+
+    states = VirtualAlloc(nullptr, STATES_MAP_SIZE, MEM_COMMIT, PAGE_READWRITE);
+    if (states == nullptr) {
+      throw bad_alloc();
+    }
+
+    // Large pages require SeLockMemoryPrivilege, fall back to regular ones without it
+    size_t largePageSize = GetLargePageMinimum();
+    if (largePageSize != 0) {
+      scratchpadsSize = roundUp(count * SLOW_HASH_SCRATCHPAD_SIZE, largePageSize);
+      scratchpads = VirtualAlloc(nullptr, scratchpadsSize, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+      hugePages = scratchpads != nullptr;
+    }
+
+    if (!hugePages) {
+      scratchpadsSize = count * SLOW_HASH_SCRATCHPAD_SIZE;
+      scratchpads = VirtualAlloc(nullptr, scratchpadsSize, MEM_COMMIT, PAGE_READWRITE);
+      if (scratchpads == nullptr) {
+        VirtualFree(states, 0, MEM_RELEASE);
+        throw bad_alloc();
+      }
+    }
+  }
+
+  cn_multi_context::~cn_multi_context() {
+    if (!VirtualFree(scratchpads, 0, MEM_RELEASE) || !VirtualFree(states, 0, MEM_RELEASE)) {
+      throw bad_alloc();
+    }
+  }
+
 #else
 
   cn_context::cn_context() {
@@ -71,6 +120,52 @@ namespace Crypto {
     }
   }
 
+  static void *mapRegularPages(size_t size) {
+#if !defined(__APPLE__)
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+#else
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#endif
+    if (data == MAP_FAILED) {
+      throw bad_alloc();
+    }
+
+    mlock(data, size);
+    return data;
+  }
+
+  cn_multi_context::cn_multi_context(size_t count) : hashCount(count), hugePages(false) {
+    checkMultiHashCount(count);
+
+    // Scratchpad size equals the huge page size, so every scratchpad gets a huge page of its own
+    scratchpadsSize = count * SLOW_HASH_SCRATCHPAD_SIZE;
+#if defined(MAP_HUGETLB)
+    // Fails unless huge pages are reserved by the system (vm.nr_hugepages), regular pages are used then
+    scratchpads = mmap(nullptr, scratchpadsSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    hugePages = scratchpads != MAP_FAILED;
+    if (hugePages) {
+      mlock(scratchpads, scratchpadsSize);
+    }
+#endif
+
+    if (!hugePages) {
+      scratchpads = mapRegularPages(scratchpadsSize);
+    }
+
+    try {
+      states = mapRegularPages(STATES_MAP_SIZE);
+    } catch (bad_alloc&) {
+      munmap(scratchpads, scratchpadsSize);
+      throw;
+    }
+  }
+
+  cn_multi_context::~cn_multi_context() {
+    if (munmap(scratchpads, scratchpadsSize) != 0 || munmap(states, STATES_MAP_SIZE) != 0) {
+      throw bad_alloc();
+    }
+  }
+
 #endif
 
 }
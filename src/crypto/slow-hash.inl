@@ -15,19 +15,17 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
-static void
 #if defined(AESNI)
-cn_slow_hash_aesni
+#define SLOW_HASH_FN(name) name##_aesni
 #else
-cn_slow_hash_noaesni
+#define SLOW_HASH_FN(name) name##_noaesni
 #endif
-(void *restrict context, const void *restrict data, size_t length, void *restrict hash)
+
+static void SLOW_HASH_FN(cn_slow_hash_explode)(struct cn_state *restrict ctx, uint8_t *restrict long_state, const void *restrict data, size_t length)
 {
-#define ctx ((struct cn_ctx *) context)
   ALIGNED_DECL(uint8_t ExpandedKey[256], 16);
   size_t i;
-  __m128i *longoutput, *expkey, *xmminput, b_x;
-  ALIGNED_DECL(uint64_t a[2], 16);
+  __m128i *longoutput, *expkey, *xmminput;
   hash_process(&ctx->state.hs, (const uint8_t*) data, length);
 
   memcpy(ctx->text, ctx->state.init, INIT_SIZE_BYTE);
@@ -40,7 +38,7 @@ cn_slow_hash_noaesni
   memcpy(ExpandedKey, ctx->aes_ctx->key->exp_data, ctx->aes_ctx->key->exp_data_len);
 #endif
 
-  longoutput = (__m128i *) ctx->long_state;
+  longoutput = (__m128i *) long_state;
   expkey = (__m128i *) ExpandedKey;
   xmminput = (__m128i *) ctx->text;
 
@@ -86,62 +84,65 @@ cn_slow_hash_noaesni
     ctx->a[i] = ((uint64_t *)ctx->state.k)[i] ^  ((uint64_t *)ctx->state.k)[i+4];
     ctx->b[i] = ((uint64_t *)ctx->state.k)[i+2] ^  ((uint64_t *)ctx->state.k)[i+6];
   }
+}
 
-  b_x = _mm_load_si128((__m128i *)ctx->b);
-  a[0] = ctx->a[0];
-  a[1] = ctx->a[1];
-
-  for(i = 0; likely(i < 0x80000); i++)
-  {
-    __m128i c_x = _mm_load_si128((__m128i *)&ctx->long_state[a[0] & 0x1FFFF0]);
-    __m128i a_x = _mm_load_si128((__m128i *)a);
-    ALIGNED_DECL(uint64_t c[2], 16);
-    ALIGNED_DECL(uint64_t b[2], 16);
-    uint64_t *nextblock, *dst;
+static inline void SLOW_HASH_FN(cn_slow_hash_round)(uint8_t *restrict long_state, uint64_t *restrict a, __m128i *restrict b_x)
+{
+  __m128i c_x = _mm_load_si128((__m128i *)&long_state[a[0] & 0x1FFFF0]);
+  __m128i a_x = _mm_load_si128((__m128i *)a);
+  ALIGNED_DECL(uint64_t c[2], 16);
+  ALIGNED_DECL(uint64_t b[2], 16);
+  uint64_t *nextblock, *dst;
 
 #if defined(AESNI)
-    c_x = _mm_aesenc_si128(c_x, a_x);
+  c_x = _mm_aesenc_si128(c_x, a_x);
 #else
-    aesb_single_round((uint8_t *) &c_x, (uint8_t *) &c_x, (uint8_t *) &a_x);
+  aesb_single_round((uint8_t *) &c_x, (uint8_t *) &c_x, (uint8_t *) &a_x);
 #endif
 
-    _mm_store_si128((__m128i *)c, c_x);
-    //__builtin_prefetch(&ctx->long_state[c[0] & 0x1FFFF0], 0, 1);
+  _mm_store_si128((__m128i *)c, c_x);
+  //__builtin_prefetch(&long_state[c[0] & 0x1FFFF0], 0, 1);
 
-    b_x = _mm_xor_si128(b_x, c_x);
-    _mm_store_si128((__m128i *)&ctx->long_state[a[0] & 0x1FFFF0], b_x);
+  *b_x = _mm_xor_si128(*b_x, c_x);
+  _mm_store_si128((__m128i *)&long_state[a[0] & 0x1FFFF0], *b_x);
 
-    nextblock = (uint64_t *)&ctx->long_state[c[0] & 0x1FFFF0];
-    b[0] = nextblock[0];
-    b[1] = nextblock[1];
+  nextblock = (uint64_t *)&long_state[c[0] & 0x1FFFF0];
+  b[0] = nextblock[0];
+  b[1] = nextblock[1];
 
-    {
-      uint64_t hi, lo;
-      // hi,lo = 64bit x 64bit multiply of c[0] and b[0]
+  {
+    uint64_t hi, lo;
+    // hi,lo = 64bit x 64bit multiply of c[0] and b[0]
 
 #if defined(__GNUC__) && defined(__x86_64__)
-      __asm__("mulq %3\n\t"
-        : "=d" (hi),
-        "=a" (lo)
-        : "%a" (c[0]),
-        "rm" (b[0])
-        : "cc" );
+    __asm__("mulq %3\n\t"
+      : "=d" (hi),
+      "=a" (lo)
+      : "%a" (c[0]),
+      "rm" (b[0])
+      : "cc" );
 #else
-      lo = mul128(c[0], b[0], &hi);
+    lo = mul128(c[0], b[0], &hi);
 #endif
 
-      a[0] += hi;
-      a[1] += lo;
-    }
-    dst = (uint64_t *) &ctx->long_state[c[0] & 0x1FFFF0];
-    dst[0] = a[0];
-    dst[1] = a[1];
-
-    a[0] ^= b[0];
-    a[1] ^= b[1];
-    b_x = c_x;
-    //__builtin_prefetch(&ctx->long_state[a[0] & 0x1FFFF0], 0, 3);
+    a[0] += hi;
+    a[1] += lo;
   }
+  dst = (uint64_t *) &long_state[c[0] & 0x1FFFF0];
+  dst[0] = a[0];
+  dst[1] = a[1];
+
+  a[0] ^= b[0];
+  a[1] ^= b[1];
+  *b_x = c_x;
+  //__builtin_prefetch(&long_state[a[0] & 0x1FFFF0], 0, 3);
+}
+
+static void SLOW_HASH_FN(cn_slow_hash_implode)(struct cn_state *restrict ctx, const uint8_t *restrict long_state, void *restrict hash)
+{
+  ALIGNED_DECL(uint8_t ExpandedKey[256], 16);
+  size_t i;
+  __m128i *longoutput, *expkey, *xmminput;
 
   memcpy(ctx->text, ctx->state.init, INIT_SIZE_BYTE);
 #if defined(AESNI)
@@ -152,6 +153,10 @@ cn_slow_hash_noaesni
   memcpy(ExpandedKey, ctx->aes_ctx->key->exp_data, ctx->aes_ctx->key->exp_data_len);
 #endif
 
+  longoutput = (__m128i *) long_state;
+  expkey = (__m128i *) ExpandedKey;
+  xmminput = (__m128i *) ctx->text;
+
   //for (i = 0; likely(i < MEMORY); i += INIT_SIZE_BYTE)
   //    aesni_parallel_xor(&ctx->text, ExpandedKey, &ctx->long_state[i]);
 
@@ -199,3 +204,90 @@ cn_slow_hash_noaesni
   hash_permutation(&ctx->state.hs);
   extra_hashes[ctx->state.hs.b[0] & 3](&ctx->state, 200, hash);
 }
+
+static void SLOW_HASH_FN(cn_slow_hash)(void *restrict context, const void *restrict data, size_t length, void *restrict hash)
+{
+  struct cn_ctx *ctx = (struct cn_ctx *) context;
+  ALIGNED_DECL(uint64_t a[2], 16);
+  __m128i b_x;
+  size_t i;
+
+  SLOW_HASH_FN(cn_slow_hash_explode)(&ctx->st, ctx->long_state, data, length);
+
+  b_x = _mm_load_si128((__m128i *)ctx->st.b);
+  a[0] = ctx->st.a[0];
+  a[1] = ctx->st.a[1];
+
+  for(i = 0; likely(i < 0x80000); i++)
+  {
+    SLOW_HASH_FN(cn_slow_hash_round)(ctx->long_state, a, &b_x);
+  }
+
+  SLOW_HASH_FN(cn_slow_hash_implode)(&ctx->st, ctx->long_state, hash);
+}
+
+/*
+ * Scratchpad walks of independent inputs don't depend on each other, so their rounds are interleaved:
+ * the CPU can keep several random scratchpad accesses in flight instead of waiting for each one.
+ * Scratchpads are laid out back to back, MEMORY bytes each, the rest of the per-hash state lives apart.
+ */
+static void SLOW_HASH_FN(cn_slow_hash_multi)(void *restrict scratchpads, void *restrict states, size_t count, const void *const *restrict data, const size_t *restrict lengths, void *restrict hashes)
+{
+  struct cn_state *ctx = (struct cn_state *) states;
+  uint8_t *long_state[SLOW_HASH_MAX_MULTI_COUNT];
+  ALIGNED_DECL(uint64_t a[SLOW_HASH_MAX_MULTI_COUNT][2], 16);
+  __m128i b_x[SLOW_HASH_MAX_MULTI_COUNT];
+  size_t i, j;
+
+  assert(count > 0 && count <= SLOW_HASH_MAX_MULTI_COUNT);
+
+  for (j = 0; j < count; j++)
+  {
+    long_state[j] = (uint8_t *) scratchpads + j * MEMORY;
+    SLOW_HASH_FN(cn_slow_hash_explode)(&ctx[j], long_state[j], data[j], lengths[j]);
+    b_x[j] = _mm_load_si128((__m128i *)ctx[j].b);
+    a[j][0] = ctx[j].a[0];
+    a[j][1] = ctx[j].a[1];
+  }
+
+  switch (count)
+  {
+  case 4:
+    for(i = 0; likely(i < 0x80000); i++)
+    {
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[0], a[0], &b_x[0]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[1], a[1], &b_x[1]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[2], a[2], &b_x[2]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[3], a[3], &b_x[3]);
+    }
+    break;
+  case 3:
+    for(i = 0; likely(i < 0x80000); i++)
+    {
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[0], a[0], &b_x[0]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[1], a[1], &b_x[1]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[2], a[2], &b_x[2]);
+    }
+    break;
+  case 2:
+    for(i = 0; likely(i < 0x80000); i++)
+    {
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[0], a[0], &b_x[0]);
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[1], a[1], &b_x[1]);
+    }
+    break;
+  default:
+    for(i = 0; likely(i < 0x80000); i++)
+    {
+      SLOW_HASH_FN(cn_slow_hash_round)(long_state[0], a[0], &b_x[0]);
+    }
+    break;
+  }
+
+  for (j = 0; j < count; j++)
+  {
+    SLOW_HASH_FN(cn_slow_hash_implode)(&ctx[j], long_state[j], (char *) hashes + j * HASH_SIZE);
+  }
+}
+
+#undef SLOW_HASH_FN
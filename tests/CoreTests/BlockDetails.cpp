@@ -0,0 +1,206 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "BlockDetails.h"
+
+#include "Common/Math.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+bool compareTransactionDetails(const TransactionDetails& expected, const TransactionDetails& actual) {
+  DEFINE_TESTS_ERROR_CONTEXT("compareTransactionDetails");
+
+  CHECK_EQ(expected.hash, actual.hash);
+  CHECK_EQ(expected.size, actual.size);
+  CHECK_EQ(expected.fee, actual.fee);
+  CHECK_EQ(expected.totalInputsAmount, actual.totalInputsAmount);
+  CHECK_EQ(expected.totalOutputsAmount, actual.totalOutputsAmount);
+  CHECK_EQ(expected.mixin, actual.mixin);
+  CHECK_EQ(expected.unlockTime, actual.unlockTime);
+  CHECK_EQ(expected.timestamp, actual.timestamp);
+  CHECK_EQ(expected.inBlockchain, actual.inBlockchain);
+  CHECK_EQ(expected.blockHash, actual.blockHash);
+  CHECK_EQ(expected.blockIndex, actual.blockIndex);
+  CHECK_EQ(expected.inputs.size(), actual.inputs.size());
+  CHECK_EQ(expected.outputs.size(), actual.outputs.size());
+  for (size_t i = 0; i < expected.outputs.size(); ++i) {
+    CHECK_EQ(expected.outputs[i].globalIndex, actual.outputs[i].globalIndex);
+  }
+
+  return true;
+}
+
+bool compareBlockDetails(const BlockDetails& expected, const BlockDetails& actual) {
+  DEFINE_TESTS_ERROR_CONTEXT("compareBlockDetails");
+
+  CHECK_EQ(expected.hash, actual.hash);
+  CHECK_EQ(expected.index, actual.index);
+  CHECK_EQ(expected.majorVersion, actual.majorVersion);
+  CHECK_EQ(expected.minorVersion, actual.minorVersion);
+  CHECK_EQ(expected.timestamp, actual.timestamp);
+  CHECK_EQ(expected.prevBlockHash, actual.prevBlockHash);
+  CHECK_EQ(expected.nonce, actual.nonce);
+  CHECK_EQ(expected.isAlternative, actual.isAlternative);
+  CHECK_EQ(expected.difficulty, actual.difficulty);
+  CHECK_EQ(expected.reward, actual.reward);
+  CHECK_EQ(expected.baseReward, actual.baseReward);
+  CHECK_EQ(expected.blockSize, actual.blockSize);
+  CHECK_EQ(expected.transactionsCumulativeSize, actual.transactionsCumulativeSize);
+  CHECK_EQ(expected.alreadyGeneratedCoins, actual.alreadyGeneratedCoins);
+  CHECK_EQ(expected.alreadyGeneratedTransactions, actual.alreadyGeneratedTransactions);
+  CHECK_EQ(expected.sizeMedian, actual.sizeMedian);
+  CHECK_EQ(expected.penalty, actual.penalty);
+  CHECK_EQ(expected.totalFeeAmount, actual.totalFeeAmount);
+  CHECK_EQ(expected.transactions.size(), actual.transactions.size());
+  for (size_t i = 0; i < expected.transactions.size(); ++i) {
+    CHECK_TEST_CONDITION(compareTransactionDetails(expected.transactions[i], actual.transactions[i]));
+  }
+
+  return true;
+}
+
+}
+
+gen_blocks_details::gen_blocks_details() {
+  REGISTER_CALLBACK("check_blocks_details", gen_blocks_details::check_blocks_details);
+}
+
+bool gen_blocks_details::generate(std::vector<test_event_entry>& events) const {
+  GENERATE_ACCOUNT(miner_account);
+  GENERATE_ACCOUNT(alice);
+
+  MAKE_GENESIS_BLOCK(events, blk_0, miner_account, 1338224400);
+  REWIND_BLOCKS(events, blk_0r, blk_0, miner_account);
+  MAKE_TX(events, tx_0, miner_account, alice, MK_COINS(1), blk_0r);
+  MAKE_NEXT_BLOCK_TX1(events, blk_1, blk_0r, miner_account, tx_0);
+
+  // make the chain longer than the median window, so batched requests are split into several runs
+  REWIND_BLOCKS_N(events, blk_1r, blk_1, miner_account, m_currency->rewardBlocksWindow() + 10);
+  MAKE_TX(events, tx_1, miner_account, alice, MK_COINS(2), blk_1r);
+  MAKE_NEXT_BLOCK_TX1(events, blk_2, blk_1r, miner_account, tx_1);
+  MAKE_NEXT_BLOCK(events, blk_3, blk_2, miner_account);
+
+  // alternative block on the same height as the top block
+  MAKE_NEXT_BLOCK(events, blk_3_alt, blk_2, miner_account);
+
+  DO_CALLBACK(events, "check_blocks_details");
+  return true;
+}
+
+bool gen_blocks_details::check_blocks_details(CryptoNote::Core& c, size_t ev_index, const std::vector<test_event_entry>& events) {
+  DEFINE_TESTS_ERROR_CONTEXT("gen_blocks_details::check_blocks_details");
+
+  uint32_t topIndex = c.getTopBlockIndex();
+  CHECK_TEST_CONDITION(topIndex > m_currency->rewardBlocksWindow());
+
+  std::vector<Crypto::Hash> alternativeHashes = c.getAlternativeBlockHashesByIndex(topIndex);
+  CHECK_EQ(alternativeHashes.size(), 1);
+
+  std::vector<Crypto::Hash> mainChainHashes;
+  for (uint32_t index = 0; index <= topIndex; ++index) {
+    mainChainHashes.push_back(c.getBlockHashByIndex(index));
+  }
+
+  // whole main chain in one request: one run sliding the median window over every block
+  std::vector<BlockDetails> mainChainDetails = c.getBlocksDetails(mainChainHashes);
+  CHECK_EQ(mainChainDetails.size(), mainChainHashes.size());
+
+  for (uint32_t index = 0; index <= topIndex; ++index) {
+    const BlockDetails& block = mainChainDetails[index];
+    CHECK_EQ(block.hash, mainChainHashes[index]);
+    CHECK_EQ(block.index, index);
+    CHECK_TEST_CONDITION(!block.isAlternative);
+    CHECK_EQ(block.difficulty, c.getBlockDifficulty(index));
+
+    std::vector<uint64_t> lastBlocksSizes;
+    uint32_t windowBegin = index > m_currency->rewardBlocksWindow() ? index - static_cast<uint32_t>(m_currency->rewardBlocksWindow()) : 0;
+    for (uint32_t windowIndex = windowBegin; windowIndex < index; ++windowIndex) {
+      lastBlocksSizes.push_back(mainChainDetails[windowIndex].transactionsCumulativeSize);
+    }
+
+    uint64_t expectedMedian = index == 0 ? 0 : Common::medianValue(lastBlocksSizes);
+    CHECK_EQ(block.sizeMedian, expectedMedian);
+
+    uint64_t prevGeneratedCoins = index == 0 ? 0 : mainChainDetails[index - 1].alreadyGeneratedCoins;
+    uint64_t baseReward = 0;
+    int64_t emissionChange = 0;
+    CHECK_TEST_CONDITION(m_currency->getBlockReward(block.majorVersion, block.sizeMedian, 0, prevGeneratedCoins, 0, baseReward, emissionChange));
+    CHECK_EQ(block.baseReward, baseReward);
+
+    uint64_t totalFee = 0;
+    for (size_t i = 0; i < block.transactions.size(); ++i) {
+      // per transaction lookup goes through the non-batched path
+      TransactionDetails expected = c.getTransactionDetails(block.transactions[i].hash);
+      CHECK_TEST_CONDITION(compareTransactionDetails(expected, block.transactions[i]));
+      if (i != 0) {
+        totalFee += block.transactions[i].fee;
+      }
+    }
+
+    CHECK_EQ(block.totalFeeAmount, totalFee);
+  }
+
+  CHECK_EQ(mainChainDetails[1].alreadyGeneratedTransactions, 2);
+
+  uint64_t feeBlocks = 0;
+  for (const BlockDetails& block : mainChainDetails) {
+    if (block.transactions.size() > 1) {
+      CHECK_EQ(block.totalFeeAmount, m_currency->minimumFee());
+      ++feeBlocks;
+    }
+  }
+
+  CHECK_EQ(feeBlocks, 2);
+
+  // sparse request with duplicates, gaps wider than the median window and blocks from several segments
+  std::vector<Crypto::Hash> requestedHashes = {
+    mainChainHashes[topIndex], alternativeHashes[0], mainChainHashes[0], mainChainHashes[1],
+    mainChainHashes[topIndex], mainChainHashes[topIndex - 1], mainChainHashes[2]
+  };
+
+  std::vector<BlockDetails> batchDetails = c.getBlocksDetails(requestedHashes);
+  CHECK_EQ(batchDetails.size(), requestedHashes.size());
+
+  for (size_t i = 0; i < requestedHashes.size(); ++i) {
+    BlockDetails expected = c.getBlockDetails(requestedHashes[i]);
+    CHECK_TEST_CONDITION(compareBlockDetails(expected, batchDetails[i]));
+
+    if (!expected.isAlternative) {
+      CHECK_TEST_CONDITION(compareBlockDetails(mainChainDetails[expected.index], batchDetails[i]));
+    }
+  }
+
+  const BlockDetails& alternativeBlock = batchDetails[1];
+  CHECK_TEST_CONDITION(alternativeBlock.isAlternative);
+  CHECK_EQ(alternativeBlock.index, topIndex);
+  CHECK_EQ(alternativeBlock.prevBlockHash, mainChainHashes[topIndex - 1]);
+  // difficulty of an alternative block is taken from its own chain, not from the main chain
+  CHECK_TEST_CONDITION(alternativeBlock.difficulty > 0);
+  CHECK_EQ(alternativeBlock.alreadyGeneratedCoins, mainChainDetails[topIndex - 1].alreadyGeneratedCoins + alternativeBlock.reward);
+
+  bool thrown = false;
+  try {
+    c.getBlocksDetails({ Crypto::rand<Crypto::Hash>() });
+  } catch (std::runtime_error&) {
+    thrown = true;
+  }
+
+  CHECK_TEST_CONDITION(thrown);
+  return true;
+}
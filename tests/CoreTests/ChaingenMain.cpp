@@ -20,6 +20,7 @@
 #include "Common/CommandLine.h"
 
 #include "BlockReward.h"
+#include "BlockDetails.h"
 #include "BlockValidation.h"
 #include "ChainSplit1.h"
 #include "ChainSwitch1.h"
@@ -102,6 +103,7 @@ int main(int argc, char* argv[]) {
       GENERATE_AND_PLAY(gen_simple_chain_split_1);
       GENERATE_AND_PLAY(gen_simple_chain_001);
       GENERATE_AND_PLAY(one_block);
+      GENERATE_AND_PLAY(gen_blocks_details);
       // GENERATE_AND_PLAY(gen_ring_signature_big); // Takes up to XXX hours (if CRYPTONOTE_MINED_MONEY_UNLOCK_WINDOW ==
       // 10)
 
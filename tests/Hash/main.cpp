@@ -20,6 +20,7 @@
 #include <iomanip>
 #include <ios>
 #include <string>
+#include <vector>
 
 #include "crypto/hash.h"
 #include "../Io.h"
@@ -44,6 +45,67 @@ extern "C" {
   static void slow_hash(const void *data, size_t length, char *hash) {
     cn_slow_hash(*context, data, length, *reinterpret_cast<chash *>(hash));
   }
+
+}
+
+static void printHex(const void *data, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    cerr << setbase(16) << setw(2) << setfill('0') << int(static_cast<const unsigned char *>(data)[i]);
+  }
+}
+
+// Hashes all the tests count at a time, each lane gets its own input, wrapping around the test list
+static int testSlowHashMulti(size_t count, fstream &input) {
+  vector<chash> expected;
+  vector<vector<char>> data;
+  for (;;) {
+    chash hash;
+    input.exceptions(ios_base::badbit);
+    get(input, hash);
+    if (input.rdstate() & ios_base::eofbit) {
+      break;
+    }
+    input.exceptions(ios_base::badbit | ios_base::failbit | ios_base::eofbit);
+    input.clear(input.rdstate());
+    expected.push_back(hash);
+    data.emplace_back();
+    get(input, data.back());
+  }
+
+  if (data.size() < count) {
+    cerr << "Not enough tests for " << count << " lanes" << endl;
+    return 1;
+  }
+
+  Crypto::cn_multi_context multiContext(count);
+  bool error = false;
+  for (size_t first = 0; first < data.size(); first += count) {
+    const void *multiData[Crypto::SLOW_HASH_MAX_MULTI_COUNT];
+    size_t multiLength[Crypto::SLOW_HASH_MAX_MULTI_COUNT];
+    size_t test[Crypto::SLOW_HASH_MAX_MULTI_COUNT];
+    chash actual[Crypto::SLOW_HASH_MAX_MULTI_COUNT];
+    for (size_t lane = 0; lane < count; lane++) {
+      test[lane] = (first + lane) % data.size();
+      multiData[lane] = data[test[lane]].data();
+      multiLength[lane] = data[test[lane]].size();
+    }
+
+    cn_slow_hash_multi(multiContext, multiData, multiLength, actual);
+    for (size_t lane = 0; lane < count; lane++) {
+      if (expected[test[lane]] != actual[lane]) {
+        cerr << "Hash mismatch on test " << test[lane] + 1 << " in lane " << lane << " of " << count << endl << "Input: ";
+        printHex(data[test[lane]].data(), data[test[lane]].size());
+        cerr << endl << "Expected hash: ";
+        printHex(&expected[test[lane]], sizeof(chash));
+        cerr << endl << "Actual hash: ";
+        printHex(&actual[lane], sizeof(chash));
+        cerr << endl;
+        error = true;
+      }
+    }
+  }
+
+  return error ? 1 : 0;
 }
 
 extern "C" typedef void hash_f(const void *, size_t, char *);
@@ -66,6 +128,16 @@ int main(int argc, char *argv[]) {
     cerr << "Wrong number of arguments" << endl;
     return 1;
   }
+  const string multiPrefix = "slow-multi-";
+  if (string(argv[1]).compare(0, multiPrefix.size(), multiPrefix) == 0) {
+    size_t count = stoul(string(argv[1]).substr(multiPrefix.size()));
+    if (count == 0 || count > Crypto::SLOW_HASH_MAX_MULTI_COUNT) {
+      cerr << "Unsupported slow hash count" << endl;
+      return 1;
+    }
+    input.open(argv[2], ios_base::in);
+    return testSlowHashMulti(count, input);
+  }
   for (hf = hashes;; hf++) {
     if (hf >= &hashes[sizeof(hashes) / sizeof(hash_func)]) {
       cerr << "Unknown function" << endl;
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "CryptoNoteCore/Account.h"
@@ -28,7 +29,7 @@
 #include "MultiTransactionTestBase.h"
 
 template<size_t a_ring_size>
-class test_check_ring_signature : private multi_tx_test_base<a_ring_size>
+class test_check_ring_signature : protected multi_tx_test_base<a_ring_size>
 {
   static_assert(0 < a_ring_size, "ring_size must be greater than 0");
 
@@ -64,8 +65,60 @@ public:
     return Crypto::check_ring_signature(m_tx_prefix_hash, txin.keyImage, this->m_public_key_ptrs, ring_size, m_tx.signatures[0].data());
   }
 
-private:
+protected:
   CryptoNote::AccountBase m_alice;
   CryptoNote::Transaction m_tx;
   Crypto::Hash m_tx_prefix_hash;
 };
+
+// Same rings checked again, as decoys reused across transactions and transactions checked in pool and then in block
+template<size_t a_ring_size>
+class test_check_ring_signature_cached : public test_check_ring_signature<a_ring_size>
+{
+public:
+  static const size_t point_cache_capacity = 1024;
+
+  ~test_check_ring_signature_cached()
+  {
+    Crypto::set_point_cache_capacity(0);
+  }
+
+  bool init()
+  {
+    if (!test_check_ring_signature<a_ring_size>::init())
+      return false;
+
+    Crypto::set_point_cache_capacity(point_cache_capacity);
+    return this->test();
+  }
+};
+
+// The same input checked batch_size times in one call, as inputs of a block are checked
+template<size_t a_ring_size>
+class test_check_ring_signatures_batch : public test_check_ring_signature<a_ring_size>
+{
+public:
+  static const size_t batch_size = 20;
+  static const size_t loop_count = test_check_ring_signature<a_ring_size>::loop_count / 10;
+
+  bool init()
+  {
+    if (!test_check_ring_signature<a_ring_size>::init())
+      return false;
+
+    const CryptoNote::KeyInput& txin = boost::get<CryptoNote::KeyInput>(this->m_tx.inputs[0]);
+    Crypto::ring_signature_check check = { &this->m_tx_prefix_hash, &txin.keyImage, this->m_public_key_ptrs, a_ring_size, this->m_tx.signatures[0].data() };
+    m_checks.assign(batch_size, check);
+    return true;
+  }
+
+  bool test()
+  {
+    bool results[batch_size];
+    Crypto::check_ring_signatures(m_checks.data(), m_checks.size(), results);
+    return std::all_of(results, results + batch_size, [](bool result) { return result; });
+  }
+
+private:
+  std::vector<Crypto::ring_signature_check> m_checks;
+};
@@ -52,8 +52,40 @@ public:
     return hash == m_expected_hash;
   }
 
-private:
+protected:
   data_t m_data;
   Crypto::Hash m_expected_hash;
+
+private:
   Crypto::cn_context m_context;
 };
+
+// Each call computes hashesPerThread hashes at once, as miner threads do
+template<size_t hashesPerThread>
+class test_cn_slow_hash_multi : public test_cn_slow_hash {
+public:
+  test_cn_slow_hash_multi() : m_multi_context(hashesPerThread) {
+  }
+
+  bool test() {
+    const void* data[hashesPerThread];
+    size_t lengths[hashesPerThread];
+    Crypto::Hash hashes[hashesPerThread];
+    for (size_t i = 0; i < hashesPerThread; ++i) {
+      data[i] = &m_data;
+      lengths[i] = sizeof(m_data);
+    }
+
+    Crypto::cn_slow_hash_multi(m_multi_context, data, lengths, hashes);
+    for (size_t i = 0; i < hashesPerThread; ++i) {
+      if (hashes[i] != m_expected_hash) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  Crypto::cn_multi_context m_multi_context;
+};
@@ -0,0 +1,101 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <vector>
+
+#include "CryptoNoteCore/Account.h"
+#include "CryptoNoteCore/CachedBlock.h"
+#include "CryptoNoteCore/CachedTransaction.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+
+#include "MultiTransactionTestBase.h"
+
+// Deserializes a raw block the way Core::addBlock does and computes the hashes needed for validation
+template<size_t a_ring_size, size_t a_tx_count>
+class test_parse_block : private multi_tx_test_base<a_ring_size>
+{
+  static_assert(0 < a_tx_count, "tx_count must be greater than 0");
+
+public:
+  static const size_t loop_count = a_tx_count < 100 ? 100 : 10;
+  static const size_t ring_size = a_ring_size;
+  static const size_t tx_count = a_tx_count;
+
+  typedef multi_tx_test_base<a_ring_size> base_class;
+
+  bool init()
+  {
+    using namespace CryptoNote;
+
+    if (!base_class::init())
+      return false;
+
+    m_alice.generate();
+
+    std::vector<TransactionDestinationEntry> destinations;
+    destinations.push_back(TransactionDestinationEntry(this->m_source_amount, m_alice.getAccountKeys().address));
+
+    Transaction tx;
+    if (!constructTransaction(this->m_miners[this->real_source_idx].getAccountKeys(), this->m_sources, destinations, std::vector<uint8_t>(), tx, 0, this->m_logger))
+      return false;
+
+    BlockTemplate block;
+    block.majorVersion = BLOCK_MAJOR_VERSION_1;
+    block.minorVersion = 0;
+    block.timestamp = 0;
+    block.nonce = 0;
+    block.baseTransaction = this->m_miner_txs[0];
+    for (size_t i = 0; i < tx_count; ++i) {
+      // transactions differ by unlock time only, it doesn't matter for parsing
+      tx.unlockTime = i;
+      m_rawBlock.transactions.push_back(toBinaryArray(tx));
+      block.transactionHashes.push_back(getBinaryArrayHash(m_rawBlock.transactions.back()));
+    }
+
+    m_rawBlock.block = toBinaryArray(block);
+    return true;
+  }
+
+  bool test()
+  {
+    using namespace CryptoNote;
+
+    BlockTemplate block;
+    if (!fromBinaryArray(block, m_rawBlock.block))
+      return false;
+
+    CachedBlock cachedBlock(block);
+    cachedBlock.getBlockHash();
+
+    std::vector<CachedTransaction> transactions;
+    transactions.reserve(m_rawBlock.transactions.size());
+    for (const auto& rawTransaction : m_rawBlock.transactions) {
+      transactions.emplace_back(rawTransaction);
+      transactions.back().getTransactionHash();
+      transactions.back().getTransactionPrefixHash();
+    }
+
+    return transactions.size() == block.transactionHashes.size();
+  }
+
+private:
+  CryptoNote::AccountBase m_alice;
+  CryptoNote::RawBlock m_rawBlock;
+};
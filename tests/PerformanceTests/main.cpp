@@ -28,6 +28,7 @@
 #include "GenerateKeyImage.h"
 #include "GenerateKeyImageHelper.h"
 #include "IsOutToAccount.h"
+#include "ParseBlock.h"
 
 int main(int argc, char** argv)
 {
@@ -63,6 +64,20 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE1(test_check_ring_signature, 10);
   TEST_PERFORMANCE1(test_check_ring_signature, 100);
 
+  TEST_PERFORMANCE1(test_check_ring_signature_cached, 1);
+  TEST_PERFORMANCE1(test_check_ring_signature_cached, 2);
+  TEST_PERFORMANCE1(test_check_ring_signature_cached, 10);
+  TEST_PERFORMANCE1(test_check_ring_signature_cached, 100);
+
+  TEST_PERFORMANCE1(test_check_ring_signatures_batch, 1);
+  TEST_PERFORMANCE1(test_check_ring_signatures_batch, 10);
+  TEST_PERFORMANCE1(test_check_ring_signatures_batch, 100);
+
+  TEST_PERFORMANCE2(test_parse_block, 1, 10);
+  TEST_PERFORMANCE2(test_parse_block, 1, 100);
+  TEST_PERFORMANCE2(test_parse_block, 10, 10);
+  TEST_PERFORMANCE2(test_parse_block, 10, 100);
+
   TEST_PERFORMANCE0(test_is_out_to_acc);
   TEST_PERFORMANCE0(test_generate_key_image_helper);
   TEST_PERFORMANCE0(test_generate_key_derivation);
@@ -71,6 +86,10 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE0(test_derive_secret_key);
 
   TEST_PERFORMANCE0(test_cn_slow_hash);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 1);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 2);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 3);
+  TEST_PERFORMANCE1(test_cn_slow_hash_multi, 4);
 
   std::cout << "Tests finished. Elapsed time: " << timer.elapsed_ms() / 1000 << " sec" << std::endl;
 
@@ -0,0 +1,421 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include <boost/filesystem.hpp>
+
+#include "Common/ScopeExit.h"
+#include "Common/StringTools.h"
+#include "CryptoNoteCore/CachedBlock.h"
+#include "CryptoNoteCore/Checkpoints.h"
+#include "CryptoNoteCore/Core.h"
+#include "CryptoNoteCore/CoreErrors.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/DatabaseBlockchainCacheFactory.h"
+#include "CryptoNoteCore/MemoryBlockchainCacheFactory.h"
+#include "CryptoNoteCore/RocksDBWrapper.h"
+#include "CryptoNoteCore/TransactionApi.h"
+#include "CryptoNoteProtocol/CryptoNoteProtocolHandler.h"
+#include "P2p/NetNode.h"
+#include "P2p/NetNodeConfig.h"
+#include "System/ContextGroup.h"
+#include "System/Dispatcher.h"
+#include "System/InterruptedException.h"
+#include "System/Timer.h"
+#include "Transfers/CommonTypes.h"
+#include "Transfers/TransfersConsumer.h"
+
+#include "../Common/VectorMainChainStorage.h"
+#include "../UnitTests/INodeStubs.h"
+
+using namespace CryptoNote;
+
+namespace SyncBenchmark {
+
+namespace {
+
+// blocks per TransfersConsumer::onNewBlocks call
+const uint32_t SCAN_BATCH_SIZE = 100;
+
+// answers global output indexes from a table filled before the measurement, TransfersConsumer asks for them from its worker threads
+class GlobalIndexesNode : public INodeDummyStub {
+public:
+  void addTransaction(const Crypto::Hash& transactionHash, std::vector<uint32_t>&& globalIndexes) {
+    m_globalIndexes[transactionHash] = std::move(globalIndexes);
+  }
+
+  virtual void getTransactionOutsGlobalIndices(const Crypto::Hash& transactionHash, std::vector<uint32_t>& outsGlobalIndices,
+    const Callback& callback) override {
+    auto it = m_globalIndexes.find(transactionHash);
+    if (it == m_globalIndexes.end()) {
+      callback(make_error_code(std::errc::invalid_argument));
+      return;
+    }
+
+    outsGlobalIndices = it->second;
+    callback(std::error_code());
+  }
+
+private:
+  std::unordered_map<Crypto::Hash, std::vector<uint32_t>> m_globalIndexes;
+};
+
+struct NodeResult {
+  uint32_t topIndex;
+  double seconds;
+  std::string error;
+};
+
+double getSeconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+}
+
+Common::JsonValue makeInteger(uint64_t value) {
+  return Common::JsonValue(static_cast<Common::JsonValue::Integer>(value));
+}
+
+uint64_t countTransactions(const GeneratedChain& chain) {
+  uint64_t count = 0;
+  for (const RawBlock& block : chain.blocks) {
+    count += block.transactions.size();
+  }
+
+  return count;
+}
+
+Common::JsonValue makeThroughput(const GeneratedChain& chain, double seconds) {
+  uint64_t transactionCount = countTransactions(chain);
+  Common::JsonValue result(Common::JsonValue::OBJECT);
+  result.insert("blocks", makeInteger(chain.blocks.size()));
+  result.insert("transactions", makeInteger(transactionCount));
+  result.insert("seconds", Common::JsonValue(seconds));
+  result.insert("blocks_per_second", Common::JsonValue(seconds > 0 ? chain.blocks.size() / seconds : 0.0));
+  result.insert("transactions_per_second", Common::JsonValue(seconds > 0 ? transactionCount / seconds : 0.0));
+  return result;
+}
+
+uint64_t getDirectorySize(const std::string& path) {
+  uint64_t size = 0;
+  for (boost::filesystem::recursive_directory_iterator it(path), end; it != end; ++it) {
+    if (boost::filesystem::is_regular_file(it->status())) {
+      size += boost::filesystem::file_size(it->path());
+    }
+  }
+
+  return size;
+}
+
+std::string prepareDirectory(const BenchmarkSettings& settings, const std::string& name) {
+  boost::filesystem::path path = boost::filesystem::path(settings.workDir) / name;
+  boost::filesystem::remove_all(path);
+  boost::filesystem::create_directories(path);
+  return path.string();
+}
+
+Checkpoints createCheckpoints(const GeneratedChain& chain, const BenchmarkSettings& settings, Logging::ILogger& logger) {
+  Checkpoints checkpoints(logger);
+  if (settings.useCheckpoints && !chain.blocks.empty()) {
+    CachedBlock topBlock(fromBinaryArray<BlockTemplate>(chain.blocks.back().block));
+    checkpoints.addCheckpoint(static_cast<uint32_t>(chain.blocks.size()), Common::podToHex(topBlock.getBlockHash()));
+  }
+
+  return checkpoints;
+}
+
+std::unique_ptr<IMainChainStorage> createStorage(const Currency& currency, const GeneratedChain* chain) {
+  std::unique_ptr<IMainChainStorage> storage = createVectorMainChainStorage(currency);
+  if (chain != nullptr) {
+    for (const RawBlock& block : chain->blocks) {
+      storage->pushBlock(block);
+    }
+  }
+
+  return storage;
+}
+
+Common::JsonValue measureDatabaseCore(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings,
+  Logging::ILogger& logger, const std::string& name, bool import) {
+  DataBaseConfig databaseConfig = settings.databaseConfig;
+  databaseConfig.setDataDir(prepareDirectory(settings, name));
+
+  double seconds;
+  uint64_t initialSize;
+  {
+    RocksDBWrapper database(logger);
+    database.init(databaseConfig);
+    Tools::ScopeExit databaseShutdown([&database] { database.shutdown(); });
+    initialSize = getDirectorySize(databaseConfig.getDataDir());
+
+    // raw blocks are copied before the measurement, the core takes them by value
+    std::vector<RawBlock> blocks;
+    if (!import) {
+      blocks = chain.blocks;
+    }
+
+    System::Dispatcher dispatcher;
+    Core core(currency, logger, createCheckpoints(chain, settings, logger), dispatcher,
+      std::unique_ptr<IBlockchainCacheFactory>(new DatabaseBlockchainCacheFactory(database, logger)),
+      createStorage(currency, import ? &chain : nullptr));
+
+    std::chrono::steady_clock::time_point start;
+    if (import) {
+      start = std::chrono::steady_clock::now();
+      core.load();
+    } else {
+      core.load();
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < blocks.size(); ++i) {
+        std::error_code result = core.addBlock(std::move(blocks[i]));
+        if (result != error::AddBlockErrorCondition::BLOCK_ADDED) {
+          throw std::runtime_error("Failed to add block " + std::to_string(i + 1) + ": " + result.message());
+        }
+      }
+    }
+
+    seconds = getSeconds(std::chrono::steady_clock::now() - start);
+    if (core.getTopBlockIndex() != chain.blocks.size()) {
+      throw std::runtime_error("Core has " + std::to_string(core.getTopBlockIndex()) + " blocks after genesis instead of " +
+        std::to_string(chain.blocks.size()));
+    }
+  }
+
+  // measured after shutdown, when memtables are flushed
+  uint64_t databaseSize = getDirectorySize(databaseConfig.getDataDir());
+  Common::JsonValue result = makeThroughput(chain, seconds);
+  result.insert("database_profile", DataBaseConfig::profileToString(databaseConfig.getProfile()));
+  result.insert("database_bytes", makeInteger(databaseSize));
+  result.insert("database_growth_bytes", makeInteger(databaseSize > initialSize ? databaseSize - initialSize : 0));
+  return result;
+}
+
+// Runs a core, a protocol handler and a P2P server on the calling thread until the server is stopped, like a daemon.
+// If waitIndex is not zero, the node stops itself when its top block index reaches waitIndex or the timeout expires.
+void runNode(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings, Logging::ILogger& logger,
+  bool preload, uint16_t port, uint16_t peerPort, uint32_t waitIndex, std::promise<NodeServer*>& started, NodeResult& result) {
+  bool isStarted = false;
+  try {
+    System::Dispatcher dispatcher;
+    Core core(currency, logger, createCheckpoints(chain, settings, logger), dispatcher,
+      std::unique_ptr<IBlockchainCacheFactory>(new MemoryBlockchainCacheFactory("", logger)), createStorage(currency, preload ? &chain : nullptr));
+    core.load();
+
+    CryptoNoteProtocolHandler protocol(currency, dispatcher, core, nullptr, logger);
+    NodeServer server(dispatcher, protocol, logger);
+    protocol.set_p2p_endpoint(&server);
+
+    NetworkAddress peer;
+    Common::parseIpAddressAndPort(peer.ip, peer.port, "127.0.0.1:" + std::to_string(peerPort));
+
+    NetNodeConfig config;
+    config.setBindIp("127.0.0.1");
+    config.setBindPort(port);
+    config.setExternalPort(0);
+    config.setAllowLocalIp(true);
+    config.setHideMyPort(false);
+    config.setConfigFolder(prepareDirectory(settings, "p2p_" + std::to_string(port)));
+    config.setExclusiveNodes({ peer });
+    if (!server.init(config)) {
+      throw std::runtime_error("Failed to initialize P2P server on port " + std::to_string(port));
+    }
+
+    System::ContextGroup waitGroup(dispatcher);
+    auto start = std::chrono::steady_clock::now();
+    if (waitIndex != 0) {
+      waitGroup.spawn([&] {
+        System::Timer timer(dispatcher);
+        try {
+          while (core.getTopBlockIndex() < waitIndex && std::chrono::steady_clock::now() - start < settings.p2pTimeout) {
+            timer.sleep(std::chrono::milliseconds(10));
+          }
+        } catch (System::InterruptedException&) {
+          return;
+        }
+
+        result.seconds = getSeconds(std::chrono::steady_clock::now() - start);
+        result.topIndex = core.getTopBlockIndex();
+        server.sendStopSignal();
+      });
+    }
+
+    started.set_value(&server);
+    isStarted = true;
+    server.run();
+    waitGroup.interrupt();
+    waitGroup.wait();
+
+    server.deinit();
+    protocol.set_p2p_endpoint(nullptr);
+  } catch (std::exception& e) {
+    if (isStarted) {
+      result.error = e.what();
+    } else {
+      started.set_exception(std::current_exception());
+    }
+  }
+}
+
+}
+
+Common::JsonValue describeChain(const GeneratedChain& chain) {
+  uint64_t size = 0;
+  for (const RawBlock& block : chain.blocks) {
+    size += block.block.size();
+    for (const BinaryArray& transaction : block.transactions) {
+      size += transaction.size();
+    }
+  }
+
+  Common::JsonValue result(Common::JsonValue::OBJECT);
+  result.insert("blocks", makeInteger(chain.blocks.size()));
+  result.insert("transactions", makeInteger(countTransactions(chain)));
+  result.insert("bytes", makeInteger(size));
+  result.insert("transactions_per_block", makeInteger(chain.parameters.transactionsPerBlock));
+  result.insert("inputs_per_transaction", makeInteger(chain.parameters.inputsPerTransaction));
+  result.insert("mixin", makeInteger(chain.parameters.mixin));
+  result.insert("outputs_per_transaction", makeInteger(chain.parameters.outputsPerTransaction));
+  result.insert("seed", makeInteger(chain.parameters.seed));
+  return result;
+}
+
+Common::JsonValue measureCoreAddBlock(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings,
+  Logging::ILogger& logger) {
+  return measureDatabaseCore(currency, chain, settings, logger, "core_add_block", false);
+}
+
+Common::JsonValue measureCoreImport(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings,
+  Logging::ILogger& logger) {
+  return measureDatabaseCore(currency, chain, settings, logger, "core_import", true);
+}
+
+Common::JsonValue measureP2pSync(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings,
+  Logging::ILogger& logger) {
+  uint16_t sourcePort = settings.p2pPort;
+  uint16_t targetPort = settings.p2pPort + 1;
+  uint32_t topIndex = static_cast<uint32_t>(chain.blocks.size());
+
+  std::promise<NodeServer*> sourceStarted;
+  NodeResult sourceResult = {};
+  std::thread sourceThread([&] {
+    runNode(currency, chain, settings, logger, true, sourcePort, targetPort, 0, sourceStarted, sourceResult);
+  });
+
+  NodeServer* source;
+  try {
+    source = sourceStarted.get_future().get();
+  } catch (std::exception&) {
+    sourceThread.join();
+    throw;
+  }
+
+  std::promise<NodeServer*> targetStarted;
+  NodeResult targetResult = {};
+  std::thread targetThread([&] {
+    runNode(currency, chain, settings, logger, false, targetPort, sourcePort, topIndex, targetStarted, targetResult);
+  });
+
+  std::exception_ptr targetError;
+  try {
+    targetStarted.get_future().get();
+  } catch (std::exception&) {
+    targetError = std::current_exception();
+  }
+
+  targetThread.join();
+  source->sendStopSignal();
+  sourceThread.join();
+
+  if (targetError) {
+    std::rethrow_exception(targetError);
+  }
+
+  if (!targetResult.error.empty() || !sourceResult.error.empty()) {
+    throw std::runtime_error("P2P node failed: " + (targetResult.error.empty() ? sourceResult.error : targetResult.error));
+  }
+
+  if (targetResult.topIndex != topIndex) {
+    throw std::runtime_error("P2P sync timed out at block " + std::to_string(targetResult.topIndex) + " of " + std::to_string(topIndex));
+  }
+
+  return makeThroughput(chain, targetResult.seconds);
+}
+
+Common::JsonValue measureTransfersScan(const Currency& currency, const GeneratedChain& chain, const BenchmarkSettings& settings,
+  Logging::ILogger& logger) {
+  GlobalIndexesNode node;
+  std::vector<CompleteBlock> blocks;
+  blocks.reserve(chain.blocks.size());
+  {
+    // global indexes come from a core, as a wallet gets them from a node
+    System::Dispatcher dispatcher;
+    Core core(currency, logger, createCheckpoints(chain, settings, logger), dispatcher,
+      std::unique_ptr<IBlockchainCacheFactory>(new MemoryBlockchainCacheFactory("", logger)), createStorage(currency, &chain));
+    core.load();
+
+    for (const RawBlock& rawBlock : chain.blocks) {
+      CompleteBlock block;
+      BlockTemplate blockTemplate = fromBinaryArray<BlockTemplate>(rawBlock.block);
+      block.blockHash = CachedBlock(blockTemplate).getBlockHash();
+      block.transactions.push_back(createTransactionPrefix(blockTemplate.baseTransaction));
+      for (const BinaryArray& transaction : rawBlock.transactions) {
+        block.transactions.push_back(createTransactionPrefix(fromBinaryArray<Transaction>(transaction)));
+      }
+
+      for (const auto& transaction : block.transactions) {
+        std::vector<uint32_t> globalIndexes;
+        if (!core.getTransactionGlobalIndexes(transaction->getTransactionHash(), globalIndexes)) {
+          throw std::runtime_error("Failed to get global indexes of transaction " + Common::podToHex(transaction->getTransactionHash()));
+        }
+
+        node.addTransaction(transaction->getTransactionHash(), std::move(globalIndexes));
+      }
+
+      block.block = std::move(blockTemplate);
+      blocks.push_back(std::move(block));
+    }
+  }
+
+  TransfersConsumer consumer(currency, node, logger, chain.walletKeys.viewSecretKey);
+  AccountSubscription subscription;
+  subscription.keys = chain.walletKeys;
+  subscription.syncStart.timestamp = 0;
+  subscription.syncStart.height = 0;
+  subscription.transactionSpendableAge = 1;
+  ITransfersSubscription& transfers = consumer.addSubscription(subscription);
+
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < blocks.size(); i += SCAN_BATCH_SIZE) {
+    uint32_t count = std::min(SCAN_BATCH_SIZE, static_cast<uint32_t>(blocks.size()) - i);
+    // blocks[0] is the block with index 1
+    if (!consumer.onNewBlocks(blocks.data() + i, i + 1, count)) {
+      throw std::runtime_error("TransfersConsumer failed to process blocks from " + std::to_string(i + 1));
+    }
+  }
+
+  double seconds = getSeconds(std::chrono::steady_clock::now() - start);
+  Common::JsonValue result = makeThroughput(chain, seconds);
+  result.insert("wallet_outputs", makeInteger(transfers.getContainer().transfersCount()));
+  return result;
+}
+
+}
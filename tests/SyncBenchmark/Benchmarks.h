@@ -0,0 +1,61 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "Common/JsonValue.h"
+#include "CryptoNoteCore/Currency.h"
+#include "CryptoNoteCore/DataBaseConfig.h"
+#include "Logging/ILogger.h"
+
+#include "ChainGenerator.h"
+
+namespace SyncBenchmark {
+
+struct BenchmarkSettings {
+  // adds a checkpoint at the top block, so cores skip proof of work and signature checks like during initial sync
+  bool useCheckpoints;
+  // data directory of the database config is replaced by a subdirectory of workDir for every benchmark
+  CryptoNote::DataBaseConfig databaseConfig;
+  std::string workDir;
+  uint16_t p2pPort;
+  std::chrono::seconds p2pTimeout;
+};
+
+Common::JsonValue describeChain(const GeneratedChain& chain);
+
+// Every block goes through Core::addBlock of a core with RocksDB cache, as blocks received from peers do
+Common::JsonValue measureCoreAddBlock(const CryptoNote::Currency& currency, const GeneratedChain& chain,
+  const BenchmarkSettings& settings, Logging::ILogger& logger);
+
+// A core with RocksDB cache loads the chain from its main chain storage, as a daemon does after the cache is deleted
+Common::JsonValue measureCoreImport(const CryptoNote::Currency& currency, const GeneratedChain& chain,
+  const BenchmarkSettings& settings, Logging::ILogger& logger);
+
+// A node with an empty chain downloads the chain from another node over loopback, both cores keep the chain in memory
+Common::JsonValue measureP2pSync(const CryptoNote::Currency& currency, const GeneratedChain& chain,
+  const BenchmarkSettings& settings, Logging::ILogger& logger);
+
+// TransfersConsumer of the wallet account processes the chain in batches, as the blockchain synchronizer feeds it
+Common::JsonValue measureTransfersScan(const CryptoNote::Currency& currency, const GeneratedChain& chain,
+  const BenchmarkSettings& settings, Logging::ILogger& logger);
+
+}
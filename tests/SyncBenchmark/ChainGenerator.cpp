@@ -0,0 +1,242 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ChainGenerator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <set>
+#include <stdexcept>
+
+#include "Common/StdInputStream.h"
+#include "Common/StdOutputStream.h"
+#include "CryptoNoteCore/CryptoNoteSerialization.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/TransactionExtra.h"
+#include "Serialization/BinaryInputStreamSerializer.h"
+#include "Serialization/BinaryOutputStreamSerializer.h"
+#include "Serialization/SerializationOverloads.h"
+
+using namespace CryptoNote;
+
+namespace SyncBenchmark {
+
+namespace {
+
+// Not a sum of a few digits, so no coinbase output has this amount and decoys are spent outputs of the benchmark
+const uint64_t FUNDING_AMOUNT = UINT64_C(10001234567);
+
+}
+
+void serialize(ChainParameters& parameters, ISerializer& serializer) {
+  serializer(parameters.blockCount, "blockCount");
+  serializer(parameters.transactionsPerBlock, "transactionsPerBlock");
+  serializer(parameters.inputsPerTransaction, "inputsPerTransaction");
+  serializer(parameters.mixin, "mixin");
+  serializer(parameters.outputsPerTransaction, "outputsPerTransaction");
+  serializer(parameters.seed, "seed");
+}
+
+void serialize(GeneratedChain& chain, ISerializer& serializer) {
+  serializer(chain.parameters, "parameters");
+  serializer(chain.walletKeys, "walletKeys");
+  serializer(chain.blocks, "blocks");
+}
+
+void saveChain(const GeneratedChain& chain, const std::string& path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+
+  Common::StdOutputStream stream(file);
+  BinaryOutputStreamSerializer serializer(stream);
+  serialize(const_cast<GeneratedChain&>(chain), serializer);
+  file.flush();
+  if (!file) {
+    throw std::runtime_error("Failed to write " + path);
+  }
+}
+
+GeneratedChain loadChain(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+
+  GeneratedChain chain;
+  Common::StdInputStream stream(file);
+  BinaryInputStreamSerializer serializer(stream);
+  serialize(chain, serializer);
+  return chain;
+}
+
+ChainGenerator::ChainGenerator(const Currency& currency, const ChainParameters& parameters, Logging::ILogger& logger) :
+  m_currency(currency), m_parameters(parameters), m_logger(logger), m_generator(currency), m_random(parameters.seed) {
+  m_miner.generate();
+  m_wallet.generate();
+}
+
+GeneratedChain ChainGenerator::generate() {
+  GeneratedChain chain;
+  chain.parameters = m_parameters;
+  chain.walletKeys = m_wallet.getAccountKeys();
+  chain.blocks.reserve(m_parameters.blockCount);
+
+  // genesis outputs belong to nobody we know but take global indexes
+  BlockTemplate previousBlock = m_currency.genesisBlock();
+  addOutputs(previousBlock.baseTransaction);
+  m_coinbaseOutputs.emplace_back();
+
+  // a block spends the coinbase outputs unlocked in it and funds transactions of the next block
+  const uint32_t fundingDepth = m_currency.minedMoneyUnlockWindow() + 1;
+  for (uint32_t index = 1; index <= m_parameters.blockCount; ++index) {
+    std::list<Transaction> transactions;
+    if (index > fundingDepth + 1) {
+      for (uint32_t i = 0; i < m_parameters.transactionsPerBlock; ++i) {
+        transactions.push_back(createTransaction());
+      }
+    }
+
+    bool hasFundingTransaction = index > fundingDepth;
+    if (hasFundingTransaction) {
+      transactions.push_back(createFundingTransaction(m_coinbaseOutputs[index - fundingDepth]));
+    }
+
+    BlockTemplate block;
+    if (!m_generator.constructBlock(block, previousBlock, m_miner, transactions)) {
+      throw std::runtime_error("Failed to construct block " + std::to_string(index) + ", it is probably too big");
+    }
+
+    RawBlock rawBlock;
+    rawBlock.block = toBinaryArray(block);
+    m_coinbaseOutputs.push_back(addOutputs(block.baseTransaction));
+    for (const Transaction& transaction : transactions) {
+      std::vector<SpendableOutput> outputs = addOutputs(transaction);
+      if (hasFundingTransaction && &transaction == &transactions.back()) {
+        for (const SpendableOutput& output : outputs) {
+          if (output.amount == FUNDING_AMOUNT) {
+            m_unspentFundingOutputs.push_back(output);
+          }
+        }
+      }
+
+      rawBlock.transactions.push_back(toBinaryArray(transaction));
+    }
+
+    chain.blocks.push_back(std::move(rawBlock));
+    previousBlock = std::move(block);
+  }
+
+  return chain;
+}
+
+Transaction ChainGenerator::createFundingTransaction(const std::vector<SpendableOutput>& coinbaseOutputs) {
+  // at least mixin + 1 outputs, so the first transactions have enough decoys
+  uint64_t outputCount = std::max<uint64_t>(static_cast<uint64_t>(m_parameters.transactionsPerBlock) * m_parameters.inputsPerTransaction,
+    m_parameters.mixin + 1);
+
+  std::vector<TransactionSourceEntry> sources;
+  uint64_t inputAmount = 0;
+  for (const SpendableOutput& output : coinbaseOutputs) {
+    sources.push_back(createSource(output, 0));
+    inputAmount += output.amount;
+  }
+
+  if (inputAmount / FUNDING_AMOUNT <= outputCount) {
+    throw std::runtime_error("Block reward is too small to fund " + std::to_string(outputCount) + " inputs per block");
+  }
+
+  const AccountPublicAddress& minerAddress = m_miner.getAccountKeys().address;
+  std::vector<TransactionDestinationEntry> destinations(outputCount, TransactionDestinationEntry(FUNDING_AMOUNT, minerAddress));
+  destinations.emplace_back(inputAmount - outputCount * FUNDING_AMOUNT, minerAddress);
+  return constructTransaction(sources, destinations);
+}
+
+Transaction ChainGenerator::createTransaction() {
+  std::vector<TransactionSourceEntry> sources;
+  for (uint32_t i = 0; i < m_parameters.inputsPerTransaction; ++i) {
+    sources.push_back(createSource(m_unspentFundingOutputs.front(), m_parameters.mixin));
+    m_unspentFundingOutputs.pop_front();
+  }
+
+  uint64_t amount = m_parameters.inputsPerTransaction * FUNDING_AMOUNT - m_currency.minimumFee();
+  std::vector<TransactionDestinationEntry> destinations;
+  for (uint32_t i = 0; i < m_parameters.outputsPerTransaction; ++i) {
+    uint64_t outputAmount = amount / m_parameters.outputsPerTransaction + (i == 0 ? amount % m_parameters.outputsPerTransaction : 0);
+    destinations.emplace_back(outputAmount, m_wallet.getAccountKeys().address);
+  }
+
+  return constructTransaction(sources, destinations);
+}
+
+TransactionSourceEntry ChainGenerator::createSource(const SpendableOutput& output, size_t mixin) {
+  std::set<uint32_t> globalIndexes = { output.globalIndex };
+  std::uniform_int_distribution<uint32_t> distribution(0, static_cast<uint32_t>(m_fundingOutputKeys.size() - 1));
+  while (globalIndexes.size() < mixin + 1) {
+    globalIndexes.insert(distribution(m_random));
+  }
+
+  TransactionSourceEntry source;
+  source.amount = output.amount;
+  source.realTransactionPublicKey = output.transactionPublicKey;
+  source.realOutputIndexInTransaction = output.indexInTransaction;
+  for (uint32_t globalIndex : globalIndexes) {
+    if (globalIndex == output.globalIndex) {
+      source.realOutput = source.outputs.size();
+      source.outputs.emplace_back(globalIndex, output.key);
+    } else {
+      source.outputs.emplace_back(globalIndex, m_fundingOutputKeys[globalIndex]);
+    }
+  }
+
+  return source;
+}
+
+Transaction ChainGenerator::constructTransaction(const std::vector<TransactionSourceEntry>& sources,
+  const std::vector<TransactionDestinationEntry>& destinations) {
+  Transaction transaction;
+  if (!CryptoNote::constructTransaction(m_miner.getAccountKeys(), sources, destinations, std::vector<uint8_t>(), transaction, 0, m_logger)) {
+    throw std::runtime_error("Failed to construct transaction");
+  }
+
+  return transaction;
+}
+
+std::vector<ChainGenerator::SpendableOutput> ChainGenerator::addOutputs(const Transaction& transaction) {
+  std::vector<SpendableOutput> outputs;
+  Crypto::PublicKey transactionPublicKey = getTransactionPublicKeyFromExtra(transaction.extra);
+  for (size_t i = 0; i < transaction.outputs.size(); ++i) {
+    const TransactionOutput& output = transaction.outputs[i];
+    SpendableOutput spendableOutput;
+    spendableOutput.amount = output.amount;
+    spendableOutput.globalIndex = m_outputCounts[output.amount]++;
+    spendableOutput.key = boost::get<KeyOutput>(output.target).key;
+    spendableOutput.transactionPublicKey = transactionPublicKey;
+    spendableOutput.indexInTransaction = i;
+    if (output.amount == FUNDING_AMOUNT) {
+      m_fundingOutputKeys.push_back(spendableOutput.key);
+    }
+
+    outputs.push_back(spendableOutput);
+  }
+
+  return outputs;
+}
+
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CryptoNoteCore/Account.h"
+#include "CryptoNoteCore/CryptoNoteFormatUtils.h"
+#include "CryptoNoteCore/Currency.h"
+#include "Logging/ILogger.h"
+#include "Serialization/ISerializer.h"
+
+#include "../TestGenerator/TestGenerator.h"
+
+namespace SyncBenchmark {
+
+struct ChainParameters {
+  uint32_t blockCount;
+  uint32_t transactionsPerBlock;
+  uint32_t inputsPerTransaction;
+  uint32_t mixin;
+  uint32_t outputsPerTransaction;
+  uint32_t seed;
+};
+
+// Blocks after the genesis block and keys of the account which receives outputs of all regular transactions
+struct GeneratedChain {
+  ChainParameters parameters;
+  CryptoNote::AccountKeys walletKeys;
+  std::vector<CryptoNote::RawBlock> blocks;
+};
+
+void serialize(ChainParameters& parameters, CryptoNote::ISerializer& serializer);
+void serialize(GeneratedChain& chain, CryptoNote::ISerializer& serializer);
+
+void saveChain(const GeneratedChain& chain, const std::string& path);
+GeneratedChain loadChain(const std::string& path);
+
+// Builds a valid chain of version 1 blocks with difficulty 1. Every block after the first few ones contains
+// transactionsPerBlock transactions which spend inputsPerTransaction outputs with mixin decoys each and send
+// outputsPerTransaction outputs to the wallet. Shape of the chain and choice of decoys depend on the parameters only,
+// keys are random, so save the chain to compare runs byte for byte.
+class ChainGenerator {
+public:
+  ChainGenerator(const CryptoNote::Currency& currency, const ChainParameters& parameters, Logging::ILogger& logger);
+
+  GeneratedChain generate();
+
+private:
+  struct SpendableOutput {
+    uint64_t amount;
+    uint32_t globalIndex;
+    Crypto::PublicKey key;
+    Crypto::PublicKey transactionPublicKey;
+    size_t indexInTransaction;
+  };
+
+  CryptoNote::Transaction createFundingTransaction(const std::vector<SpendableOutput>& coinbaseOutputs);
+  CryptoNote::Transaction createTransaction();
+  CryptoNote::TransactionSourceEntry createSource(const SpendableOutput& output, size_t mixin);
+  CryptoNote::Transaction constructTransaction(const std::vector<CryptoNote::TransactionSourceEntry>& sources,
+    const std::vector<CryptoNote::TransactionDestinationEntry>& destinations);
+  std::vector<SpendableOutput> addOutputs(const CryptoNote::Transaction& transaction);
+
+  const CryptoNote::Currency& m_currency;
+  ChainParameters m_parameters;
+  Logging::ILogger& m_logger;
+  test_generator m_generator;
+  CryptoNote::AccountBase m_miner;
+  CryptoNote::AccountBase m_wallet;
+  std::mt19937 m_random;
+
+  // outputs are numbered per amount in chain order, as the core does it
+  std::unordered_map<uint64_t, uint32_t> m_outputCounts;
+  // keys of all outputs with the funding amount by global index, decoys are taken from them
+  std::vector<Crypto::PublicKey> m_fundingOutputKeys;
+  std::vector<std::vector<SpendableOutput>> m_coinbaseOutputs;
+  std::deque<SpendableOutput> m_unspentFundingOutputs;
+};
+
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+
+#include "Common/CommandLine.h"
+#include "Common/ScopeExit.h"
+#include "CryptoNoteCore/Currency.h"
+#include "Logging/StreamLogger.h"
+
+#include "Benchmarks.h"
+#include "ChainGenerator.h"
+
+namespace po = boost::program_options;
+
+using namespace SyncBenchmark;
+
+namespace {
+const command_line::arg_descriptor<uint32_t> arg_blocks = {"blocks", "Number of generated blocks after the genesis block", 1000};
+const command_line::arg_descriptor<uint32_t> arg_tx_per_block = {"tx-per-block", "Number of regular transactions in a generated block", 10};
+const command_line::arg_descriptor<uint32_t> arg_inputs = {"inputs", "Number of inputs of a generated transaction", 1};
+const command_line::arg_descriptor<uint32_t> arg_mixin = {"mixin", "Number of decoys of a generated input", 2};
+const command_line::arg_descriptor<uint32_t> arg_outputs = {"outputs", "Number of outputs of a generated transaction", 2};
+const command_line::arg_descriptor<uint32_t> arg_seed = {"seed", "Seed of decoy choice", 0};
+const command_line::arg_descriptor<std::string> arg_save_chain = {"save-chain", "Save the generated chain to a file", ""};
+const command_line::arg_descriptor<std::string> arg_load_chain = {"load-chain", "Load a chain saved by --save-chain instead of generating one", ""};
+const command_line::arg_descriptor<bool> arg_checkpoints = {"checkpoints", "Add a checkpoint at the top block, so blocks are accepted without proof of work and signature checks"};
+const command_line::arg_descriptor<std::string> arg_work_dir = {"work-dir", "Directory of a temporary subdirectory for data bases and P2P state, the system temporary directory by default", ""};
+const command_line::arg_descriptor<uint16_t> arg_p2p_port = {"p2p-port", "Port of the P2P node which serves the chain, the next port is used by the synchronizing node", 18280};
+const command_line::arg_descriptor<uint32_t> arg_p2p_timeout = {"p2p-timeout", "Seconds to wait for P2P synchronization", 600};
+const command_line::arg_descriptor<int> arg_log_level = {"log-level", "Level of log messages written to stderr", Logging::WARNING};
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    po::options_description desc_options("Allowed options");
+    command_line::add_arg(desc_options, command_line::arg_help);
+    command_line::add_arg(desc_options, arg_blocks);
+    command_line::add_arg(desc_options, arg_tx_per_block);
+    command_line::add_arg(desc_options, arg_inputs);
+    command_line::add_arg(desc_options, arg_mixin);
+    command_line::add_arg(desc_options, arg_outputs);
+    command_line::add_arg(desc_options, arg_seed);
+    command_line::add_arg(desc_options, arg_save_chain);
+    command_line::add_arg(desc_options, arg_load_chain);
+    command_line::add_arg(desc_options, arg_checkpoints);
+    command_line::add_arg(desc_options, arg_work_dir);
+    command_line::add_arg(desc_options, arg_p2p_port);
+    command_line::add_arg(desc_options, arg_p2p_timeout);
+    command_line::add_arg(desc_options, arg_log_level);
+    CryptoNote::DataBaseConfig::initOptions(desc_options);
+
+    po::variables_map vm;
+    bool r = command_line::handle_error_helper(desc_options, [&]() {
+      po::store(po::parse_command_line(argc, argv, desc_options), vm);
+      po::notify(vm);
+      return true;
+    });
+    if (!r)
+      return 1;
+
+    if (command_line::get_arg(vm, command_line::arg_help)) {
+      std::cout << desc_options << std::endl;
+      return 0;
+    }
+
+    Logging::StreamLogger logger(std::cerr, static_cast<Logging::Level>(command_line::get_arg(vm, arg_log_level)));
+    CryptoNote::Currency currency = CryptoNote::CurrencyBuilder(logger).currency();
+
+    BenchmarkSettings settings;
+    settings.useCheckpoints = command_line::get_arg(vm, arg_checkpoints);
+    settings.databaseConfig.init(vm);
+    settings.p2pPort = command_line::get_arg(vm, arg_p2p_port);
+    settings.p2pTimeout = std::chrono::seconds(command_line::get_arg(vm, arg_p2p_timeout));
+    boost::filesystem::path workDir = command_line::get_arg(vm, arg_work_dir);
+    if (workDir.empty()) {
+      workDir = boost::filesystem::temp_directory_path();
+    }
+
+    settings.workDir = (workDir / boost::filesystem::unique_path("sync_benchmark-%%%%-%%%%")).string();
+    boost::filesystem::create_directories(settings.workDir);
+    Tools::ScopeExit workDirRemoval([&settings] { boost::filesystem::remove_all(settings.workDir); });
+
+    Common::JsonValue result(Common::JsonValue::OBJECT);
+    GeneratedChain chain;
+    std::string chainPath = command_line::get_arg(vm, arg_load_chain);
+    if (!chainPath.empty()) {
+      chain = loadChain(chainPath);
+    } else {
+      ChainParameters parameters;
+      parameters.blockCount = command_line::get_arg(vm, arg_blocks);
+      parameters.transactionsPerBlock = command_line::get_arg(vm, arg_tx_per_block);
+      parameters.inputsPerTransaction = command_line::get_arg(vm, arg_inputs);
+      parameters.mixin = command_line::get_arg(vm, arg_mixin);
+      parameters.outputsPerTransaction = command_line::get_arg(vm, arg_outputs);
+      parameters.seed = command_line::get_arg(vm, arg_seed);
+      if (parameters.blockCount == 0 || parameters.inputsPerTransaction == 0 || parameters.outputsPerTransaction == 0) {
+        std::cerr << "--blocks, --inputs and --outputs must be positive" << std::endl;
+        return 1;
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      chain = ChainGenerator(currency, parameters, logger).generate();
+      result.insert("generation_seconds", std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::string savePath = command_line::get_arg(vm, arg_save_chain);
+    if (!savePath.empty()) {
+      saveChain(chain, savePath);
+    }
+
+    result.insert("chain", describeChain(chain));
+    result.insert("checkpoints", Common::JsonValue(settings.useCheckpoints));
+    result.insert("core_add_block", measureCoreAddBlock(currency, chain, settings, logger));
+    result.insert("core_import", measureCoreImport(currency, chain, settings, logger));
+    result.insert("p2p_sync", measureP2pSync(currency, chain, settings, logger));
+    result.insert("transfers_scan", measureTransfersScan(currency, chain, settings, logger));
+
+    std::cout << result << std::endl;
+    return 0;
+  } catch (std::exception& e) {
+    std::cerr << "Sync benchmark failed: " << e.what() << std::endl;
+    return 1;
+  }
+}
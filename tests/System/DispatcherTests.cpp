@@ -15,7 +15,12 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <atomic>
+#include <deque>
 #include <future>
+#include <iostream>
+#include <thread>
+#include <vector>
 #include <System/Context.h>
 #include <System/Dispatcher.h>
 #include <System/Event.h>
@@ -327,6 +332,84 @@ TEST_F(DispatcherTests, remoteSpawnActuallyWorksParallel) {
   }
 }
 
+TEST_F(DispatcherTests, remoteSpawnFromManyThreadsKeepsOrderOfEachThread) {
+  const size_t THREADS = 4;
+  const size_t PROCEDURES = 100000;
+  // every spawned procedure gets a context with its own stack, producers must not run too far ahead
+  const size_t MAX_PENDING = 1000;
+  Event remoteSpawnDone(dispatcher);
+  std::atomic<size_t> pending(0);
+  std::vector<size_t> executed(THREADS, 0);
+  size_t outOfOrder = 0;
+  size_t remaining = THREADS * PROCEDURES;
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < THREADS; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (size_t i = 0; i < PROCEDURES; ++i) {
+        while (pending >= MAX_PENDING) {
+          std::this_thread::yield();
+        }
+
+        ++pending;
+        dispatcher.remoteSpawn([&, thread, i] {
+          --pending;
+          if (executed[thread]++ != i) {
+            ++outOfOrder;
+          }
+
+          if (--remaining == 0) {
+            remoteSpawnDone.set();
+          }
+        });
+      }
+    });
+  }
+
+  remoteSpawnDone.wait();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, outOfOrder);
+  ASSERT_EQ(std::vector<size_t>(THREADS, PROCEDURES), executed);
+}
+
+TEST_F(DispatcherTests, remoteSpawnsPerSecond) {
+  const size_t THREADS = 4;
+  const size_t PROCEDURES = 250000;
+  const size_t MAX_PENDING = 1000;
+  Event remoteSpawnDone(dispatcher);
+  std::atomic<size_t> pending(0);
+  size_t remaining = THREADS * PROCEDURES;
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < THREADS; ++thread) {
+    threads.emplace_back([&] {
+      for (size_t i = 0; i < PROCEDURES; ++i) {
+        while (pending >= MAX_PENDING) {
+          std::this_thread::yield();
+        }
+
+        ++pending;
+        dispatcher.remoteSpawn([&] {
+          --pending;
+          if (--remaining == 0) {
+            remoteSpawnDone.set();
+          }
+        });
+      }
+    });
+  }
+
+  remoteSpawnDone.wait();
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::cout << "Executed " << static_cast<size_t>(THREADS * PROCEDURES / seconds) << " remote spawns per second from " << THREADS << " threads" << std::endl;
+}
+
 TEST_F(DispatcherTests, spawnActuallySpawns) {
   bool spawnDone = false;
   Context<> context(dispatcher, [&]() {
@@ -122,3 +122,11 @@ TEST_F(TcpListenerTests, tcpListener3) {
   contextGroup.wait();
   ASSERT_TRUE(stopped);
 }
+
+#ifndef _WIN32
+TEST_F(TcpListenerTests, listenersWithPortReuseShareThePort) {
+  TcpListener first(dispatcher, Ipv4Address("127.0.0.1"), 6667, true);
+  TcpListener second(dispatcher, Ipv4Address("127.0.0.1"), 6667, true);
+  ASSERT_ANY_THROW(TcpListener(dispatcher, Ipv4Address("127.0.0.1"), 6667));
+}
+#endif
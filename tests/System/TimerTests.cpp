@@ -15,6 +15,10 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
 #include <thread>
 #include <System/Context.h>
 #include <System/Dispatcher.h>
@@ -278,3 +282,79 @@ TEST_F(TimerTests, timerWithZeroTimeIsYielding) {
   Timer(dispatcher).sleep(std::chrono::milliseconds(0));
   ASSERT_TRUE(done);
 }
+
+TEST_F(TimerTests, timersExpireInOrderOfDuration) {
+  std::vector<size_t> durations;
+  for (size_t i = 1; i <= 50; ++i) {
+    durations.push_back(i * 2);
+  }
+
+  std::shuffle(durations.begin(), durations.end(), std::mt19937(0));
+  std::vector<size_t> expired;
+  for (auto duration : durations) {
+    contextGroup.spawn([&, duration] {
+      Timer(dispatcher).sleep(std::chrono::milliseconds(duration));
+      expired.push_back(duration);
+    });
+  }
+
+  contextGroup.wait();
+  ASSERT_EQ(durations.size(), expired.size());
+  ASSERT_TRUE(std::is_sorted(expired.begin(), expired.end()));
+}
+
+TEST_F(TimerTests, interruptedTimersDontAffectOthers) {
+  const size_t COUNT = 500;
+  std::mt19937 generator(0);
+  std::vector<int> results(COUNT, 0);
+  std::vector<std::unique_ptr<Context<>>> contexts;
+  for (size_t i = 0; i < COUNT; ++i) {
+    // interrupted timers are spread from a second to months to get to every level of timer wheel
+    auto duration = i % 2 == 0 ? std::chrono::milliseconds(1 + generator() % 50) : std::chrono::milliseconds(UINT64_C(1000) << (generator() % 24));
+    contexts.emplace_back(new Context<>(dispatcher, [&, i, duration] {
+      auto begin = std::chrono::steady_clock::now();
+      try {
+        Timer(dispatcher).sleep(duration);
+        results[i] = std::chrono::steady_clock::now() - begin >= duration ? 1 : -1;
+      } catch (InterruptedException&) {
+        results[i] = 2;
+      }
+    }));
+  }
+
+  dispatcher.yield();
+  std::vector<size_t> interrupted;
+  for (size_t i = 1; i < COUNT; i += 2) {
+    interrupted.push_back(i);
+  }
+
+  std::shuffle(interrupted.begin(), interrupted.end(), generator);
+  for (auto i : interrupted) {
+    contexts[i]->interrupt();
+  }
+
+  for (size_t i = 0; i < COUNT; ++i) {
+    contexts[i]->wait();
+    ASSERT_EQ(i % 2 == 0 ? 1 : 2, results[i]) << "timer " << i;
+  }
+}
+
+TEST_F(TimerTests, timersPerSecond) {
+  const size_t CONTEXTS = 1000;
+  const size_t ROUNDS = 100;
+  auto begin = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < ROUNDS; ++round) {
+    for (size_t i = 0; i < CONTEXTS; ++i) {
+      contextGroup.spawn([&] {
+        Timer(dispatcher).sleep(std::chrono::seconds(60));
+      });
+    }
+
+    dispatcher.yield();
+    contextGroup.interrupt();
+    contextGroup.wait();
+  }
+
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  std::cout << "Armed and cancelled " << static_cast<size_t>(CONTEXTS * ROUNDS / seconds) << " timers per second" << std::endl;
+}
@@ -40,6 +40,7 @@ std::error_code DataBaseMock::writeSync(IWriteBatch& batch) {
 }
 
 std::error_code DataBaseMock::read(IReadBatch& batch) {
+  ++readCount;
   auto keys = batch.getRawKeys();
   std::vector<std::string> kvs;
   std::vector<bool> states;
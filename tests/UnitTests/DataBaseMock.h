@@ -37,5 +37,6 @@ public:
   std::unordered_map<uint32_t, RawBlock> blocks();
 
   std::map<std::string, std::string> baseState;
+  size_t readCount = 0;
 };
 }
@@ -127,6 +127,13 @@ bool ICoreStub::getPoolChangesLite(const Crypto::Hash& tailBlockId, const std::v
   return returnStatus;
 }
 
+bool ICoreStub::getPoolChangesLiteSince(const Crypto::Hash& tailBlockId, uint64_t& poolVersion, const std::vector<Crypto::Hash>& knownTxsIds,
+          std::vector<CryptoNote::TransactionPrefixInfo>& addedTxs, std::vector<Crypto::Hash>& deletedTxsIds, bool& isDelta) const {
+  isDelta = false;
+  poolVersion = 0;
+  return getPoolChangesLite(tailBlockId, knownTxsIds, addedTxs, deletedTxsIds);
+}
+
 bool ICoreStub::queryBlocks(const std::vector<Crypto::Hash>& block_ids, uint64_t timestamp,
     uint32_t& start_height, uint32_t& current_height, uint32_t& full_offset, std::vector<CryptoNote::BlockFullInfo>& entries) const {
   //stub
@@ -353,6 +360,15 @@ CryptoNote::BlockDetails ICoreStub::getBlockDetails(const Crypto::Hash& blockHas
   return details;
 }
 
+std::vector<CryptoNote::BlockDetails> ICoreStub::getBlocksDetails(const std::vector<Crypto::Hash>& blockHashes) const {
+  std::vector<CryptoNote::BlockDetails> blocksDetails;
+  for (const auto& hash : blockHashes) {
+    blocksDetails.push_back(getBlockDetails(hash));
+  }
+
+  return blocksDetails;
+}
+
 CryptoNote::TransactionDetails ICoreStub::getTransactionDetails(const Crypto::Hash& transactionHash) const {
   CryptoNote::BinaryArray transactionBinaryArray;
 
@@ -70,6 +70,8 @@ public:
   virtual bool getPoolChanges(const Crypto::Hash& tailBlockId, const std::vector<Crypto::Hash>& knownTxsIds, std::vector<CryptoNote::BinaryArray>& addedTxs, std::vector<Crypto::Hash>& deletedTxsIds) const override;
   virtual bool getPoolChangesLite(const Crypto::Hash& tailBlockId, const std::vector<Crypto::Hash>& knownTxsIds,
           std::vector<CryptoNote::TransactionPrefixInfo>& addedTxs, std::vector<Crypto::Hash>& deletedTxsIds) const override;
+  virtual bool getPoolChangesLiteSince(const Crypto::Hash& tailBlockId, uint64_t& poolVersion, const std::vector<Crypto::Hash>& knownTxsIds,
+          std::vector<CryptoNote::TransactionPrefixInfo>& addedTxs, std::vector<Crypto::Hash>& deletedTxsIds, bool& isDelta) const override;
   virtual bool queryBlocks(const std::vector<Crypto::Hash>& block_ids, uint64_t timestamp,
     uint32_t& start_height, uint32_t& current_height, uint32_t& full_offset, std::vector<CryptoNote::BlockFullInfo>& entries) const override;
   virtual bool queryBlocksLite(const std::vector<Crypto::Hash>& block_ids, uint64_t timestamp,
@@ -101,10 +103,13 @@ public:
 
   virtual bool hasTransaction(const Crypto::Hash& transactionHash) const override;
   virtual CryptoNote::BlockDetails getBlockDetails(const Crypto::Hash& blockHash) const override;
+  virtual std::vector<CryptoNote::BlockDetails> getBlocksDetails(const std::vector<Crypto::Hash>& blockHashes) const override;
   virtual CryptoNote::TransactionDetails getTransactionDetails(const Crypto::Hash& transactionHash) const override;
   virtual std::vector<Crypto::Hash> getAlternativeBlockHashesByIndex(uint32_t blockIndex) const override;
   virtual std::vector<Crypto::Hash> getBlockHashesByTimestamps(uint64_t timestampBegin, size_t secondsCount) const override { return {};}
   virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash& paymentId) const override { return {}; }
+  virtual std::vector<Crypto::Hash> getTransactionHashesByKeyImages(const std::vector<Crypto::KeyImage>& keyImages) const override { return {}; }
+  virtual std::vector<Crypto::Hash> getTransactionHashesByOutputKeys(const std::vector<Crypto::PublicKey>& outputKeys) const override { return {}; }
 
 private:
   uint32_t topHeight;
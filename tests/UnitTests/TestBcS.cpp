@@ -1277,16 +1277,17 @@ TEST_F(BcSTest, checkBlocksRerequestingOnError) {
   generator.generateEmptyBlocks(20);
   m_node.setGetNewBlocksLimit(10);
   
-  std::atomic<int> requestsCount(0);
-  std::list<Hash> firstlyKnownBlockIdsTaken;
-  std::list<Hash> secondlyKnownBlockIdsTaken;
+  // next batch may be requested while the previous one is processed, so batches are counted apart from requests
+  std::mutex requestsMutex;
+  std::vector<std::vector<Hash>> requests;
+  size_t batchesCount = 0;
 
   std::vector<Hash> firstlyReceivedBlocks;
   std::vector<Hash> secondlyReceivedBlocks;
 
-
   c.onNewBlocksFunctor = [&](const CompleteBlock* blocks, uint32_t, size_t count) -> bool {
-    if (requestsCount == 2) {
+    ++batchesCount;
+    if (batchesCount == 2) {
       for (size_t i = 0; i < count; ++i) {
         firstlyReceivedBlocks.push_back(blocks[i].blockHash);
       }
@@ -1294,26 +1295,69 @@ TEST_F(BcSTest, checkBlocksRerequestingOnError) {
       return false;
     }
 
-    if (requestsCount == 3) {
+    if (batchesCount == 3) {
       for (size_t i = 0; i < count; ++i) {
         secondlyReceivedBlocks.push_back(blocks[i].blockHash);
       }
     }
 
-    return true;   
+    return true;
   };
 
   m_node.queryBlocksFunctor = [&](const std::vector<Hash>& knownBlockIds, uint64_t timestamp, std::vector<BlockShortEntry>& newBlocks, uint32_t& startHeight, const INode::Callback& callback) -> bool {
-    ++requestsCount;
+    std::unique_lock<std::mutex> lock(requestsMutex);
+    requests.push_back(knownBlockIds);
+    return true;
+  };
 
-    if (requestsCount == 2) {
-      firstlyKnownBlockIdsTaken.assign(knownBlockIds.begin(), knownBlockIds.end());
-    }
+  m_sync.addObserver(&o1);
+  m_sync.addConsumer(&c);
+  m_sync.start();
+  e.wait();
+  m_sync.stop();
 
-    if (requestsCount == 3) {
-      secondlyKnownBlockIdsTaken.assign(knownBlockIds.begin(), knownBlockIds.end());
-    }
+  size_t firstRequestAfterRestart;
+  {
+    std::unique_lock<std::mutex> lock(requestsMutex);
+    firstRequestAfterRestart = requests.size();
+  }
+
+  m_sync.start();
+  e.wait();
+  m_sync.stop();
+  m_sync.removeObserver(&o1);
+  o1.syncFunc = [](std::error_code) {};
+
+  std::unique_lock<std::mutex> lock(requestsMutex);
+  ASSERT_LT(firstRequestAfterRestart, requests.size());
+  // second batch was answered to the second request, after restart it must be requested the same way
+  EXPECT_EQ(requests[1], requests[firstRequestAfterRestart]);
+  EXPECT_EQ(firstlyReceivedBlocks, secondlyReceivedBlocks);
+}
+
+TEST_F(BcSTest, checkNextBlocksRequestedWhileProcessing) {
+  FunctorialBlockhainConsumerStub c(m_currency.genesisBlockHash());
+  IBlockchainSynchronizerFunctorialObserver o1;
+  EventWaiter e;
+  o1.syncFunc = [&](std::error_code) {
+    e.notify();
+  };
 
+  generator.generateEmptyBlocks(20);
+  m_node.setGetNewBlocksLimit(10);
+
+  std::atomic<size_t> requestsCount(0);
+  std::vector<size_t> requestsCountOnBatch;
+  size_t receivedBlocksCount = 0;
+
+  c.onNewBlocksFunctor = [&](const CompleteBlock*, uint32_t, size_t count) -> bool {
+    requestsCountOnBatch.push_back(requestsCount);
+    receivedBlocksCount += count;
+    return true;
+  };
+
+  m_node.queryBlocksFunctor = [&](const std::vector<Hash>&, uint64_t, std::vector<BlockShortEntry>&, uint32_t&, const INode::Callback&) -> bool {
+    ++requestsCount;
     return true;
   };
 
@@ -1322,15 +1366,58 @@ TEST_F(BcSTest, checkBlocksRerequestingOnError) {
   m_sync.start();
   e.wait();
   m_sync.stop();
+  m_sync.removeObserver(&o1);
+  o1.syncFunc = [](std::error_code) {};
+
+  ASSERT_EQ(generator.getBlockchain().size() - 1, receivedBlocksCount);
+  ASSERT_LE(2, requestsCountOnBatch.size());
+  // request for the second batch was sent before the first one was passed to consumer
+  EXPECT_EQ(2, requestsCountOnBatch.front());
+}
 
+TEST_F(BcSTest, checkConsumersUpdatedConcurrently) {
+  FunctorialBlockhainConsumerStub c1(m_currency.genesisBlockHash());
+  FunctorialBlockhainConsumerStub c2(m_currency.genesisBlockHash());
+  IBlockchainSynchronizerFunctorialObserver o1;
+  EventWaiter e;
+  o1.syncFunc = [&](std::error_code) {
+    e.notify();
+  };
+
+  generator.generateEmptyBlocks(3);
+
+  std::atomic<int> enteredCount(0);
+  std::atomic<bool> overlapped(false);
+  auto onNewBlocks = [&](const CompleteBlock*, uint32_t, size_t) -> bool {
+    ++enteredCount;
+    // serial dispatch would never let the second consumer in while the first one waits
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (enteredCount < 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (enteredCount >= 2) {
+      overlapped = true;
+    }
+
+    return true;
+  };
+
+  c1.onNewBlocksFunctor = onNewBlocks;
+  c2.onNewBlocksFunctor = onNewBlocks;
+
+  m_sync.addObserver(&o1);
+  m_sync.addConsumer(&c1);
+  m_sync.addConsumer(&c2);
   m_sync.start();
   e.wait();
   m_sync.stop();
   m_sync.removeObserver(&o1);
   o1.syncFunc = [](std::error_code) {};
 
-  EXPECT_EQ(firstlyKnownBlockIdsTaken, secondlyKnownBlockIdsTaken);
-  EXPECT_EQ(firstlyReceivedBlocks, secondlyReceivedBlocks);
+  EXPECT_TRUE(overlapped);
+  EXPECT_EQ(generator.getBlockchain().size(), m_sync.getConsumerKnownBlocks(c1).size());
+  EXPECT_EQ(m_sync.getConsumerKnownBlocks(c1), m_sync.getConsumerKnownBlocks(c2));
 }
 
 TEST_F(BcSTest, checkTxOrder) {
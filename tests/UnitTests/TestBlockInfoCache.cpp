@@ -0,0 +1,93 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include "CryptoNoteCore/BlockInfoCache.h"
+#include "CryptoNoteCore/ICore.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+Crypto::Hash makeHash(uint8_t value) {
+  Crypto::Hash hash = {};
+  hash.data[0] = value;
+  return hash;
+}
+
+}
+
+TEST(BlockInfoCache, getReturnsPutInfo) {
+  BlockInfoCache<BlockShortInfo> cache(2);
+
+  BlockShortInfo info;
+  info.blockId = makeHash(1);
+  info.block = {1, 2, 3};
+  cache.put(info.blockId, info);
+
+  BlockShortInfo cached;
+  ASSERT_TRUE(cache.get(info.blockId, cached));
+  ASSERT_EQ(info.blockId, cached.blockId);
+  ASSERT_EQ(info.block, cached.block);
+  ASSERT_EQ(1, cache.getHits());
+  ASSERT_EQ(0, cache.getMisses());
+}
+
+TEST(BlockInfoCache, getCountsMisses) {
+  BlockInfoCache<BlockShortInfo> cache(2);
+
+  BlockShortInfo cached;
+  ASSERT_FALSE(cache.get(makeHash(1), cached));
+  ASSERT_EQ(0, cache.getHits());
+  ASSERT_EQ(1, cache.getMisses());
+}
+
+TEST(BlockInfoCache, putEvictsLeastRecentlyUsedBlock) {
+  BlockInfoCache<BlockFullInfo> cache(2);
+
+  BlockFullInfo info;
+  cache.put(makeHash(1), info);
+  cache.put(makeHash(2), info);
+  ASSERT_TRUE(cache.get(makeHash(1), info));
+
+  cache.put(makeHash(3), info);
+  ASSERT_EQ(2, cache.size());
+  ASSERT_TRUE(cache.get(makeHash(1), info));
+  ASSERT_FALSE(cache.get(makeHash(2), info));
+  ASSERT_TRUE(cache.get(makeHash(3), info));
+}
+
+TEST(BlockInfoCache, clearRemovesAllBlocks) {
+  BlockInfoCache<BlockFullInfo> cache(2);
+
+  BlockFullInfo info;
+  cache.put(makeHash(1), info);
+  cache.clear();
+
+  ASSERT_EQ(0, cache.size());
+  ASSERT_FALSE(cache.get(makeHash(1), info));
+}
+
+TEST(BlockInfoCache, zeroCapacityKeepsNothing) {
+  BlockInfoCache<BlockFullInfo> cache(0);
+
+  BlockFullInfo info;
+  cache.put(makeHash(1), info);
+
+  ASSERT_EQ(0, cache.size());
+  ASSERT_FALSE(cache.get(makeHash(1), info));
+}
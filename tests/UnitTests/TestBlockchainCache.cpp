@@ -240,6 +240,36 @@ TEST_F(BlockchainCacheTests, getBlockHashesChained) {
   ASSERT_EQ(expected, actual);
 }
 
+TEST_F(BlockchainCacheTests, getBlocksByIndexesChained) {
+  const size_t BLOCK_COUNT = 5;
+  const uint64_t REWARD = rand();
+  const uint64_t SIZE = rand();
+  const Difficulty DIFFICULTY = rand();
+  std::vector<CachedTransaction> transactions;
+  TransactionValidatorState validatorState;
+  generator.generateEmptyBlocks(BLOCK_COUNT);
+  auto bcCopy = generator.getBlockchainCopy();
+  for (size_t i = 1; i < bcCopy.size(); ++i) { //Skip genesis block
+    const CachedBlock block(bcCopy.at(i));
+    ASSERT_NO_FATAL_FAILURE(blockCache.pushBlock(block, transactions, validatorState, SIZE, REWARD, DIFFICULTY, RawBlock{toBinaryArray(bcCopy.at(i)), {}}));
+  }
+
+  uint32_t start = static_cast<uint32_t>(generator.getBlockchain().size());
+  BlockchainCache otherCache("cache", currency, logger, &blockCache, start);
+  generator.generateEmptyBlocks(BLOCK_COUNT);
+  for (size_t i = start; i < generator.getBlockchain().size(); ++i) {
+    const CachedBlock block(generator.getBlockchain()[i]);
+    ASSERT_NO_FATAL_FAILURE(otherCache.pushBlock(block, transactions, validatorState, SIZE, REWARD, DIFFICULTY, RawBlock{toBinaryArray(generator.getBlockchain()[i]), {}}));
+  }
+
+  std::vector<uint32_t> indexes = { start + 1, 2, start + 1, start - 1 };
+  auto blocks = otherCache.getBlocksByIndexes(indexes);
+  ASSERT_EQ(indexes.size(), blocks.size());
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    ASSERT_EQ(toBinaryArray(generator.getBlockchain()[indexes[i]]), blocks[i].block);
+  }
+}
+
 TEST_F(BlockchainCacheTests, split) {
   const uint32_t SPLIT_HEIGHT = 3;
   const size_t BLOCK_COUNT = 10;
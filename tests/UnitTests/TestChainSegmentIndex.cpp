@@ -0,0 +1,124 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "CryptoNoteCore/BlockchainCache.h"
+#include "CryptoNoteCore/ChainSegmentIndex.h"
+#include "CryptoNoteCore/CryptoNoteTools.h"
+#include "CryptoNoteCore/TransactionValidatiorState.h"
+#include "Logging/FileLogger.h"
+#include "TestBlockchainGenerator.h"
+
+using namespace CryptoNote;
+
+class ChainSegmentIndexTests : public ::testing::Test {
+public:
+  ChainSegmentIndexTests() :
+    currency(CurrencyBuilder(logger).currency()),
+    rootCache("root", currency, logger, nullptr),
+    generator(currency) {
+  }
+
+  void SetUp() override {
+    generator.generateEmptyBlocks(BLOCK_COUNT);
+    blocks = generator.getBlockchainCopy();
+    segment.reset(new BlockchainCache("segment", currency, logger, &rootCache, 1));
+
+    for (size_t i = 1; i < blocks.size(); ++i) { //Skip genesis block
+      pushBlock(segment.get(), blocks[i]);
+    }
+  }
+
+  void pushBlock(IBlockchainCache* cache, const BlockTemplate& block) {
+    std::vector<CachedTransaction> transactions;
+    TransactionValidatorState validatorState;
+    CachedBlock cachedBlock(block);
+    cache->pushBlock(cachedBlock, transactions, validatorState, 0, 0, 1, RawBlock{toBinaryArray(block), {}});
+    index.addBlock(cache, cachedBlock.getBlockHash(), block);
+  }
+
+  static Crypto::Hash blockHash(const BlockTemplate& block) {
+    return CachedBlock(block).getBlockHash();
+  }
+
+  static const size_t BLOCK_COUNT = 5;
+
+  Currency currency;
+  Logging::FileLogger logger;
+  BlockchainCache rootCache;
+  TestBlockchainGenerator generator;
+  std::vector<BlockTemplate> blocks;
+  std::unique_ptr<IBlockchainCache> segment;
+  ChainSegmentIndex index;
+};
+
+TEST_F(ChainSegmentIndexTests, findBlockReturnsSegment) {
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    ASSERT_EQ(segment.get(), index.findBlock(blockHash(blocks[i])));
+  }
+}
+
+TEST_F(ChainSegmentIndexTests, rootSegmentIsNotIndexed) {
+  ASSERT_EQ(nullptr, index.findBlock(blockHash(blocks[0])));
+}
+
+TEST_F(ChainSegmentIndexTests, findTransactionReturnsSegment) {
+  auto transactionHash = getObjectHash(blocks[1].baseTransaction);
+  ASSERT_EQ(segment.get(), index.findTransaction(transactionHash, [](IBlockchainCache*) { return true; }));
+  ASSERT_EQ(nullptr, index.findTransaction(transactionHash, [](IBlockchainCache*) { return false; }));
+}
+
+TEST_F(ChainSegmentIndexTests, moveSplitBlocksRepointsUpperBlocks) {
+  const uint32_t splitIndex = 3;
+  auto upperSegment = segment->split(splitIndex);
+  index.moveSplitBlocks(segment.get(), upperSegment.get());
+
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    auto expected = i < splitIndex ? segment.get() : upperSegment.get();
+    ASSERT_EQ(expected, index.findBlock(blockHash(blocks[i])));
+    ASSERT_EQ(expected, index.findTransaction(getObjectHash(blocks[i].baseTransaction), [](IBlockchainCache*) { return true; }));
+  }
+}
+
+TEST_F(ChainSegmentIndexTests, removeSegmentForgetsItsBlocksOnly) {
+  const uint32_t splitIndex = 3;
+  auto upperSegment = segment->split(splitIndex);
+  index.moveSplitBlocks(segment.get(), upperSegment.get());
+  index.removeSegment(upperSegment.get());
+
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    auto expected = i < splitIndex ? segment.get() : nullptr;
+    ASSERT_EQ(expected, index.findBlock(blockHash(blocks[i])));
+    ASSERT_EQ(expected, index.findTransaction(getObjectHash(blocks[i].baseTransaction), [](IBlockchainCache*) { return true; }));
+  }
+}
+
+TEST_F(ChainSegmentIndexTests, moveSplitBlocksFromRootSegmentAddsThem) {
+  for (size_t i = 1; i < blocks.size(); ++i) {
+    pushBlock(&rootCache, blocks[i]);
+  }
+
+  auto upperSegment = rootCache.split(2);
+  index.clear();
+  index.moveSplitBlocks(&rootCache, upperSegment.get());
+
+  ASSERT_EQ(nullptr, index.findBlock(blockHash(blocks[1])));
+  for (size_t i = 2; i < blocks.size(); ++i) {
+    ASSERT_EQ(upperSegment.get(), index.findBlock(blockHash(blocks[i])));
+  }
+}
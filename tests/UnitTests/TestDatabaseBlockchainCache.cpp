@@ -17,6 +17,8 @@
 
 #include "gtest/gtest.h"
 
+#include <boost/filesystem/operations.hpp>
+
 #include "crypto/crypto.h"
 
 #include "CryptoNoteCore/BlockchainCache.h"
@@ -142,6 +144,162 @@ TEST_F(DatabaseBlockchainCacheTests, HasBlockFromBlockchain) {
   ASSERT_FALSE(blockchain.hasBlock(randomBlockHash()));
 }
 
+TEST_F(DatabaseBlockchainCacheTests, HasBlockPushedAfterFilterWasBuilt) {
+  ASSERT_FALSE(blockchain.hasBlock(randomBlockHash()));
+
+  generator.generateEmptyBlocks(1);
+  const auto& block = generator.getBlockchain().back();
+  CachedBlock cached{block};
+  TransactionValidatorState state;
+  blockchain.pushBlock(cached, {}, state, 0, 0, 0, { toBinaryArray(block), {} });
+
+  ASSERT_TRUE(blockchain.hasBlock(cached.getBlockHash()));
+  ASSERT_TRUE(blockchain.hasBlock(generatedBlockHashes.back()));
+}
+
+TEST_F(DatabaseBlockchainCacheTests, HasBlockReturnsFalseForSplitBlocks) {
+  // database index is one ahead of the generator, which has its own genesis block
+  generator.generateEmptyBlocks(2);
+  const auto& block = generator.getBlockchain().back();
+  CachedBlock cached{block};
+  TransactionValidatorState state;
+  // split moves the block to a memory cache, which requires real block size and difficulty
+  blockchain.pushBlock(cached, {}, state, toBinaryArray(block).size(), 0, 1, { toBinaryArray(block), {} });
+  ASSERT_TRUE(blockchain.hasBlock(cached.getBlockHash()));
+
+  auto upper = blockchain.split(blockchain.getTopBlockIndex());
+
+  ASSERT_FALSE(blockchain.hasBlock(cached.getBlockHash()));
+  ASSERT_TRUE(upper->hasBlock(cached.getBlockHash()));
+}
+
+TEST_F(DatabaseBlockchainCacheTests, CheckIfSpentFindsKeyImagesOfPushedBlocks) {
+  ASSERT_FALSE(blockchain.checkIfSpent(Crypto::rand<KeyImage>()));
+
+  generator.generateEmptyBlocks(2);
+  const auto& block = generator.getBlockchain().back();
+  CachedBlock cached{block};
+  TransactionValidatorState state;
+  auto keyImage = Crypto::rand<KeyImage>();
+  state.spentKeyImages.insert(keyImage);
+  blockchain.pushBlock(cached, {}, state, toBinaryArray(block).size(), 0, 1, { toBinaryArray(block), {} });
+
+  ASSERT_TRUE(blockchain.checkIfSpent(keyImage));
+  ASSERT_FALSE(blockchain.checkIfSpent(keyImage, blockchain.getTopBlockIndex() - 1));
+
+  auto upper = blockchain.split(blockchain.getTopBlockIndex());
+  ASSERT_FALSE(blockchain.checkIfSpent(keyImage));
+  ASSERT_TRUE(upper->checkIfSpent(keyImage));
+}
+
+TEST_F(DatabaseBlockchainCacheTests, CheckIfSpentDoesNotReadDatabaseForUnspentKeyImages) {
+  ASSERT_FALSE(blockchain.checkIfSpent(Crypto::rand<KeyImage>()));
+
+  size_t readCount = database.readCount;
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_FALSE(blockchain.checkIfSpent(Crypto::rand<KeyImage>(), blockchain.getTopBlockIndex()));
+  }
+
+  ASSERT_EQ(readCount, database.readCount);
+}
+
+TEST_F(DatabaseBlockchainCacheTests, ExplorerIndexesAreDisabledByDefault) {
+  ASSERT_EQ(ExplorerIndexesStatus::DISABLED, blockchain.getExplorerIndexesStatus());
+  ASSERT_FALSE(blockchain.buildExplorerIndexes(1));
+
+  Hash transactionHash;
+  uint16_t outputIndex;
+  const auto& output = generator.getBlockchain().back().baseTransaction.outputs.front();
+  ASSERT_FALSE(blockchain.findTransactionByOutputKey(boost::get<KeyOutput>(output.target).key, transactionHash, outputIndex));
+}
+
+TEST_F(DatabaseBlockchainCacheTests, ExplorerIndexesAreBuiltForExistingBlocks) {
+  DatabaseBlockchainCache indexed(currency, database, blockchainCacheFactory, logger, true);
+  ASSERT_EQ(ExplorerIndexesStatus::BUILDING, indexed.getExplorerIndexesStatus());
+
+  while (indexed.buildExplorerIndexes(2)) {
+  }
+
+  ASSERT_EQ(ExplorerIndexesStatus::READY, indexed.getExplorerIndexesStatus());
+  for (const auto& block : generator.getBlockchain()) {
+    const auto& outputs = block.baseTransaction.outputs;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      Hash transactionHash;
+      uint16_t outputIndex;
+      ASSERT_TRUE(indexed.findTransactionByOutputKey(boost::get<KeyOutput>(outputs[i].target).key, transactionHash, outputIndex));
+      ASSERT_EQ(getObjectHash(block.baseTransaction), transactionHash);
+      ASSERT_EQ(i, outputIndex);
+    }
+  }
+}
+
+TEST_F(DatabaseBlockchainCacheTests, ExplorerIndexesOfSplitBlocksAreRemoved) {
+  DatabaseBlockchainCache indexed(currency, database, blockchainCacheFactory, logger, true);
+  while (indexed.buildExplorerIndexes(100)) {
+  }
+
+  generator.generateEmptyBlocks(2);
+  const auto& block = generator.getBlockchain().back();
+  CachedBlock cached{block};
+  TransactionValidatorState state;
+  indexed.pushBlock(cached, {}, state, toBinaryArray(block).size(), 0, 1, { toBinaryArray(block), {} });
+
+  Hash transactionHash;
+  uint16_t outputIndex;
+  const auto& outputKey = boost::get<KeyOutput>(block.baseTransaction.outputs.front().target).key;
+  ASSERT_TRUE(indexed.findTransactionByOutputKey(outputKey, transactionHash, outputIndex));
+
+  auto upper = indexed.split(indexed.getTopBlockIndex());
+  ASSERT_FALSE(indexed.findTransactionByOutputKey(outputKey, transactionHash, outputIndex));
+  ASSERT_TRUE(upper->findTransactionByOutputKey(outputKey, transactionHash, outputIndex));
+  ASSERT_EQ(getObjectHash(block.baseTransaction), transactionHash);
+  ASSERT_EQ(ExplorerIndexesStatus::READY, indexed.getExplorerIndexesStatus());
+}
+
+TEST_F(DatabaseBlockchainCacheTests, CachesAreRestoredFromSnapshot) {
+  auto snapshotPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("dbcache_%%%%%%%%%%%%.bin");
+  {
+    DatabaseBlockchainCache saved(currency, database, blockchainCacheFactory, logger, false, snapshotPath.string());
+    ASSERT_TRUE(saved.hasBlock(generatedBlockHashes.back()));
+    ASSERT_FALSE(saved.checkIfSpent(Crypto::rand<KeyImage>()));
+    saved.save();
+  }
+
+  DatabaseBlockchainCache loaded(currency, database, blockchainCacheFactory, logger, false, snapshotPath.string());
+  loaded.load();
+  boost::filesystem::remove(snapshotPath);
+
+  auto timestamps = blockchain.getLastTimestamps(count);
+  auto blocksSizes = blockchain.getLastBlocksSizes(count);
+
+  size_t readCount = database.readCount;
+  ASSERT_EQ(timestamps, loaded.getLastTimestamps(count));
+  ASSERT_EQ(blocksSizes, loaded.getLastBlocksSizes(count));
+  ASSERT_FALSE(loaded.hasBlock(randomBlockHash()));
+  ASSERT_FALSE(loaded.checkIfSpent(Crypto::rand<KeyImage>(), loaded.getTopBlockIndex()));
+  ASSERT_EQ(readCount, database.readCount);
+}
+
+TEST_F(DatabaseBlockchainCacheTests, SnapshotOfAnotherTopBlockIsIgnored) {
+  auto snapshotPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("dbcache_%%%%%%%%%%%%.bin");
+  DatabaseBlockchainCache saved(currency, database, blockchainCacheFactory, logger, false, snapshotPath.string());
+  saved.save();
+
+  generator.generateEmptyBlocks(1);
+  const auto& block = generator.getBlockchain().back();
+  CachedBlock cached{block};
+  TransactionValidatorState state;
+  blockchain.pushBlock(cached, {}, state, 0, 0, 0, { toBinaryArray(block), {} });
+
+  DatabaseBlockchainCache loaded(currency, database, blockchainCacheFactory, logger, false, snapshotPath.string());
+  loaded.load();
+  boost::filesystem::remove(snapshotPath);
+
+  ASSERT_EQ(blockchain.getTopBlockIndex(), loaded.getTopBlockIndex());
+  ASSERT_TRUE(loaded.hasBlock(cached.getBlockHash()));
+  ASSERT_EQ(blockchain.getLastTimestamps(count), loaded.getLastTimestamps(count));
+}
+
 TEST_F(DatabaseBlockchainCacheTests, RawBlocksWereInserted) {
   ASSERT_EQ(generatedBlockHashes.size() + 1, database.blocks().size());
   uint32_t i = static_cast<uint32_t>(count);
@@ -0,0 +1,241 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <System/ContextGroup.h>
+#include <System/Dispatcher.h>
+#include <System/Event.h>
+#include <System/RemoteContext.h>
+#include <System/Timer.h>
+
+#include "Logging/ConsoleLogger.h"
+#include "Rpc/BinaryRpcClient.h"
+#include "Rpc/BinaryRpcProtocol.h"
+#include "Rpc/HttpClient.h"
+#include "Rpc/HttpServer.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+const uint16_t TEST_PORT = 16668;
+const uint16_t TEST_BINARY_PORT = 16669;
+const size_t CLIENT_COUNT = 50;
+const size_t REQUESTS_PER_CLIENT = 100;
+
+class EchoHttpServer : public HttpServer {
+public:
+  EchoHttpServer(System::Dispatcher& dispatcher, Logging::ILogger& log) :
+    HttpServer(dispatcher, log), dispatcherThread(std::this_thread::get_id()), requestCount(0), foreignThreadCount(0) {
+  }
+
+  virtual void processRequest(const HttpRequest& request, HttpResponse& response) override {
+    if (request.getUrl() == "/slow") {
+      System::Timer(m_dispatcher).sleep(std::chrono::milliseconds(100));
+    } else if (request.getUrl() == "/notify") {
+      notifyBinaryConnections(BINARY_RPC_NOTIFY_POOL_CHANGED, request.getBody());
+    } else if (request.getUrl() != "/echo") {
+      response.setStatus(HttpResponse::STATUS_404);
+      return;
+    }
+
+    invokeInDispatcher([this] {
+      if (std::this_thread::get_id() != dispatcherThread) {
+        ++foreignThreadCount;
+      }
+
+      ++requestCount;
+    });
+
+    response.setBody(request.getBody());
+  }
+
+  const std::thread::id dispatcherThread;
+  size_t requestCount;
+  size_t foreignThreadCount;
+};
+
+class HttpServerTests : public ::testing::Test {
+public:
+  HttpServerTests() : logger(Logging::ERROR) {
+  }
+
+  // clients run in their own thread, so that the server dispatcher works meanwhile
+  size_t runClients() {
+    return System::RemoteContext<size_t>(dispatcher, [] {
+      System::Dispatcher clientDispatcher;
+      System::ContextGroup clients(clientDispatcher);
+      size_t echoed = 0;
+      for (size_t i = 0; i < CLIENT_COUNT; ++i) {
+        clients.spawn([&clientDispatcher, &echoed, i] {
+          HttpClient client(clientDispatcher, "127.0.0.1", TEST_PORT);
+          for (size_t j = 0; j < REQUESTS_PER_CLIENT; ++j) {
+            HttpRequest request;
+            HttpResponse response;
+            request.setUrl("/echo");
+            request.setBody(std::to_string(i) + ":" + std::to_string(j));
+            client.request(request, response);
+            if (response.getBody() == request.getBody()) {
+              ++echoed;
+            }
+          }
+        });
+      }
+
+      clients.wait();
+      return echoed;
+    }).get();
+  }
+
+  void testRequests(size_t ioThreadCount) {
+    EchoHttpServer server(dispatcher, logger);
+    server.start("127.0.0.1", TEST_PORT, ioThreadCount);
+
+    auto begin = std::chrono::steady_clock::now();
+    size_t echoed = runClients();
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    server.stop();
+
+    ASSERT_EQ(CLIENT_COUNT * REQUESTS_PER_CLIENT, echoed);
+    ASSERT_EQ(CLIENT_COUNT * REQUESTS_PER_CLIENT, server.requestCount);
+    ASSERT_EQ(0, server.foreignThreadCount);
+    std::cout << CLIENT_COUNT << " clients, " << ioThreadCount << " I/O threads: " << static_cast<size_t>(echoed / seconds) <<
+      " requests per second" << std::endl;
+  }
+
+  Logging::ConsoleLogger logger;
+  System::Dispatcher dispatcher;
+};
+
+}
+
+TEST_F(HttpServerTests, requestsAreProcessedInDispatcher) {
+  testRequests(0);
+}
+
+TEST_F(HttpServerTests, requestsAreProcessedInDispatcherWithIoThreads) {
+  testRequests(4);
+}
+
+TEST_F(HttpServerTests, startFailsIfPortIsBusy) {
+  EchoHttpServer server(dispatcher, logger);
+  server.start("127.0.0.1", TEST_PORT);
+
+  EchoHttpServer other(dispatcher, logger);
+  ASSERT_ANY_THROW(other.start("127.0.0.1", TEST_PORT, 2));
+  server.stop();
+}
+
+TEST_F(HttpServerTests, binaryRequestsOfManyContextsShareConnection) {
+  EchoHttpServer server(dispatcher, logger);
+  server.startBinary("127.0.0.1", TEST_BINARY_PORT);
+
+  size_t echoed = System::RemoteContext<size_t>(dispatcher, [] {
+    System::Dispatcher clientDispatcher;
+    System::ContextGroup clients(clientDispatcher);
+    BinaryRpcClient client(clientDispatcher, "127.0.0.1", TEST_BINARY_PORT);
+    size_t echoed = 0;
+    for (size_t i = 0; i < CLIENT_COUNT; ++i) {
+      clients.spawn([&client, &echoed, i] {
+        for (size_t j = 0; j < REQUESTS_PER_CLIENT; ++j) {
+          HttpRequest request;
+          HttpResponse response;
+          request.setUrl("/echo");
+          request.setBody(std::to_string(i) + ":" + std::to_string(j));
+          client.request(request, response);
+          if (response.getStatus() == HttpResponse::STATUS_200 && response.getBody() == request.getBody()) {
+            ++echoed;
+          }
+        }
+      });
+    }
+
+    clients.wait();
+    return echoed;
+  }).get();
+
+  server.stop();
+  ASSERT_EQ(CLIENT_COUNT * REQUESTS_PER_CLIENT, echoed);
+  ASSERT_EQ(CLIENT_COUNT * REQUESTS_PER_CLIENT, server.requestCount);
+}
+
+TEST_F(HttpServerTests, binaryResponsesDontWaitForSlowRequests) {
+  EchoHttpServer server(dispatcher, logger);
+  server.startBinary("127.0.0.1", TEST_BINARY_PORT);
+
+  std::vector<std::string> completed = System::RemoteContext<std::vector<std::string>>(dispatcher, [] {
+    System::Dispatcher clientDispatcher;
+    System::ContextGroup clients(clientDispatcher);
+    BinaryRpcClient client(clientDispatcher, "127.0.0.1", TEST_BINARY_PORT);
+    std::vector<std::string> completed;
+    for (auto url : { "/slow", "/echo", "/unknown" }) {
+      clients.spawn([&client, &completed, url] {
+        HttpRequest request;
+        HttpResponse response;
+        request.setUrl(url);
+        client.request(request, response);
+        completed.push_back(url + std::string(response.getStatus() == HttpResponse::STATUS_200 ? "" : " failed"));
+      });
+    }
+
+    clients.wait();
+    return completed;
+  }).get();
+
+  server.stop();
+  ASSERT_EQ(std::vector<std::string>({ "/echo", "/unknown failed", "/slow" }), completed);
+}
+
+TEST_F(HttpServerTests, binaryConnectionsReceiveNotifications) {
+  EchoHttpServer server(dispatcher, logger);
+  server.startBinary("127.0.0.1", TEST_BINARY_PORT);
+
+  std::string notification = System::RemoteContext<std::string>(dispatcher, [] {
+    System::Dispatcher clientDispatcher;
+    System::Event notified(clientDispatcher);
+    std::string notification;
+    BinaryRpcClient client(clientDispatcher, "127.0.0.1", TEST_BINARY_PORT, [&](const std::string& url, const std::string& body) {
+      notification = url + " " + body;
+      notified.set();
+    });
+
+    HttpRequest request;
+    HttpResponse response;
+    request.setUrl("/notify");
+    request.setBody("42");
+    client.request(request, response);
+    notified.wait();
+    return notification;
+  }).get();
+
+  server.stop();
+  ASSERT_EQ(std::string(BINARY_RPC_NOTIFY_POOL_CHANGED) + " 42", notification);
+}
+
+TEST_F(HttpServerTests, binaryRequestThrowsConnectExceptionWithoutServer) {
+  BinaryRpcClient client(dispatcher, "127.0.0.1", TEST_BINARY_PORT);
+  HttpRequest request;
+  HttpResponse response;
+  request.setUrl("/echo");
+  ASSERT_THROW(client.request(request, response), ConnectException);
+  ASSERT_FALSE(client.isConnected());
+}
@@ -0,0 +1,174 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Common/Metrics.h"
+
+using namespace Common;
+
+namespace {
+
+void checkBucket(uint64_t value) {
+  size_t index = MetricHistogram::getBucketIndex(value);
+  ASSERT_LT(index, MetricHistogram::BUCKET_COUNT);
+  ASSERT_GE(MetricHistogram::getBucketUpperBound(index), value);
+  if (index > 0) {
+    ASSERT_LT(MetricHistogram::getBucketUpperBound(index - 1), value);
+  }
+
+  // upper bound of a bucket is less than 12.5% above any of its values
+  ASSERT_LE(MetricHistogram::getBucketUpperBound(index) - value, value / 8);
+}
+
+}
+
+TEST(MetricsTests, bucketsContainTheirValues) {
+  for (uint64_t value = 0; value < 100000; ++value) {
+    checkBucket(value);
+  }
+
+  for (unsigned shift = 17; shift < 40; ++shift) {
+    uint64_t power = UINT64_C(1) << shift;
+    checkBucket(power - 1);
+    checkBucket(power);
+    checkBucket(power + 1);
+    checkBucket(power + power / 3);
+  }
+
+  checkBucket(MetricHistogram::MAX_VALUE);
+
+  ASSERT_EQ(MetricHistogram::BUCKET_COUNT - 1, MetricHistogram::getBucketIndex(MetricHistogram::MAX_VALUE));
+  ASSERT_EQ(MetricHistogram::BUCKET_COUNT - 1, MetricHistogram::getBucketIndex(UINT64_MAX));
+  ASSERT_EQ(MetricHistogram::MAX_VALUE, MetricHistogram::getBucketUpperBound(MetricHistogram::BUCKET_COUNT - 1));
+}
+
+TEST(MetricsTests, histogramReportsPercentiles) {
+  MetricsRegistry registry;
+  registry.enable();
+  MetricHistogram& histogram = registry.histogram("test_duration", "Test");
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram.record(value);
+  }
+
+  MetricHistogram::Snapshot snapshot = histogram.getSnapshot();
+  ASSERT_EQ(1000, snapshot.count);
+  ASSERT_EQ(500500, snapshot.sum);
+  ASSERT_EQ(1, snapshot.getPercentile(0));
+  ASSERT_GE(snapshot.getPercentile(50), 500);
+  ASSERT_LE(snapshot.getPercentile(50), 500 + 500 / 8);
+  ASSERT_GE(snapshot.getPercentile(99), 990);
+  ASSERT_LE(snapshot.getPercentile(99), 990 + 990 / 8);
+  ASSERT_EQ(1024, snapshot.getPercentile(100));
+}
+
+TEST(MetricsTests, disabledRegistryIgnoresUpdates) {
+  MetricsRegistry registry;
+  MetricCounter& counter = registry.counter("test_total", "Test");
+  MetricGauge& gauge = registry.gauge("test_size", "Test");
+  MetricHistogram& histogram = registry.histogram("test_duration", "Test");
+  counter.increment();
+  gauge.set(10);
+  histogram.record(10);
+  {
+    MetricTimer timer(histogram);
+  }
+
+  ASSERT_EQ(0, counter.getValue());
+  ASSERT_EQ(0, gauge.getValue());
+  ASSERT_EQ(0, histogram.getSnapshot().count);
+
+  registry.enable();
+  counter.increment();
+  gauge.add(10);
+  {
+    MetricTimer timer(histogram);
+    MetricTimer nullTimer(nullptr);
+  }
+
+  ASSERT_EQ(1, counter.getValue());
+  ASSERT_EQ(10, gauge.getValue());
+  ASSERT_EQ(1, histogram.getSnapshot().count);
+}
+
+TEST(MetricsTests, updatesFromManyThreadsAreCounted) {
+  const size_t THREAD_COUNT = 8;
+  const size_t UPDATES_PER_THREAD = 100000;
+
+  MetricsRegistry registry;
+  registry.enable();
+  MetricCounter& counter = registry.counter("test_total", "Test");
+  MetricHistogram& histogram = registry.histogram("test_duration", "Test");
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    threads.emplace_back([&counter, &histogram, i] {
+      for (size_t j = 0; j < UPDATES_PER_THREAD; ++j) {
+        counter.increment(2);
+        histogram.record(i);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(2 * THREAD_COUNT * UPDATES_PER_THREAD, counter.getValue());
+  MetricHistogram::Snapshot snapshot = histogram.getSnapshot();
+  ASSERT_EQ(THREAD_COUNT * UPDATES_PER_THREAD, snapshot.count);
+  ASSERT_EQ(THREAD_COUNT * (THREAD_COUNT - 1) / 2 * UPDATES_PER_THREAD, snapshot.sum);
+}
+
+TEST(MetricsTests, registryReturnsSameMetricForSameLabels) {
+  MetricsRegistry registry;
+  ASSERT_EQ(&registry.counter("test_total", "Test", "url=\"/a\""), &registry.counter("test_total", "Test", "url=\"/a\""));
+  ASSERT_NE(&registry.counter("test_total", "Test", "url=\"/a\""), &registry.counter("test_total", "Test", "url=\"/b\""));
+  ASSERT_THROW(registry.gauge("test_total", "Test"), std::runtime_error);
+}
+
+TEST(MetricsTests, prometheusTextContainsAllMetrics) {
+  MetricsRegistry registry;
+  registry.enable();
+  registry.counter("test_requests_total", "Requests", "url=\"/a\"").increment(3);
+  registry.gauge("test_queue_size", "Queue size").set(-2);
+  MetricHistogram& histogram = registry.histogram("test_duration_microseconds", "Duration");
+  histogram.record(0);
+  histogram.record(3);
+  histogram.record(4);
+  histogram.record(5);
+
+  ASSERT_EQ(
+    "# HELP test_duration_microseconds Duration\n"
+    "# TYPE test_duration_microseconds histogram\n"
+    "test_duration_microseconds_bucket{le=\"1\"} 1\n"
+    "test_duration_microseconds_bucket{le=\"2\"} 1\n"
+    "test_duration_microseconds_bucket{le=\"4\"} 3\n"
+    "test_duration_microseconds_bucket{le=\"8\"} 4\n"
+    "test_duration_microseconds_bucket{le=\"+Inf\"} 4\n"
+    "test_duration_microseconds_sum 12\n"
+    "test_duration_microseconds_count 4\n"
+    "# HELP test_queue_size Queue size\n"
+    "# TYPE test_queue_size gauge\n"
+    "test_queue_size -2\n"
+    "# HELP test_requests_total Requests\n"
+    "# TYPE test_requests_total counter\n"
+    "test_requests_total{url=\"/a\"} 3\n", registry.toPrometheusText());
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include "NodeRpcProxy/NodeRpcProxy.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+BlockDetails makeBlock(uint32_t index, bool isAlternative) {
+  BlockDetails block;
+  block.index = index;
+  block.isAlternative = isAlternative;
+  block.hash = Crypto::rand<Crypto::Hash>();
+  return block;
+}
+
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, empty) {
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_TRUE(splitBlocksByHeights({}, {}, blocksByHeights));
+  ASSERT_TRUE(blocksByHeights.empty());
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, groupsAlternativesWithMainBlock) {
+  std::vector<BlockDetails> blocks = { makeBlock(5, false), makeBlock(5, true), makeBlock(5, true), makeBlock(2, false), makeBlock(7, false) };
+  std::vector<BlockDetails> expected = blocks;
+
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_TRUE(splitBlocksByHeights({ 5, 2, 7 }, std::move(blocks), blocksByHeights));
+  ASSERT_EQ(3, blocksByHeights.size());
+  ASSERT_EQ(3, blocksByHeights[0].size());
+  ASSERT_EQ(expected[0].hash, blocksByHeights[0][0].hash);
+  ASSERT_EQ(expected[2].hash, blocksByHeights[0][2].hash);
+  ASSERT_EQ(1, blocksByHeights[1].size());
+  ASSERT_EQ(expected[3].hash, blocksByHeights[1][0].hash);
+  ASSERT_EQ(1, blocksByHeights[2].size());
+  ASSERT_EQ(expected[4].hash, blocksByHeights[2][0].hash);
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, duplicateHeights) {
+  std::vector<BlockDetails> blocks = { makeBlock(3, false), makeBlock(3, true), makeBlock(3, false), makeBlock(3, true) };
+
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_TRUE(splitBlocksByHeights({ 3, 3 }, std::move(blocks), blocksByHeights));
+  ASSERT_EQ(2, blocksByHeights.size());
+  ASSERT_EQ(2, blocksByHeights[0].size());
+  ASSERT_EQ(2, blocksByHeights[1].size());
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, missingHeightFails) {
+  std::vector<BlockDetails> blocks = { makeBlock(1, false) };
+
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_FALSE(splitBlocksByHeights({ 1, 2 }, std::move(blocks), blocksByHeights));
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, alternativeWithoutMainBlockFails) {
+  std::vector<BlockDetails> blocks = { makeBlock(1, true) };
+
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_FALSE(splitBlocksByHeights({ 1 }, std::move(blocks), blocksByHeights));
+}
+
+TEST(NodeRpcProxySplitBlocksByHeights, extraBlocksFail) {
+  std::vector<BlockDetails> blocks = { makeBlock(1, false), makeBlock(2, false) };
+
+  std::vector<std::vector<BlockDetails>> blocksByHeights;
+  ASSERT_FALSE(splitBlocksByHeights({ 1 }, std::move(blocks), blocksByHeights));
+}
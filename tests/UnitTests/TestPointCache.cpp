@@ -0,0 +1,118 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "crypto/crypto.h"
+
+using namespace Crypto;
+
+class PointCacheTests : public ::testing::Test {
+public:
+  void SetUp() override {
+    ring.resize(RING_SIZE);
+    for (size_t i = 0; i < RING_SIZE; ++i) {
+      SecretKey secretKey;
+      generate_keys(ring[i], secretKey);
+      if (i == REAL_INDEX) {
+        realSecretKey = secretKey;
+      }
+
+      ringPointers.push_back(&ring[i]);
+    }
+
+    prefixHash = rand<Hash>();
+    generate_key_image(ring[REAL_INDEX], realSecretKey, keyImage);
+    signatures.resize(RING_SIZE);
+    generate_ring_signature(prefixHash, keyImage, ringPointers, realSecretKey, REAL_INDEX, signatures.data());
+  }
+
+  void TearDown() override {
+    set_point_cache_capacity(0);
+  }
+
+  static const size_t RING_SIZE = 4;
+  static const size_t REAL_INDEX = 1;
+
+  std::vector<PublicKey> ring;
+  std::vector<const PublicKey*> ringPointers;
+  SecretKey realSecretKey;
+  KeyImage keyImage;
+  Hash prefixHash;
+  std::vector<Signature> signatures;
+};
+
+TEST_F(PointCacheTests, disabledByDefault) {
+  auto before = get_point_cache_stats();
+  ASSERT_TRUE(check_ring_signature(prefixHash, keyImage, ringPointers, signatures.data()));
+  auto after = get_point_cache_stats();
+
+  ASSERT_EQ(before.hits, after.hits);
+  ASSERT_EQ(before.misses, after.misses);
+  ASSERT_EQ(0, after.size);
+}
+
+TEST_F(PointCacheTests, repeatedCheckHitsCache) {
+  set_point_cache_capacity(1024);
+
+  auto before = get_point_cache_stats();
+  ASSERT_TRUE(check_ring_signature(prefixHash, keyImage, ringPointers, signatures.data()));
+  auto afterFirst = get_point_cache_stats();
+  ASSERT_EQ(RING_SIZE + 1, afterFirst.misses - before.misses);
+  ASSERT_EQ(RING_SIZE + 1, afterFirst.size);
+
+  ASSERT_TRUE(check_ring_signature(prefixHash, keyImage, ringPointers, signatures.data()));
+  auto afterSecond = get_point_cache_stats();
+  ASSERT_EQ(RING_SIZE + 1, afterSecond.hits - afterFirst.hits);
+  ASSERT_EQ(afterFirst.misses, afterSecond.misses);
+}
+
+TEST_F(PointCacheTests, cachedPointsDontHideBadSignature) {
+  set_point_cache_capacity(1024);
+  ASSERT_TRUE(check_ring_signature(prefixHash, keyImage, ringPointers, signatures.data()));
+
+  Hash otherPrefixHash = rand<Hash>();
+  ASSERT_FALSE(check_ring_signature(otherPrefixHash, keyImage, ringPointers, signatures.data()));
+}
+
+TEST_F(PointCacheTests, sizeIsBounded) {
+  const size_t capacity = 16;
+  set_point_cache_capacity(capacity);
+
+  for (size_t i = 0; i < 10 * capacity; ++i) {
+    PublicKey publicKey;
+    SecretKey secretKey;
+    generate_keys(publicKey, secretKey);
+    ASSERT_TRUE(check_key(publicKey));
+
+    KeyDerivation derivation;
+    ASSERT_TRUE(generate_key_derivation(publicKey, realSecretKey, derivation));
+  }
+
+  ASSERT_LE(get_point_cache_stats().size, capacity);
+}
+
+TEST_F(PointCacheTests, changingCapacityEmptiesCache) {
+  set_point_cache_capacity(1024);
+  ASSERT_TRUE(check_ring_signature(prefixHash, keyImage, ringPointers, signatures.data()));
+  ASSERT_NE(0, get_point_cache_stats().size);
+
+  set_point_cache_capacity(2048);
+  ASSERT_EQ(0, get_point_cache_stats().size);
+}
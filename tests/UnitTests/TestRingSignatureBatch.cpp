@@ -0,0 +1,119 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "crypto/crypto.h"
+
+using namespace Crypto;
+
+namespace {
+
+struct RingSignature {
+  Hash prefixHash;
+  KeyImage keyImage;
+  std::vector<PublicKey> ring;
+  std::vector<const PublicKey*> ringPointers;
+  std::vector<Signature> signatures;
+
+  explicit RingSignature(size_t ringSize) : ring(ringSize), signatures(ringSize) {
+    size_t realIndex = ringSize / 2;
+    SecretKey realSecretKey;
+    for (size_t i = 0; i < ringSize; ++i) {
+      SecretKey secretKey;
+      generate_keys(ring[i], secretKey);
+      if (i == realIndex) {
+        realSecretKey = secretKey;
+      }
+    }
+
+    for (auto& key : ring) {
+      ringPointers.push_back(&key);
+    }
+
+    prefixHash = rand<Hash>();
+    generate_key_image(ring[realIndex], realSecretKey, keyImage);
+    generate_ring_signature(prefixHash, keyImage, ringPointers, realSecretKey, realIndex, signatures.data());
+  }
+
+  ring_signature_check check() const {
+    return { &prefixHash, &keyImage, ringPointers.data(), ringPointers.size(), signatures.data() };
+  }
+};
+
+class RingSignatureBatchTests : public ::testing::Test {
+public:
+  std::vector<bool> checkBatch(const std::vector<RingSignature>& signatures) {
+    std::vector<ring_signature_check> checks;
+    for (auto& signature : signatures) {
+      checks.push_back(signature.check());
+    }
+
+    std::unique_ptr<bool[]> results(new bool[checks.size()]);
+    check_ring_signatures(checks.data(), checks.size(), results.get());
+    return std::vector<bool>(results.get(), results.get() + checks.size());
+  }
+
+  void assertMatchesSingleChecks(const std::vector<RingSignature>& signatures, const std::vector<bool>& results) {
+    ASSERT_EQ(signatures.size(), results.size());
+    for (size_t i = 0; i < signatures.size(); ++i) {
+      auto& signature = signatures[i];
+      ASSERT_EQ(check_ring_signature(signature.prefixHash, signature.keyImage, signature.ringPointers, signature.signatures.data()), results[i]) << "signature " << i;
+    }
+  }
+};
+
+}
+
+TEST_F(RingSignatureBatchTests, emptyBatch) {
+  ASSERT_TRUE(checkBatch({}).empty());
+}
+
+TEST_F(RingSignatureBatchTests, validSignaturesPass) {
+  std::vector<RingSignature> signatures;
+  for (size_t ringSize : {1, 2, 3, 10}) {
+    signatures.emplace_back(ringSize);
+  }
+
+  auto results = checkBatch(signatures);
+  ASSERT_EQ(std::vector<bool>(signatures.size(), true), results);
+  assertMatchesSingleChecks(signatures, results);
+}
+
+TEST_F(RingSignatureBatchTests, invalidSignaturesFailWithoutAffectingOthers) {
+  std::vector<RingSignature> signatures;
+  for (size_t i = 0; i < 6; ++i) {
+    signatures.emplace_back(3);
+  }
+
+  signatures[1].prefixHash = rand<Hash>();
+  std::memset(&signatures[2].signatures[0], 0xff, sizeof(EllipticCurveScalar));
+  std::swap(signatures[3].signatures[0], signatures[3].signatures[1]);
+
+  PublicKey notAPoint;
+  do {
+    notAPoint = rand<PublicKey>();
+  } while (check_key(notAPoint));
+  std::memcpy(&signatures[4].keyImage, &notAPoint, sizeof(KeyImage));
+
+  auto results = checkBatch(signatures);
+  ASSERT_EQ(std::vector<bool>({true, false, false, false, false, true}), results);
+  assertMatchesSingleChecks(signatures, results);
+}
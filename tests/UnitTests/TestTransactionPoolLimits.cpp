@@ -0,0 +1,201 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+#include "gtest/gtest.h"
+
+#include "CryptoNoteConfig.h"
+#include "CryptoNoteCore/CryptoNoteBasic.h"
+#include "CryptoNoteCore/TransactionPool.h"
+#include "CryptoNoteCore/TransactionValidatiorState.h"
+#include "Logging/ConsoleLogger.h"
+
+using namespace CryptoNote;
+
+namespace {
+
+const uint64_t OUTPUT_AMOUNT = 1000000;
+
+class TransactionPoolLimitsTest : public ::testing::Test {
+public:
+  TransactionPoolLimitsTest() : logger(Logging::ERROR) {
+  }
+
+  CachedTransaction createTransaction(uint64_t fee, size_t extraSize = 0) {
+    Transaction transaction;
+    transaction.version = CURRENT_TRANSACTION_VERSION;
+    transaction.unlockTime = 0;
+
+    KeyInput input;
+    input.amount = OUTPUT_AMOUNT + fee;
+    input.outputIndexes.push_back(0);
+    input.keyImage = Crypto::rand<Crypto::KeyImage>();
+    transaction.inputs.push_back(input);
+
+    KeyOutput target;
+    target.key = Crypto::rand<Crypto::PublicKey>();
+    TransactionOutput output;
+    output.amount = OUTPUT_AMOUNT;
+    output.target = target;
+    transaction.outputs.push_back(output);
+
+    transaction.extra.resize(extraSize);
+    transaction.signatures.push_back({Crypto::rand<Crypto::Signature>()});
+    return CachedTransaction(std::move(transaction));
+  }
+
+  bool push(TransactionPool& pool, const CachedTransaction& transaction) {
+    TransactionValidatorState state;
+    state.spentKeyImages.insert(boost::get<KeyInput>(transaction.getTransaction().inputs[0]).keyImage);
+    return pool.pushTransaction(CachedTransaction(transaction), std::move(state));
+  }
+
+protected:
+  Logging::ConsoleLogger logger;
+};
+
+}
+
+TEST_F(TransactionPoolLimitsTest, lowestFeeTransactionIsEvictedWhenCountLimitIsReached) {
+  TransactionPool pool(logger, 3);
+  auto transaction1 = createTransaction(10);
+  auto transaction2 = createTransaction(20);
+  auto transaction3 = createTransaction(30);
+  auto transaction4 = createTransaction(40);
+
+  ASSERT_TRUE(push(pool, transaction2));
+  ASSERT_TRUE(push(pool, transaction1));
+  ASSERT_TRUE(push(pool, transaction3));
+  ASSERT_TRUE(pool.takeEvictedTransactions().empty());
+
+  ASSERT_TRUE(push(pool, transaction4));
+  ASSERT_EQ(3, pool.getTransactionCount());
+  ASSERT_FALSE(pool.checkIfTransactionPresent(transaction1.getTransactionHash()));
+  ASSERT_EQ(std::vector<Crypto::Hash>{transaction1.getTransactionHash()}, pool.takeEvictedTransactions());
+  ASSERT_TRUE(pool.takeEvictedTransactions().empty());
+  ASSERT_EQ(1, pool.getEvictedTransactionCount());
+}
+
+TEST_F(TransactionPoolLimitsTest, transactionWithLowestFeeIsRejectedWhenPoolIsFull) {
+  TransactionPool pool(logger, 2);
+  auto transaction1 = createTransaction(20);
+  auto transaction2 = createTransaction(30);
+  auto transaction3 = createTransaction(10);
+
+  ASSERT_TRUE(push(pool, transaction1));
+  ASSERT_TRUE(push(pool, transaction2));
+  ASSERT_FALSE(push(pool, transaction3));
+
+  ASSERT_FALSE(pool.checkIfTransactionPresent(transaction3.getTransactionHash()));
+  ASSERT_EQ(2, pool.getTransactionCount());
+  ASSERT_TRUE(pool.takeEvictedTransactions().empty());
+  ASSERT_EQ(0, pool.getEvictedTransactionCount());
+
+  // Key image of the rejected transaction is not kept in the pool state
+  ASSERT_EQ(2, pool.getPoolTransactionValidationState().spentKeyImages.size());
+}
+
+TEST_F(TransactionPoolLimitsTest, feePerByteDecidesWhatIsEvictedBySizeLimit) {
+  auto small = createTransaction(100);
+  auto big = createTransaction(150, 1000);
+  auto medium = createTransaction(120, 100);
+  uint64_t maxSize = small.getTransactionBinaryArray().size() + big.getTransactionBinaryArray().size();
+  TransactionPool pool(logger, std::numeric_limits<size_t>::max(), maxSize);
+
+  ASSERT_TRUE(push(pool, small));
+  ASSERT_TRUE(push(pool, big));
+  ASSERT_EQ(maxSize, pool.getTransactionsSize());
+
+  ASSERT_TRUE(push(pool, medium));
+  ASSERT_EQ(std::vector<Crypto::Hash>{big.getTransactionHash()}, pool.takeEvictedTransactions());
+  ASSERT_EQ(small.getTransactionBinaryArray().size() + medium.getTransactionBinaryArray().size(), pool.getTransactionsSize());
+}
+
+TEST_F(TransactionPoolLimitsTest, removeTransactionUpdatesSize) {
+  TransactionPool pool(logger);
+  auto transaction1 = createTransaction(10);
+  auto transaction2 = createTransaction(20, 50);
+
+  ASSERT_TRUE(push(pool, transaction1));
+  ASSERT_TRUE(push(pool, transaction2));
+  ASSERT_TRUE(pool.removeTransaction(transaction1.getTransactionHash()));
+  ASSERT_EQ(transaction2.getTransactionBinaryArray().size(), pool.getTransactionsSize());
+  ASSERT_TRUE(pool.removeTransaction(transaction2.getTransactionHash()));
+  ASSERT_EQ(0, pool.getTransactionsSize());
+}
+
+TEST_F(TransactionPoolLimitsTest, generationChangesOnlyWithPoolContents) {
+  TransactionPool pool(logger);
+  auto transaction = createTransaction(10);
+
+  uint64_t generation = pool.getGeneration();
+  ASSERT_TRUE(push(pool, transaction));
+  ASSERT_NE(generation, pool.getGeneration());
+
+  generation = pool.getGeneration();
+  ASSERT_FALSE(push(pool, transaction));
+  ASSERT_FALSE(pool.removeTransaction(createTransaction(20).getTransactionHash()));
+  ASSERT_EQ(generation, pool.getGeneration());
+
+  ASSERT_TRUE(pool.removeTransaction(transaction.getTransactionHash()));
+  ASSERT_NE(generation, pool.getGeneration());
+}
+
+TEST_F(TransactionPoolLimitsTest, getChangesSinceReturnsNetChanges) {
+  TransactionPool pool(logger);
+  auto kept = createTransaction(10);
+  auto removed = createTransaction(20);
+  auto transient = createTransaction(30);
+  auto added = createTransaction(40);
+
+  ASSERT_TRUE(push(pool, kept));
+  ASSERT_TRUE(push(pool, removed));
+  uint64_t generation = pool.getGeneration();
+
+  ASSERT_TRUE(pool.removeTransaction(removed.getTransactionHash()));
+  ASSERT_TRUE(push(pool, transient));
+  ASSERT_TRUE(push(pool, added));
+  ASSERT_TRUE(pool.removeTransaction(transient.getTransactionHash()));
+
+  std::vector<Crypto::Hash> addedTransactions;
+  std::vector<Crypto::Hash> removedTransactions;
+  ASSERT_TRUE(pool.getChangesSince(generation, addedTransactions, removedTransactions));
+  ASSERT_EQ(std::vector<Crypto::Hash>{added.getTransactionHash()}, addedTransactions);
+  ASSERT_EQ(std::vector<Crypto::Hash>{removed.getTransactionHash()}, removedTransactions);
+
+  addedTransactions.clear();
+  removedTransactions.clear();
+  ASSERT_TRUE(pool.getChangesSince(pool.getGeneration(), addedTransactions, removedTransactions));
+  ASSERT_TRUE(addedTransactions.empty());
+  ASSERT_TRUE(removedTransactions.empty());
+}
+
+TEST_F(TransactionPoolLimitsTest, getChangesSinceFailsForUnknownGeneration) {
+  TransactionPool pool(logger);
+  uint64_t generation = pool.getGeneration();
+  for (size_t i = 0; i <= parameters::CRYPTONOTE_MEMPOOL_CHANGE_LOG_SIZE; ++i) {
+    auto transaction = createTransaction(10);
+    ASSERT_TRUE(push(pool, transaction));
+    ASSERT_TRUE(pool.removeTransaction(transaction.getTransactionHash()));
+  }
+
+  std::vector<Crypto::Hash> addedTransactions;
+  std::vector<Crypto::Hash> removedTransactions;
+  ASSERT_FALSE(pool.getChangesSince(generation, addedTransactions, removedTransactions));
+  ASSERT_FALSE(pool.getChangesSince(pool.getGeneration() + 1, addedTransactions, removedTransactions));
+  ASSERT_TRUE(pool.getChangesSince(pool.getGeneration() - 2, addedTransactions, removedTransactions));
+  ASSERT_TRUE(addedTransactions.empty());
+  ASSERT_TRUE(removedTransactions.empty());
+}
@@ -17,6 +17,8 @@
 
 #include "gtest/gtest.h"
 
+#include <sstream>
+
 #include "IWalletLegacy.h"
 
 #include "crypto/crypto.h"
@@ -1001,6 +1003,61 @@ TEST_F(TransfersContainer_balance, filtersByStateAndKeySimultaneously) {
   ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeStateUnlocked | ITransfersContainer::IncludeTypeKey));
 }
 
+TEST_F(TransfersContainer_balance, followsHeightOnAdvanceAndDetach) {
+  TestTransactionBuilder tx1;
+  tx1.setUnlockTime(TEST_BLOCK_HEIGHT + 10 + currency.lockedTxAllowedDeltaBlocks());
+  tx1.addTestInput(AMOUNT_1 + 1);
+  auto outInfo = tx1.addTestKeyOutput(AMOUNT_1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX, account);
+  ASSERT_TRUE(container.addTransaction(blockInfo(TEST_BLOCK_HEIGHT), *tx1.build(), { outInfo }));
+
+  auto tx2 = addTransaction(TEST_BLOCK_HEIGHT + 5, AMOUNT_2);
+
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeStateLocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateSoftLocked | ITransfersContainer::IncludeTypeAll));
+
+  container.advanceHeight(TEST_BLOCK_HEIGHT + 6);
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateUnlocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeStateLocked | ITransfersContainer::IncludeTypeAll));
+
+  container.advanceHeight(TEST_BLOCK_HEIGHT + 10);
+  ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeStateUnlocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(0, container.balance(ITransfersContainer::IncludeAllLocked));
+
+  container.detach(TEST_BLOCK_HEIGHT + 6);
+  ASSERT_EQ(0, container.balance(ITransfersContainer::IncludeStateUnlocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_1, container.balance(ITransfersContainer::IncludeStateLocked | ITransfersContainer::IncludeTypeAll));
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateSoftLocked | ITransfersContainer::IncludeTypeAll));
+}
+
+TEST_F(TransfersContainer_balance, excludesSpentTransfers) {
+  auto tx = addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_1 + AMOUNT_2);
+  container.advanceHeight(TEST_CONTAINER_CURRENT_HEIGHT);
+  ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeAllUnlocked));
+
+  addSpendingTransaction(tx->getTransactionHash(), TEST_CONTAINER_CURRENT_HEIGHT + 1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX + 1, AMOUNT_1);
+  ASSERT_EQ(0, container.balance(ITransfersContainer::IncludeAllUnlocked));
+  ASSERT_EQ(AMOUNT_2, container.balance(ITransfersContainer::IncludeStateSoftLocked | ITransfersContainer::IncludeTypeAll));
+
+  container.detach(TEST_CONTAINER_CURRENT_HEIGHT + 1);
+  ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeAllUnlocked));
+  ASSERT_EQ(AMOUNT_1 + AMOUNT_2, container.balance(ITransfersContainer::IncludeAll));
+}
+
+TEST_F(TransfersContainer_balance, isRestoredOnLoad) {
+  auto tx1 = addTransaction(WALLET_LEGACY_UNCONFIRMED_TRANSACTION_HEIGHT, AMOUNT_1);
+  auto tx2 = addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_2);
+  container.advanceHeight(TEST_CONTAINER_CURRENT_HEIGHT);
+
+  std::stringstream stream;
+  container.save(stream);
+
+  TransfersContainer loaded(currency, logger, TEST_TRANSACTION_SPENDABLE_AGE);
+  loaded.load(stream);
+
+  ASSERT_EQ(AMOUNT_1, loaded.balance(ITransfersContainer::IncludeAllLocked));
+  ASSERT_EQ(AMOUNT_2, loaded.balance(ITransfersContainer::IncludeAllUnlocked));
+}
+
 
 //--------------------------------------------------------------------------- 
 // TransfersContainer_getOutputs
@@ -1131,3 +1188,68 @@ TEST_F(TransfersContainer_getOutputs, filtersByStateAndKeySimultaneously) {
   ASSERT_EQ(AMOUNT_1 + AMOUNT_2, transfers.front().amount);
 }
 
+
+//--------------------------------------------------------------------------- 
+// TransfersContainer_spendableOutputs
+//--------------------------------------------------------------------------- 
+
+class TransfersContainer_spendableOutputs : public TransfersContainerTest {
+public:
+  enum TestAmounts : uint64_t {
+    AMOUNT_1 = 13,
+    AMOUNT_2 = 17
+  };
+};
+
+TEST_F(TransfersContainer_spendableOutputs, countsVisibleKeyOutputsInAmountRange) {
+  addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_1);
+  addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_2);
+  addTransaction(WALLET_LEGACY_UNCONFIRMED_TRANSACTION_HEIGHT, AMOUNT_2);
+
+  ASSERT_EQ(2, container.spendableOutputsCount(0, std::numeric_limits<uint64_t>::max()));
+  ASSERT_EQ(1, container.spendableOutputsCount(0, AMOUNT_1));
+  ASSERT_EQ(1, container.spendableOutputsCount(AMOUNT_1 + 1, AMOUNT_2));
+  ASSERT_EQ(0, container.spendableOutputsCount(AMOUNT_2 + 1, std::numeric_limits<uint64_t>::max()));
+}
+
+TEST_F(TransfersContainer_spendableOutputs, ignoresMultisignatureOutputs) {
+  TestTransactionBuilder tx;
+  tx.addTestInput(AMOUNT_1 + AMOUNT_2 + 1);
+  auto outInfo1 = tx.addTestKeyOutput(AMOUNT_1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX, account);
+  auto outInfo2 = tx.addTestMultisignatureOutput(AMOUNT_2, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX);
+  ASSERT_TRUE(container.addTransaction(blockInfo(TEST_BLOCK_HEIGHT), *tx.build(), { outInfo1, outInfo2 }));
+
+  ASSERT_EQ(1, container.spendableOutputsCount(0, std::numeric_limits<uint64_t>::max()));
+}
+
+TEST_F(TransfersContainer_spendableOutputs, returnsOnlyUnlockedOutputs) {
+  addTransaction(TEST_CONTAINER_CURRENT_HEIGHT - TEST_TRANSACTION_SPENDABLE_AGE, AMOUNT_1);
+  addTransaction(TEST_CONTAINER_CURRENT_HEIGHT, AMOUNT_2);
+
+  TransactionOutputInformation output;
+  ASSERT_TRUE(container.getSpendableOutput(0, AMOUNT_1, 0, output));
+  ASSERT_EQ(AMOUNT_1, output.amount);
+  ASSERT_FALSE(container.getSpendableOutput(AMOUNT_2, AMOUNT_2, 0, output));
+  ASSERT_FALSE(container.getSpendableOutput(0, AMOUNT_1, 1, output));
+
+  container.advanceHeight(TEST_CONTAINER_CURRENT_HEIGHT + TEST_TRANSACTION_SPENDABLE_AGE);
+  ASSERT_TRUE(container.getSpendableOutput(AMOUNT_2, AMOUNT_2, 0, output));
+  ASSERT_EQ(AMOUNT_2, output.amount);
+}
+
+TEST_F(TransfersContainer_spendableOutputs, excludesSpentOutputs) {
+  auto tx = addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_1);
+  ASSERT_EQ(1, container.spendableOutputsCount(0, AMOUNT_1));
+
+  addSpendingTransaction(tx->getTransactionHash(), TEST_BLOCK_HEIGHT + 1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX + 1, AMOUNT_1);
+  ASSERT_EQ(0, container.spendableOutputsCount(0, AMOUNT_1));
+}
+
+TEST_F(TransfersContainer_spendableOutputs, restoresOutputsOnDetach) {
+  auto tx = addTransaction(TEST_BLOCK_HEIGHT, AMOUNT_1);
+  addSpendingTransaction(tx->getTransactionHash(), TEST_BLOCK_HEIGHT + 1, TEST_TRANSACTION_OUTPUT_GLOBAL_INDEX + 1, AMOUNT_1);
+  ASSERT_EQ(0, container.spendableOutputsCount(0, AMOUNT_1));
+
+  container.detach(TEST_BLOCK_HEIGHT + 1);
+  ASSERT_EQ(1, container.spendableOutputsCount(0, AMOUNT_1));
+}
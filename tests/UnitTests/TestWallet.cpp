@@ -2741,6 +2741,110 @@ TEST_F(WalletApi, donationTransactionHaveCorrectFee) {
   wallet.shutdown();
 }
 
+TEST_F(WalletApi, transferWithoutMixinSpendsDustOutputEvenIfNotNeeded) {
+  CatchTransactionNodeStub catchNode(generator);
+  CryptoNote::WalletGreen wallet(dispatcher, currency, catchNode, logger);
+  wallet.initialize(BOB_WALLET_PATH, "pass");
+  wallet.createAddress();
+
+  const uint64_t DUST = currency.defaultDustThreshold();
+
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), SENT + FEE);
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), DUST);
+  unlockMoney(wallet, catchNode);
+  waitForActualBalance(wallet, SENT + FEE + DUST);
+
+  sendMoney(wallet, RANDOM_ADDRESS, SENT, FEE, 0);
+
+  ASSERT_TRUE(catchNode.caught);
+  ASSERT_EQ(2, catchNode.transaction.inputs.size());
+  ASSERT_EQ(SENT + FEE + DUST, getInputAmount(catchNode.transaction));
+
+  wallet.shutdown();
+}
+
+TEST_F(WalletApi, transferWithMixinDoesNotSpendDustOutput) {
+  CatchTransactionNodeStub catchNode(generator);
+  CryptoNote::WalletGreen wallet(dispatcher, currency, catchNode, logger);
+  wallet.initialize(BOB_WALLET_PATH, "pass");
+  wallet.createAddress();
+
+  const uint64_t DUST = currency.defaultDustThreshold();
+
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), SENT + FEE);
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), DUST);
+  unlockMoney(wallet, catchNode);
+  waitForActualBalance(wallet, SENT + FEE + DUST);
+
+  sendMoney(wallet, RANDOM_ADDRESS, SENT, FEE, 2);
+
+  ASSERT_TRUE(catchNode.caught);
+  ASSERT_EQ(1, catchNode.transaction.inputs.size());
+  ASSERT_EQ(SENT + FEE, getInputAmount(catchNode.transaction));
+
+  wallet.shutdown();
+}
+
+TEST_F(WalletApi, transferSelectsOutputsOfAllSourceAddressesOnly) {
+  CatchTransactionNodeStub catchNode(generator);
+  CryptoNote::WalletGreen wallet(dispatcher, currency, catchNode, logger);
+  wallet.initialize(BOB_WALLET_PATH, "pass");
+  std::string first = wallet.createAddress();
+  std::string second = wallet.createAddress();
+  std::string notSource = wallet.createAddress();
+
+  generator.getSingleOutputTransaction(parseAddress(first), SENT);
+  generator.getSingleOutputTransaction(parseAddress(second), SENT);
+  generator.getSingleOutputTransaction(parseAddress(notSource), SENT);
+  unlockMoney(wallet, catchNode);
+  waitForActualBalance(wallet, 3 * SENT);
+
+  // Neither source address has enough money alone
+  sendMoney(wallet, { first, second }, RANDOM_ADDRESS, SENT, FEE, 2);
+
+  ASSERT_TRUE(catchNode.caught);
+  ASSERT_EQ(2, catchNode.transaction.inputs.size());
+  ASSERT_EQ(2 * SENT, getInputAmount(catchNode.transaction));
+  ASSERT_EQ(0, wallet.getActualBalance(first));
+  ASSERT_EQ(0, wallet.getActualBalance(second));
+  ASSERT_EQ(SENT, wallet.getActualBalance(notSource));
+
+  wallet.shutdown();
+}
+
+TEST_F(WalletApi, transferDoesNotCountLockedOutputs) {
+  CatchTransactionNodeStub catchNode(generator);
+  CryptoNote::WalletGreen wallet(dispatcher, currency, catchNode, logger);
+  wallet.initialize(BOB_WALLET_PATH, "pass");
+  wallet.createAddress();
+
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), SENT + FEE);
+  unlockMoney(wallet, catchNode);
+  waitForActualBalance(wallet, SENT + FEE);
+
+  const uint64_t LOCKED = 10 * SENT;
+  generator.getSingleOutputTransaction(parseAddress(wallet.getAddress(0)), LOCKED);
+  catchNode.updateObservers();
+  waitForValue<uint64_t>(wallet, LOCKED, [&wallet] () { return wallet.getPendingBalance(); });
+
+  try {
+    sendMoney(wallet, RANDOM_ADDRESS, 2 * SENT, FEE, 2);
+    ASSERT_FALSE(true);
+  } catch (const std::system_error& e) {
+    ASSERT_EQ(make_error_code(CryptoNote::error::WRONG_AMOUNT), e.code());
+  }
+
+  ASSERT_FALSE(catchNode.caught);
+
+  sendMoney(wallet, RANDOM_ADDRESS, SENT, FEE, 2);
+
+  ASSERT_TRUE(catchNode.caught);
+  ASSERT_EQ(1, catchNode.transaction.inputs.size());
+  ASSERT_EQ(SENT + FEE, getInputAmount(catchNode.transaction));
+
+  wallet.shutdown();
+}
+
 TEST_F(WalletApi, donationSerialization) {
   const uint64_t DONATION_THRESHOLD = 1000000;
 
@@ -21,6 +21,7 @@
 #include <random>
 
 #include "CryptoNoteCore/TransactionApi.h"
+#include "CryptoNoteCore/CachedTransaction.h"
 #include "CryptoNoteCore/CryptoNoteFormatUtils.h" // TODO: delete
 #include "CryptoNoteCore/Account.h"
 #include "crypto/crypto.h"
@@ -249,6 +250,22 @@ TEST_F(TransactionApi, prefixHash) {
   ASSERT_EQ(hash, reloadedTx(tx)->getTransactionPrefixHash());
 }
 
+TEST_F(TransactionApi, cachedTransactionPrefixHashFromBlob) {
+  TransactionTypes::InputKeyInfo info = createInputInfo(1000);
+  KeyPair ephKeys;
+  size_t index = tx->addInput(sender, info, ephKeys);
+  tx->addOutput(500, sender.address);
+  tx->signInputKey(index, info, ephKeys);
+
+  auto txBlob = tx->getTransactionData();
+  CachedTransaction fromBlob(txBlob);
+  CachedTransaction fromObject(fromBlob.getTransaction());
+
+  ASSERT_EQ(tx->getTransactionPrefixHash(), fromBlob.getTransactionPrefixHash());
+  ASSERT_EQ(fromObject.getTransactionPrefixHash(), fromBlob.getTransactionPrefixHash());
+  ASSERT_EQ(tx->getTransactionHash(), fromBlob.getTransactionHash());
+}
+
 TEST_F(TransactionApi, findOutputs) {
   AccountKeys accounts[] = { generateAccountKeys(), generateAccountKeys(), generateAccountKeys() };
 
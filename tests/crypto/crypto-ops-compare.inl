@@ -0,0 +1,97 @@
+// Copyright (c) 2012-2017, The CryptoNote developers, The Bytecoin developers
+//
+// This file is part of Bytecoin.
+//
+// Bytecoin is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Bytecoin is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
+
+/* Byte-level wrappers around the group operations, compiled once per field backend.
+The includer defines COMPARE_NAME to give each copy its own prefix. */
+
+int COMPARE_NAME(scalarmult_base)(unsigned char *res, const unsigned char *a) {
+  ge_p3 point;
+  ge_scalarmult_base(&point, a);
+  ge_p3_tobytes(res, &point);
+  return 0;
+}
+
+int COMPARE_NAME(scalarmult_mul8)(unsigned char *res, const unsigned char *a, const unsigned char *A) {
+  ge_p3 point;
+  ge_p2 point2;
+  ge_p1p1 point3;
+  if (ge_frombytes_vartime(&point, A) != 0) {
+    return -1;
+  }
+  ge_scalarmult(&point2, a, &point);
+  ge_mul8(&point3, &point2);
+  ge_p1p1_to_p2(&point2, &point3);
+  ge_tobytes(res, &point2);
+  return 0;
+}
+
+int COMPARE_NAME(double_scalarmult_base)(unsigned char *res, const unsigned char *a, const unsigned char *A, const unsigned char *b) {
+  ge_p3 point;
+  ge_p2 point2;
+  if (ge_frombytes_vartime(&point, A) != 0) {
+    return -1;
+  }
+  ge_double_scalarmult_base_vartime(&point2, a, &point, b);
+  ge_tobytes(res, &point2);
+  return 0;
+}
+
+int COMPARE_NAME(double_scalarmult_precomp)(unsigned char *res, const unsigned char *a, const unsigned char *A, const unsigned char *b, const unsigned char *B) {
+  ge_p3 point, point2;
+  ge_dsmp precomp;
+  ge_p2 point3;
+  if (ge_frombytes_vartime(&point, A) != 0 || ge_frombytes_vartime(&point2, B) != 0) {
+    return -1;
+  }
+  ge_dsm_precomp(precomp, &point2);
+  ge_double_scalarmult_precomp_vartime(&point3, a, &point, b, precomp);
+  ge_tobytes(res, &point3);
+  return 0;
+}
+
+int COMPARE_NAME(hash_to_ec)(unsigned char *res, const unsigned char *h) {
+  ge_p2 point;
+  ge_p1p1 point2;
+  ge_p3 point3;
+  ge_fromfe_frombytes_vartime(&point, h);
+  ge_mul8(&point2, &point);
+  ge_p1p1_to_p3(&point3, &point2);
+  ge_p3_tobytes(res, &point3);
+  return 0;
+}
+
+/* sum = A + B, diff = 2 * (A - B) */
+int COMPARE_NAME(add_sub)(unsigned char *sum, unsigned char *diff, const unsigned char *A, const unsigned char *B) {
+  ge_p3 point, point2;
+  ge_cached cached;
+  ge_p1p1 point3;
+  ge_p2 point4;
+  if (ge_frombytes_vartime(&point, A) != 0 || ge_frombytes_vartime(&point2, B) != 0) {
+    return -1;
+  }
+  ge_p3_to_cached(&cached, &point2);
+  ge_add(&point3, &point, &cached);
+  ge_p1p1_to_p2(&point4, &point3);
+  ge_tobytes(sum, &point4);
+  ge_sub(&point3, &point, &cached);
+  ge_p1p1_to_p2(&point4, &point3);
+  ge_p2_dbl(&point3, &point4);
+  ge_p1p1_to_p3(&point, &point3);
+  ge_p3_to_p2(&point4, &point);
+  ge_tobytes(diff, &point4);
+  return 0;
+}
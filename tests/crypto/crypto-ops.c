@@ -16,3 +16,6 @@
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "crypto/crypto-ops.c"
+
+#define COMPARE_NAME(name) backend_##name
+#include "crypto-ops-compare.inl"
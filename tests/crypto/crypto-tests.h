@@ -25,6 +25,17 @@ extern "C" {
 
 void setup_random(void);
 
+#define DECLARE_COMPARE_FUNCTIONS(prefix) \
+  int prefix##scalarmult_base(unsigned char *res, const unsigned char *a); \
+  int prefix##scalarmult_mul8(unsigned char *res, const unsigned char *a, const unsigned char *A); \
+  int prefix##double_scalarmult_base(unsigned char *res, const unsigned char *a, const unsigned char *A, const unsigned char *b); \
+  int prefix##double_scalarmult_precomp(unsigned char *res, const unsigned char *a, const unsigned char *A, const unsigned char *b, const unsigned char *B); \
+  int prefix##hash_to_ec(unsigned char *res, const unsigned char *h); \
+  int prefix##add_sub(unsigned char *sum, unsigned char *diff, const unsigned char *A, const unsigned char *B);
+
+DECLARE_COMPARE_FUNCTIONS(ref10_)
+DECLARE_COMPARE_FUNCTIONS(backend_)
+
 #if defined(__cplusplus)
 }
 
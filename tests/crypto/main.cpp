@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with Bytecoin.  If not, see <http://www.gnu.org/licenses/>.
 
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <fstream>
@@ -41,12 +42,95 @@ bool operator !=(const Crypto::KeyDerivation &a, const Crypto::KeyDerivation &b)
   return 0 != memcmp(&a, &b, sizeof(Crypto::KeyDerivation));
 }
 
+typedef unsigned char bytes32[32];
+
+static bool same_result(int expected, int actual, const void *expectedData, const void *actualData, size_t size) {
+  return expected == actual && (expected != 0 || memcmp(expectedData, actualData, size) == 0);
+}
+
+/* Runs the group operations on the reference field code and on the build's backend, results must be bit-identical */
+static bool compare_backends() {
+  vector<array<unsigned char, 32>> points;
+  vector<array<unsigned char, 32>> hashes;
+  const size_t RANDOM_COUNT = 256;
+
+  array<unsigned char, 32> encoding;
+  /* Identity, zero and the non-canonical encodings of y = 0..18 */
+  for (unsigned char low = 0; low < 19; ++low) {
+    encoding.fill(0);
+    encoding[0] = low;
+    points.push_back(encoding);
+    encoding[31] = 0x80;
+    points.push_back(encoding);
+    encoding.fill(0xff);
+    encoding[0] = static_cast<unsigned char>(0xed + low);
+    encoding[31] = 0x7f;
+    points.push_back(encoding);
+    hashes.push_back(encoding);
+    encoding[31] = 0xff;
+    points.push_back(encoding);
+    hashes.push_back(encoding);
+  }
+
+  for (size_t i = 0; i < RANDOM_COUNT; ++i) {
+    Crypto::EllipticCurveScalar scalar;
+    random_scalar(scalar);
+    ref10_scalarmult_base(encoding.data(), reinterpret_cast<const unsigned char *>(&scalar));
+    points.push_back(encoding);
+    encoding[31] ^= 0x80;
+    points.push_back(encoding);
+    Crypto::generate_random_bytes(encoding.size(), encoding.data());
+    points.push_back(encoding);
+    hashes.push_back(encoding);
+  }
+
+  for (size_t i = 0; i < hashes.size(); ++i) {
+    bytes32 expected, actual;
+    if (!same_result(ref10_hash_to_ec(expected, hashes[i].data()), backend_hash_to_ec(actual, hashes[i].data()), expected, actual, sizeof(bytes32))) {
+      cerr << "hash_to_ec differs on input " << i << endl;
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    const unsigned char *A = points[i].data();
+    const unsigned char *B = points[(i * 7 + 3) % points.size()].data();
+    Crypto::EllipticCurveScalar a, b;
+    bytes32 expected, actual, expected2, actual2;
+    random_scalar(a);
+    random_scalar(b);
+    const unsigned char *pa = reinterpret_cast<const unsigned char *>(&a);
+    const unsigned char *pb = reinterpret_cast<const unsigned char *>(&b);
+
+    if (!same_result(ref10_scalarmult_base(expected, pa), backend_scalarmult_base(actual, pa), expected, actual, sizeof(bytes32)) ||
+      !same_result(ref10_scalarmult_mul8(expected, pa, A), backend_scalarmult_mul8(actual, pa, A), expected, actual, sizeof(bytes32)) ||
+      !same_result(ref10_double_scalarmult_base(expected, pa, A, pb), backend_double_scalarmult_base(actual, pa, A, pb), expected, actual, sizeof(bytes32)) ||
+      !same_result(ref10_double_scalarmult_precomp(expected, pa, A, pb, B), backend_double_scalarmult_precomp(actual, pa, A, pb, B), expected, actual, sizeof(bytes32))) {
+      cerr << "Scalar multiplication differs on point " << i << endl;
+      return false;
+    }
+
+    int expectedResult = ref10_add_sub(expected, expected2, A, B);
+    int actualResult = backend_add_sub(actual, actual2, A, B);
+    if (!same_result(expectedResult, actualResult, expected, actual, sizeof(bytes32)) ||
+      !same_result(expectedResult, actualResult, expected2, actual2, sizeof(bytes32))) {
+      cerr << "Point addition differs on point " << i << endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
 int main(int argc, char *argv[]) {
   fstream input;
   string cmd;
   size_t test = 0;
   bool error = false;
   setup_random();
+  if (argc == 2 && string(argv[1]) == "--compare-backends") {
+    return compare_backends() ? 0 : 1;
+  }
   if (argc != 2) {
     cerr << "invalid arguments" << endl;
     return 1;